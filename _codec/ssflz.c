@@ -0,0 +1,348 @@
+/* --------------------------------------------------------------------------------------------- */
+/* Small System Framework                                                                        */
+/*                                                                                               */
+/* ssflz.c                                                                                       */
+/* Provides LZ compression codec.                                                                */
+/*                                                                                               */
+/* BSD-3-Clause License                                                                          */
+/* Copyright 2026 Supurloop Software LLC                                                         */
+/*                                                                                               */
+/* Redistribution and use in source and binary forms, with or without modification, are          */
+/* permitted provided that the following conditions are met:                                     */
+/*                                                                                               */
+/* 1. Redistributions of source code must retain the above copyright notice, this list of        */
+/* conditions and the following disclaimer.                                                      */
+/* 2. Redistributions in binary form must reproduce the above copyright notice, this list of     */
+/* conditions and the following disclaimer in the documentation and/or other materials provided  */
+/* with the distribution.                                                                        */
+/* 3. Neither the name of the copyright holder nor the names of its contributors may be used to  */
+/* endorse or promote products derived from this software without specific prior written         */
+/* permission.                                                                                   */
+/*                                                                                               */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   */
+/* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    */
+/* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL      */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE */
+/* GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    */
+/* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     */
+/* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  */
+/* OF THE POSSIBILITY OF SUCH DAMAGE.                                                            */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "ssfport.h"
+#include "ssfassert.h"
+#include "ssflz.h"
+
+/* --------------------------------------------------------------------------------------------- */
+/* Defines                                                                                       */
+/* --------------------------------------------------------------------------------------------- */
+#if (SSF_LZ_HASH_BITS < 8) || (SSF_LZ_HASH_BITS > 16)
+#error SSF_LZ_HASH_BITS must be 8 to 16
+#endif
+
+/* Encoding is a series of sequences, each a token, literal bytes, and a match:                  */
+/*   token: high nibble literal length, low nibble match length - SSF_LZ_MIN_MATCH               */
+/*   nibble of 15: length continues in following bytes, each added, until a byte below 255       */
+/*   match: 16-bit little endian offset back into the output, then the match length bytes        */
+/* The last sequence has a match nibble of 0 and an offset of 0, which no match can have, so a   */
+/* stream cut anywhere before that end marker is never taken for a complete one.                 */
+#define SSF_LZ_NIBBLE_MAX (15u)
+#define SSF_LZ_LEN_BYTE_MAX (255u)
+#define SSF_LZ_SKIP_SHIFT (10u) /* Search steps grow by 1 for every 2^shift bytes without a match */
+#define SSF_LZ_HASH(v) ((uint32_t)((v) * 2654435761ul) >> (32u - SSF_LZ_HASH_BITS))
+#define SSF_LZ_DECODE_CONTEXT_MAGIC (0x4C5A4443ul)
+
+typedef enum
+{
+    SSF_LZ_DEC_TOKEN,
+    SSF_LZ_DEC_LIT_LEN,
+    SSF_LZ_DEC_LIT,
+    SSF_LZ_DEC_OFFSET_LO,
+    SSF_LZ_DEC_OFFSET_HI,
+    SSF_LZ_DEC_MATCH_LEN,
+    SSF_LZ_DEC_END,
+    SSF_LZ_DEC_ERROR,
+} SSFLZDecState_t;
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the 4 bytes at p as a little endian 32-bit value.                                     */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFLZRead32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the number of length bytes that follow a token nibble for len.                        */
+/* --------------------------------------------------------------------------------------------- */
+static size_t _SSFLZLenBytes(size_t len)
+{
+    if (len < SSF_LZ_NIBBLE_MAX) return 0;
+    return ((len - SSF_LZ_NIBBLE_MAX) / SSF_LZ_LEN_BYTE_MAX) + 1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Writes the length bytes that follow a token nibble for len at out[*o].                        */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFLZWriteLen(uint8_t *out, size_t *o, size_t len)
+{
+    if (len < SSF_LZ_NIBBLE_MAX) return;
+    len -= SSF_LZ_NIBBLE_MAX;
+    while (len >= SSF_LZ_LEN_BYTE_MAX)
+    {
+        out[(*o)++] = SSF_LZ_LEN_BYTE_MAX;
+        len -= SSF_LZ_LEN_BYTE_MAX;
+    }
+    out[(*o)++] = (uint8_t)len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if the sequence was appended to out, else false if out is too small.             */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFLZEncodeSequence(const uint8_t *lit, size_t litLen, size_t offset,
+                                 size_t matchLen, uint8_t *out, size_t outSize, size_t *outLen)
+{
+    size_t o = *outLen;
+    size_t need = 1 + _SSFLZLenBytes(litLen) + litLen;
+    bool isLast = (matchLen == 0);
+
+    /* matchLen of 0 is the last sequence, which has the end marker in place of a match */
+    need += 2;
+    if (isLast == false)
+    {
+        matchLen -= SSF_LZ_MIN_MATCH;
+        need += _SSFLZLenBytes(matchLen);
+    }
+    if (need > (outSize - o)) return false;
+
+    out[o++] = (uint8_t)(((litLen < SSF_LZ_NIBBLE_MAX) ? litLen : SSF_LZ_NIBBLE_MAX) << 4);
+    _SSFLZWriteLen(out, &o, litLen);
+    memcpy(&out[o], lit, litLen);
+    o += litLen;
+    out[o++] = (uint8_t)offset;
+    out[o++] = (uint8_t)(offset >> 8);
+    if (isLast == false)
+    {
+        out[*outLen] |= (uint8_t)((matchLen < SSF_LZ_NIBBLE_MAX) ? matchLen : SSF_LZ_NIBBLE_MAX);
+        _SSFLZWriteLen(out, &o, matchLen);
+    }
+    *outLen = o;
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if in encoded into out with outLen set, else false if out is too small.          */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFLZEncode(SSFLZEncodeContext_t *context, const uint8_t *in, size_t inLen, uint8_t *out,
+                 size_t outSize, size_t *outLen)
+{
+    size_t ip = 0;
+    size_t anchor = 0;
+    size_t ref;
+    size_t len;
+    size_t o = 0;
+    uint32_t v;
+    uint32_t h;
+
+    SSF_REQUIRE(context != NULL);
+    SSF_REQUIRE(in != NULL);
+    SSF_REQUIRE(inLen <= SSF_LZ_MAX_IN_LEN);
+    SSF_REQUIRE(out != NULL);
+    SSF_REQUIRE(outLen != NULL);
+
+    /* Stale entries are harmless, every candidate is checked against the input */
+    memset(context->table, 0, sizeof(context->table));
+    while ((ip + SSF_LZ_MIN_MATCH) <= inLen)
+    {
+        v = _SSFLZRead32(&in[ip]);
+        h = SSF_LZ_HASH(v);
+        ref = context->table[h];
+        context->table[h] = (uint16_t)ip;
+        if ((ref >= ip) || (_SSFLZRead32(&in[ref]) != v))
+        {
+            /* Step faster through input that does not compress */
+            ip += 1 + ((ip - anchor) >> SSF_LZ_SKIP_SHIFT);
+            continue;
+        }
+
+        /* Extend the match as far as the input allows */
+        for (len = SSF_LZ_MIN_MATCH; ((ip + len) < inLen) && (in[ref + len] == in[ip + len]);
+             len++) {}
+        if (_SSFLZEncodeSequence(&in[anchor], ip - anchor, ip - ref, len, out, outSize, &o) ==
+            false) return false;
+        ip += len;
+        anchor = ip;
+
+        /* Index the end of the match so runs of similar data chain together */
+        if ((ip + SSF_LZ_MIN_MATCH) <= inLen)
+        { context->table[SSF_LZ_HASH(_SSFLZRead32(&in[ip - 2]))] = (uint16_t)(ip - 2); }
+    }
+    if (_SSFLZEncodeSequence(&in[anchor], inLen - anchor, 0, 0, out, outSize, &o) == false)
+    { return false; }
+    *outLen = o;
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Moves the decoder to next, or to the error state if len bytes do not fit in the output.       */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFLZDecodeNext(SSFLZDecodeContext_t *context, SSFLZDecState_t next)
+{
+    if (context->len > (context->outSize - context->outLen)) next = SSF_LZ_DEC_ERROR;
+    context->state = (uint8_t)next;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Copies the decoded match to the output and moves on to the next token.                        */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFLZDecodeMatch(SSFLZDecodeContext_t *context)
+{
+    uint8_t *dst;
+    size_t i;
+
+    _SSFLZDecodeNext(context, SSF_LZ_DEC_TOKEN);
+    if (context->state == SSF_LZ_DEC_ERROR) return;
+
+    /* Match may overlap the bytes it produces, which repeats them */
+    dst = &context->out[context->outLen];
+    if (context->offset >= context->len) memcpy(dst, dst - context->offset, context->len);
+    else { for (i = 0; i < context->len; i++) dst[i] = dst[i - context->offset]; }
+    context->outLen += context->len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes context to decode into out.                                                       */
+/* --------------------------------------------------------------------------------------------- */
+void SSFLZDecodeBegin(SSFLZDecodeContext_t *context, uint8_t *out, size_t outSize)
+{
+    SSF_REQUIRE(context != NULL);
+    SSF_REQUIRE(out != NULL);
+
+    memset(context, 0, sizeof(SSFLZDecodeContext_t));
+    context->out = out;
+    context->outSize = outSize;
+    context->state = SSF_LZ_DEC_TOKEN;
+    context->magic = SSF_LZ_DECODE_CONTEXT_MAGIC;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if in decoded so far, else false if in is malformed or the output is too small.  */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFLZDecodeUpdate(SSFLZDecodeContext_t *context, const uint8_t *in, size_t inLen)
+{
+    size_t n;
+    uint8_t b;
+
+    SSF_REQUIRE(context != NULL);
+    SSF_REQUIRE(context->magic == SSF_LZ_DECODE_CONTEXT_MAGIC);
+    SSF_REQUIRE(in != NULL);
+
+    while ((inLen > 0) && (context->state != SSF_LZ_DEC_ERROR))
+    {
+        /* Literals are copied straight through */
+        if (context->state == SSF_LZ_DEC_LIT)
+        {
+            n = (context->len < inLen) ? context->len : inLen;
+            memcpy(&context->out[context->outLen], in, n);
+            context->outLen += n;
+            context->len -= n;
+            in += n;
+            inLen -= n;
+            if (context->len == 0) context->state = SSF_LZ_DEC_OFFSET_LO;
+            continue;
+        }
+
+        b = *in++;
+        inLen--;
+        switch (context->state)
+        {
+        case SSF_LZ_DEC_TOKEN:
+            context->token = b;
+            context->len = b >> 4;
+            if (context->len == SSF_LZ_NIBBLE_MAX) context->state = SSF_LZ_DEC_LIT_LEN;
+            else if (context->len == 0) context->state = SSF_LZ_DEC_OFFSET_LO;
+            else _SSFLZDecodeNext(context, SSF_LZ_DEC_LIT);
+            break;
+        case SSF_LZ_DEC_LIT_LEN:
+            context->len += b;
+            _SSFLZDecodeNext(context, (b == SSF_LZ_LEN_BYTE_MAX) ? SSF_LZ_DEC_LIT_LEN :
+                                                                   SSF_LZ_DEC_LIT);
+            break;
+        case SSF_LZ_DEC_OFFSET_LO:
+            context->offset = b;
+            context->state = SSF_LZ_DEC_OFFSET_HI;
+            break;
+        case SSF_LZ_DEC_OFFSET_HI:
+            context->offset |= (uint16_t)(b << 8);
+            if ((context->offset == 0) && ((context->token & SSF_LZ_NIBBLE_MAX) == 0))
+            {
+                context->state = SSF_LZ_DEC_END;
+                break;
+            }
+            if ((context->offset == 0) || (context->offset > context->outLen))
+            {
+                context->state = SSF_LZ_DEC_ERROR;
+                break;
+            }
+            context->len = (size_t)(context->token & SSF_LZ_NIBBLE_MAX) + SSF_LZ_MIN_MATCH;
+            if ((context->token & SSF_LZ_NIBBLE_MAX) == SSF_LZ_NIBBLE_MAX)
+            { _SSFLZDecodeNext(context, SSF_LZ_DEC_MATCH_LEN); }
+            else _SSFLZDecodeMatch(context);
+            break;
+        case SSF_LZ_DEC_MATCH_LEN:
+            context->len += b;
+            if (b == SSF_LZ_LEN_BYTE_MAX) _SSFLZDecodeNext(context, SSF_LZ_DEC_MATCH_LEN);
+            else _SSFLZDecodeMatch(context);
+            break;
+        case SSF_LZ_DEC_END:
+            /* Nothing may follow the end marker */
+            context->state = SSF_LZ_DEC_ERROR;
+            break;
+        default:
+            SSF_ERROR();
+            break;
+        }
+    }
+    return context->state != SSF_LZ_DEC_ERROR;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if all input decoded into a complete output of outLen bytes, else false.         */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFLZDecodeEnd(SSFLZDecodeContext_t *context, size_t *outLen)
+{
+    bool retVal;
+
+    SSF_REQUIRE(context != NULL);
+    SSF_REQUIRE(context->magic == SSF_LZ_DECODE_CONTEXT_MAGIC);
+    SSF_REQUIRE(outLen != NULL);
+
+    /* Encoding ends with the end marker of a last sequence */
+    retVal = (context->state == SSF_LZ_DEC_END);
+    if (retVal) *outLen = context->outLen;
+    context->magic = 0;
+    return retVal;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if in decoded into out with outLen set, else false.                              */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFLZDecode(const uint8_t *in, size_t inLen, uint8_t *out, size_t outSize, size_t *outLen)
+{
+    SSFLZDecodeContext_t context;
+
+    SSF_REQUIRE(in != NULL);
+    SSF_REQUIRE(out != NULL);
+    SSF_REQUIRE(outLen != NULL);
+
+    SSFLZDecodeBegin(&context, out, outSize);
+    if (SSFLZDecodeUpdate(&context, in, inLen) == false)
+    {
+        context.magic = 0;
+        return false;
+    }
+    return SSFLZDecodeEnd(&context, outLen);
+}
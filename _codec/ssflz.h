@@ -0,0 +1,91 @@
+/* --------------------------------------------------------------------------------------------- */
+/* Small System Framework                                                                        */
+/*                                                                                               */
+/* ssflz.h                                                                                       */
+/* Provides LZ compression codec interface.                                                      */
+/*                                                                                               */
+/* BSD-3-Clause License                                                                          */
+/* Copyright 2026 Supurloop Software LLC                                                         */
+/*                                                                                               */
+/* Redistribution and use in source and binary forms, with or without modification, are          */
+/* permitted provided that the following conditions are met:                                     */
+/*                                                                                               */
+/* 1. Redistributions of source code must retain the above copyright notice, this list of        */
+/* conditions and the following disclaimer.                                                      */
+/* 2. Redistributions in binary form must reproduce the above copyright notice, this list of     */
+/* conditions and the following disclaimer in the documentation and/or other materials provided  */
+/* with the distribution.                                                                        */
+/* 3. Neither the name of the copyright holder nor the names of its contributors may be used to  */
+/* endorse or promote products derived from this software without specific prior written         */
+/* permission.                                                                                   */
+/*                                                                                               */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   */
+/* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    */
+/* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL      */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE */
+/* GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    */
+/* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     */
+/* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  */
+/* OF THE POSSIBILITY OF SUCH DAMAGE.                                                            */
+#ifndef SSF_LZ_H_INCLUDE
+#define SSF_LZ_H_INCLUDE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssfport.h"
+
+/* --------------------------------------------------------------------------------------------- */
+/* Defines                                                                                       */
+/* --------------------------------------------------------------------------------------------- */
+#define SSF_LZ_MIN_MATCH (4u)
+#define SSF_LZ_MAX_IN_LEN (65535u)
+
+/* Largest encoding of inLen bytes, when nothing in them matches */
+#define SSF_LZ_ENCODE_MAX_LEN(inLen) ((inLen) + ((inLen) / 255u) + 4u)
+
+typedef struct
+{
+    uint16_t table[1u << SSF_LZ_HASH_BITS]; /* Last input offset seen for each hash */
+} SSFLZEncodeContext_t;
+
+typedef struct
+{
+    uint8_t *out;      /* Decoded output, also the history that matches copy from */
+    size_t outSize;
+    size_t outLen;
+    size_t len;        /* Literal or match bytes still to copy */
+    uint16_t offset;   /* Distance back to the match being decoded */
+    uint8_t token;
+    uint8_t state;
+    uint32_t magic;    /* Context validity marker */
+} SSFLZDecodeContext_t;
+
+/* --------------------------------------------------------------------------------------------- */
+/* External Interface                                                                            */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFLZEncode(SSFLZEncodeContext_t *context, const uint8_t *in, size_t inLen, uint8_t *out,
+                 size_t outSize, size_t *outLen);
+bool SSFLZDecode(const uint8_t *in, size_t inLen, uint8_t *out, size_t outSize, size_t *outLen);
+
+/* Incremental decode interface - Begin/Update/End                                               */
+void SSFLZDecodeBegin(SSFLZDecodeContext_t *context, uint8_t *out, size_t outSize);
+bool SSFLZDecodeUpdate(SSFLZDecodeContext_t *context, const uint8_t *in, size_t inLen);
+bool SSFLZDecodeEnd(SSFLZDecodeContext_t *context, size_t *outLen);
+
+/* --------------------------------------------------------------------------------------------- */
+/* Unit test                                                                                     */
+/* --------------------------------------------------------------------------------------------- */
+#if SSF_CONFIG_LZ_UNIT_TEST == 1
+void SSFLZUnitTest(void);
+#endif /* SSF_CONFIG_LZ_UNIT_TEST */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSF_LZ_H_INCLUDE */
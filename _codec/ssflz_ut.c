@@ -0,0 +1,315 @@
+/* --------------------------------------------------------------------------------------------- */
+/* Small System Framework                                                                        */
+/*                                                                                               */
+/* ssflz_ut.c                                                                                    */
+/* Provides LZ compression codec unit test.                                                      */
+/*                                                                                               */
+/* BSD-3-Clause License                                                                          */
+/* Copyright 2026 Supurloop Software LLC                                                         */
+/*                                                                                               */
+/* Redistribution and use in source and binary forms, with or without modification, are          */
+/* permitted provided that the following conditions are met:                                     */
+/*                                                                                               */
+/* 1. Redistributions of source code must retain the above copyright notice, this list of        */
+/* conditions and the following disclaimer.                                                      */
+/* 2. Redistributions in binary form must reproduce the above copyright notice, this list of     */
+/* conditions and the following disclaimer in the documentation and/or other materials provided  */
+/* with the distribution.                                                                        */
+/* 3. Neither the name of the copyright holder nor the names of its contributors may be used to  */
+/* endorse or promote products derived from this software without specific prior written         */
+/* permission.                                                                                   */
+/*                                                                                               */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   */
+/* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    */
+/* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL      */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE */
+/* GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    */
+/* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     */
+/* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  */
+/* OF THE POSSIBILITY OF SUCH DAMAGE.                                                            */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "ssfassert.h"
+#include "ssflz.h"
+
+#if SSF_CONFIG_LZ_UNIT_TEST == 1
+
+#define SSF_LZ_UT_MAX_LEN (8192u)
+#define SSF_LZ_UT_SWEEP_LEN (600u)
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+#define SSF_LZ_UT_BENCH_BYTES (64ul * 1024ul * 1024ul)
+#endif
+
+static SSFLZEncodeContext_t _ssfLZUTContext;
+static uint8_t _ssfLZUTIn[SSF_LZ_MAX_IN_LEN];
+static uint8_t _ssfLZUTEnc[SSF_LZ_ENCODE_MAX_LEN(SSF_LZ_MAX_IN_LEN)];
+static uint8_t _ssfLZUTOut[SSF_LZ_MAX_IN_LEN];
+
+/* --------------------------------------------------------------------------------------------- */
+/* Fills data with dataLen bytes of pseudo random data that does not compress.                   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFLZUTRandom(uint8_t *data, size_t dataLen, uint32_t seed)
+{
+    size_t i;
+
+    for (i = 0; i < dataLen; i++)
+    {
+        seed = (seed * 1103515245ul) + 12345ul;
+        data[i] = (uint8_t)(seed >> 16);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Fills data with up to dataSize bytes of JSON config text, returns its length.                 */
+/* --------------------------------------------------------------------------------------------- */
+static size_t _SSFLZUTJson(uint8_t *data, size_t dataSize)
+{
+    char entry[160];
+    size_t len = 0;
+    size_t entryLen;
+    uint32_t i;
+
+    for (i = 0; ; i++)
+    {
+        entryLen = (size_t)snprintf(entry, sizeof(entry),
+                                    "%s{\"id\":%lu,\"name\":\"sensor-%lu\",\"enabled\":%s,"
+                                    "\"rateMs\":%lu,\"limits\":{\"lo\":%ld,\"hi\":%lu}}",
+                                    (i == 0) ? "{\"sensors\":[" : ",", (unsigned long)i,
+                                    (unsigned long)i, ((i % 3u) == 0) ? "false" : "true",
+                                    (unsigned long)(100u * (1u + (i % 5u))),
+                                    -(long)(i % 40u), (unsigned long)(1000u + (i * 7u)));
+        if ((len + entryLen + 2) > dataSize) break;
+        memcpy(&data[len], entry, entryLen);
+        len += entryLen;
+    }
+    memcpy(&data[len], "]}", 2);
+    return len + 2;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Asserts in round trips through the encoder and decoder, returns its encoded length.           */
+/* --------------------------------------------------------------------------------------------- */
+static size_t _SSFLZUTRoundTrip(const uint8_t *in, size_t inLen)
+{
+    SSFLZDecodeContext_t context;
+    size_t encLen;
+    size_t outLen;
+    size_t i;
+
+    SSF_ASSERT(SSFLZEncode(&_ssfLZUTContext, in, inLen, _ssfLZUTEnc, sizeof(_ssfLZUTEnc),
+                           &encLen));
+    SSF_ASSERT(encLen <= SSF_LZ_ENCODE_MAX_LEN(inLen));
+    memset(_ssfLZUTOut, 0, inLen);
+    SSF_ASSERT(SSFLZDecode(_ssfLZUTEnc, encLen, _ssfLZUTOut, inLen, &outLen));
+    SSF_ASSERT((outLen == inLen) && (memcmp(in, _ssfLZUTOut, inLen) == 0));
+
+    /* Output must fit exactly, in both directions */
+    SSF_ASSERT(SSFLZEncode(&_ssfLZUTContext, in, inLen, _ssfLZUTEnc, encLen - 1, &i) == false);
+    if (inLen > 0)
+    { SSF_ASSERT(SSFLZDecode(_ssfLZUTEnc, encLen, _ssfLZUTOut, inLen - 1, &i) == false); }
+
+    /* Decoding a byte at a time gives the same output */
+    memset(_ssfLZUTOut, 0, inLen);
+    SSFLZDecodeBegin(&context, _ssfLZUTOut, inLen);
+    for (i = 0; i < encLen; i++) SSF_ASSERT(SSFLZDecodeUpdate(&context, &_ssfLZUTEnc[i], 1));
+    SSF_ASSERT(SSFLZDecodeEnd(&context, &outLen));
+    SSF_ASSERT((outLen == inLen) && (memcmp(in, _ssfLZUTOut, inLen) == 0));
+    return encLen;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Asserts every proper prefix of the encoding of in fails to decode, at once and incrementally.  */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFLZUTPrefixes(const uint8_t *in, size_t inLen)
+{
+    SSFLZDecodeContext_t context;
+    size_t encLen;
+    size_t outLen;
+    size_t i;
+
+    SSF_ASSERT(SSFLZEncode(&_ssfLZUTContext, in, inLen, _ssfLZUTEnc, sizeof(_ssfLZUTEnc),
+                           &encLen));
+    for (i = 0; i < encLen; i++)
+    {
+        SSF_ASSERT(SSFLZDecode(_ssfLZUTEnc, i, _ssfLZUTOut, inLen, &outLen) == false);
+    }
+    SSFLZDecodeBegin(&context, _ssfLZUTOut, inLen);
+    for (i = 0; i < (encLen - 1); i++)
+    {
+        SSF_ASSERT(SSFLZDecodeUpdate(&context, &_ssfLZUTEnc[i], 1));
+    }
+    SSF_ASSERT(SSFLZDecodeEnd(&context, &outLen) == false);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if enc decodes into an output of outSize bytes, else false.                      */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFLZUTDecodes(const uint8_t *enc, size_t encLen, size_t outSize)
+{
+    size_t outLen;
+
+    return SSFLZDecode(enc, encLen, _ssfLZUTOut, outSize, &outLen);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Units tests the LZ compression codec.                                                         */
+/* --------------------------------------------------------------------------------------------- */
+void SSFLZUnitTest(void)
+{
+    SSFLZDecodeContext_t context;
+    size_t len;
+    size_t encLen;
+    size_t outLen;
+    size_t i;
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    uint64_t start;
+    uint64_t encTicks;
+    uint64_t decTicks;
+    uint32_t reps;
+    uint32_t r;
+    uint32_t t;
+    static const char *names[] = { "JSON", "random" };
+#endif
+
+    /* Check requirements */
+    SSF_ASSERT_TEST(SSFLZEncode(NULL, _ssfLZUTIn, 1, _ssfLZUTEnc, sizeof(_ssfLZUTEnc), &len));
+    SSF_ASSERT_TEST(SSFLZEncode(&_ssfLZUTContext, NULL, 1, _ssfLZUTEnc, sizeof(_ssfLZUTEnc),
+                                &len));
+    SSF_ASSERT_TEST(SSFLZEncode(&_ssfLZUTContext, _ssfLZUTIn, SSF_LZ_MAX_IN_LEN + 1, _ssfLZUTEnc,
+                                sizeof(_ssfLZUTEnc), &len));
+    SSF_ASSERT_TEST(SSFLZEncode(&_ssfLZUTContext, _ssfLZUTIn, 1, NULL, sizeof(_ssfLZUTEnc), &len));
+    SSF_ASSERT_TEST(SSFLZEncode(&_ssfLZUTContext, _ssfLZUTIn, 1, _ssfLZUTEnc, sizeof(_ssfLZUTEnc),
+                                NULL));
+    SSF_ASSERT_TEST(SSFLZDecode(NULL, 1, _ssfLZUTOut, sizeof(_ssfLZUTOut), &len));
+    SSF_ASSERT_TEST(SSFLZDecode(_ssfLZUTEnc, 1, NULL, sizeof(_ssfLZUTOut), &len));
+    SSF_ASSERT_TEST(SSFLZDecode(_ssfLZUTEnc, 1, _ssfLZUTOut, sizeof(_ssfLZUTOut), NULL));
+    SSF_ASSERT_TEST(SSFLZDecodeBegin(NULL, _ssfLZUTOut, sizeof(_ssfLZUTOut)));
+    SSF_ASSERT_TEST(SSFLZDecodeBegin(&context, NULL, sizeof(_ssfLZUTOut)));
+    SSFLZDecodeBegin(&context, _ssfLZUTOut, sizeof(_ssfLZUTOut));
+    SSF_ASSERT_TEST(SSFLZDecodeUpdate(NULL, _ssfLZUTEnc, 1));
+    SSF_ASSERT_TEST(SSFLZDecodeUpdate(&context, NULL, 1));
+    SSF_ASSERT_TEST(SSFLZDecodeEnd(NULL, &len));
+    SSF_ASSERT_TEST(SSFLZDecodeEnd(&context, NULL));
+    SSF_ASSERT(SSFLZDecodeEnd(&context, &len) == false);
+    SSF_ASSERT_TEST(SSFLZDecodeUpdate(&context, _ssfLZUTEnc, 1));
+    SSF_ASSERT_TEST(SSFLZDecodeEnd(&context, &len));
+
+    /* Empty input is a single empty last sequence and its end marker */
+    SSF_ASSERT(_SSFLZUTRoundTrip(_ssfLZUTIn, 0) == 3);
+    SSF_ASSERT((_ssfLZUTEnc[0] == 0) && (_ssfLZUTEnc[1] == 0) && (_ssfLZUTEnc[2] == 0));
+
+    /* Every length across the literal and match length byte boundaries */
+    _SSFLZUTRandom(_ssfLZUTIn, SSF_LZ_UT_SWEEP_LEN, 1);
+    for (len = 0; len <= SSF_LZ_UT_SWEEP_LEN; len++)
+    {
+        SSF_ASSERT(_SSFLZUTRoundTrip(_ssfLZUTIn, len) <= SSF_LZ_ENCODE_MAX_LEN(len));
+    }
+    memset(_ssfLZUTIn, 'a', SSF_LZ_UT_SWEEP_LEN);
+    for (len = 0; len <= SSF_LZ_UT_SWEEP_LEN; len++)
+    {
+        encLen = _SSFLZUTRoundTrip(_ssfLZUTIn, len);
+        if (len >= 16) SSF_ASSERT(encLen <= (10u + (len / 255u)));
+    }
+    for (len = 0; len <= SSF_LZ_UT_SWEEP_LEN; len++)
+    {
+        _SSFLZUTRandom(_ssfLZUTIn, len, (uint32_t)len);
+        memcpy(&_ssfLZUTIn[len], _ssfLZUTIn, len);
+        encLen = _SSFLZUTRoundTrip(_ssfLZUTIn, len * 2);
+        if (len >= 16) SSF_ASSERT(encLen < (len + 18u));
+    }
+
+    /* Representative data, and the largest input */
+    len = _SSFLZUTJson(_ssfLZUTIn, SSF_LZ_UT_MAX_LEN);
+    SSF_ASSERT((_SSFLZUTRoundTrip(_ssfLZUTIn, len) * 2) < len);
+    _SSFLZUTRandom(_ssfLZUTIn, SSF_LZ_MAX_IN_LEN, 2);
+    SSF_ASSERT(_SSFLZUTRoundTrip(_ssfLZUTIn, SSF_LZ_MAX_IN_LEN) > SSF_LZ_MAX_IN_LEN);
+    memset(_ssfLZUTIn, 0, SSF_LZ_MAX_IN_LEN);
+    SSF_ASSERT(_SSFLZUTRoundTrip(_ssfLZUTIn, SSF_LZ_MAX_IN_LEN) < 300u);
+
+    /* Overlapping match repeats the bytes it produces */
+    SSF_ASSERT(SSFLZDecode((const uint8_t *)"\x14" "a" "\x01\x00" "\x00\x00\x00", 7, _ssfLZUTOut,
+                           9, &outLen));
+    SSF_ASSERT((outLen == 9) && (memcmp(_ssfLZUTOut, "aaaaaaaaa", 9) == 0));
+
+    /* Malformed input is rejected, never written past out */
+    SSF_ASSERT(_SSFLZUTDecodes((const uint8_t *)"\x14" "a" "\x01\x00" "\x00\x00\x00", 7, 8) ==
+               false);
+    SSF_ASSERT(_SSFLZUTDecodes((const uint8_t *)"\x14" "a" "\x01\x00", 4, 9) == false);
+    SSF_ASSERT(_SSFLZUTDecodes((const uint8_t *)"\x14" "a" "\x01\x00" "\x00", 5, 9) == false);
+    SSF_ASSERT(_SSFLZUTDecodes((const uint8_t *)"\x11" "a" "\x00\x00" "\x00\x00\x00", 7, 9) ==
+               false);
+    SSF_ASSERT(_SSFLZUTDecodes((const uint8_t *)"\x10" "a" "\x00\x00" "\x00", 5, 9) == false);
+    SSF_ASSERT(_SSFLZUTDecodes((const uint8_t *)"\x10" "a" "\x02\x00" "\x00", 5, 9) == false);
+    SSF_ASSERT(_SSFLZUTDecodes((const uint8_t *)"\x20" "a", 2, 9) == false);
+    SSF_ASSERT(_SSFLZUTDecodes((const uint8_t *)"\x01", 1, 9) == false);
+    SSF_ASSERT(_SSFLZUTDecodes((const uint8_t *)"\xf0\xff\xff", 3, 400) == false);
+    SSF_ASSERT(_SSFLZUTDecodes((const uint8_t *)"\x1f" "a" "\x01\x00\xff\xff", 6, 400) ==
+               false);
+    SSF_ASSERT(_SSFLZUTDecodes((const uint8_t *)"\x00", 1, 0) == false);
+    SSF_ASSERT(_SSFLZUTDecodes((const uint8_t *)"\x00\x00\x00" "\x00", 4, 0) == false);
+    SSF_ASSERT(_SSFLZUTDecodes((const uint8_t *)"\x00\x00\x00", 3, 0));
+
+    /* Input cut anywhere before the end marker is rejected */
+    for (len = 0; len <= 64u; len++)
+    {
+        _SSFLZUTRandom(_ssfLZUTIn, len, (uint32_t)len);
+        _SSFLZUTPrefixes(_ssfLZUTIn, len);
+        memcpy(&_ssfLZUTIn[len / 2], _ssfLZUTIn, len / 2);
+        _SSFLZUTPrefixes(_ssfLZUTIn, len);
+        memset(_ssfLZUTIn, 'a', len);
+        _SSFLZUTPrefixes(_ssfLZUTIn, len);
+    }
+    len = _SSFLZUTJson(_ssfLZUTIn, 1024);
+    _SSFLZUTPrefixes(_ssfLZUTIn, len);
+
+    /* Corrupted encodings either fail or stay within out */
+    len = _SSFLZUTJson(_ssfLZUTIn, 1024);
+    SSF_ASSERT(SSFLZEncode(&_ssfLZUTContext, _ssfLZUTIn, len, _ssfLZUTEnc, sizeof(_ssfLZUTEnc),
+                           &encLen));
+    for (i = 0; i < encLen; i++)
+    {
+        _ssfLZUTEnc[i] ^= 0x5a;
+        memset(_ssfLZUTOut, 0xee, len + 1);
+        if (SSFLZDecode(_ssfLZUTEnc, encLen, _ssfLZUTOut, len, &outLen))
+        { SSF_ASSERT(outLen <= len); }
+        SSF_ASSERT(_ssfLZUTOut[len] == 0xee);
+        _ssfLZUTEnc[i] ^= 0x5a;
+    }
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    for (t = 0; t < 2; t++)
+    {
+        if (t == 0) len = _SSFLZUTJson(_ssfLZUTIn, SSF_LZ_UT_MAX_LEN);
+        else
+        {
+            len = SSF_LZ_UT_MAX_LEN;
+            _SSFLZUTRandom(_ssfLZUTIn, len, 3);
+        }
+        reps = (uint32_t)(SSF_LZ_UT_BENCH_BYTES / len);
+        start = SSFPortGetHRTick64();
+        for (r = 0; r < reps; r++)
+        {
+            SSF_ASSERT(SSFLZEncode(&_ssfLZUTContext, _ssfLZUTIn, len, _ssfLZUTEnc,
+                                   sizeof(_ssfLZUTEnc), &encLen));
+        }
+        encTicks = SSFPortGetHRTick64() - start;
+        start = SSFPortGetHRTick64();
+        for (r = 0; r < reps; r++)
+        {
+            SSF_ASSERT(SSFLZDecode(_ssfLZUTEnc, encLen, _ssfLZUTOut, len, &outLen));
+        }
+        decTicks = SSFPortGetHRTick64() - start;
+        printf("\r\n  LZ %s %lu bytes: %lu encoded (%lu%%), encode %llu MB/s, decode %llu MB/s\r\n",
+               names[t], (unsigned long)len, (unsigned long)encLen,
+               (unsigned long)((encLen * 100u) / len),
+               (unsigned long long)(((uint64_t)reps * len * SSF_HR_TICKS_PER_SEC) /
+                                    ((encTicks == 0 ? 1 : encTicks) * 1000000ull)),
+               (unsigned long long)(((uint64_t)reps * len * SSF_HR_TICKS_PER_SEC) /
+                                    ((decTicks == 0 ? 1 : decTicks) * 1000000ull)));
+    }
+#endif
+}
+#endif /* SSF_CONFIG_LZ_UNIT_TEST */
@@ -31,6 +31,15 @@
 /* --------------------------------------------------------------------------------------------- */
 #include <stdlib.h>
 #include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#if defined(__linux__)
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
 #include "ssfll.h"
 #include "ssfsm.h"
 #include "ssfmpool.h"
@@ -39,20 +48,54 @@
 /* --------------------------------------------------------------------------------------------- */
 /* Defines                                                                                       */
 /* --------------------------------------------------------------------------------------------- */
-typedef struct
-{
-    SSFSMHandler_t current;
-    SSFSMHandler_t next;
-} SSFSMState_t;
+#define SSF_SM_EXEC_INIT_MAGIC (0x45584543ul)
+#define SSF_SM_EPOLL_INIT_MAGIC (0x45504f4cul)
+#define SSF_SM_EPOLL_WAKE_TAG (0xffffffffffffffffull)
 
-typedef struct
+/* Events are blocks of event pool 0 with small event data stored after the event, larger event */
+/* data is stored after the header of a block from the smallest data pool that fits it */
+typedef struct SSFSMEvent
 {
     SSFLLItem_t item;
+    SSFSMData_t *data; /* Inline, data pool block, heap copy if no pool fits, or NULL */
     SSFSMId_t smid;
     SSFSMEventId_t eid;
     SSFSMDataLen_t dataLen;
-    SSFSMData_t *data;
+    uint8_t pool;      /* Index of data pool holding data, 0 if inline or heap */
+    SSFSMPriority_t pri;
+    bool isCoalesce;   /* Indexed by exec->coalesce while queued */
+    SSFSMTimeout_t queued;
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+    uint64_t profileQueued;
+#endif
+#if SSF_SM_LOCK_FREE == 1
+    struct SSFSMEvent *inboxNext;
+    uint32_t poolNext;
+#endif
 } SSFSMEvent_t;
+#define SSF_SM_EVENT_PAYLOAD(e) ((SSFSMData_t *)(((SSFSMEvent_t *)(e)) + 1))
+
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+#define SSF_SM_PROFILE_NO_STATE (0xffu)
+#define SSF_SM_PROFILE_LINE_SIZE (100u)
+#define SSF_SM_PROFILE_NS(t) (((t) * 1000000000ull) / SSF_HR_TICKS_PER_SEC)
+#define SSF_SM_PROFILE_US(t) ((t) / (SSF_HR_TICKS_PER_SEC / 1000000ull))
+#endif
+
+#if SSF_SM_TRAN_CACHE_SIZE > 0
+#define SSF_SM_TRAN_CACHE_HASH_MUL (0x9e3779b97f4a7c15ull)
+#if SSF_SM_TRAN_CACHE_SIZE < 4
+#define SSF_SM_TRAN_CACHE_PROBES SSF_SM_TRAN_CACHE_SIZE
+#else
+#define SSF_SM_TRAN_CACHE_PROBES (4u)
+#endif
+#endif
+
+#if SSF_SM_CONFIG_ENABLE_TICK_SOURCE == 1
+#define SSF_SM_GET_TICK() _ssfsmTickFn()
+#else
+#define SSF_SM_GET_TICK() SSFPortGetTick64()
+#endif
 
 typedef struct
 {
@@ -65,333 +108,1562 @@ typedef struct
 /* --------------------------------------------------------------------------------------------- */
 /* Module variables                                                                              */
 /* --------------------------------------------------------------------------------------------- */
-static SSFSMState_t _SSFSMStates[SSF_SM_MAX];
-static SSFSMId_t _ssfsmActive = SSF_SM_MAX;
-static SSFSMId_t _ssfsmIsEntryExit;
-static SSFMPool_t _ssfsmEventPool;
-static SSFMPool_t _ssfsmTimerPool;
-static SSFLL_t _ssfsmEvents;
-static SSFLL_t _ssfsmTimers;
-static bool _ssfsmIsInited;
-static uint64_t _ssfsmMallocs;
-static uint64_t _ssfsmFrees;
+#if SSF_SM_EVENT_DATA_POOL_NUM > 0
+static const SSFSMDataLen_t _ssfsmDataPoolSizes[SSF_SM_EVENT_DATA_POOL_NUM] =
+    SSF_SM_EVENT_DATA_POOL_SIZES;
+static const uint32_t _ssfsmDataPoolCounts[SSF_SM_EVENT_DATA_POOL_NUM] =
+    SSF_SM_EVENT_DATA_POOL_COUNTS;
+#endif
+static SSFSMExec_t _ssfsmDefaultExec;
+static SSFSMExec_t *_ssfsmOwners[SSF_SM_MAX];
+static SSF_THREAD_LOCAL SSFSMExec_t *_ssfsmExec; /* Executor running handlers on this thread */
+#if SSF_SM_CONFIG_ENABLE_TICK_SOURCE == 1
+static SSFSMTimeout_t _SSFSMPortGetTick(void);
+static SSFSMTickFn_t _ssfsmTickFn = _SSFSMPortGetTick;
+static uint64_t _ssfsmSimTick;
+static uint32_t _ssfsmExecsInited; /* Tick source may only change while this is 0 */
+#endif
 
 #if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
 SSF_SM_THREAD_SYNC_DECLARATION;
 SSF_SM_THREAD_WAKE_DECLARATION;
 #endif
 
+#if SSF_SM_LOCK_FREE == 1
+/* Event pools keep their own tagged free list rather than SSFMPoolInitConcurrent(). Its per     */
+/* thread magazines would park free events where other producers cannot take them, so a post    */
+/* could assert on a pool that still has free events, every posting thread would have to flush  */
+/* before it exits, and lock-free events would depend on SSF_MPOOL_CONFIG_ENABLE_CONCURRENT.     */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns pointer to event node at index.                                                       */
+/* --------------------------------------------------------------------------------------------- */
+static SSFSMEvent_t *_SSFSMEventPoolNode(const SSFSMEventPool_t *pool, uint32_t index)
+{
+    return (SSFSMEvent_t *)(pool->nodes + (((size_t)index) * pool->nodeSize));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes the lock-free event pool with every node on the free list, plus extra nodes.      */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMEventPoolInit(SSFSMEventPool_t *pool, uint32_t size, uint32_t nodeSize,
+                                uint32_t extra)
+{
+    uint32_t i;
+
+    SSF_REQUIRE(pool != NULL);
+    SSF_REQUIRE((size > 0) && (size < (UINT32_MAX - extra)));
+    SSF_REQUIRE(nodeSize >= sizeof(SSFSMEvent_t));
+
+    /* Keep every node aligned like the first */
+    nodeSize = (uint32_t)((nodeSize + sizeof(void *) - 1) & ~(sizeof(void *) - 1));
+    SSF_ASSERT((pool->nodes = (uint8_t *)SSF_MALLOC(((size_t)size + extra) * nodeSize)) != NULL);
+    memset(pool->nodes, 0, ((size_t)size + extra) * nodeSize);
+    pool->nodeSize = nodeSize;
+    for (i = 0; i < size; i++) _SSFSMEventPoolNode(pool, i)->poolNext = i + 2;
+    _SSFSMEventPoolNode(pool, size - 1)->poolNext = 0;
+    pool->head = 1;
+    pool->size = size;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Deinitializes the lock-free event pool, all nodes must have been freed.                       */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMEventPoolDeInit(SSFSMEventPool_t *pool)
+{
+    uint32_t index;
+    uint32_t len = 0;
+
+    SSF_REQUIRE(pool != NULL);
+    SSF_REQUIRE(pool->nodes != NULL);
+
+    for (index = (uint32_t)pool->head; index != 0;
+         index = _SSFSMEventPoolNode(pool, index - 1)->poolNext) { len++; }
+    SSF_ASSERT(len == pool->size);
+    SSF_FREE(pool->nodes);
+    memset(pool, 0, sizeof(SSFSMEventPool_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns an event node, or NULL if pool is empty; safe to call from any context.               */
+/* --------------------------------------------------------------------------------------------- */
+static SSFSMEvent_t *_SSFSMEventPoolAlloc(SSFSMEventPool_t *pool)
+{
+    uint64_t head;
+    uint64_t newHead;
+    uint32_t index;
+
+    do
+    {
+        head = SSF_ATOMIC_LOAD_U64(&(pool->head));
+        index = (uint32_t)head;
+        if (index == 0) return NULL;
+        newHead = (((head >> 32) + 1) << 32) |
+                  SSF_ATOMIC_LOAD_U32(&(_SSFSMEventPoolNode(pool, index - 1)->poolNext));
+    } while (SSF_ATOMIC_CAS_U64(&(pool->head), head, newHead) == false);
+    return _SSFSMEventPoolNode(pool, index - 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Frees an event node, safe to call from any context.                                           */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMEventPoolFree(SSFSMEventPool_t *pool, SSFSMEvent_t *e)
+{
+    uint64_t head;
+    uint64_t newHead;
+    uint32_t index;
+
+    SSF_REQUIRE(((uint8_t *)e >= pool->nodes) &&
+                ((uint8_t *)e < (pool->nodes + (((size_t)pool->size) * pool->nodeSize))));
+    index = ((uint32_t)(((uint8_t *)e - pool->nodes) / pool->nodeSize)) + 1;
+
+    do
+    {
+        head = SSF_ATOMIC_LOAD_U64(&(pool->head));
+        SSF_ATOMIC_STORE_U32(&(e->poolNext), (uint32_t)head);
+        newHead = (((head >> 32) + 1) << 32) | index;
+    } while (SSF_ATOMIC_CAS_U64(&(pool->head), head, newHead) == false);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes the event inbox.                                                                  */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMInboxInit(SSFSMInbox_t *inbox, SSFSMEvent_t *stub)
+{
+    SSF_REQUIRE(inbox != NULL);
+    SSF_REQUIRE(stub != NULL);
+
+    stub->inboxNext = NULL;
+    inbox->stub = stub;
+    inbox->head = stub;
+    inbox->tail = stub;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Pushes an event to the inbox, safe to call from any context.                                  */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMInboxPush(SSFSMInbox_t *inbox, SSFSMEvent_t *e)
+{
+    SSFSMEvent_t *prev;
+
+    SSF_ATOMIC_STORE_PTR(&(e->inboxNext), NULL);
+    prev = (SSFSMEvent_t *)SSF_ATOMIC_XCHG_PTR(&(inbox->head), e);
+    SSF_ATOMIC_STORE_PTR(&(prev->inboxNext), e);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns oldest event in inbox, else NULL; must only be called from the executor's context.    */
+/* --------------------------------------------------------------------------------------------- */
+static SSFSMEvent_t *_SSFSMInboxPop(SSFSMInbox_t *inbox)
+{
+    SSFSMEvent_t *tail = inbox->tail;
+    SSFSMEvent_t *next = (SSFSMEvent_t *)SSF_ATOMIC_LOAD_PTR(&(tail->inboxNext));
+
+    /* Skip over stub */
+    if (tail == inbox->stub)
+    {
+        if (next == NULL) return NULL;
+        inbox->tail = next;
+        tail = next;
+        next = (SSFSMEvent_t *)SSF_ATOMIC_LOAD_PTR(&(tail->inboxNext));
+    }
+    if (next != NULL)
+    {
+        inbox->tail = next;
+        return tail;
+    }
+
+    /* A producer swapped head but has not linked its event yet, a later call will see it */
+    if (tail != (SSFSMEvent_t *)SSF_ATOMIC_LOAD_PTR(&(inbox->head))) return NULL;
+
+    /* Tail is the last event, requeue stub behind it so tail can be removed */
+    _SSFSMInboxPush(inbox, inbox->stub);
+    next = (SSFSMEvent_t *)SSF_ATOMIC_LOAD_PTR(&(tail->inboxNext));
+    if (next != NULL)
+    {
+        inbox->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+#endif /* SSF_SM_LOCK_FREE */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Serializes access to an executor's event queue and pool from other contexts.                  */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMLock(SSFSMExec_t *exec)
+{
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && (SSF_SM_LOCK_FREE == 0)
+    if (exec == &_ssfsmDefaultExec) { SSF_SM_THREAD_SYNC_ACQUIRE(); }
+    else { SSF_MUTEX_ACQUIRE(exec->sync); }
+#else
+    SSF_UNUSED_PTR(exec);
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Releases access obtained with _SSFSMLock().                                                   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUnlock(SSFSMExec_t *exec)
+{
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && (SSF_SM_LOCK_FREE == 0)
+    if (exec == &_ssfsmDefaultExec) { SSF_SM_THREAD_SYNC_RELEASE(); }
+    else { SSF_MUTEX_RELEASE(exec->sync); }
+#else
+    SSF_UNUSED_PTR(exec);
+#endif
+}
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Wakes the thread running the executor.                                                        */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMWakePost(SSFSMExec_t *exec)
+{
+#if SSF_SM_EPOLL == 1
+    uint64_t one = 1;
+    int fd = exec->epollWakeFd;
+
+    /* Executor blocked in epoll_wait() of an SSFSMEpoll_t? */
+    if (fd >= 0) { SSF_ASSERT((write(fd, &one, sizeof(one)) == sizeof(one)) || (errno == EAGAIN)); }
+#endif
+    if (exec == &_ssfsmDefaultExec) { SSF_SM_THREAD_WAKE_POST(); }
+    else { SSF_SM_EXEC_WAKE_POST(exec->wake); }
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the maximum data size stored in the events or blocks of an event pool.                */
+/* --------------------------------------------------------------------------------------------- */
+static SSFSMDataLen_t _SSFSMPoolDataSize(uint8_t pool)
+{
+    SSF_REQUIRE(pool < SSF_SM_NUM_EVENT_POOLS);
+
+#if SSF_SM_EVENT_DATA_POOL_NUM > 0
+    if (pool > 0) return _ssfsmDataPoolSizes[pool - 1];
+#endif
+    return SSF_SM_EVENT_INLINE_DATA_SIZE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the maximum number of events.                                                         */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFSMEventPoolSize(SSFSMExec_t *exec)
+{
+#if SSF_SM_LOCK_FREE == 1
+    return exec->eventPools[0].size;
+#else
+    return SSFMPoolSize(&(exec->eventPools[0]));
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns an event from an event pool, or NULL if it is empty.                                  */
+/* --------------------------------------------------------------------------------------------- */
+static SSFSMEvent_t *_SSFSMPoolAllocEvent(SSFSMExec_t *exec, uint8_t pool, uint8_t owner)
+{
+#if SSF_SM_LOCK_FREE == 1
+    SSF_UNUSED_INT(owner);
+    return _SSFSMEventPoolAlloc(&(exec->eventPools[pool]));
+#else
+    if (SSFMPoolIsEmpty(&(exec->eventPools[pool]))) return NULL;
+    return (SSFSMEvent_t *)SSFMPoolAlloc(&(exec->eventPools[pool]),
+                                         SSFMPoolBlockSize(&(exec->eventPools[pool])), owner);
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Copies data to event e, to a block of the smallest data pool that fits, or to the heap.       */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMAllocData(SSFSMExec_t *exec, SSFSMEvent_t *e, const SSFSMData_t *data,
+                            SSFSMDataLen_t dataLen, uint8_t owner)
+{
+#if SSF_SM_EVENT_DATA_POOL_NUM > 0
+    SSFSMEvent_t *block = NULL;
+    uint8_t i;
+#endif
+
+    e->data = NULL;
+    e->dataLen = dataLen;
+    e->pool = 0;
+    if (dataLen == 0) return;
+
+    /* Data fits in the event? */
+    if (dataLen <= SSF_SM_EVENT_INLINE_DATA_SIZE)
+    {
+        /* Yes, copy it after the event */
+        e->data = SSF_SM_EVENT_PAYLOAD(e);
+    }
+    else
+    {
+#if SSF_SM_EVENT_DATA_POOL_NUM > 0
+        /* No, find the smallest data pool with a free block that fits it */
+        for (i = 1; i < SSF_SM_NUM_EVENT_POOLS; i++)
+        {
+            if (dataLen > _SSFSMPoolDataSize(i)) continue;
+            if ((block = _SSFSMPoolAllocEvent(exec, i, owner)) != NULL) break;
+        }
+
+        /* Found a block? */
+        if (block != NULL)
+        {
+            /* Yes, copy data after the block's header */
+            e->data = SSF_SM_EVENT_PAYLOAD(block);
+            e->pool = i;
+        }
+        else
+#endif /* SSF_SM_EVENT_DATA_POOL_NUM */
+        {
+            /* No, data too big or pools that fit it are empty, copy it to the heap */
+            SSF_ASSERT((e->data = (SSFSMData_t *)SSF_MALLOC(dataLen)) != NULL);
+#if SSF_SM_LOCK_FREE == 1
+            /* May be called concurrently from producers */
+            SSF_ATOMIC_ADD_U64(&(exec->mallocs), 1);
+#else
+            exec->mallocs++;
+            SSF_ENSURE(exec->frees <= exec->mallocs);
+            SSF_ENSURE((exec->mallocs - exec->frees) <= _SSFSMEventPoolSize(exec));
+#endif
+        }
+    }
+    memcpy(e->data, data, dataLen);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Allocates an event and copies data to it, to a block of the smallest pool that fits, or heap. */
+/* --------------------------------------------------------------------------------------------- */
+static SSFSMEvent_t *_SSFSMAllocEvent(SSFSMExec_t *exec, const SSFSMData_t *data,
+                                      SSFSMDataLen_t dataLen, uint8_t owner)
+{
+    SSFSMEvent_t *e;
+
+    /* Event pool 0 bounds the number of queued events */
+    SSF_ASSERT((e = _SSFSMPoolAllocEvent(exec, 0, owner)) != NULL);
+    e->isCoalesce = false;
+    _SSFSMAllocData(exec, e, data, dataLen, owner);
+    return e;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Frees the data pool block or heap copy holding event e's data.                                */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMFreeData(SSFSMExec_t *exec, SSFSMEvent_t *e)
+{
+    SSF_REQUIRE(e != NULL);
+    SSF_REQUIRE(e->pool < SSF_SM_NUM_EVENT_POOLS);
+
+#if SSF_SM_EVENT_DATA_POOL_NUM > 0
+    /* Data in a data pool block? */
+    if (e->pool != 0)
+    {
+        /* Yes, return the block to its pool */
+#if SSF_SM_LOCK_FREE == 1
+        _SSFSMEventPoolFree(&(exec->eventPools[e->pool]), ((SSFSMEvent_t *)e->data) - 1);
+#else
+        SSFMPoolFree(&(exec->eventPools[e->pool]), ((SSFSMEvent_t *)e->data) - 1);
+#endif
+    }
+    else
+#endif /* SSF_SM_EVENT_DATA_POOL_NUM */
+    /* Data on the heap? */
+    if ((e->data != NULL) && (e->data != SSF_SM_EVENT_PAYLOAD(e)))
+    {
+        /* Yes, free it */
+        SSF_FREE(e->data);
+#if SSF_SM_LOCK_FREE == 1
+        /* Producers free data they replace */
+        SSF_ATOMIC_ADD_U64(&(exec->frees), 1);
+        SSF_ENSURE(SSF_ATOMIC_LOAD_U64(&(exec->frees)) <= SSF_ATOMIC_LOAD_U64(&(exec->mallocs)));
+#else
+        exec->frees++;
+        SSF_ENSURE(exec->frees <= exec->mallocs);
+        SSF_ENSURE((exec->mallocs - exec->frees) <= _SSFSMEventPoolSize(exec));
+#endif
+    }
+    e->data = NULL;
+    e->pool = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Frees event e and its data.                                                                   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMFreeEvent(SSFSMExec_t *exec, SSFSMEvent_t *e)
+{
+    _SSFSMFreeData(exec, e);
+#if SSF_SM_LOCK_FREE == 1
+    _SSFSMEventPoolFree(&(exec->eventPools[0]), e);
+#else
+    SSFMPoolFree(&(exec->eventPools[0]), e);
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Stops all timers for active state machine.                                                    */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMStopAllTimers(SSFSMExec_t *exec)
+{
+    SSFLLItem_t *item;
+    SSFLLItem_t *next;
+    SSFSMTimer_t t;
+
+    SSF_ASSERT((exec->active > SSF_SM_MIN) && (exec->active < SSF_SM_MAX));
+
+    item = SSF_LL_HEAD(&(exec->timers));
+    while (item != NULL)
+    {
+        next = SSF_LL_NEXT_ITEM(item);
+        memcpy(&t, item, sizeof(t));
+
+        /* Same state machine and owner? */
+        if ((t.event->smid == exec->active) && (t.owner == exec->states[exec->active].current))
+        {
+            /* Yes, free it. */
+            _SSFSMLock(exec);
+            SSFLLGetItem(&(exec->timers), &item, SSF_LL_LOC_ITEM, item);
+            _SSFSMFreeEvent(exec, t.event);
+            _SSFSMUnlock(exec);
+            SSFMPoolFree(&(exec->timerPool), item);
+        }
+        item = next;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns timer if timer with event ID found in active state machine, else NULL.                */
+/* --------------------------------------------------------------------------------------------- */
+static SSFLLItem_t *_SSFSMFindTimer(SSFSMExec_t *exec, SSFSMEventId_t eid)
+{
+    SSFLLItem_t *item;
+    SSFLLItem_t *next;
+    SSFSMTimer_t t;
+
+    SSF_ASSERT((exec->active > SSF_SM_MIN) && (exec->active < SSF_SM_MAX));
+
+    item = SSF_LL_HEAD(&(exec->timers));
+    while (item != NULL)
+    {
+        next = SSF_LL_NEXT_ITEM(item);
+        memcpy(&t, item, sizeof(t));
+        /* Same state machine, event ID, and owner */
+        if ((t.event->smid == exec->active) && (t.event->eid == eid) &&
+            (t.owner == exec->states[exec->active].current)) break;
+        item = next;
+    }
+    return item;
+}
+
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the log2 histogram bin of a duration.                                                 */
+/* --------------------------------------------------------------------------------------------- */
+static uint8_t _SSFSMProfileBin(uint64_t ticks)
+{
+    uint8_t bin = 0;
+
+    while ((ticks != 0) && (bin < (SSF_SM_PROFILE_HIST_BINS - 1))) { ticks >>= 1; bin++; }
+    return bin;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Ends dwell in a state machine's profiled state and starts dwell in state, NULL for none.      */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMProfileState(SSFSMExec_t *exec, SSFSMId_t smid, SSFSMHandler_t state)
+{
+    SSFSMProfileState_t *ps = NULL;
+    uint64_t now = SSFPortGetHRTick64();
+    uint8_t i;
+
+    /* End dwell in previous state */
+    i = exec->profileState[smid];
+    if (i != SSF_SM_PROFILE_NO_STATE)
+    { exec->profile.states[smid][i].dwell += now - exec->profileEntered[smid]; }
+    exec->profileState[smid] = SSF_SM_PROFILE_NO_STATE;
+    if (state == NULL) return;
+
+    /* Find state's entry, adding it if necessary */
+    for (i = 0; i < SSF_SM_PROFILE_MAX_STATES; i++)
+    {
+        ps = &(exec->profile.states[smid][i]);
+        if (ps->state == NULL) ps->state = state;
+        if (ps->state == state) break;
+    }
+
+    /* State table full? */
+    if (i >= SSF_SM_PROFILE_MAX_STATES) { exec->profile.statesDropped++; return; }
+    ps->entries++;
+    exec->profileState[smid] = i;
+    exec->profileEntered[smid] = now;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Records the queueing delay and processing time of an event.                                   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMProfileEvent(SSFSMExec_t *exec, SSFSMEventId_t eid, uint64_t queued,
+                               uint64_t start, uint64_t end)
+{
+    SSFSMProfileEvent_t *pe = &(exec->profile.events[eid]);
+    uint64_t t = end - start;
+
+    pe->count++;
+    pe->handlerTotal += t;
+    if (t > pe->handlerMax) pe->handlerMax = t;
+    pe->handlerTime[_SSFSMProfileBin(t)]++;
+    pe->queueDelay[_SSFSMProfileBin(start - queued)]++;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Writes formatted text with writeFn.                                                           */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMProfileWrite(SSFSMProfileWriteFn_t writeFn, const char *fmt, ...)
+{
+    char line[SSF_SM_PROFILE_LINE_SIZE];
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    SSF_ASSERT(len >= 0);
+    if (((size_t)len) >= sizeof(line)) len = sizeof(line) - 1;
+    writeFn((const uint8_t *)line, (size_t)len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Writes the non-empty bins of a histogram, bin upper bounds are in ns.                         */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMProfileWriteHist(SSFSMProfileWriteFn_t writeFn, const char *name,
+                                   const uint32_t *hist)
+{
+    uint8_t i;
+
+    _SSFSMProfileWrite(writeFn, "    %s ns:", name);
+    for (i = 0; i < SSF_SM_PROFILE_HIST_BINS; i++)
+    {
+        if (hist[i] == 0) continue;
+        _SSFSMProfileWrite(writeFn, " %s%llu:%lu", i < (SSF_SM_PROFILE_HIST_BINS - 1) ? "<" : ">=",
+                           (unsigned long long)SSF_SM_PROFILE_NS(
+                               1ull << (i < (SSF_SM_PROFILE_HIST_BINS - 1) ? i : (i - 1))),
+                           (unsigned long)hist[i]);
+    }
+    _SSFSMProfileWrite(writeFn, "\r\n");
+}
+#endif /* SSF_SM_CONFIG_ENABLE_PROFILE */
+
+#if SSF_SM_TRAN_CACHE_SIZE > 0
+/* --------------------------------------------------------------------------------------------- */
+/* Sets the super states of current and next, from the transition cache when possible.           */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMGetTranSupers(SSFSMExec_t *exec, SSFSMHandler_t current, SSFSMHandler_t next,
+                                SSFSMHandler_t *currentSuper, SSFSMHandler_t *nextSuper)
+{
+    SSFSMTranCacheEntry_t *entry;
+    SSFSMTranCacheEntry_t *victim = NULL;
+    uint64_t hash;
+    uint32_t i;
+
+    /* Probe a few slots from the hashed slot so a handful of transitions never evict each other */
+    hash = ((uint64_t)(uintptr_t)current) * SSF_SM_TRAN_CACHE_HASH_MUL;
+    hash = (hash ^ ((uint64_t)(uintptr_t)next)) * SSF_SM_TRAN_CACHE_HASH_MUL;
+    for (i = 0; (exec->isTranCacheDisabled == false) && (i < SSF_SM_TRAN_CACHE_PROBES); i++)
+    {
+        entry = &(exec->tranCache[((uint32_t)(hash >> 32) + i) & (SSF_SM_TRAN_CACHE_SIZE - 1)]);
+        if ((entry->current == current) && (entry->next == next))
+        {
+            *currentSuper = entry->currentSuper;
+            *nextSuper = entry->nextSuper;
+            exec->tranCacheHits++;
+            return;
+        }
+        if (victim == NULL) victim = entry;
+        if ((entry->current == NULL) && (victim->current != NULL)) victim = entry;
+    }
+
+    *currentSuper = NULL;
+    current(SSF_SM_EVENT_SUPER, NULL, 0, (SSFVoidFn_t *)currentSuper);
+    SSF_ASSERT(*currentSuper != current);
+    *nextSuper = NULL;
+    next(SSF_SM_EVENT_SUPER, NULL, 0, (SSFVoidFn_t *)nextSuper);
+    SSF_ASSERT(*nextSuper != next);
+    if (victim == NULL) return;
+
+    exec->tranCacheMisses++;
+    victim->current = current;
+    victim->next = next;
+    victim->currentSuper = *currentSuper;
+    victim->nextSuper = *nextSuper;
+}
+#endif /* SSF_SM_TRAN_CACHE_SIZE */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Processes event in state machine context, performs state transitions as requested.            */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMProcessEvent(SSFSMExec_t *exec, SSFSMId_t smid, SSFSMEventId_t eid,
+                               const SSFSMData_t *data, SSFSMDataLen_t dataLen)
+{
+    SSFSMHandler_t currentSuper;
+    SSFSMHandler_t nextSuper;
+    SSFSMHandler_t super;
+    SSFSMExec_t *prevExec = _ssfsmExec;
+    SSFSMState_t *state = &(exec->states[smid]);
+
+    /* Process event in context of current state */
+    _ssfsmExec = exec;
+    exec->active = smid;
+    currentSuper = NULL;
+    state->current(eid, data, dataLen, (SSFVoidFn_t *)&currentSuper);
+
+    /* Should super state also process event? */
+    if (currentSuper != NULL)
+    {
+        /* Yes, let super state process the event */
+        super = NULL;
+        currentSuper(eid, data, dataLen, (SSFVoidFn_t *)&super);
+        SSF_ASSERT(super == NULL);
+    }
+
+    /* State transition requested? */
+    if (state->next != NULL)
+    {
+        /* Yes, perform state transition */
+        exec->isEntryExit = true;
+
+#if SSF_SM_TRAN_CACHE_SIZE > 0
+        /* Determine current and next super states */
+        _SSFSMGetTranSupers(exec, state->current, state->next, &currentSuper, &nextSuper);
+#else
+        /* Determine current super state */
+        currentSuper = NULL;
+        state->current(SSF_SM_EVENT_SUPER, NULL, 0, (SSFVoidFn_t *)&currentSuper);
+        SSF_ASSERT(currentSuper != state->current);
+
+        /* Determine next super state */
+        nextSuper = NULL;
+        state->next(SSF_SM_EVENT_SUPER, NULL, 0, (SSFVoidFn_t *)&nextSuper);
+        SSF_ASSERT(nextSuper != state->next);
+#endif
+
+        /* Exit current state */
+        state->current(SSF_SM_EVENT_EXIT, NULL, 0, (SSFVoidFn_t *)&super);
+        _SSFSMStopAllTimers(exec);
+
+        /* Different supers? */
+        if (currentSuper != nextSuper)
+        {
+            /* Yes, does current have a super? */
+            if (currentSuper != NULL)
+            {
+                /* Yes, exit current super state */
+                state->current = currentSuper;
+                state->current(SSF_SM_EVENT_EXIT, NULL, 0, (SSFVoidFn_t *)&super);
+                _SSFSMStopAllTimers(exec);
+            }
+
+            /* Does next have a super? */
+            if (nextSuper != NULL)
+            {
+                /* Yes, enter next super */
+                state->current = nextSuper;
+                state->current(SSF_SM_EVENT_ENTRY, NULL, 0, (SSFVoidFn_t *)&super);
+            }
+        }
+
+        /* Enter next state */
+        state->current = state->next;
+        state->next = NULL;
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+        _SSFSMProfileState(exec, smid, state->current);
+#endif
+        state->current(SSF_SM_EVENT_ENTRY, NULL, 0, (SSFVoidFn_t *)&super);
+
+        /* End of state transition */
+        exec->isEntryExit = false;
+    }
+    exec->active = SSF_SM_MAX;
+    _ssfsmExec = prevExec;
+}
+
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Indexes a replaceable event by its state machine and event ids, coalesce lock must be held.   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMIndexEvent(SSFSMExec_t *exec, SSFSMEvent_t *e)
+{
+    SSF_REQUIRE(exec->coalesce[e->smid][e->eid] == NULL);
+
+    e->isCoalesce = true;
+    exec->coalesce[e->smid][e->eid] = e;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if the data of the indexed event for smid and eid was replaced, else false.      */
+/* Coalesce lock must be held.                                                                   */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFSMReplaceEventData(SSFSMExec_t *exec, SSFSMId_t smid, SSFSMEventId_t eid,
+                                   const SSFSMData_t *data, SSFSMDataLen_t dataLen)
+{
+    SSFSMEvent_t *e = (SSFSMEvent_t *)exec->coalesce[smid][eid];
+
+    if (e == NULL) return false;
+
+    /* Reuse the event's storage when the new data fits in it */
+    if ((dataLen <= SSF_SM_EVENT_INLINE_DATA_SIZE) && ((e->data == NULL) ||
+        (e->data == SSF_SM_EVENT_PAYLOAD(e))))
+    {
+        e->data = (dataLen == 0) ? NULL : SSF_SM_EVENT_PAYLOAD(e);
+        e->dataLen = dataLen;
+        if (dataLen != 0) memcpy(e->data, data, dataLen);
+    }
+    else
+    {
+        _SSFSMFreeData(exec, e);
+        _SSFSMAllocData(exec, e, data, dataLen, 0x11);
+    }
+    exec->coalesced[e->pri]++;
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Removes a dequeued event from the index so later posts queue a new event.                     */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUnindexEvent(SSFSMExec_t *exec, SSFSMEvent_t *e)
+{
+    if (e->isCoalesce == false) return;
+#if SSF_SM_LOCK_FREE == 1
+    SSF_MUTEX_ACQUIRE(exec->coalesceSync);
+#endif
+    exec->coalesce[e->smid][e->eid] = NULL;
+    e->isCoalesce = false;
+#if SSF_SM_LOCK_FREE == 1
+    SSF_MUTEX_RELEASE(exec->coalesceSync);
+#endif
+}
+#endif /* SSF_SM_CONFIG_ENABLE_COALESCE */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Adds an event to the executor's event queue for its priority, must hold lock if required.     */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMPushEvent(SSFSMExec_t *exec, SSFSMEvent_t *e)
+{
+    uint32_t depth;
+
+    SSF_REQUIRE(e->pri < SSF_SM_EVENT_PRIORITY_NUM);
+
+    SSF_LL_FIFO_PUSH(&(exec->events[e->pri]), e);
+    depth = SSFLLLen(&(exec->events[e->pri]));
+    if (depth > exec->maxDepths[e->pri]) exec->maxDepths[e->pri] = depth;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Moves events posted from any context to the event queues, only executor's context may call.   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMDrainInbox(SSFSMExec_t *exec)
+{
+#if SSF_SM_LOCK_FREE == 1
+    SSFSMEvent_t *e;
+
+    while ((e = _SSFSMInboxPop(&(exec->inbox))) != NULL) _SSFSMPushEvent(exec, e);
+#else
+    SSF_UNUSED_PTR(exec);
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if any event queue has events, else false.                                       */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFSMIsEventQueued(const SSFSMExec_t *exec)
+{
+    SSFSMPriority_t pri;
+
+    for (pri = 0; pri < SSF_SM_EVENT_PRIORITY_NUM; pri++)
+    { if (SSFLLIsEmpty(&(exec->events[pri])) == false) return true; }
+    return false;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if highest priority queued event was removed from an event queue, else false.    */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFSMPopEvent(SSFSMExec_t *exec, SSFLLItem_t **item)
+{
+    bool retVal = false;
+    SSFSMPriority_t pri;
+
+    _SSFSMDrainInbox(exec);
+    _SSFSMLock(exec);
+    for (pri = 0; (pri < SSF_SM_EVENT_PRIORITY_NUM) && (retVal == false); pri++)
+    { retVal = SSF_LL_FIFO_POP(&(exec->events[pri]), item); }
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+    /* Data of a dequeued event must no longer be replaced */
+    if (retVal) _SSFSMUnindexEvent(exec, (SSFSMEvent_t *)*item);
+#endif
+    _SSFSMUnlock(exec);
+    return retVal;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes a state machine executor.                                                         */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMExecInit(SSFSMExec_t *exec, uint32_t maxEvents, uint32_t maxTimers)
+{
+    uint32_t count;
+    uint8_t i;
+
+    SSF_REQUIRE(exec != NULL);
+    SSF_ASSERT(exec->magic != SSF_SM_EXEC_INIT_MAGIC);
+
+    memset(exec, 0, sizeof(SSFSMExec_t));
+    exec->active = SSF_SM_MAX;
+#if SSF_SM_EPOLL == 1
+    exec->epollWakeFd = -1;
+#endif
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+    memset(exec->profileState, SSF_SM_PROFILE_NO_STATE, sizeof(exec->profileState));
+    exec->profile.start = SSFPortGetHRTick64();
+#endif
+    for (i = 0; i < SSF_SM_NUM_EVENT_POOLS; i++)
+    {
+        count = maxEvents;
+#if SSF_SM_EVENT_DATA_POOL_NUM > 0
+        if (i > 0) count = _ssfsmDataPoolCounts[i - 1];
+#endif
+#if SSF_SM_LOCK_FREE == 1
+        /* First pool has an extra event used as inbox stub */
+        _SSFSMEventPoolInit(&(exec->eventPools[i]), count,
+                            sizeof(SSFSMEvent_t) + _SSFSMPoolDataSize(i), i == 0 ? 1 : 0);
+#else
+        SSFMPoolInit(&(exec->eventPools[i]), count, sizeof(SSFSMEvent_t) + _SSFSMPoolDataSize(i));
+#endif
+    }
+#if SSF_SM_LOCK_FREE == 1
+    _SSFSMInboxInit(&(exec->inbox), _SSFSMEventPoolNode(&(exec->eventPools[0]), maxEvents));
+#endif
+    SSFMPoolInit(&(exec->timerPool), maxTimers, sizeof(SSFSMTimer_t));
+    for (i = 0; i < SSF_SM_EVENT_PRIORITY_NUM; i++) SSFLLInit(&(exec->events[i]), maxEvents);
+    SSFLLInit(&(exec->timers), maxTimers);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    if (exec == &_ssfsmDefaultExec)
+    {
+        SSF_SM_THREAD_WAKE_INIT();
+        SSF_SM_THREAD_SYNC_INIT();
+    }
+    else
+    {
+        SSF_SM_EXEC_WAKE_INIT(exec->wake);
+#if SSF_SM_LOCK_FREE == 0
+        SSF_MUTEX_INIT(exec->sync);
+#endif
+    }
+#endif
+#if (SSF_SM_CONFIG_ENABLE_COALESCE == 1) && (SSF_SM_LOCK_FREE == 1)
+    SSF_MUTEX_INIT(exec->coalesceSync);
+#endif
+
+    exec->magic = SSF_SM_EXEC_INIT_MAGIC;
+#if SSF_SM_CONFIG_ENABLE_TICK_SOURCE == 1
+    SSF_ATOMIC_ADD_U32(&_ssfsmExecsInited, 1u);
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Deinitializes a state machine executor, its state machines are released without exit events.  */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMExecDeInit(SSFSMExec_t *exec)
+{
+    SSFLLItem_t *item;
+    SSFLLItem_t *next;
+    SSFSMTimer_t t;
+    SSFSMId_t smid;
+    uint8_t i;
+
+    SSF_REQUIRE(exec != NULL);
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
+#if SSF_SM_EPOLL == 1
+    SSF_ASSERT(exec->epollWakeFd < 0);
+#endif
+    exec->magic = 0;
+
+    /* Release ownership of state machines */
+    for (smid = SSF_SM_MIN + 1; smid < SSF_SM_MAX; smid++)
+    {
+        if (SSF_ATOMIC_LOAD_PTR(&(_ssfsmOwners[smid])) == exec)
+        { SSF_ATOMIC_STORE_PTR(&(_ssfsmOwners[smid]), NULL); }
+    }
+
+    /* Process all pending timers and free event data. */
+    item = SSF_LL_HEAD(&(exec->timers));
+    while (item != NULL)
+    {
+        next =  SSF_LL_NEXT_ITEM(item);
+        memcpy(&t, item, sizeof(t));
+        SSFLLGetItem(&(exec->timers), &item, SSF_LL_LOC_ITEM, item);
+        _SSFSMFreeEvent(exec, t.event);
+        SSFMPoolFree(&(exec->timerPool), item);
+        item = next;
+    }
+
+    /* Move events still in the inbox to the event queues. */
+    _SSFSMDrainInbox(exec);
+
+    /* Process all pending events and free event data. */
+    for (i = 0; i < SSF_SM_EVENT_PRIORITY_NUM; i++)
+    {
+        item = SSF_LL_HEAD(&(exec->events[i]));
+        while (item != NULL)
+        {
+            next =  SSF_LL_NEXT_ITEM(item);
+            SSFLLGetItem(&(exec->events[i]), &item, SSF_LL_LOC_ITEM, item);
+            _SSFSMFreeEvent(exec, (SSFSMEvent_t *)item);
+            item = next;
+        }
+    }
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    if (exec == &_ssfsmDefaultExec)
+    {
+        SSF_SM_THREAD_WAKE_DEINIT();
+        SSF_SM_THREAD_SYNC_DEINIT();
+    }
+    else
+    {
+        SSF_SM_EXEC_WAKE_DEINIT(exec->wake);
+#if SSF_SM_LOCK_FREE == 0
+        SSF_MUTEX_DEINIT(exec->sync);
+#endif
+    }
+#endif
+#if (SSF_SM_CONFIG_ENABLE_COALESCE == 1) && (SSF_SM_LOCK_FREE == 1)
+    SSF_MUTEX_DEINIT(exec->coalesceSync);
+#endif
+
+    SSFLLDeInit(&(exec->timers));
+    for (i = 0; i < SSF_SM_EVENT_PRIORITY_NUM; i++) SSFLLDeInit(&(exec->events[i]));
+    SSFMPoolDeInit(&(exec->timerPool));
+    for (i = 0; i < SSF_SM_NUM_EVENT_POOLS; i++)
+    {
+#if SSF_SM_LOCK_FREE == 1
+        _SSFSMEventPoolDeInit(&(exec->eventPools[i]));
+#else
+        SSFMPoolDeInit(&(exec->eventPools[i]));
+#endif
+    }
+
+    SSF_ASSERT(exec->mallocs == exec->frees);
+    memset(exec, 0, sizeof(SSFSMExec_t));
+    exec->active = SSF_SM_MAX;
+#if SSF_SM_CONFIG_ENABLE_TICK_SOURCE == 1
+    SSF_ATOMIC_ADD_U32(&_ssfsmExecsInited, 0u - 1u);
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes a state machine handler owned by an executor.                                     */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMExecInitHandler(SSFSMExec_t *exec, SSFSMId_t smid, SSFSMHandler_t initial)
+{
+    SSFSMHandler_t initialSuper;
+    SSFSMHandler_t super;
+    SSFSMExec_t *prevExec;
+
+    SSF_REQUIRE(exec != NULL);
+    SSF_REQUIRE((smid > SSF_SM_MIN) && (smid < SSF_SM_MAX));
+    SSF_REQUIRE(initial != NULL);
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
+    SSF_ASSERT(SSF_ATOMIC_LOAD_PTR(&(_ssfsmOwners[smid])) == NULL);
+    SSF_ASSERT(exec->states[smid].current == NULL);
+
+    /* Allow state transistions */
+    exec->active = smid;
+    exec->isEntryExit = true;
+
+    /* Determine initial's super */
+    initialSuper = NULL;
+    initial(SSF_SM_EVENT_SUPER, NULL, 0, (SSFVoidFn_t *)&initialSuper);
+    SSF_ASSERT(initial != initialSuper);
+
+    /* Ensure initial's super does not have super */
+    if (initialSuper != NULL)
+    {
+        super = NULL;
+        initialSuper(SSF_SM_EVENT_SUPER, NULL, 0, (SSFVoidFn_t *)&super);
+        SSF_ASSERT(super == NULL);
+    }
+
+    /* Executor now owns state machine */
+    SSF_ATOMIC_STORE_PTR(&(_ssfsmOwners[smid]), exec);
+    prevExec = _ssfsmExec;
+    _ssfsmExec = exec;
+
+    /* Does initial have a super? */
+    if (initialSuper != NULL)
+    {
+        /* Yes, enter initial super */
+        exec->states[smid].current = initialSuper;
+        exec->states[smid].current(SSF_SM_EVENT_ENTRY, NULL, 0, (SSFVoidFn_t *)&super);
+    }
+
+    /* Enter initial state */
+    exec->states[smid].current = initial;
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+    _SSFSMProfileState(exec, smid, initial);
+#endif
+    exec->states[smid].current(SSF_SM_EVENT_ENTRY, NULL, 0, (SSFVoidFn_t *)&super);
+
+    /* Disallow state transistions */
+    exec->active = SSF_SM_MAX;
+    exec->isEntryExit = false;
+    _ssfsmExec = prevExec;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Runs an executor's pending events, highest priority first, and expired timers until budget    */
+/* ticks elapse. Returns true if timers or events are pending, else false. Optionally reports    */
+/* delta to next timer expiration in SSF_TICKS_PER_SEC units, 0 if events are still pending.     */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFSMExecTaskBudget(SSFSMExec_t *exec, SSFSMTimeout_t *nextTimeout, SSFSMTimeout_t budget)
+{
+    SSFSMEvent_t e;
+    SSFLLItem_t *item;
+    SSFLLItem_t *next;
+    SSFSMTimer_t t;
+    SSFSMTimeout_t current = SSF_SM_GET_TICK();
+    bool isBudgetSpent = false;
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+    uint64_t start;
+#endif
+
+    SSF_REQUIRE(exec != NULL);
+    SSF_ASSERT(exec->active >= SSF_SM_MAX);
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
+
+#if SSF_SM_LOCK_FREE == 1
+    /* Events posted after this either are seen below or post a new wake */
+    SSF_ATOMIC_XCHG_U32(&(exec->isWakePending), 0);
+#endif
+
+    /* Process pending events until budget is spent, at least one event is always processed. */
+processEvents:
+    while ((isBudgetSpent == false) && (_SSFSMPopEvent(exec, &item) == true))
+    {
+        memcpy(&e, item, sizeof(e)); /* Ensure alignment */
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+        start = SSFPortGetHRTick64();
+        _SSFSMProcessEvent(exec, e.smid, e.eid, e.data, e.dataLen);
+        _SSFSMProfileEvent(exec, e.eid, e.profileQueued, start, SSFPortGetHRTick64());
+#else
+        _SSFSMProcessEvent(exec, e.smid, e.eid, e.data, e.dataLen);
+#endif
+        _SSFSMLock(exec);
+        _SSFSMFreeEvent(exec, (SSFSMEvent_t *)item);
+        _SSFSMUnlock(exec);
+        if ((budget != SSF_SM_MAX_TIMEOUT) && ((SSF_SM_GET_TICK() - current) >= budget))
+        { isBudgetSpent = true; }
+    }
+
+    /* Process timers. */
+    item = SSF_LL_HEAD(&(exec->timers));
+    while (item != NULL)
+    {
+        next = SSF_LL_NEXT_ITEM(item);
+        memcpy(&t, item, sizeof(t));  /* Ensure alignment */
+        if (t.to > current) { item = next; continue; }
+        SSFLLGetItem(&(exec->timers), &item, SSF_LL_LOC_ITEM, item);
+        t.event->queued = current;
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+        t.event->profileQueued = SSFPortGetHRTick64();
+        exec->profile.timersFired++;
+        exec->profile.timerLateness[_SSFSMProfileBin(((current - t.to) * SSF_HR_TICKS_PER_SEC) /
+                                                     SSF_TICKS_PER_SEC)]++;
+#endif
+        _SSFSMLock(exec);
+        _SSFSMPushEvent(exec, t.event);
+        _SSFSMUnlock(exec);
+        SSFMPoolFree(&(exec->timerPool), item);
+        item = next;
+        goto processEvents;
+    }
+
+    /* If necessary determine next timer expiration */
+    if (nextTimeout != NULL)
+    {
+        *nextTimeout = SSF_SM_MAX_TIMEOUT;
+        item = SSF_LL_HEAD(&(exec->timers));
+        while (item != NULL)
+        {
+            next = SSF_LL_NEXT_ITEM(item);
+            memcpy(&t, item, sizeof(t));
+            if (t.to < (*nextTimeout)) *nextTimeout = t.to;
+            item = next;
+        }
+        if (*nextTimeout != SSF_SM_MAX_TIMEOUT) *nextTimeout -= current;
+    }
+
+    /* Events left because budget was spent? */
+    if (isBudgetSpent)
+    {
+        /* Yes, they are due now */
+        _SSFSMDrainInbox(exec);
+        _SSFSMLock(exec);
+        isBudgetSpent = _SSFSMIsEventQueued(exec);
+        _SSFSMUnlock(exec);
+        if (isBudgetSpent && (nextTimeout != NULL)) *nextTimeout = 0;
+    }
+    return isBudgetSpent || !SSFLLIsEmpty(&(exec->timers));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Runs an executor's pending events and expired timers. Returns true if timers are pending,     */
+/* else false. Optionally reports delta to next timer expiration in SSF_TICKS_PER_SEC units.     */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFSMExecTask(SSFSMExec_t *exec, SSFSMTimeout_t *nextTimeout)
+{
+    return SSFSMExecTaskBudget(exec, nextTimeout, SSF_SM_MAX_TIMEOUT);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Reports an executor's event queue depth and oldest queued event age for a priority.           */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMExecGetQueueStats(SSFSMExec_t *exec, SSFSMPriority_t pri, SSFSMQueueStats_t *stats)
+{
+    SSFLLItem_t *item;
+    SSFSMEvent_t e;
+
+    SSF_REQUIRE(exec != NULL);
+    SSF_REQUIRE(pri < SSF_SM_EVENT_PRIORITY_NUM);
+    SSF_REQUIRE(stats != NULL);
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
+
+    _SSFSMDrainInbox(exec);
+    _SSFSMLock(exec);
+    stats->depth = SSFLLLen(&(exec->events[pri]));
+    stats->maxDepth = exec->maxDepths[pri];
+    stats->oldestAge = 0;
+    stats->coalesced = 0;
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+#if SSF_SM_LOCK_FREE == 1
+    SSF_MUTEX_ACQUIRE(exec->coalesceSync);
+    stats->coalesced = exec->coalesced[pri];
+    SSF_MUTEX_RELEASE(exec->coalesceSync);
+#else
+    stats->coalesced = exec->coalesced[pri];
+#endif
+#endif
+
+    /* Events are pushed to the head, so the oldest is at the tail */
+    item = SSF_LL_TAIL(&(exec->events[pri]));
+    if (item != NULL)
+    {
+        memcpy(&e, item, sizeof(e));  /* Ensure alignment */
+        stats->oldestAge = SSF_SM_GET_TICK() - e.queued;
+    }
+    _SSFSMUnlock(exec);
+}
+
+#if SSF_SM_EPOLL == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes an epoll loop running an executor, events posted from other threads wake it.      */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMExecEpollInit(SSFSMExec_t *exec, SSFSMEpoll_t *ep)
+{
+    struct epoll_event ev;
+
+    SSF_REQUIRE(exec != NULL);
+    SSF_REQUIRE(ep != NULL);
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
+    SSF_ASSERT(exec->epollWakeFd < 0);
+    SSF_ASSERT(ep->magic != SSF_SM_EPOLL_INIT_MAGIC);
+
+    memset(ep, 0, sizeof(SSFSMEpoll_t));
+    ep->exec = exec;
+    SSF_ASSERT((ep->epfd = epoll_create1(EPOLL_CLOEXEC)) >= 0);
+    SSF_ASSERT((ep->wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) >= 0);
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = SSF_SM_EPOLL_WAKE_TAG;
+    SSF_ASSERT(epoll_ctl(ep->epfd, EPOLL_CTL_ADD, ep->wakeFd, &ev) == 0);
+    exec->epollWakeFd = ep->wakeFd;
+    ep->magic = SSF_SM_EPOLL_INIT_MAGIC;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Deinitializes an epoll loop, registered file descriptors are not closed.                      */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMEpollDeInit(SSFSMEpoll_t *ep)
+{
+    SSF_REQUIRE(ep != NULL);
+    SSF_ASSERT(ep->magic == SSF_SM_EPOLL_INIT_MAGIC);
+    SSF_ASSERT(ep->exec->magic == SSF_SM_EXEC_INIT_MAGIC);
+
+    ep->exec->epollWakeFd = -1;
+    SSF_ASSERT(close(ep->wakeFd) == 0);
+    SSF_ASSERT(close(ep->epfd) == 0);
+    memset(ep, 0, sizeof(SSFSMEpoll_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Registers fd to post eid to smid with SSFSMEpollEvent_t data when any of events is ready.     */
+/* Returns true if fd registered, else false.                                                    */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFSMEpollAdd(SSFSMEpoll_t *ep, int fd, uint32_t events, SSFSMId_t smid,
+                   SSFSMEventId_t eid)
+{
+    struct epoll_event ev;
+
+    SSF_REQUIRE(ep != NULL);
+    SSF_REQUIRE((smid > SSF_SM_MIN) && (smid < SSF_SM_MAX));
+    SSF_REQUIRE((eid > SSF_SM_EVENT_EXIT) && (eid > SSF_SM_EVENT_MIN) && (eid < SSF_SM_EVENT_MAX));
+    SSF_ASSERT(ep->magic == SSF_SM_EPOLL_INIT_MAGIC);
+
+    /* Target is kept with the fd so dispatch needs no lookup */
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.u64 = (((uint64_t)(uint32_t)fd) << 32) | (((uint64_t)(uint16_t)eid) << 16) |
+                  (uint64_t)(uint8_t)smid;
+    return epoll_ctl(ep->epfd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if fd unregistered, else false.                                                  */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFSMEpollRemove(SSFSMEpoll_t *ep, int fd)
+{
+    struct epoll_event ev;
+
+    SSF_REQUIRE(ep != NULL);
+    SSF_ASSERT(ep->magic == SSF_SM_EPOLL_INIT_MAGIC);
+
+    memset(&ev, 0, sizeof(ev));
+    return epoll_ctl(ep->epfd, EPOLL_CTL_DEL, fd, &ev) == 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Runs the executor, blocks in epoll_wait() until a file descriptor is ready, an event is       */
+/* posted, the next timer expires, or maxWait ticks elapse, then posts an event for each ready   */
+/* file descriptor and runs the executor again. Returns true if timers or events are pending.    */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFSMEpollTask(SSFSMEpoll_t *ep, SSFSMTimeout_t maxWait)
+{
+    struct epoll_event evs[SSF_SM_EPOLL_MAX_EVENTS];
+    SSFSMEpollEvent_t d;
+    SSFSMTimeout_t timeout;
+    uint64_t count;
+    int timeoutMs;
+    int n;
+    int i;
+
+    SSF_REQUIRE(ep != NULL);
+    SSF_ASSERT(ep->magic == SSF_SM_EPOLL_INIT_MAGIC);
+
+    /* Wait no longer than until the next timer expires */
+    SSFSMExecTask(ep->exec, &timeout);
+    if (timeout > maxWait) timeout = maxWait;
+    if (timeout == SSF_SM_MAX_TIMEOUT) timeoutMs = -1;
+    else if (timeout >= ((((SSFSMTimeout_t)INT_MAX) / 1000u) * SSF_TICKS_PER_SEC))
+    { timeoutMs = INT_MAX; }
+    else { timeoutMs = (int)(((timeout * 1000u) + SSF_TICKS_PER_SEC - 1) / SSF_TICKS_PER_SEC); }
+
+    n = epoll_wait(ep->epfd, evs, SSF_SM_EPOLL_MAX_EVENTS, timeoutMs);
+    if ((n < 0) && (errno == EINTR)) n = 0;
+    SSF_ASSERT(n >= 0);
+
+#if SSF_SM_LOCK_FREE == 1
+    /* SSFSMExecTask() below clears this after the posts, so they need not write the wake fd */
+    SSF_ATOMIC_XCHG_U32(&(ep->exec->isWakePending), 1);
+#endif
+
+    /* Post an event per ready file descriptor, then process them all at once */
+    for (i = 0; i < n; i++)
+    {
+        if (evs[i].data.u64 == SSF_SM_EPOLL_WAKE_TAG)
+        {
+            SSF_ASSERT((read(ep->wakeFd, &count, sizeof(count)) == sizeof(count)) ||
+                       (errno == EAGAIN));
+            continue;
+        }
+        d.fd = (int)(uint32_t)(evs[i].data.u64 >> 32);
+        d.events = evs[i].events;
+        SSFSMPutEventData((SSFSMId_t)(int8_t)(uint8_t)evs[i].data.u64,
+                          (SSFSMEventId_t)(int16_t)(uint16_t)(evs[i].data.u64 >> 16),
+                          (const SSFSMData_t *)&d, sizeof(d));
+    }
+    return SSFSMExecTask(ep->exec, NULL);
+}
+#endif /* SSF_SM_EPOLL */
+
+#if SSF_SM_TRAN_CACHE_SIZE > 0
+/* --------------------------------------------------------------------------------------------- */
+/* Enables or disables, and empties, an executor's transition cache.                             */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMExecEnableTranCache(SSFSMExec_t *exec, bool enable)
+{
+    SSF_REQUIRE(exec != NULL);
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
+
+    memset(exec->tranCache, 0, sizeof(exec->tranCache));
+    exec->isTranCacheDisabled = !enable;
+}
+#endif /* SSF_SM_TRAN_CACHE_SIZE */
+
+#if SSF_SM_CONFIG_ENABLE_TICK_SOURCE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the port's system tick, the default tick source.                                      */
+/* --------------------------------------------------------------------------------------------- */
+static SSFSMTimeout_t _SSFSMPortGetTick(void)
+{
+    return SSFPortGetTick64();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Sets the tick source read by all executors, NULL restores SSFPortGetTick64().                 */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMSetTickFn(SSFSMTickFn_t tickFn)
+{
+    /* Timers and queued events of running executors hold ticks of the current source */
+    SSF_REQUIRE(SSF_ATOMIC_LOAD_U32(&_ssfsmExecsInited) == 0);
+
+    if (tickFn == NULL) tickFn = _SSFSMPortGetTick;
+    _ssfsmTickFn = tickFn;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Makes the virtual clock, starting at start ticks, the tick source.                            */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMSimInit(SSFSMTimeout_t start)
+{
+    SSF_ATOMIC_STORE_U64(&_ssfsmSimTick, start);
+    SSFSMSetTickFn(SSFSMSimGetTick);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Restores SSFPortGetTick64() as the tick source.                                               */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMSimDeInit(void)
+{
+    SSF_REQUIRE(_ssfsmTickFn == SSFSMSimGetTick);
+    SSFSMSetTickFn(NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the virtual clock's current tick.                                                     */
+/* --------------------------------------------------------------------------------------------- */
+SSFSMTimeout_t SSFSMSimGetTick(void)
+{
+    return (SSFSMTimeout_t)SSF_ATOMIC_LOAD_U64(&_ssfsmSimTick);
+}
+
 /* --------------------------------------------------------------------------------------------- */
-/* Frees event data.                                                                             */
+/* Moves the virtual clock forward by ticks.                                                     */
 /* --------------------------------------------------------------------------------------------- */
-static void _SSFSMFreeEventData(SSFSMData_t *data)
+void SSFSMSimAdvance(SSFSMTimeout_t ticks)
 {
-    SSF_REQUIRE(data != NULL);
-    SSF_FREE(data);
-    _ssfsmFrees++;
-    SSF_ENSURE(_ssfsmFrees <= _ssfsmMallocs);
-    SSF_ENSURE((_ssfsmMallocs - _ssfsmFrees) <= SSFMPoolSize(&_ssfsmEventPool));
+    SSF_REQUIRE(_ssfsmTickFn == SSFSMSimGetTick);
+    SSF_REQUIRE(ticks <= (SSF_SM_MAX_TIMEOUT - SSFSMSimGetTick()));
+
+    SSF_ATOMIC_STORE_U64(&_ssfsmSimTick, SSFSMSimGetTick() + ticks);
 }
 
 /* --------------------------------------------------------------------------------------------- */
-/* Stops all timers for active state machine.                                                    */
+/* Runs an executor for duration virtual ticks, jumping the clock straight to each timer expiry. */
+/* Returns true if timers or events are pending, else false.                                     */
 /* --------------------------------------------------------------------------------------------- */
-static void _SSFSMStopAllTimers(void)
+bool SSFSMExecSimRun(SSFSMExec_t *exec, SSFSMTimeout_t duration)
 {
-    SSFLLItem_t *item;
-    SSFLLItem_t *next;
-    SSFSMTimer_t t;
+    SSFSMTimeout_t nextTimeout;
+    SSFSMTimeout_t remaining;
+    bool isPending;
 
-    SSF_ASSERT((_ssfsmActive > SSF_SM_MIN) && (_ssfsmActive < SSF_SM_MAX));
+    SSF_REQUIRE(exec != NULL);
+    SSF_REQUIRE(_ssfsmTickFn == SSFSMSimGetTick);
+    SSF_REQUIRE(duration <= (SSF_SM_MAX_TIMEOUT - SSFSMSimGetTick()));
 
-    item = SSF_LL_HEAD(&_ssfsmTimers);
-    while (item != NULL)
+    remaining = duration;
+    while (true)
     {
-        next = SSF_LL_NEXT_ITEM(item);
-        memcpy(&t, item, sizeof(t));
-
-        /* Same state machine and owner? */
-        if ((t.event->smid == _ssfsmActive) && (t.owner == _SSFSMStates[_ssfsmActive].current))
-        {
-            /* Yes, any event data? */
-            if ((t.event->data) && (t.event->dataLen > sizeof(SSFSMData_t *)))
-            {
-                /* Yes, free it. */
-                _SSFSMFreeEventData(t.event->data);
-            }
-            SSFLLGetItem(&_ssfsmTimers, &item, SSF_LL_LOC_ITEM, item);
-            SSFMPoolFree(&_ssfsmEventPool, t.event);
-            SSFMPoolFree(&_ssfsmTimerPool, item);
-        }
-        item = next;
+        isPending = SSFSMExecTask(exec, &nextTimeout);
+        if (nextTimeout == 0) continue;
+        if ((isPending == false) || (nextTimeout > remaining)) break;
+        SSFSMSimAdvance(nextTimeout);
+        remaining -= nextTimeout;
     }
+    SSFSMSimAdvance(remaining);
+    return isPending;
 }
+#endif /* SSF_SM_CONFIG_ENABLE_TICK_SOURCE */
 
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
 /* --------------------------------------------------------------------------------------------- */
-/* Returns timer if timer with event ID found in active state machine, else NULL.                */
+/* Copies an executor's profile, including dwell in the current states, to profile.             */
 /* --------------------------------------------------------------------------------------------- */
-static SSFLLItem_t *_SSFSMFindTimer(SSFSMEventId_t eid)
+void SSFSMExecGetProfile(SSFSMExec_t *exec, SSFSMProfile_t *profile)
 {
-    SSFLLItem_t *item;
-    SSFLLItem_t *next;
-    SSFSMTimer_t t;
+    uint64_t now = SSFPortGetHRTick64();
+    SSFSMId_t smid;
+    uint8_t i;
 
-    SSF_ASSERT((_ssfsmActive > SSF_SM_MIN) && (_ssfsmActive < SSF_SM_MAX));
+    SSF_REQUIRE(exec != NULL);
+    SSF_REQUIRE(profile != NULL);
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
 
-    item = SSF_LL_HEAD(&_ssfsmTimers);
-    while (item != NULL)
+    memcpy(profile, &(exec->profile), sizeof(SSFSMProfile_t));
+    for (smid = SSF_SM_MIN + 1; smid < SSF_SM_MAX; smid++)
     {
-        next = SSF_LL_NEXT_ITEM(item);
-        memcpy(&t, item, sizeof(t));
-        /* Same state machine, event ID, and owner */
-        if ((t.event->smid == _ssfsmActive) && (t.event->eid == eid) &&
-            (t.owner == _SSFSMStates[_ssfsmActive].current)) break;
-        item = next;
+        i = exec->profileState[smid];
+        if (i != SSF_SM_PROFILE_NO_STATE)
+        { profile->states[smid][i].dwell += now - exec->profileEntered[smid]; }
     }
-    return item;
+    profile->elapsed = now - profile->start;
 }
 
 /* --------------------------------------------------------------------------------------------- */
-/* Processes event in state machine context, performs state transitions as requested.            */
+/* Clears an executor's profile, dwell in the current states restarts now.                       */
 /* --------------------------------------------------------------------------------------------- */
-static void _SSFSMProcessEvent(SSFSMId_t smid, SSFSMEventId_t eid, const SSFSMData_t *data,
-                               SSFSMDataLen_t dataLen)
+void SSFSMExecResetProfile(SSFSMExec_t *exec)
 {
-    SSFSMHandler_t currentSuper;
-    SSFSMHandler_t nextSuper;
-    SSFSMHandler_t super;
+    SSFSMHandler_t current[SSF_SM_MAX];
+    uint64_t now;
+    SSFSMId_t smid;
+    uint8_t i;
 
-    /* Process event in context of current state */
-    _ssfsmActive = smid;
-    currentSuper = NULL;
-    _SSFSMStates[_ssfsmActive].current(eid, data, dataLen, (SSFVoidFn_t *)&currentSuper);
+    SSF_REQUIRE(exec != NULL);
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
 
-    /* Should super state also process event? */
-    if (currentSuper != NULL)
+    for (smid = SSF_SM_MIN + 1; smid < SSF_SM_MAX; smid++)
     {
-        /* Yes, let super state process the event */
-        super = NULL;
-        currentSuper(eid, data, dataLen, (SSFVoidFn_t *)&super);
-        SSF_ASSERT(super == NULL);
+        i = exec->profileState[smid];
+        current[smid] = NULL;
+        if (i != SSF_SM_PROFILE_NO_STATE) current[smid] = exec->profile.states[smid][i].state;
     }
 
-    /* State transition requested? */
-    if (_SSFSMStates[_ssfsmActive].next != NULL)
+    memset(&(exec->profile), 0, sizeof(SSFSMProfile_t));
+    now = SSFPortGetHRTick64();
+    exec->profile.start = now;
+    for (smid = SSF_SM_MIN + 1; smid < SSF_SM_MAX; smid++)
     {
-        /* Yes, perform state transition */
-        _ssfsmIsEntryExit = true;
-
-        /* Determine current super state */
-        currentSuper = NULL;
-        _SSFSMStates[_ssfsmActive].current(SSF_SM_EVENT_SUPER, NULL, 0, (SSFVoidFn_t *)&currentSuper);
-        SSF_ASSERT(currentSuper != _SSFSMStates[_ssfsmActive].current);
+        if (current[smid] == NULL) continue;
+        exec->profile.states[smid][0].state = current[smid];
+        exec->profileState[smid] = 0;
+        exec->profileEntered[smid] = now;
+    }
+}
 
-        /* Determine next super state */
-        nextSuper = NULL;
-        _SSFSMStates[_ssfsmActive].next(SSF_SM_EVENT_SUPER, NULL, 0, (SSFVoidFn_t *)&nextSuper);
-        SSF_ASSERT(nextSuper != _SSFSMStates[_ssfsmActive].next);
+/* --------------------------------------------------------------------------------------------- */
+/* Writes a profile as text with writeFn.                                                        */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMProfilePrint(const SSFSMProfile_t *profile, SSFSMProfileWriteFn_t writeFn)
+{
+    const SSFSMProfileState_t *ps;
+    const SSFSMProfileEvent_t *pe;
+    SSFSMId_t smid;
+    SSFSMEventId_t eid;
+    uint8_t i;
 
-        /* Exit current state */
-        _SSFSMStates[_ssfsmActive].current(SSF_SM_EVENT_EXIT, NULL, 0, (SSFVoidFn_t *)&super);
-        _SSFSMStopAllTimers();
+    SSF_REQUIRE(profile != NULL);
+    SSF_REQUIRE(writeFn != NULL);
 
-        /* Different supers? */
-        if (currentSuper != nextSuper)
+    _SSFSMProfileWrite(writeFn, "State machine profile over %llu us\r\n",
+                       (unsigned long long)SSF_SM_PROFILE_US(profile->elapsed));
+    for (smid = SSF_SM_MIN + 1; smid < SSF_SM_MAX; smid++)
+    {
+        for (i = 0; i < SSF_SM_PROFILE_MAX_STATES; i++)
         {
-            /* Yes, does current have a super? */
-            if (currentSuper != NULL)
-            {
-                /* Yes, exit current super state */
-                _SSFSMStates[_ssfsmActive].current = currentSuper;
-                _SSFSMStates[_ssfsmActive].current(SSF_SM_EVENT_EXIT, NULL, 0, (SSFVoidFn_t *)&super);
-                _SSFSMStopAllTimers();
-            }
-
-            /* Does next have a super? */
-            if (nextSuper != NULL)
-            {
-                /* Yes, enter next super */
-                _SSFSMStates[_ssfsmActive].current = nextSuper;
-                _SSFSMStates[_ssfsmActive].current(SSF_SM_EVENT_ENTRY, NULL, 0, (SSFVoidFn_t *)&super);
-            }
+            ps = &(profile->states[smid][i]);
+            if (ps->state == NULL) break;
+            _SSFSMProfileWrite(writeFn, "  sm %d state 0x%llx: entries %lu, dwell %llu us\r\n",
+                               (int)smid, (unsigned long long)(uintptr_t)ps->state,
+                               (unsigned long)ps->entries,
+                               (unsigned long long)SSF_SM_PROFILE_US(ps->dwell));
         }
-
-        /* Enter next state */
-        _SSFSMStates[_ssfsmActive].current = _SSFSMStates[_ssfsmActive].next;
-        _SSFSMStates[_ssfsmActive].next = NULL;
-        _SSFSMStates[_ssfsmActive].current(SSF_SM_EVENT_ENTRY, NULL, 0, (SSFVoidFn_t *)&super);
-
-        /* End of state transition */
-        _ssfsmIsEntryExit = false;
     }
-    _ssfsmActive = SSF_SM_MAX;
+    if (profile->statesDropped != 0)
+    {
+        _SSFSMProfileWrite(writeFn, "  state entries dropped %lu\r\n",
+                           (unsigned long)profile->statesDropped);
+    }
+    for (eid = SSF_SM_EVENT_MIN + 1; eid < SSF_SM_EVENT_MAX; eid++)
+    {
+        pe = &(profile->events[eid]);
+        if (pe->count == 0) continue;
+        _SSFSMProfileWrite(writeFn, "  event %d: count %lu, avg %llu ns, max %llu ns\r\n",
+                           (int)eid, (unsigned long)pe->count,
+                           (unsigned long long)SSF_SM_PROFILE_NS(pe->handlerTotal / pe->count),
+                           (unsigned long long)SSF_SM_PROFILE_NS(pe->handlerMax));
+        _SSFSMProfileWriteHist(writeFn, "queued", pe->queueDelay);
+        _SSFSMProfileWriteHist(writeFn, "handler", pe->handlerTime);
+    }
+    _SSFSMProfileWrite(writeFn, "  timers fired %lu\r\n", (unsigned long)profile->timersFired);
+    if (profile->timersFired != 0) _SSFSMProfileWriteHist(writeFn, "late", profile->timerLateness);
 }
+#endif /* SSF_SM_CONFIG_ENABLE_PROFILE */
 
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
 /* --------------------------------------------------------------------------------------------- */
-/* Allocates event data.                                                                         */
+/* Blocks until an event is posted to the executor or timeout system ticks elapse.               */
 /* --------------------------------------------------------------------------------------------- */
-static void _SSFSMAllocEventData(SSFSMEvent_t *event, const SSFSMData_t *data,
-                                 SSFSMDataLen_t dataLen)
+void SSFSMExecWait(SSFSMExec_t *exec, SSFSMTimeout_t timeout)
 {
-    SSF_REQUIRE(event != NULL);
+    SSF_REQUIRE(exec != NULL);
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
 
-    event->dataLen = dataLen;
-    if (event->dataLen == 0) event->data = NULL;
-    else if (event->dataLen <= sizeof(SSFSMData_t *))
-    { memcpy(&(event->data), data, event->dataLen); }
-    else
-    {
-        SSF_ASSERT((event->data = (SSFSMData_t *)SSF_MALLOC(event->dataLen)) != NULL);
-        _ssfsmMallocs++;
-        memcpy(event->data, data, event->dataLen);
-        SSF_ENSURE(_ssfsmFrees <= _ssfsmMallocs);
-        SSF_ENSURE((_ssfsmMallocs - _ssfsmFrees) <= SSFMPoolSize(&_ssfsmEventPool));
-    }
+    if (exec == &_ssfsmDefaultExec) { SSF_SM_THREAD_WAKE_WAIT(timeout); }
+    else { SSF_SM_EXEC_WAKE_WAIT(exec->wake, timeout); }
 }
+#endif
 
 /* --------------------------------------------------------------------------------------------- */
-/* Initializes state machine framework.                                                          */
+/* Initializes state machine framework's default executor.                                       */
 /* --------------------------------------------------------------------------------------------- */
 void SSFSMInit(uint32_t maxEvents, uint32_t maxTimers)
 {
-    SSF_ASSERT(_ssfsmIsInited == false);
-
-    SSFMPoolInit(&_ssfsmEventPool, maxEvents, sizeof(SSFSMEvent_t));
-    SSFMPoolInit(&_ssfsmTimerPool, maxTimers, sizeof(SSFSMTimer_t));
-    SSFLLInit(&_ssfsmEvents, maxEvents);
-    SSFLLInit(&_ssfsmTimers, maxTimers);
-
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    SSF_SM_THREAD_WAKE_INIT();
-    SSF_SM_THREAD_SYNC_INIT();
-#endif
-
-    _ssfsmIsInited = true;
+    SSFSMExecInit(&_ssfsmDefaultExec, maxEvents, maxTimers);
 }
+
 /* --------------------------------------------------------------------------------------------- */
-/* Deinitializes state machine framework.                                                        */
+/* Deinitializes state machine framework's default executor.                                     */
 /* --------------------------------------------------------------------------------------------- */
 void SSFSMDeInit(void)
 {
-    SSFLLItem_t *item;
-    SSFLLItem_t *next;
-    SSFSMTimer_t t;
-    SSFSMEvent_t e;
-
-    SSF_ASSERT(_ssfsmIsInited);
-    _ssfsmIsInited = false;
-
-    /* Process all pending timers and free event data. */
-    item = SSF_LL_HEAD(&_ssfsmTimers);
-    while (item != NULL)
-    {
-        next =  SSF_LL_NEXT_ITEM(item);
-        memcpy(&t, item, sizeof(t));
-        SSFLLGetItem(&_ssfsmTimers, &item, SSF_LL_LOC_ITEM, item);
-        if ((t.event->data != NULL) && (t.event->dataLen > sizeof(SSFSMData_t *)))
-        { _SSFSMFreeEventData(t.event->data); }
-        SSFMPoolFree(&_ssfsmTimerPool, item);
-        item = next;
-    }
-
-    /* Process all pending events and free event data. */
-    item = SSF_LL_HEAD(&_ssfsmEvents);
-    while (item != NULL)
-    {
-        next =  SSF_LL_NEXT_ITEM(item);
-        memcpy(&e, item, sizeof(e));
-        SSFLLGetItem(&_ssfsmEvents, &item, SSF_LL_LOC_ITEM, item);
-        if ((e.data != NULL) && (e.dataLen > sizeof(SSFSMData_t *)))
-        { _SSFSMFreeEventData(e.data); }
-        SSFMPoolFree(&_ssfsmEventPool, item);
-        item = next;
-    }
-
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    SSF_SM_THREAD_WAKE_DEINIT();
-    SSF_SM_THREAD_SYNC_DEINIT();
-#endif
-
-    SSFLLDeInit(&_ssfsmTimers);
-    SSFLLDeInit(&_ssfsmEvents);
-    SSFMPoolDeInit(&_ssfsmTimerPool);
-    SSFMPoolDeInit(&_ssfsmEventPool);
-
-    memset(_SSFSMStates, 0, sizeof(_SSFSMStates));
-    _ssfsmActive = SSF_SM_MAX;
-    _ssfsmIsEntryExit = false;
-    SSF_ASSERT(_ssfsmMallocs == _ssfsmFrees);
-    _ssfsmMallocs = 0;
-    _ssfsmFrees = 0;
+    SSFSMExecDeInit(&_ssfsmDefaultExec);
 }
 
 /* --------------------------------------------------------------------------------------------- */
-/* Initializes a state machine handler.                                                          */
+/* Initializes a state machine handler owned by the default executor.                            */
 /* --------------------------------------------------------------------------------------------- */
 void SSFSMInitHandler(SSFSMId_t smid, SSFSMHandler_t initial)
 {
-    SSFSMHandler_t initialSuper;
-    SSFSMHandler_t super;
-
-    SSF_REQUIRE((smid > SSF_SM_MIN) && (smid < SSF_SM_MAX));
-    SSF_REQUIRE(initial != NULL);
-    SSF_ASSERT(_ssfsmIsInited);
-    SSF_ASSERT(_SSFSMStates[smid].current == NULL);
-
-    /* Allow state transistions */
-    _ssfsmActive = smid;
-    _ssfsmIsEntryExit = true;
-
-    /* Determine initial's super */
-    initialSuper = NULL;
-    initial(SSF_SM_EVENT_SUPER, NULL, 0, (SSFVoidFn_t *)&initialSuper);
-    SSF_ASSERT(initial != initialSuper);
-
-    /* Does initial have a super? */
-    if (initialSuper != NULL)
-    {
-        /* Yes, ensure super does not have super */
-        super = NULL;
-        initialSuper(SSF_SM_EVENT_SUPER, NULL, 0, (SSFVoidFn_t *)&super);
-        SSF_ASSERT(super == NULL);
-
-        /* Enter initial super */
-        _SSFSMStates[smid].current = initialSuper;
-        _SSFSMStates[smid].current(SSF_SM_EVENT_ENTRY, NULL, 0, (SSFVoidFn_t *)&super);
-    }
-
-    /* Enter initial state */
-    _SSFSMStates[smid].current = initial;
-    _SSFSMStates[smid].current(SSF_SM_EVENT_ENTRY, NULL, 0, (SSFVoidFn_t *)&super);
-
-    /* Disallow state transistions */
-    _ssfsmActive = SSF_SM_MAX;
-    _ssfsmIsEntryExit = false;
+    SSFSMExecInitHandler(&_ssfsmDefaultExec, smid, initial);
 }
 
 /* --------------------------------------------------------------------------------------------- */
-/* DeInitializes a state machine handler.                                                        */
+/* DeInitializes a state machine handler, call from the context of its executor.                 */
 /* --------------------------------------------------------------------------------------------- */
 void SSFSMDeInitHandler(SSFSMId_t smid)
 {
     SSFSMHandler_t currentSuper;
     SSFSMHandler_t super;
+    SSFSMExec_t *exec;
+    SSFSMExec_t *prevExec;
 
     SSF_REQUIRE((smid > SSF_SM_MIN) && (smid < SSF_SM_MAX));
-    SSF_ASSERT(_ssfsmIsInited);
-    SSF_ASSERT(_SSFSMStates[smid].current != NULL);
+    exec = (SSFSMExec_t *)SSF_ATOMIC_LOAD_PTR(&(_ssfsmOwners[smid]));
+    SSF_ASSERT(exec != NULL);
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
+    SSF_ASSERT(exec->states[smid].current != NULL);
 
-    _ssfsmActive = smid;
-    _ssfsmIsEntryExit = true;
+    prevExec = _ssfsmExec;
+    _ssfsmExec = exec;
+    exec->active = smid;
+    exec->isEntryExit = true;
 
     /* Determine current's super */
     currentSuper = NULL;
-    _SSFSMStates[smid].current(SSF_SM_EVENT_SUPER, NULL, 0, (SSFVoidFn_t *)&currentSuper);
-    SSF_ASSERT(currentSuper != _SSFSMStates[smid].current);
+    exec->states[smid].current(SSF_SM_EVENT_SUPER, NULL, 0, (SSFVoidFn_t *)&currentSuper);
+    SSF_ASSERT(currentSuper != exec->states[smid].current);
 
     /* Exit current state */
-    _SSFSMStates[smid].current(SSF_SM_EVENT_EXIT, NULL, 0, (SSFVoidFn_t *)&super);
-    _SSFSMStopAllTimers();
+    exec->states[smid].current(SSF_SM_EVENT_EXIT, NULL, 0, (SSFVoidFn_t *)&super);
+    _SSFSMStopAllTimers(exec);
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+    _SSFSMProfileState(exec, smid, NULL);
+#endif
 
     /* Does current have a super? */
     if (currentSuper != NULL)
@@ -402,69 +1674,174 @@ void SSFSMDeInitHandler(SSFSMId_t smid)
         SSF_ASSERT(super == NULL);
 
         /* Yes, exit current super */
-        _SSFSMStates[smid].current = currentSuper;
-        _SSFSMStates[smid].current(SSF_SM_EVENT_EXIT, NULL, 0, (SSFVoidFn_t *)&super);
-        _SSFSMStopAllTimers();
+        exec->states[smid].current = currentSuper;
+        exec->states[smid].current(SSF_SM_EVENT_EXIT, NULL, 0, (SSFVoidFn_t *)&super);
+        _SSFSMStopAllTimers(exec);
     }
 
-    _ssfsmActive = SSF_SM_MAX;
-    _ssfsmIsEntryExit = false;
+    exec->active = SSF_SM_MAX;
+    exec->isEntryExit = false;
+    _ssfsmExec = prevExec;
 
     /* Reset the state machine */
-    memset(&_SSFSMStates[smid], 0, sizeof(SSFSMState_t));
+    memset(&(exec->states[smid]), 0, sizeof(SSFSMState_t));
+    SSF_ATOMIC_STORE_PTR(&(_ssfsmOwners[smid]), NULL);
 }
 
 /* --------------------------------------------------------------------------------------------- */
-/* Posts a new event to a state machine, processes it immediately if possible.                   */
+/* Posts a new event at a priority to a state machine's executor, processes it immediately if    */
+/* possible. If isReplace only replaces the data of a still queued event posted with isReplace.  */
 /* --------------------------------------------------------------------------------------------- */
-void SSFSMPutEventData(SSFSMId_t smid, SSFSMEventId_t eid, const SSFSMData_t *data,
-                       SSFSMDataLen_t dataLen)
+static void _SSFSMPutEvent(SSFSMId_t smid, SSFSMEventId_t eid, const SSFSMData_t *data,
+                           SSFSMDataLen_t dataLen, SSFSMPriority_t pri, bool isReplace)
 {
+    SSFSMExec_t *exec;
     SSFSMEvent_t *e;
 
     SSF_REQUIRE((smid > SSF_SM_MIN) && (smid < SSF_SM_MAX));
     SSF_REQUIRE((eid > SSF_SM_EVENT_EXIT) && (eid > SSF_SM_EVENT_MIN) && (eid < SSF_SM_EVENT_MAX));
     SSF_REQUIRE(((data == NULL) && (dataLen == 0)) || ((data != NULL) && (dataLen > 0)));
-    SSF_ASSERT(_ssfsmIsInited);
-    SSF_ASSERT(_SSFSMStates[smid].current != NULL);
+    SSF_REQUIRE(pri < SSF_SM_EVENT_PRIORITY_NUM);
+    exec = (SSFSMExec_t *)SSF_ATOMIC_LOAD_PTR(&(_ssfsmOwners[smid]));
+    SSF_ASSERT(exec != NULL);
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
+    SSF_ASSERT(exec->states[smid].current != NULL);
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 0
+    SSF_UNUSED_INT(isReplace);
+#endif
+
+#if SSF_SM_LOCK_FREE == 1
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+    /* Replaceable events are indexed and queued while holding the coalesce lock */
+    if (isReplace)
+    {
+        SSF_MUTEX_ACQUIRE(exec->coalesceSync);
+        if (_SSFSMReplaceEventData(exec, smid, eid, data, dataLen))
+        {
+            SSF_MUTEX_RELEASE(exec->coalesceSync);
+            return;
+        }
+    }
+#endif
+
+    /* Queue event without blocking, executor moves it from its inbox to its event queue */
+    e = _SSFSMAllocEvent(exec, data, dataLen, 0x11);
+    e->smid = smid;
+    e->eid = eid;
+    e->pri = pri;
+    e->queued = SSF_SM_GET_TICK();
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+    e->profileQueued = SSFPortGetHRTick64();
+#endif
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+    if (isReplace) _SSFSMIndexEvent(exec, e);
+#endif
+    _SSFSMInboxPush(&(exec->inbox), e);
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+    if (isReplace) { SSF_MUTEX_RELEASE(exec->coalesceSync); }
+#endif
 
+    /* Only first event posted since the executor's task last started needs to wake it */
+    if (SSF_ATOMIC_XCHG_U32(&(exec->isWakePending), 1) == 0) _SSFSMWakePost(exec);
+#else
 #if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 0
     /* In state handler or there are pending events? */
-    if (((_ssfsmActive > SSF_SM_MIN) && (_ssfsmActive < SSF_SM_MAX)) ||
-        (SSFLLIsEmpty(&_ssfsmEvents) == false))
+    if (((exec->active > SSF_SM_MIN) && (exec->active < SSF_SM_MAX)) ||
+        _SSFSMIsEventQueued(exec))
     {
 #endif
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-        SSF_SM_THREAD_SYNC_ACQUIRE();
+        _SSFSMLock(exec);
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+        /* Replaced data of a queued event? */
+        if (isReplace && _SSFSMReplaceEventData(exec, smid, eid, data, dataLen))
+        {
+            /* Yes, nothing to queue */
+            _SSFSMUnlock(exec);
+            return;
+        }
 #endif
         /* Yes, queue event */
-        e = (SSFSMEvent_t *)SSFMPoolAlloc(&_ssfsmEventPool, sizeof(SSFSMEvent_t), 0x11);
+        e = _SSFSMAllocEvent(exec, data, dataLen, 0x11);
         e->smid = smid;
         e->eid = eid;
-        _SSFSMAllocEventData(e, data, dataLen);
-        SSF_LL_FIFO_PUSH(&_ssfsmEvents, e);
+        e->pri = pri;
+        e->queued = SSF_SM_GET_TICK();
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+        e->profileQueued = SSFPortGetHRTick64();
+#endif
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+        if (isReplace) _SSFSMIndexEvent(exec, e);
+#endif
+        _SSFSMPushEvent(exec, e);
 #if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-        SSF_SM_THREAD_WAKE_POST();
-        SSF_SM_THREAD_SYNC_RELEASE();
+        _SSFSMWakePost(exec);
+#endif
+        _SSFSMUnlock(exec);
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 0
+    }
+    else
+    {
+        /* No, process event right now */
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+        uint64_t start = SSFPortGetHRTick64();
+
+        _SSFSMProcessEvent(exec, smid, eid, data, dataLen);
+        _SSFSMProfileEvent(exec, eid, start, start, SSFPortGetHRTick64());
 #else
-    /* No, process event right now */
-    } else _SSFSMProcessEvent(smid, eid, data, dataLen);
+        _SSFSMProcessEvent(exec, smid, eid, data, dataLen);
+#endif
+    }
 #endif
+#endif /* SSF_SM_LOCK_FREE */
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Posts a new event at a priority to a state machine's executor, processes it immediately if    */
+/* possible.                                                                                     */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMPutEventDataPri(SSFSMId_t smid, SSFSMEventId_t eid, const SSFSMData_t *data,
+                          SSFSMDataLen_t dataLen, SSFSMPriority_t pri)
+{
+    _SSFSMPutEvent(smid, eid, data, dataLen, pri, false);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Posts a new event at the default priority to a state machine's executor.                      */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMPutEventData(SSFSMId_t smid, SSFSMEventId_t eid, const SSFSMData_t *data,
+                       SSFSMDataLen_t dataLen)
+{
+    SSFSMPutEventDataPri(smid, eid, data, dataLen, SSF_SM_EVENT_PRIORITY_DEFAULT);
+}
+
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Replaces the data of the still queued event for smid and eid posted by this function, else    */
+/* posts a new event at a priority as SSFSMPutEventDataPri() does.                               */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMReplaceEventDataPri(SSFSMId_t smid, SSFSMEventId_t eid, const SSFSMData_t *data,
+                              SSFSMDataLen_t dataLen, SSFSMPriority_t pri)
+{
+    _SSFSMPutEvent(smid, eid, data, dataLen, pri, true);
 }
+#endif
 
 /* --------------------------------------------------------------------------------------------- */
 /* Record request for state transition.                                                          */
 /* --------------------------------------------------------------------------------------------- */
 void SSFSMTran(SSFSMHandler_t next)
 {
-    SSF_REQUIRE(next != NULL);
-    SSF_ASSERT((_ssfsmActive > SSF_SM_MIN) && (_ssfsmActive < SSF_SM_MAX));
-    SSF_REQUIRE(next != _SSFSMStates[_ssfsmActive].current);
-    SSF_ASSERT(_SSFSMStates[_ssfsmActive].next == NULL);
-    SSF_ASSERT(_ssfsmIsEntryExit == false);
-    SSF_ASSERT(_ssfsmIsInited);
+    SSFSMExec_t *exec = _ssfsmExec;
 
-    _SSFSMStates[_ssfsmActive].next = next;
+    SSF_REQUIRE(next != NULL);
+    SSF_ASSERT(exec != NULL);
+    SSF_ASSERT((exec->active > SSF_SM_MIN) && (exec->active < SSF_SM_MAX));
+    SSF_REQUIRE(next != exec->states[exec->active].current);
+    SSF_ASSERT(exec->states[exec->active].next == NULL);
+    SSF_ASSERT(exec->isEntryExit == false);
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
+
+    exec->states[exec->active].next = next;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -473,25 +1850,29 @@ void SSFSMTran(SSFSMHandler_t next)
 void SSFSMStartTimerData(SSFSMEventId_t eid, SSFSMTimeout_t interval, const SSFSMData_t *data,
                          SSFSMDataLen_t dataLen)
 {
+    SSFSMExec_t *exec = _ssfsmExec;
     SSFSMTimer_t *tp;
 
     SSF_REQUIRE((eid > SSF_SM_EVENT_EXIT) && (eid > SSF_SM_EVENT_MIN) && (eid < SSF_SM_EVENT_MAX));
     SSF_REQUIRE(((data == NULL) && (dataLen == 0)) || ((data != NULL) && (dataLen > 0)));
-    SSF_ASSERT((_ssfsmActive > SSF_SM_MIN) && (_ssfsmActive < SSF_SM_MAX));
-    SSF_ASSERT(_ssfsmIsInited);
+    SSF_ASSERT(exec != NULL);
+    SSF_ASSERT((exec->active > SSF_SM_MIN) && (exec->active < SSF_SM_MAX));
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
 
     /* Stop duplicate timer if it already exists */
     SSFSMStopTimer(eid);
 
     /* Create new timer. */
-    tp = (SSFSMTimer_t *)SSFMPoolAlloc(&_ssfsmTimerPool, sizeof(SSFSMTimer_t), 0x22);
-    tp->event = (SSFSMEvent_t *)SSFMPoolAlloc(&_ssfsmEventPool, sizeof(SSFSMEvent_t), 0x33);
-    tp->to = interval + SSFPortGetTick64();
-    tp->event->smid = _ssfsmActive;
+    tp = (SSFSMTimer_t *)SSFMPoolAlloc(&(exec->timerPool), sizeof(SSFSMTimer_t), 0x22);
+    _SSFSMLock(exec);
+    tp->event = _SSFSMAllocEvent(exec, data, dataLen, 0x33);
+    tp->to = interval + SSF_SM_GET_TICK();
+    tp->event->smid = exec->active;
     tp->event->eid = eid;
-    tp->owner = _SSFSMStates[_ssfsmActive].current;
-    _SSFSMAllocEventData(tp->event, data, dataLen);
-    SSF_LL_FIFO_PUSH(&_ssfsmTimers, tp);
+    tp->event->pri = SSF_SM_EVENT_PRIORITY_DEFAULT;
+    tp->owner = exec->states[exec->active].current;
+    _SSFSMUnlock(exec);
+    SSF_LL_FIFO_PUSH(&(exec->timers), tp);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -499,21 +1880,23 @@ void SSFSMStartTimerData(SSFSMEventId_t eid, SSFSMTimeout_t interval, const SSFS
 /* --------------------------------------------------------------------------------------------- */
 void SSFSMStopTimer(SSFSMEventId_t eid)
 {
+    SSFSMExec_t *exec = _ssfsmExec;
     SSFLLItem_t *item;
     SSFSMTimer_t t;
 
-    SSF_ASSERT((_ssfsmActive > SSF_SM_MIN) && (_ssfsmActive < SSF_SM_MAX));
-    SSF_ASSERT(_ssfsmIsInited);
+    SSF_ASSERT(exec != NULL);
+    SSF_ASSERT((exec->active > SSF_SM_MIN) && (exec->active < SSF_SM_MAX));
+    SSF_ASSERT(exec->magic == SSF_SM_EXEC_INIT_MAGIC);
 
-    item = _SSFSMFindTimer(eid);
+    item = _SSFSMFindTimer(exec, eid);
     if (item != NULL)
     {
-        SSFLLGetItem(&_ssfsmTimers, &item, SSF_LL_LOC_ITEM, item);
+        SSFLLGetItem(&(exec->timers), &item, SSF_LL_LOC_ITEM, item);
         memcpy(&t, item, sizeof(t));
-        if ((t.event->data) && (t.event->dataLen > sizeof(SSFSMData_t *)))
-        {_SSFSMFreeEventData(t.event->data); }
-        SSFMPoolFree(&_ssfsmEventPool, t.event);
-        SSFMPoolFree(&_ssfsmTimerPool, item);
+        _SSFSMLock(exec);
+        _SSFSMFreeEvent(exec, t.event);
+        _SSFSMUnlock(exec);
+        SSFMPoolFree(&(exec->timerPool), item);
     }
 }
 
@@ -523,66 +1906,96 @@ void SSFSMStopTimer(SSFSMEventId_t eid)
 /* --------------------------------------------------------------------------------------------- */
 bool SSFSMTask(SSFSMTimeout_t *nextTimeout)
 {
-    SSFSMEvent_t e;
-    SSFLLItem_t *item;
-    SSFLLItem_t *next;
-    SSFSMTimer_t t;
-    SSFSMTimeout_t current = SSFPortGetTick64();
-    bool retVal;
+    return SSFSMExecTask(&_ssfsmDefaultExec, nextTimeout);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Call periodically from main loop. Processes events until budget ticks elapse. Returns true if */
+/* timers or events are pending, else false. Optionally reports delta to next timer expiration.  */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFSMTaskBudget(SSFSMTimeout_t *nextTimeout, SSFSMTimeout_t budget)
+{
+    return SSFSMExecTaskBudget(&_ssfsmDefaultExec, nextTimeout, budget);
+}
 
-    SSF_ASSERT(_ssfsmActive >= SSF_SM_MAX);
-    SSF_ASSERT(_ssfsmIsInited);
+/* --------------------------------------------------------------------------------------------- */
+/* Reports the default executor's event queue depth and oldest queued event age for a priority.  */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMGetQueueStats(SSFSMPriority_t pri, SSFSMQueueStats_t *stats)
+{
+    SSFSMExecGetQueueStats(&_ssfsmDefaultExec, pri, stats);
+}
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    SSF_SM_THREAD_SYNC_ACQUIRE();
-#endif
+#if SSF_SM_EPOLL == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes an epoll loop running the default executor.                                       */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMEpollInit(SSFSMEpoll_t *ep)
+{
+    SSFSMExecEpollInit(&_ssfsmDefaultExec, ep);
+}
+#endif /* SSF_SM_EPOLL */
 
-    /* Process all pending events. */
-processEvents:
-    while (SSF_LL_FIFO_POP(&_ssfsmEvents, &item) == true)
-    {
-        memcpy(&e, item, sizeof(e)); /* Ensure alignment */
-        if (e.dataLen > sizeof(SSFSMData_t *))
-        { _SSFSMProcessEvent(e.smid, e.eid, e.data, e.dataLen); }
-        else _SSFSMProcessEvent(e.smid, e.eid, (SSFSMData_t *)&e.data, e.dataLen);
-        if ((e.data != NULL) && (e.dataLen > sizeof(SSFSMData_t *)))
-        { _SSFSMFreeEventData(e.data); }
-        SSFMPoolFree(&_ssfsmEventPool, item);
-    }
+#if SSF_SM_TRAN_CACHE_SIZE > 0
+/* --------------------------------------------------------------------------------------------- */
+/* Enables or disables, and empties, the default executor's transition cache.                    */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMEnableTranCache(bool enable)
+{
+    SSFSMExecEnableTranCache(&_ssfsmDefaultExec, enable);
+}
+#endif /* SSF_SM_TRAN_CACHE_SIZE */
 
-    /* Process timers. */
-    item = SSF_LL_HEAD(&_ssfsmTimers);
-    while (item != NULL)
-    {
-        next = SSF_LL_NEXT_ITEM(item);
-        memcpy(&t, item, sizeof(t));  /* Ensure alignment */
-        if (t.to > current) { item = next; continue; }
-        SSFLLGetItem(&_ssfsmTimers, &item, SSF_LL_LOC_ITEM, item);
-        SSF_LL_FIFO_PUSH(&_ssfsmEvents, (SSFLLItem_t*)t.event);
-        SSFMPoolFree(&_ssfsmTimerPool, item);
-        item = next;
-        goto processEvents;
-    }
+#if SSF_SM_CONFIG_ENABLE_TICK_SOURCE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Runs the default executor for duration virtual ticks, returns true if timers/events pending.  */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFSMSimRun(SSFSMTimeout_t duration)
+{
+    return SSFSMExecSimRun(&_ssfsmDefaultExec, duration);
+}
+#endif /* SSF_SM_CONFIG_ENABLE_TICK_SOURCE */
 
-    /* If necessary determine next timer expiration */
-    if (nextTimeout != NULL)
-    {
-        *nextTimeout = SSF_SM_MAX_TIMEOUT;
-        item = SSF_LL_HEAD(&_ssfsmTimers);
-        while (item != NULL)
-        {
-            next = SSF_LL_NEXT_ITEM(item);
-            memcpy(&t, item, sizeof(t));
-            if (t.to < (*nextTimeout)) *nextTimeout = t.to;
-            item = next;
-        }
-        if (*nextTimeout != SSF_SM_MAX_TIMEOUT) *nextTimeout -= current;
-    }
-    retVal = !SSFLLIsEmpty(&_ssfsmTimers);
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Copies the default executor's profile to profile.                                             */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMGetProfile(SSFSMProfile_t *profile)
+{
+    SSFSMExecGetProfile(&_ssfsmDefaultExec, profile);
+}
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    SSF_SM_THREAD_SYNC_RELEASE();
-#endif
-    return retVal;
+/* --------------------------------------------------------------------------------------------- */
+/* Clears the default executor's profile.                                                        */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMResetProfile(void)
+{
+    SSFSMExecResetProfile(&_ssfsmDefaultExec);
 }
 
+#if SSF_SM_CONFIG_ENABLE_PROFILE_CLI == 1
+/* --------------------------------------------------------------------------------------------- */
+/* CLI command handler, prints the default executor's profile and resets it if //reset given.    */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFSMProfileCLIHandler(SSFGObj_t *gobjCmd, uint32_t numOpts, SSFGObj_t *gobjOpts,
+                            uint32_t numArgs, SSFGObj_t *gobjArgs,
+                            SSFVTEdWriteStdoutFn_t writeStdoutFn)
+{
+    static SSFSMProfile_t profile; /* Too big for most stacks */
+    bool isReset;
+
+    SSF_UNUSED_PTR(gobjCmd);
+    SSF_UNUSED_PTR(gobjArgs);
+    SSF_REQUIRE(gobjOpts != NULL);
+    SSF_REQUIRE(writeStdoutFn != NULL);
+
+    isReset = SSFCLIGObjGetIsOpt("reset", gobjOpts);
+    if ((numArgs != 0) || (numOpts != (isReset ? 1u : 0u))) return false;
+
+    SSFSMGetProfile(&profile);
+    SSFSMProfilePrint(&profile, writeStdoutFn);
+    if (isReset) SSFSMResetProfile();
+    return true;
+}
+#endif /* SSF_SM_CONFIG_ENABLE_PROFILE_CLI */
+#endif /* SSF_SM_CONFIG_ENABLE_PROFILE */
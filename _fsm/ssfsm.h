@@ -40,6 +40,14 @@ extern "C" {
 #include <stdbool.h>
 #include "ssfport.h"
 #include "ssf.h"
+#include "ssfll.h"
+#include "ssfmpool.h"
+#if SSF_SM_CONFIG_ENABLE_PROFILE_CLI == 1
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 0
+#error SSF_SM_CONFIG_ENABLE_PROFILE_CLI requires SSF_SM_CONFIG_ENABLE_PROFILE
+#endif
+#include "ssfcli.h"
+#endif
 
 /* --------------------------------------------------------------------------------------------- */
 /* Defines                                                                                       */
@@ -49,6 +57,8 @@ typedef int16_t SSFSMEventId_t;
 typedef uint8_t SSFSMData_t;
 typedef uint16_t SSFSMDataLen_t;
 typedef SSFPortTick_t SSFSMTimeout_t;
+typedef uint8_t SSFSMPriority_t;
+typedef SSFSMTimeout_t (*SSFSMTickFn_t)(void);
 
 /* Note: superHandler is always a function pointer to SSFSMHandler_t */
 typedef void (*SSFSMHandler_t)(SSFSMEventId_t eid, const SSFSMData_t *data,
@@ -59,23 +69,266 @@ typedef void (*SSFSMHandler_t)(SSFSMEventId_t eid, const SSFSMData_t *data,
       SSF_ASSERT((sizeof(v) >= dataLen) && (data != NULL)); \
       memcpy(&(v), data, dataLen); }
 
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && (SSF_SM_CONFIG_ENABLE_LOCK_FREE_EVENTS == 1)
+#define SSF_SM_LOCK_FREE (1u)
+#else
+#define SSF_SM_LOCK_FREE (0u)
+#endif
+
+#if (SSF_SM_CONFIG_ENABLE_EPOLL == 1) && defined(__linux__)
+#define SSF_SM_EPOLL (1u)
+#else
+#define SSF_SM_EPOLL (0u)
+#endif
+
+/* Event pool 0 holds the events with inline data, the rest hold blocks for larger event data */
+#define SSF_SM_NUM_EVENT_POOLS (SSF_SM_EVENT_DATA_POOL_NUM + 1u)
+
+typedef struct
+{
+    SSFSMHandler_t current;
+    SSFSMHandler_t next;
+} SSFSMState_t;
+
+#if SSF_SM_LOCK_FREE == 1
+/* Preallocated event nodes of nodeSize bytes, free list head is an ABA tag (high 32 bits) and */
+/* node index + 1 */
+typedef struct
+{
+    uint8_t *nodes;
+    uint64_t head;
+    uint32_t size;
+    uint32_t nodeSize;
+} SSFSMEventPool_t;
+
+/* Intrusive multi-producer/single-consumer queue, producers swap head, consumer owns tail */
+typedef struct
+{
+    struct SSFSMEvent *head;
+    struct SSFSMEvent *tail;
+    struct SSFSMEvent *stub;
+} SSFSMInbox_t;
+#endif /* SSF_SM_LOCK_FREE */
+
+/* Event queue instrumentation for one priority level */
+typedef struct
+{
+    uint32_t depth;           /* Number of queued events */
+    uint32_t maxDepth;        /* Most events queued at once since executor was initialized */
+    SSFSMTimeout_t oldestAge; /* Ticks oldest queued event has waited, 0 if none are queued */
+    uint32_t coalesced;       /* Posts that replaced the data of a queued event instead */
+} SSFSMQueueStats_t;
+
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+/* Profile durations are in SSFPortGetHRTick64() ticks */
+typedef struct
+{
+    SSFSMHandler_t state;     /* NULL if unused */
+    uint32_t entries;         /* Number of times state was entered */
+    uint64_t dwell;           /* Total time spent in state */
+} SSFSMProfileState_t;
+
+typedef struct
+{
+    uint32_t count;                                 /* Number of times event was processed */
+    uint64_t handlerTotal;                          /* Total time spent processing event */
+    uint64_t handlerMax;                            /* Longest time spent processing event */
+    uint32_t queueDelay[SSF_SM_PROFILE_HIST_BINS];  /* Log2 histogram of time queued */
+    uint32_t handlerTime[SSF_SM_PROFILE_HIST_BINS]; /* Log2 histogram of time processing */
+} SSFSMProfileEvent_t;
+
+typedef struct
+{
+    SSFSMProfileState_t states[SSF_SM_MAX][SSF_SM_PROFILE_MAX_STATES];
+    uint32_t statesDropped;   /* State entries not recorded because a state table was full */
+    SSFSMProfileEvent_t events[SSF_SM_EVENT_MAX];
+    uint32_t timersFired;     /* Number of expired timers */
+    uint32_t timerLateness[SSF_SM_PROFILE_HIST_BINS]; /* Log2 histogram of expiry lateness */
+    uint64_t start;           /* Time profile was reset */
+    uint64_t elapsed;         /* Time since profile was reset when snapshot was taken */
+} SSFSMProfile_t;
+
+/* Writes a piece of profile text, same signature as an ssfvted/ssfcli stdout writer */
+typedef void (*SSFSMProfileWriteFn_t)(const uint8_t *data, size_t dataLen);
+#endif /* SSF_SM_CONFIG_ENABLE_PROFILE */
+
+#if SSF_SM_TRAN_CACHE_SIZE > 0
+#if (SSF_SM_TRAN_CACHE_SIZE & (SSF_SM_TRAN_CACHE_SIZE - 1)) != 0
+#error SSF_SM_TRAN_CACHE_SIZE must be a power of 2
+#endif
+/* Super states of a transition's current and next states found the first time it was taken */
+typedef struct
+{
+    SSFSMHandler_t current;
+    SSFSMHandler_t next;
+    SSFSMHandler_t currentSuper;
+    SSFSMHandler_t nextSuper;
+} SSFSMTranCacheEntry_t;
+#endif /* SSF_SM_TRAN_CACHE_SIZE */
+
+/* Owns a group of state machines with their event queues and timers, fields are private */
+typedef struct
+{
+    SSFSMState_t states[SSF_SM_MAX];
+    SSFSMId_t active;
+    bool isEntryExit;
+#if SSF_SM_LOCK_FREE == 1
+    SSFSMEventPool_t eventPools[SSF_SM_NUM_EVENT_POOLS];
+    SSFSMInbox_t inbox;
+    uint32_t isWakePending;
+#else
+    SSFMPool_t eventPools[SSF_SM_NUM_EVENT_POOLS];
+#endif
+    SSFMPool_t timerPool;
+    SSFLL_t events[SSF_SM_EVENT_PRIORITY_NUM];
+    uint32_t maxDepths[SSF_SM_EVENT_PRIORITY_NUM];
+    SSFLL_t timers;
+    uint64_t mallocs;
+    uint64_t frees;
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+    void *coalesce[SSF_SM_MAX][SSF_SM_EVENT_MAX]; /* Queued replaceable event of (smid, eid) */
+    uint32_t coalesced[SSF_SM_EVENT_PRIORITY_NUM];
+#if SSF_SM_LOCK_FREE == 1
+    SSFMutex_t coalesceSync;
+#endif
+#endif
+#if SSF_SM_TRAN_CACHE_SIZE > 0
+    SSFSMTranCacheEntry_t tranCache[SSF_SM_TRAN_CACHE_SIZE];
+    uint64_t tranCacheHits;
+    uint64_t tranCacheMisses;
+    bool isTranCacheDisabled;
+#endif
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+    SSFSMProfile_t profile;
+    uint64_t profileEntered[SSF_SM_MAX];
+    uint8_t profileState[SSF_SM_MAX];
+#endif
+#if SSF_SM_EPOLL == 1
+    int epollWakeFd;          /* eventfd of attached SSFSMEpoll_t, -1 if none */
+#endif
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+#if SSF_SM_LOCK_FREE == 0
+    SSFMutex_t sync;
+#endif
+    SSFSMExecWake_t wake;
+#endif
+    uint32_t magic;
+} SSFSMExec_t;
+
+#if SSF_SM_EPOLL == 1
+/* Data of events posted for ready file descriptors */
+typedef struct
+{
+    int fd;
+    uint32_t events;          /* Ready EPOLLIN, EPOLLOUT, EPOLLERR, EPOLLHUP... flags */
+} SSFSMEpollEvent_t;
+
+/* Runs an executor from an epoll loop, fields are private */
+typedef struct
+{
+    SSFSMExec_t *exec;
+    int epfd;
+    int wakeFd;
+    uint32_t magic;
+} SSFSMEpoll_t;
+#endif /* SSF_SM_EPOLL */
+
 /* --------------------------------------------------------------------------------------------- */
 /* External interface                                                                            */
 /* --------------------------------------------------------------------------------------------- */
 
-/* These functions must be called in a single threaded context */
+/* These functions must be called in a single threaded context, they use the default executor */
 void SSFSMInit(uint32_t maxEvents, uint32_t maxTimers);
 void SSFSMDeInit(void);
 void SSFSMInitHandler(SSFSMId_t smid, SSFSMHandler_t initial);
-void SSFSMDeInitHandler(SSFSMId_t smid);
 bool SSFSMTask(SSFSMTimeout_t *nextTimeout);
+bool SSFSMTaskBudget(SSFSMTimeout_t *nextTimeout, SSFSMTimeout_t budget);
+void SSFSMGetQueueStats(SSFSMPriority_t pri, SSFSMQueueStats_t *stats);
+
+/* Must be called from the context running the state machine's executor */
+void SSFSMDeInitHandler(SSFSMId_t smid);
+
+/* Each executor's functions must be called from the single context running that executor */
+void SSFSMExecInit(SSFSMExec_t *exec, uint32_t maxEvents, uint32_t maxTimers);
+void SSFSMExecDeInit(SSFSMExec_t *exec);
+void SSFSMExecInitHandler(SSFSMExec_t *exec, SSFSMId_t smid, SSFSMHandler_t initial);
+bool SSFSMExecTask(SSFSMExec_t *exec, SSFSMTimeout_t *nextTimeout);
+bool SSFSMExecTaskBudget(SSFSMExec_t *exec, SSFSMTimeout_t *nextTimeout, SSFSMTimeout_t budget);
+void SSFSMExecGetQueueStats(SSFSMExec_t *exec, SSFSMPriority_t pri, SSFSMQueueStats_t *stats);
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+void SSFSMExecWait(SSFSMExec_t *exec, SSFSMTimeout_t timeout);
+#endif
+
+#if SSF_SM_EPOLL == 1
+/* Must be called from the context running the executor, level triggered like epoll */
+void SSFSMEpollInit(SSFSMEpoll_t *ep);
+void SSFSMExecEpollInit(SSFSMExec_t *exec, SSFSMEpoll_t *ep);
+void SSFSMEpollDeInit(SSFSMEpoll_t *ep);
+bool SSFSMEpollAdd(SSFSMEpoll_t *ep, int fd, uint32_t events, SSFSMId_t smid,
+                   SSFSMEventId_t eid);
+bool SSFSMEpollRemove(SSFSMEpoll_t *ep, int fd);
+bool SSFSMEpollTask(SSFSMEpoll_t *ep, SSFSMTimeout_t maxWait);
+#endif
+
+#if SSF_SM_TRAN_CACHE_SIZE > 0
+/* Transition caching is enabled when an executor is initialized */
+void SSFSMEnableTranCache(bool enable);
+void SSFSMExecEnableTranCache(SSFSMExec_t *exec, bool enable);
+#endif
+
+#if SSF_SM_CONFIG_ENABLE_TICK_SOURCE == 1
+/* Must be called while no executor is initialized, NULL restores SSFPortGetTick64() */
+void SSFSMSetTickFn(SSFSMTickFn_t tickFn);
+void SSFSMSimInit(SSFSMTimeout_t start);
+void SSFSMSimDeInit(void);
+
+/* Virtual clock, only valid between SSFSMSimInit() and SSFSMSimDeInit() */
+SSFSMTimeout_t SSFSMSimGetTick(void);
+void SSFSMSimAdvance(SSFSMTimeout_t ticks);
+bool SSFSMSimRun(SSFSMTimeout_t duration);
+bool SSFSMExecSimRun(SSFSMExec_t *exec, SSFSMTimeout_t duration);
+#endif /* SSF_SM_CONFIG_ENABLE_TICK_SOURCE */
+
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+/* Must be called from the context running the executor */
+void SSFSMGetProfile(SSFSMProfile_t *profile);
+void SSFSMResetProfile(void);
+void SSFSMExecGetProfile(SSFSMExec_t *exec, SSFSMProfile_t *profile);
+void SSFSMExecResetProfile(SSFSMExec_t *exec);
+void SSFSMProfilePrint(const SSFSMProfile_t *profile, SSFSMProfileWriteFn_t writeFn);
+
+#if SSF_SM_CONFIG_ENABLE_PROFILE_CLI == 1
+/* CLI command handler printing the default executor's profile, //reset resets it afterwards */
+#define SSF_SM_PROFILE_CLI_CMD_STR "smprof"
+#define SSF_SM_PROFILE_CLI_SYNTAX_STR "smprof [//reset] - print state machine profile"
+bool SSFSMProfileCLIHandler(SSFGObj_t *gobjCmd, uint32_t numOpts, SSFGObj_t *gobjOpts,
+                            uint32_t numArgs, SSFGObj_t *gobjArgs,
+                            SSFVTEdWriteStdoutFn_t writeStdoutFn);
+#endif /* SSF_SM_CONFIG_ENABLE_PROFILE_CLI */
+#endif /* SSF_SM_CONFIG_ENABLE_PROFILE */
 
 /* May be called from any context when SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1, */
 /* Otherwise must be called from the same single threaded context as above functions */
+/* Event is queued to the executor that owns the state machine, 0 is the highest priority */
+void SSFSMPutEventDataPri(SSFSMId_t smid, SSFSMEventId_t eid, const SSFSMData_t *data,
+                          SSFSMDataLen_t dataLen, SSFSMPriority_t pri);
+/* As SSFSMPutEventDataPri() at SSF_SM_EVENT_PRIORITY_DEFAULT */
 void SSFSMPutEventData(SSFSMId_t smid, SSFSMEventId_t eid, const SSFSMData_t *data,
                        SSFSMDataLen_t dataLen);
+#define SSFSMPutEventPri(smid, eid, pri) SSFSMPutEventDataPri(smid, eid, NULL, 0, pri)
 #define SSFSMPutEvent(smid, eid) SSFSMPutEventData(smid, eid, NULL, 0)
 
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+/* As SSFSMPutEventDataPri(), but if an event queued by these functions for smid and eid has not */
+/* been processed yet only its data is replaced, it keeps its place and priority in the queue */
+void SSFSMReplaceEventDataPri(SSFSMId_t smid, SSFSMEventId_t eid, const SSFSMData_t *data,
+                              SSFSMDataLen_t dataLen, SSFSMPriority_t pri);
+#define SSFSMReplaceEventData(smid, eid, data, dataLen) \
+        SSFSMReplaceEventDataPri(smid, eid, data, dataLen, SSF_SM_EVENT_PRIORITY_DEFAULT)
+#define SSFSMReplaceEventPri(smid, eid, pri) SSFSMReplaceEventDataPri(smid, eid, NULL, 0, pri)
+#define SSFSMReplaceEvent(smid, eid) SSFSMReplaceEventData(smid, eid, NULL, 0)
+#endif
+
 /* --------------------------------------------------------------------------------------------- */
 /* External interface only for state handlers                                                    */
 /* --------------------------------------------------------------------------------------------- */
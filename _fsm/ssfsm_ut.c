@@ -32,9 +32,20 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "ssfsm.h"
 #include "ssfport.h"
 #include "ssfassert.h"
+#if SSF_SM_CONFIG_ENABLE_PROFILE_CLI == 1
+#include "ssfargv.h"
+#endif
+#if SSF_SM_EPOLL == 1
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#endif
 
 #if SSF_CONFIG_SM_UNIT_TEST == 1
 
@@ -55,6 +66,98 @@ static bool _ssfsmFlags[SSFSM_UT_NUM_SMS][SSFSM_UT_NUM_HANDLERS][SSFSM_UT_NUM_EV
 static uint8_t _utTrace[255];
 static uint16_t _utTraceIndex;
 
+#define SSFSM_UT_EXEC_PINGS (10000u)
+static SSFSMExec_t _ssfsmUTExec;
+static uint32_t _ssfsmUTExecCount;
+static bool _ssfsmUTExecTimerFired;
+
+#define SSFSM_UT_DATA_MAX_EVENTS (8u)
+#define SSFSM_UT_DATA_HEAP_SIZE (1024u)
+static uint32_t _ssfsmUTDataCount;
+static SSFSMDataLen_t _ssfsmUTDataBatchSize;
+static uint32_t _ssfsmUTDataBatchLen;
+static uint64_t _ssfsmUTDataBatchMallocs;
+
+#define SSFSM_UT_PRI_EVENTS (6u)
+static const SSFSMPriority_t _ssfsmUTPris[SSFSM_UT_PRI_EVENTS] =
+    { SSF_SM_EVENT_PRIORITY_NUM - 1, SSF_SM_EVENT_PRIORITY_NUM - 1, SSF_SM_EVENT_PRIORITY_DEFAULT,
+      0, 0, SSF_SM_EVENT_PRIORITY_DEFAULT };
+static uint8_t _ssfsmUTPriReceived[SSFSM_UT_PRI_EVENTS];
+static uint32_t _ssfsmUTPriCount;
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+#define SSFSM_UT_DATA_BENCH_EVENTS (200000ul)
+#endif
+
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+#define SSFSM_UT_COALESCE_POSTS (100u)
+#define SSFSM_UT_COALESCE_MT_POSTS (100000ul)
+static uint32_t _ssfsmUTCoalesceCount;
+static uint32_t _ssfsmUTCoalesceLast;
+static SSFSMDataLen_t _ssfsmUTCoalesceLastLen;
+static uint32_t _ssfsmUTCoalescePlain;
+#endif
+
+#if SSF_SM_TRAN_CACHE_SIZE > 0
+#define SSFSM_UT_TRAN_CYCLE (3u)
+static char _ssfsmUTTranTrace[32];
+static uint8_t _ssfsmUTTranTraceLen;
+static uint32_t _ssfsmUTTranSupers;
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+#define SSFSM_UT_TRAN_BENCH_EVENTS (1000000ul)
+#endif
+#endif
+
+#if SSF_SM_CONFIG_ENABLE_TICK_SOURCE == 1
+#define SSFSM_UT_SIM_HOUR ((SSFSMTimeout_t)SSF_TICKS_PER_SEC * 60u * 60u)
+#define SSFSM_UT_SIM_MAX_BACKOFF (8u * SSFSM_UT_SIM_HOUR)
+static uint32_t _ssfsmUTSimRetries;
+static SSFSMTimeout_t _ssfsmUTSimBackoff;
+static SSFSMTimeout_t _ssfsmUTSimLastRetry;
+static SSFSMTimeout_t _ssfsmUTSimTick;
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+#define SSFSM_UT_SIM_BENCH_HOURS (8000000ull)
+#endif
+#endif
+
+#if SSF_SM_EPOLL == 1
+#define SSFSM_UT_EPOLL_TIMER (SSF_TICKS_PER_SEC / 20u)
+#define SSFSM_UT_EPOLL_MAX_READY (4u)
+static SSFSMEpollEvent_t _ssfsmUTEpollReady[SSFSM_UT_EPOLL_MAX_READY];
+static uint32_t _ssfsmUTEpollNumReady;
+static size_t _ssfsmUTEpollBytes;
+static uint32_t _ssfsmUTEpollTimers;
+static uint32_t _ssfsmUTEpollWakes;
+#endif
+
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+static SSFSMProfile_t _ssfsmUTProfile;
+static char _ssfsmUTProfileOut[4096];
+static size_t _ssfsmUTProfileOutLen;
+#endif
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+static bool _ssfsmUTExecIsThreaded;
+static pthread_t _ssfsmUTExecMainThread;
+static pthread_t _ssfsmUTExecThread;
+static uint32_t _ssfsmUTExecStop;
+
+#define SSFSM_UT_MP_NUM_PRODUCERS (8u)
+#define SSFSM_UT_MP_EVENTS_PER_PRODUCER (10000u)
+
+typedef struct
+{
+    uint32_t producer;
+    uint32_t seq;
+    uint32_t check;
+} SSFSMUTMPData_t;
+
+static uint32_t _ssfsmUTMPNextSeq[SSFSM_UT_MP_NUM_PRODUCERS];
+static uint32_t _ssfsmUTMPReceived;
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+static uint64_t *_ssfsmUTMPLatency;
+#endif
+#endif
+
 /* --------------------------------------------------------------------------------------------- */
 /* Returns true if all flags are cleared, else false.                                            */
 /* --------------------------------------------------------------------------------------------- */
@@ -492,182 +595,1591 @@ void UT4TestHandler1(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t
 #endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1 */
 
 /* --------------------------------------------------------------------------------------------- */
-/* Performs unit test on ssfll's external interface.                                             */
+/* Default executor test handler, returns count incremented by other executor until done.        */
 /* --------------------------------------------------------------------------------------------- */
-void SSFSMUnitTest(void)
+void UTExecPingHandler(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+                       SSFVoidFn_t *superHandler)
 {
-    SSFSMTimeout_t nextTimeout;
-    SSFSMTimeout_t lastTimeout;
-    SSFSMTimeout_t start;
-    SSFSMTimeout_t delta;
+    uint32_t count;
 
-    SSF_ASSERT_TEST(SSFSMDeInit());
-    memset(_ssfsmFlags, 0, sizeof(_ssfsmFlags));
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
-    SSF_ASSERT_TEST(SSFSMInitHandler(SSF_SM_UNIT_TEST_1, UT1TestHandler1));
-    SSF_ASSERT_TEST(SSFSMInitHandler(SSF_SM_UNIT_TEST_2, UT2TestHandler1));
-    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UT1_1));
-    SSF_ASSERT_TEST(SSFSMTask(NULL));
-    SSF_ASSERT_TEST(SSFSMTask(&nextTimeout));
+    SSF_UNUSED_PTR(superHandler);
 
-    SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    switch (eid)
+    {
+    case SSF_SM_EVENT_UNIT_TEST_1:
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+        if (_ssfsmUTExecIsThreaded)
+        { SSF_ASSERT(pthread_equal(pthread_self(), _ssfsmUTExecMainThread)); }
+#endif
+        SSF_SM_EVENT_DATA_ALIGN(count);
+        _ssfsmUTExecCount = count;
+        if (count < SSFSM_UT_EXEC_PINGS)
+        {
+            SSFSMPutEventData(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_2, (SSFSMData_t *)&count,
+                              sizeof(count));
+        }
+        break;
+    default:
+        break;
+    }
+}
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    start = SSFPortGetTick64();
-    SSF_SM_THREAD_WAKE_WAIT(SSF_TICKS_PER_SEC);
-    delta = SSFPortGetTick64() - start;
-    SSF_ASSERT((delta > (SSF_TICKS_PER_SEC * 0.9)) && (delta < (SSF_TICKS_PER_SEC * 1.1)));
+/* --------------------------------------------------------------------------------------------- */
+/* Other executor test handler, increments count and returns it to the default executor.         */
+/* --------------------------------------------------------------------------------------------- */
+void UTExecPongHandler(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+                       SSFVoidFn_t *superHandler)
+{
+    uint32_t count;
+
+    SSF_UNUSED_PTR(superHandler);
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+    if (_ssfsmUTExecIsThreaded && (eid != SSF_SM_EVENT_ENTRY))
+    { SSF_ASSERT(pthread_equal(pthread_self(), _ssfsmUTExecThread)); }
 #endif
 
-    SSF_ASSERT_TEST(SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS));
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
-    SSFSMInitHandler(SSF_SM_UNIT_TEST_1, UT1TestHandler1);
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_ENTRY);
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
-    SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UT1_1);
+    switch (eid)
+    {
+    case SSF_SM_EVENT_ENTRY:
+        SSFSMStartTimer(SSF_SM_EVENT_UNIT_TEST_1, 0);
+        break;
+    case SSF_SM_EVENT_UNIT_TEST_1:
+        _ssfsmUTExecTimerFired = true;
+        break;
+    case SSF_SM_EVENT_UNIT_TEST_2:
+        SSF_SM_EVENT_DATA_ALIGN(count);
+        count++;
+        SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UNIT_TEST_1, (SSFSMData_t *)&count,
+                          sizeof(count));
+        break;
+    default:
+        break;
+    }
+}
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    start = SSFPortGetTick64();
-    SSF_SM_THREAD_WAKE_WAIT(SSF_TICKS_PER_SEC);
-    delta = SSFPortGetTick64() - start;
-    SSF_ASSERT(delta < (SSF_TICKS_PER_SEC * 0.1));
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+/* --------------------------------------------------------------------------------------------- */
+/* Runs the other executor until told to stop.                                                   */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFSMUTExecThread(void *arg)
+{
+    SSF_UNUSED_PTR(arg);
 
-    start = SSFPortGetTick64();
-    SSF_SM_THREAD_WAKE_WAIT(SSF_TICKS_PER_SEC);
-    delta = SSFPortGetTick64() - start;
-    SSF_ASSERT((delta > (SSF_TICKS_PER_SEC * 0.9)) && (delta < (SSF_TICKS_PER_SEC * 1.1)));
+    _ssfsmUTExecThread = pthread_self();
+    while (SSF_ATOMIC_LOAD_U32(&_ssfsmUTExecStop) == 0)
+    {
+        SSFSMExecTask(&_ssfsmUTExec, NULL);
+        SSFSMExecWait(&_ssfsmUTExec, SSF_TICKS_PER_SEC / 10);
+    }
+    return NULL;
+}
 #endif
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    while (SSFSMTask(NULL));
+/* --------------------------------------------------------------------------------------------- */
+/* Passes events between state machines owned by the default and another executor.               */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTExec(void)
+{
+    uint32_t count;
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+    pthread_t thread;
 #endif
 
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UT1_1);
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
-    SSFSMInitHandler(SSF_SM_UNIT_TEST_2, UT2TestHandler1);
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_2, 0, SSF_SM_EVENT_ENTRY);
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    SSF_ASSERT_TEST(SSFSMExecInit(NULL, SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS));
+    SSF_ASSERT_TEST(SSFSMExecDeInit(&_ssfsmUTExec));
+    SSF_ASSERT_TEST(SSFSMExecInitHandler(&_ssfsmUTExec, SSF_SM_UNIT_TEST_2, UTExecPongHandler));
+    SSF_ASSERT_TEST(SSFSMExecTask(&_ssfsmUTExec, NULL));
 
-    SSF_ASSERT_TEST(SSFSMTran(UT1TestHandler2));
-    SSF_ASSERT_TEST(SSFSMStartTimerData(SSF_SM_EVENT_UT1_1, 1, (SSFSMData_t *)"a", 1));
-    SSF_ASSERT_TEST(SSFSMStartTimer(SSF_SM_EVENT_UT1_1, 1));
-    SSF_ASSERT_TEST(SSFSMStopTimer(SSF_SM_EVENT_UT1_1));
-    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_MIN, SSF_SM_EVENT_UT1_1));
-    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_MAX, SSF_SM_EVENT_UT1_1));
-    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MIN));
-    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MAX));
-    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_ENTRY));
-    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_EXIT));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_MIN, SSF_SM_EVENT_UT1_1, NULL, 0));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_MAX, SSF_SM_EVENT_UT1_1, NULL, 0));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MIN, NULL, 0));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MAX, NULL, 0));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_ENTRY, NULL, 0));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_EXIT, NULL, 0));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UT1_1, (SSFSMData_t *)"a", 0));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UT1_1, NULL, 1));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_MIN, SSF_SM_EVENT_UT1_1, (SSFSMData_t *)"a", 1));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_MAX, SSF_SM_EVENT_UT1_1, (SSFSMData_t *)"a", 1));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MIN, (SSFSMData_t *)"a", 1));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MAX, (SSFSMData_t *)"a", 1));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_ENTRY, (SSFSMData_t *)"a", 1));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_EXIT, (SSFSMData_t *)"a", 1));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_MIN, SSF_SM_EVENT_UT1_1,
-                                      (SSFSMData_t *)"1234567890", 10));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_MAX, SSF_SM_EVENT_UT1_1,
-                                      (SSFSMData_t *)"1234567890", 10));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MIN,
-                                      (SSFSMData_t *)"1234567890", 10));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MAX,
-                                      (SSFSMData_t *)"1234567890", 10));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_ENTRY,
-                                      (SSFSMData_t *)"1234567890", 10));
-    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_EXIT,
-                                      (SSFSMData_t *)"1234567890", 10));
+    SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSFSMExecInit(&_ssfsmUTExec, SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSF_ASSERT_TEST(SSFSMExecInit(&_ssfsmUTExec, SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS));
+    SSFSMInitHandler(SSF_SM_UNIT_TEST_1, UTExecPingHandler);
+    _ssfsmUTExecTimerFired = false;
+    SSFSMExecInitHandler(&_ssfsmUTExec, SSF_SM_UNIT_TEST_2, UTExecPongHandler);
+
+    /* A state machine is owned by only one executor */
+    SSF_ASSERT_TEST(SSFSMInitHandler(SSF_SM_UNIT_TEST_2, UTExecPongHandler));
+    SSF_ASSERT_TEST(SSFSMExecInitHandler(&_ssfsmUTExec, SSF_SM_UNIT_TEST_1, UTExecPingHandler));
+
+    /* Timers run on the executor owning the state machine */
     SSF_ASSERT(SSFSMTask(NULL) == false);
-    nextTimeout = 0;
-    SSF_ASSERT(SSFSMTask(&nextTimeout) == false);
-    SSF_ASSERT(nextTimeout == SSF_SM_MAX_TIMEOUT);
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
-    SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UT1_2);
+    SSF_ASSERT(_ssfsmUTExecTimerFired == false);
+    SSF_ASSERT(SSFSMExecTask(&_ssfsmUTExec, NULL) == false);
+    SSF_ASSERT(_ssfsmUTExecTimerFired);
+
+    /* Events run on the executor owning the target state machine */
+    count = SSFSM_UT_EXEC_PINGS - 10;
+    _ssfsmUTExecCount = 0;
+    SSFSMPutEventData(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_2, (SSFSMData_t *)&count,
+                      sizeof(count));
+    while (_ssfsmUTExecCount < SSFSM_UT_EXEC_PINGS)
+    {
+        SSFSMExecTask(&_ssfsmUTExec, NULL);
+        SSFSMTask(NULL);
+    }
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    while (SSFSMTask(NULL));
-#endif
+    /* Deinitializing an executor releases its state machines */
+    SSFSMExecDeInit(&_ssfsmUTExec);
+    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_2));
+    SSF_ASSERT_TEST(SSFSMDeInitHandler(SSF_SM_UNIT_TEST_2));
+    SSFSMInitHandler(SSF_SM_UNIT_TEST_2, UTExecPongHandler);
+    SSFSMDeInitHandler(SSF_SM_UNIT_TEST_2);
+    SSFSMDeInit();
 
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UT1_2);
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+    /* Run the other executor in its own thread */
+    SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSFSMExecInit(&_ssfsmUTExec, SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSFSMInitHandler(SSF_SM_UNIT_TEST_1, UTExecPingHandler);
+    _ssfsmUTExecTimerFired = false;
+    SSFSMExecInitHandler(&_ssfsmUTExec, SSF_SM_UNIT_TEST_2, UTExecPongHandler);
+    _ssfsmUTExecMainThread = pthread_self();
+    _ssfsmUTExecStop = 0;
+    _ssfsmUTExecIsThreaded = true;
+    SSF_ASSERT(pthread_create(&thread, NULL, _SSFSMUTExecThread, NULL) == 0);
+
+    count = 0;
+    _ssfsmUTExecCount = 0;
+    SSFSMPutEventData(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_2, (SSFSMData_t *)&count,
+                      sizeof(count));
+    while (_ssfsmUTExecCount < SSFSM_UT_EXEC_PINGS)
+    {
+        SSF_SM_THREAD_WAKE_WAIT(SSF_TICKS_PER_SEC);
+        SSFSMTask(NULL);
+    }
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    while (SSFSMTask(NULL));
-#else
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
-    nextTimeout = 0;
-    SSF_ASSERT(SSFSMTask(&nextTimeout) == false);
-    SSF_ASSERT(nextTimeout == SSF_SM_MAX_TIMEOUT);
+    SSF_ATOMIC_STORE_U32(&_ssfsmUTExecStop, 1);
+    SSF_ASSERT(pthread_join(thread, NULL) == 0);
+    _ssfsmUTExecIsThreaded = false;
+    SSF_ASSERT(_ssfsmUTExecTimerFired);
+    SSFSMExecDeInit(&_ssfsmUTExec);
+    SSFSMDeInit();
 #endif
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UT1_1);
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UTX_1);
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_2, 0, SSF_SM_EVENT_UT1_1);
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_2, 0, SSF_SM_EVENT_UT1_2);
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
-    SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_2);
+}
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    while (SSFSMTask(NULL));
-#endif
+/* --------------------------------------------------------------------------------------------- */
+/* Posts an event with a dataLen byte data pattern verified by UTDataHandler().                  */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTPutData(SSFSMDataLen_t dataLen)
+{
+    static uint8_t data[SSFSM_UT_DATA_HEAP_SIZE];
+    SSFSMDataLen_t i;
 
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UTX_2);
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
-    SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_2, NULL, 0);
+    SSF_ASSERT(dataLen <= sizeof(data));
+    for (i = 0; i < dataLen; i++) data[i] = (uint8_t)(dataLen + i);
+    SSFSMPutEventData(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_2,
+                      dataLen == 0 ? NULL : (SSFSMData_t *)data, dataLen);
+}
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    while (SSFSMTask(NULL));
-#endif
+/* --------------------------------------------------------------------------------------------- */
+/* Event data test handler, posts batches of events and verifies their data patterns.            */
+/* --------------------------------------------------------------------------------------------- */
+void UTDataHandler(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+                   SSFVoidFn_t *superHandler)
+{
+    SSFSMDataLen_t i;
 
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UTX_2);
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
-    SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_2, (SSFSMData_t *)"a", 1);
+    SSF_UNUSED_PTR(superHandler);
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    while (SSFSMTask(NULL));
-#endif
+    switch (eid)
+    {
+    case SSF_SM_EVENT_UNIT_TEST_1:
+        /* Events posted from a handler are always queued */
+        for (i = 0; i < _ssfsmUTDataBatchLen; i++) _SSFSMUTPutData(_ssfsmUTDataBatchSize);
+        _ssfsmUTDataBatchMallocs = _ssfsmUTExec.mallocs;
+        break;
+    case SSF_SM_EVENT_UNIT_TEST_2:
+        SSF_ASSERT((dataLen == 0) == (data == NULL));
+        for (i = 0; i < dataLen; i++) SSF_ASSERT(data[i] == (uint8_t)(dataLen + i));
+        _ssfsmUTDataCount++;
+        break;
+    default:
+        break;
+    }
+}
 
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UTX_2);
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_EXIT);
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 1, SSF_SM_EVENT_ENTRY);
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
-    SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_2, NULL, 0);
+/* --------------------------------------------------------------------------------------------- */
+/* Queues len events with size bytes of data, processes them, returns mallocs while queued.      */
+/* --------------------------------------------------------------------------------------------- */
+static uint64_t _SSFSMUTDataBatch(SSFSMDataLen_t size, uint32_t len)
+{
+    _ssfsmUTDataBatchSize = size;
+    _ssfsmUTDataBatchLen = len;
+    _ssfsmUTDataCount = 0;
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_1);
+    while (SSFSMExecTask(&_ssfsmUTExec, NULL));
+    SSF_ASSERT(_ssfsmUTDataCount == len);
+    return _ssfsmUTDataBatchMallocs;
+}
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    while (SSFSMTask(NULL));
+/* --------------------------------------------------------------------------------------------- */
+/* Verifies event data is stored in pooled events and only copied to the heap when needed.      */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTEventData(void)
+{
+    SSFSMDataLen_t sizes[] = { 0, 1, SSF_SM_EVENT_INLINE_DATA_SIZE };
+    uint32_t i;
+#if SSF_SM_EVENT_DATA_POOL_NUM > 0
+    SSFSMDataLen_t poolSizes[SSF_SM_EVENT_DATA_POOL_NUM] = SSF_SM_EVENT_DATA_POOL_SIZES;
+    uint32_t poolCounts[SSF_SM_EVENT_DATA_POOL_NUM] = SSF_SM_EVENT_DATA_POOL_COUNTS;
+#endif
+    SSFSMDataLen_t maxPoolSize = SSF_SM_EVENT_INLINE_DATA_SIZE;
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    SSFSMDataLen_t benchSizes[] = { 4, SSF_SM_EVENT_INLINE_DATA_SIZE, 64, 256,
+                                    SSFSM_UT_DATA_HEAP_SIZE };
+    uint32_t j;
+    uint64_t start;
+    uint64_t ticks;
 #endif
 
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 1, SSF_SM_EVENT_UTX_2);
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
-    SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_2, (SSFSMData_t *)"a", 1);
+    SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSFSMExecInit(&_ssfsmUTExec, SSFSM_UT_DATA_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSFSMExecInitHandler(&_ssfsmUTExec, SSF_SM_UNIT_TEST_2, UTDataHandler);
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    while (SSFSMTask(NULL));
-#endif
+    /* Event data that fits in the event never uses the heap */
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    { SSF_ASSERT(_SSFSMUTDataBatch(sizes[i], SSFSM_UT_DATA_MAX_EVENTS - 1) == 0); }
+    SSF_ASSERT(_ssfsmUTExec.mallocs == 0);
 
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 1, SSF_SM_EVENT_UTX_2);
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
-    SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_2, (SSFSMData_t *)"1234567890", 10);
+#if SSF_SM_EVENT_DATA_POOL_NUM > 0
+    /* Event data that fits in a pool never uses the heap until the pools that fit it are empty */
+    for (i = 0; i < SSF_SM_EVENT_DATA_POOL_NUM; i++)
+    {
+        SSF_ASSERT(_SSFSMUTDataBatch(poolSizes[i], poolCounts[i]) == 0);
+        maxPoolSize = poolSizes[i];
+    }
+    i = poolCounts[SSF_SM_EVENT_DATA_POOL_NUM - 1] + 1;
+    SSF_ASSERT(_SSFSMUTDataBatch(maxPoolSize, i) == 1);
+    SSF_ASSERT(_ssfsmUTExec.frees == 1);
+#endif
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    while (SSFSMTask(NULL));
+    /* Event data larger than every pool is copied to the heap */
+    _ssfsmUTExec.mallocs = 0;
+    _ssfsmUTExec.frees = 0;
+    SSF_ASSERT(_SSFSMUTDataBatch(maxPoolSize + 1, 2) == 2);
+    SSF_ASSERT(_SSFSMUTDataBatch(SSFSM_UT_DATA_HEAP_SIZE, 3) == 5);
+    SSF_ASSERT(_ssfsmUTExec.frees == 5);
+
+    /* Pending events are freed when the executor is deinitialized */
+    _ssfsmUTDataBatchSize = SSFSM_UT_DATA_HEAP_SIZE;
+    _ssfsmUTDataBatchLen = 1;
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_1);
+    _SSFSMUTPutData(SSF_SM_EVENT_INLINE_DATA_SIZE);
+    _SSFSMUTPutData(maxPoolSize);
+    _SSFSMUTPutData(SSFSM_UT_DATA_HEAP_SIZE);
+    SSFSMExecDeInit(&_ssfsmUTExec);
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    for (i = 0; i < sizeof(benchSizes) / sizeof(benchSizes[0]); i++)
+    {
+        SSFSMExecInit(&_ssfsmUTExec, SSFSM_UT_DATA_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+        SSFSMExecInitHandler(&_ssfsmUTExec, SSF_SM_UNIT_TEST_2, UTDataHandler);
+        _ssfsmUTDataCount = 0;
+        start = SSFPortGetHRTick64();
+        for (j = 0; j < SSFSM_UT_DATA_BENCH_EVENTS; j++)
+        {
+            _SSFSMUTPutData(benchSizes[i]);
+            SSFSMExecTask(&_ssfsmUTExec, NULL);
+        }
+        ticks = SSFPortGetHRTick64() - start;
+        SSF_ASSERT(_ssfsmUTDataCount == SSFSM_UT_DATA_BENCH_EVENTS);
+        printf("\r\n  Event data %4u bytes: %llu events/sec, %llu mallocs\r\n",
+               (unsigned int)benchSizes[i],
+               (unsigned long long)((SSFSM_UT_DATA_BENCH_EVENTS * SSF_HR_TICKS_PER_SEC) /
+                                    (ticks == 0 ? 1 : ticks)),
+               (unsigned long long)_ssfsmUTExec.mallocs);
+        SSFSMExecDeInit(&_ssfsmUTExec);
+    }
 #endif
+    SSFSMDeInit();
+}
 
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 1, SSF_SM_EVENT_UTX_2);
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 1, SSF_SM_EVENT_EXIT);
-    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_ENTRY);
-    SSF_ASSERT(_SSFSMFlagsAreCleared());
-    start = SSFPortGetTick64();
-    SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_1, (SSFSMData_t *)"t", 1);
+/* --------------------------------------------------------------------------------------------- */
+/* Priority test handler, posts events at mixed priorities and records the order they arrive.    */
+/* --------------------------------------------------------------------------------------------- */
+void UTPriHandler(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+                  SSFVoidFn_t *superHandler)
+{
+    uint8_t i;
+    SSFSMTimeout_t start;
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    SSFSMTask(NULL);
-#endif
+    SSF_UNUSED_PTR(superHandler);
+
+    switch (eid)
+    {
+    case SSF_SM_EVENT_UNIT_TEST_1:
+        /* Events posted from a handler are always queued */
+        for (i = 0; i < SSFSM_UT_PRI_EVENTS; i++)
+        {
+            SSFSMPutEventDataPri(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_2, (SSFSMData_t *)&i,
+                                 sizeof(i), _ssfsmUTPris[i]);
+        }
+        break;
+    case SSF_SM_EVENT_UNIT_TEST_2:
+        SSF_SM_EVENT_DATA_ALIGN(i);
+        SSF_ASSERT(_ssfsmUTPriCount < SSFSM_UT_PRI_EVENTS);
+        _ssfsmUTPriReceived[_ssfsmUTPriCount] = i;
+        _ssfsmUTPriCount++;
+
+        /* Use up at least one tick */
+        start = SSFPortGetTick64();
+        while (SSFPortGetTick64() == start);
+        break;
+    default:
+        break;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Verifies events are processed highest priority first within a per call time budget.          */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTPriority(void)
+{
+    SSFSMQueueStats_t stats;
+    SSFSMTimeout_t nextTimeout;
+    uint32_t i;
+    uint32_t j;
+    uint32_t calls;
+    uint8_t first = 0;
+    void (*putEventData)(SSFSMId_t smid, SSFSMEventId_t eid, const SSFSMData_t *data,
+                         SSFSMDataLen_t dataLen);
+
+    SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSFSMExecInit(&_ssfsmUTExec, SSFSM_UT_PRI_EVENTS + 1, SSFSM_UT_MAX_TIMERS);
+    SSFSMExecInitHandler(&_ssfsmUTExec, SSF_SM_UNIT_TEST_2, UTPriHandler);
+
+    SSF_ASSERT_TEST(SSFSMPutEventPri(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_1,
+                                     SSF_SM_EVENT_PRIORITY_NUM));
+    SSF_ASSERT_TEST(SSFSMExecGetQueueStats(NULL, 0, &stats));
+    SSF_ASSERT_TEST(SSFSMExecGetQueueStats(&_ssfsmUTExec, SSF_SM_EVENT_PRIORITY_NUM, &stats));
+    SSF_ASSERT_TEST(SSFSMExecGetQueueStats(&_ssfsmUTExec, 0, NULL));
+    SSF_ASSERT_TEST(SSFSMExecTaskBudget(NULL, NULL, 1));
+
+    for (i = 0; i < SSF_SM_EVENT_PRIORITY_NUM; i++)
+    {
+        SSFSMExecGetQueueStats(&_ssfsmUTExec, (SSFSMPriority_t)i, &stats);
+        SSF_ASSERT((stats.depth == 0) && (stats.maxDepth == 0) && (stats.oldestAge == 0));
+    }
+
+    /* Each call with a one tick budget processes the posting event and one handler that uses */
+    /* up a tick, the rest stay queued and are reported as due now */
+    _ssfsmUTPriCount = 0;
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_1);
+    nextTimeout = SSF_SM_MAX_TIMEOUT;
+    SSF_ASSERT(SSFSMExecTaskBudget(&_ssfsmUTExec, &nextTimeout, 1));
+    SSF_ASSERT(nextTimeout == 0);
+    SSF_ASSERT(_ssfsmUTPriCount == 1);
+    SSFSMExecGetQueueStats(&_ssfsmUTExec, SSF_SM_EVENT_PRIORITY_NUM - 1, &stats);
+    SSF_ASSERT((stats.depth == 2) && (stats.maxDepth == 2) && (stats.oldestAge >= 1));
+    SSFSMExecGetQueueStats(&_ssfsmUTExec, 0, &stats);
+    SSF_ASSERT((stats.depth == 1) && (stats.maxDepth == 2));
+
+    /* Last event is processed by a call that returns false */
+    calls = 1;
+    while (SSFSMExecTaskBudget(&_ssfsmUTExec, &nextTimeout, 1)) calls++;
+    SSF_ASSERT(calls == (SSFSM_UT_PRI_EVENTS - 1));
+    SSF_ASSERT(_ssfsmUTPriCount == SSFSM_UT_PRI_EVENTS);
+    SSF_ASSERT(nextTimeout == SSF_SM_MAX_TIMEOUT);
+
+    /* Higher priorities first, posting order within a priority */
+    for (i = 1; i < SSFSM_UT_PRI_EVENTS; i++)
+    {
+        j = _ssfsmUTPriReceived[i - 1];
+        SSF_ASSERT(_ssfsmUTPris[j] <= _ssfsmUTPris[_ssfsmUTPriReceived[i]]);
+        if (_ssfsmUTPris[j] == _ssfsmUTPris[_ssfsmUTPriReceived[i]])
+        { SSF_ASSERT(j < _ssfsmUTPriReceived[i]); }
+    }
+    for (i = 0; i < SSF_SM_EVENT_PRIORITY_NUM; i++)
+    {
+        SSFSMExecGetQueueStats(&_ssfsmUTExec, (SSFSMPriority_t)i, &stats);
+        SSF_ASSERT((stats.depth == 0) && (stats.oldestAge == 0));
+    }
+
+    /* Without a budget all events are processed in one call */
+    _ssfsmUTPriCount = 0;
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_1);
+    SSF_ASSERT(SSFSMExecTask(&_ssfsmUTExec, &nextTimeout) == false);
+    SSF_ASSERT(_ssfsmUTPriCount == SSFSM_UT_PRI_EVENTS);
+
+    /* SSFSMPutEventData() is a function posting at the default priority */
+    _ssfsmUTPriCount = 0;
+    putEventData = SSFSMPutEventData;
+    putEventData(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_2, (SSFSMData_t *)&first,
+                 sizeof(first));
+    SSFSMExecGetQueueStats(&_ssfsmUTExec, SSF_SM_EVENT_PRIORITY_DEFAULT, &stats);
+    SSF_ASSERT((_ssfsmUTPriCount == 1) || (stats.depth == 1));
+    SSFSMExecTask(&_ssfsmUTExec, NULL);
+    SSF_ASSERT((_ssfsmUTPriCount == 1) && (_ssfsmUTPriReceived[0] == 0));
+
+    /* Pending events at every priority are freed when the executor is deinitialized */
+    _ssfsmUTPriCount = 0;
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_1);
+    SSFSMExecTaskBudget(&_ssfsmUTExec, NULL, 1);
+    SSFSMExecDeInit(&_ssfsmUTExec);
+    SSFSMDeInit();
+}
+
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Replaces the UNIT_TEST_2 event with sequence value seq in a data pattern of dataLen bytes.    */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTReplaceData(uint32_t seq, SSFSMDataLen_t dataLen, SSFSMPriority_t pri)
+{
+    static uint8_t data[SSFSM_UT_DATA_HEAP_SIZE];
+
+    SSF_REQUIRE((dataLen >= sizeof(seq)) && (dataLen <= sizeof(data)));
+    memset(data, (uint8_t)seq, dataLen);
+    memcpy(data, &seq, sizeof(seq));
+    SSFSMReplaceEventDataPri(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_2, data, dataLen, pri);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Coalesce test handler, UNIT_TEST_1 replaces one UNIT_TEST_2 event many times, UNIT_TEST_2     */
+/* records the value received.                                                                   */
+/* --------------------------------------------------------------------------------------------- */
+void UTCoalesceHandler(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+                       SSFVoidFn_t *superHandler)
+{
+    const SSFSMDataLen_t sizes[] = { 4, 64, 8, SSFSM_UT_DATA_HEAP_SIZE };
+    uint32_t i;
+    SSFSMDataLen_t j;
+
+    SSF_UNUSED_PTR(superHandler);
+
+    switch (eid)
+    {
+    case SSF_SM_EVENT_UNIT_TEST_1:
+        /* Events posted from a handler are always queued, with data replace at every priority */
+        if (dataLen != 0)
+        {
+            for (i = 0; i < SSF_SM_EVENT_PRIORITY_NUM; i++)
+            {
+                _SSFSMUTReplaceData(i, sizeof(i),
+                                    (SSFSMPriority_t)(SSF_SM_EVENT_PRIORITY_NUM - 1 - i));
+            }
+            break;
+        }
+        for (i = 0; i < SSFSM_UT_COALESCE_POSTS; i++)
+        {
+            _SSFSMUTReplaceData(i, sizes[i % (sizeof(sizes) / sizeof(sizes[0]))],
+                                SSF_SM_EVENT_PRIORITY_DEFAULT);
+            if (i == (SSFSM_UT_COALESCE_POSTS / 2))
+            { SSFSMPutEvent(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_2); }
+        }
+        break;
+    case SSF_SM_EVENT_UNIT_TEST_2:
+        if (dataLen == 0) { _ssfsmUTCoalescePlain++; break; }
+        SSF_ASSERT(dataLen >= sizeof(i));
+        memcpy(&i, data, sizeof(i));
+        for (j = sizeof(i); j < dataLen; j++) SSF_ASSERT(data[j] == (uint8_t)i);
+        _ssfsmUTCoalesceCount++;
+        _ssfsmUTCoalesceLast = i;
+        _ssfsmUTCoalesceLastLen = dataLen;
+        break;
+    default:
+        break;
+    }
+}
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+/* --------------------------------------------------------------------------------------------- */
+/* Replaces the UNIT_TEST_2 event with increasing values as fast as possible.                    */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFSMUTCoalesceThread(void *arg)
+{
+    uint8_t data[64];
+    uint32_t i;
+
+    SSF_UNUSED_PTR(arg);
+
+    for (i = 1; i <= SSFSM_UT_COALESCE_MT_POSTS; i++)
+    {
+        memset(data, (uint8_t)i, sizeof(data));
+        memcpy(data, &i, sizeof(i));
+        SSFSMReplaceEventData(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_2, data,
+                              (i & 1) ? sizeof(data) : sizeof(i));
+    }
+    return NULL;
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/* Verifies replaceable events keep one queued event per state machine and event id.            */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTCoalesce(void)
+{
+    SSFSMQueueStats_t stats;
+    SSFSMPriority_t pri;
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+    pthread_t thread;
+    uint32_t last;
+#endif
+
+    SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSF_ASSERT_TEST(SSFSMReplaceEvent(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_2));
+    SSFSMExecInit(&_ssfsmUTExec, 3, SSFSM_UT_MAX_TIMERS);
+    SSFSMExecInitHandler(&_ssfsmUTExec, SSF_SM_UNIT_TEST_2, UTCoalesceHandler);
+    SSF_ASSERT_TEST(SSFSMReplaceEvent(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_EXIT));
+    SSF_ASSERT_TEST(SSFSMReplaceEventDataPri(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_2, NULL,
+                                             0, SSF_SM_EVENT_PRIORITY_NUM));
+
+    /* Many replacements from a handler queue only one event besides the plain put, */
+    /* far fewer than the executor's event limit */
+    _ssfsmUTCoalesceCount = 0;
+    _ssfsmUTCoalescePlain = 0;
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_1);
+    SSF_ASSERT(SSFSMExecTask(&_ssfsmUTExec, NULL) == false);
+    SSF_ASSERT((_ssfsmUTCoalesceCount == 1) && (_ssfsmUTCoalescePlain == 1));
+    SSF_ASSERT(_ssfsmUTCoalesceLast == (SSFSM_UT_COALESCE_POSTS - 1));
+    SSF_ASSERT(_ssfsmUTCoalesceLastLen == SSFSM_UT_DATA_HEAP_SIZE);
+    SSFSMExecGetQueueStats(&_ssfsmUTExec, SSF_SM_EVENT_PRIORITY_DEFAULT, &stats);
+    SSF_ASSERT((stats.coalesced == (SSFSM_UT_COALESCE_POSTS - 1)) && (stats.maxDepth == 2));
+    SSF_ASSERT(_ssfsmUTExec.mallocs == _ssfsmUTExec.frees);
+
+    /* Once processed the next replacement queues a new event */
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_1);
+    SSF_ASSERT(SSFSMExecTask(&_ssfsmUTExec, NULL) == false);
+    SSF_ASSERT((_ssfsmUTCoalesceCount == 2) && (_ssfsmUTCoalescePlain == 2));
+    SSF_ASSERT(_ssfsmUTCoalesceLast == (SSFSM_UT_COALESCE_POSTS - 1));
+
+    /* A replaced event keeps the priority it was first posted at */
+    pri = 1;
+    SSFSMPutEventData(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_1, &pri, sizeof(pri));
+    SSF_ASSERT(SSFSMExecTask(&_ssfsmUTExec, NULL) == false);
+    SSF_ASSERT(_ssfsmUTCoalesceCount == 3);
+    SSF_ASSERT(_ssfsmUTCoalesceLast == (SSF_SM_EVENT_PRIORITY_NUM - 1));
+    SSFSMExecGetQueueStats(&_ssfsmUTExec, SSF_SM_EVENT_PRIORITY_NUM - 1, &stats);
+    SSF_ASSERT(stats.coalesced == (SSF_SM_EVENT_PRIORITY_NUM - 1));
+
+    /* Pending replaced data is freed when the executor is deinitialized */
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_2, SSF_SM_EVENT_UNIT_TEST_2);
+    _SSFSMUTReplaceData(0, SSFSM_UT_DATA_HEAP_SIZE, 0);
+    _SSFSMUTReplaceData(1, 64, 0);
+    _SSFSMUTReplaceData(2, SSFSM_UT_DATA_HEAP_SIZE, 0);
+    SSFSMExecDeInit(&_ssfsmUTExec);
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+    /* Values replaced by another thread arrive in order and the last one is never lost */
+    SSFSMExecInit(&_ssfsmUTExec, 2, SSFSM_UT_MAX_TIMERS);
+    SSFSMExecInitHandler(&_ssfsmUTExec, SSF_SM_UNIT_TEST_2, UTCoalesceHandler);
+    _ssfsmUTCoalesceCount = 0;
+    _ssfsmUTCoalesceLast = 0;
+    SSF_ASSERT(pthread_create(&thread, NULL, _SSFSMUTCoalesceThread, NULL) == 0);
+    last = 0;
+    while (_ssfsmUTCoalesceLast < SSFSM_UT_COALESCE_MT_POSTS)
+    {
+        SSFSMExecWait(&_ssfsmUTExec, SSF_TICKS_PER_SEC);
+        SSFSMExecTask(&_ssfsmUTExec, NULL);
+        SSF_ASSERT(_ssfsmUTCoalesceLast >= last);
+        last = _ssfsmUTCoalesceLast;
+    }
+    SSF_ASSERT(pthread_join(thread, NULL) == 0);
+    SSF_ASSERT(SSFSMExecTask(&_ssfsmUTExec, NULL) == false);
+    SSF_ASSERT(_ssfsmUTCoalesceCount <= SSFSM_UT_COALESCE_MT_POSTS);
+    SSFSMExecGetQueueStats(&_ssfsmUTExec, SSF_SM_EVENT_PRIORITY_DEFAULT, &stats);
+    SSF_ASSERT((_ssfsmUTCoalesceCount + stats.coalesced) == SSFSM_UT_COALESCE_MT_POSTS);
+    SSFSMExecDeInit(&_ssfsmUTExec);
+#endif
+    SSFSMDeInit();
+}
+#endif /* SSF_SM_CONFIG_ENABLE_COALESCE */
+
+#if SSF_SM_TRAN_CACHE_SIZE > 0
+void UTTranA1(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+              SSFVoidFn_t *superHandler);
+void UTTranA2(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+              SSFVoidFn_t *superHandler);
+void UTTranB(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+             SSFVoidFn_t *superHandler);
+
+/* --------------------------------------------------------------------------------------------- */
+/* Records entry (lower case) and exit (upper case) of the transition test states.               */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTTranTrace(SSFSMEventId_t eid, char c)
+{
+    if (eid == SSF_SM_EVENT_SUPER) _ssfsmUTTranSupers++;
+    if ((eid != SSF_SM_EVENT_ENTRY) && (eid != SSF_SM_EVENT_EXIT)) return;
+    SSF_ASSERT(_ssfsmUTTranTraceLen < (sizeof(_ssfsmUTTranTrace) - 1));
+    _ssfsmUTTranTrace[_ssfsmUTTranTraceLen] = (eid == SSF_SM_EVENT_EXIT) ? (char)(c - 32) : c;
+    _ssfsmUTTranTraceLen++;
+    _ssfsmUTTranTrace[_ssfsmUTTranTraceLen] = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Transition test super state of UTTranA1() and UTTranA2().                                     */
+/* --------------------------------------------------------------------------------------------- */
+void UTTranSuperA(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+                  SSFVoidFn_t *superHandler)
+{
+    SSF_UNUSED_PTR(data);
+    SSF_UNUSED_PTR(superHandler);
+
+    _SSFSMUTTranTrace(eid, 's');
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Transition test state, UNIT_TEST_1 goes to sibling UTTranA2().                                */
+/* --------------------------------------------------------------------------------------------- */
+void UTTranA1(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+              SSFVoidFn_t *superHandler)
+{
+    SSF_UNUSED_PTR(data);
+
+    _SSFSMUTTranTrace(eid, 'a');
+    switch (eid)
+    {
+    case SSF_SM_EVENT_ENTRY:
+    case SSF_SM_EVENT_EXIT:
+        break;
+    case SSF_SM_EVENT_UNIT_TEST_1:
+        SSFSMTran(UTTranA2);
+        break;
+    default:
+        SSF_SM_SUPER(UTTranSuperA);
+        break;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Transition test state, UNIT_TEST_1 leaves the super state for UTTranB().                      */
+/* --------------------------------------------------------------------------------------------- */
+void UTTranA2(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+              SSFVoidFn_t *superHandler)
+{
+    SSF_UNUSED_PTR(data);
+
+    _SSFSMUTTranTrace(eid, 'b');
+    switch (eid)
+    {
+    case SSF_SM_EVENT_ENTRY:
+    case SSF_SM_EVENT_EXIT:
+        break;
+    case SSF_SM_EVENT_UNIT_TEST_1:
+        SSFSMTran(UTTranB);
+        break;
+    default:
+        SSF_SM_SUPER(UTTranSuperA);
+        break;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Transition test state without a super state, UNIT_TEST_1 goes back to UTTranA1().             */
+/* --------------------------------------------------------------------------------------------- */
+void UTTranB(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+             SSFVoidFn_t *superHandler)
+{
+    SSF_UNUSED_PTR(data);
+    SSF_UNUSED_PTR(superHandler);
+
+    _SSFSMUTTranTrace(eid, 'c');
+    if (eid == SSF_SM_EVENT_UNIT_TEST_1) SSFSMTran(UTTranA1);
+}
+
+/* Takes every transition of the test cycle once, returns the number of super state queries.     */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFSMUTTranCycle(void)
+{
+    uint8_t i;
+
+    _ssfsmUTTranTraceLen = 0;
+    _ssfsmUTTranTrace[0] = 0;
+    _ssfsmUTTranSupers = 0;
+    for (i = 0; i < SSFSM_UT_TRAN_CYCLE; i++)
+    {
+        SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UNIT_TEST_1);
+        SSFSMExecTask(&_ssfsmUTExec, NULL);
+    }
+    return _ssfsmUTTranSupers;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Verifies cached transitions run the same exits and entries without querying super states.    */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTTranCache(void)
+{
+    SSFSMExec_t *exec = &_ssfsmUTExec;
+    const char *cycle = "AbBScCsa";
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    uint32_t i;
+    uint32_t j;
+    uint64_t start;
+    uint64_t ticks;
+#endif
+
+    SSF_ASSERT_TEST(SSFSMExecEnableTranCache(NULL, true));
+    SSF_ASSERT_TEST(SSFSMExecEnableTranCache(exec, true));
+    SSF_ASSERT_TEST(SSFSMEnableTranCache(true));
+
+    SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSFSMEnableTranCache(true);
+    SSFSMExecInit(exec, SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSFSMExecInitHandler(exec, SSF_SM_UNIT_TEST_1, UTTranA1);
+
+    /* Without the cache every transition queries both super states */
+    SSFSMExecEnableTranCache(exec, false);
+    SSF_ASSERT(_SSFSMUTTranCycle() == (SSFSM_UT_TRAN_CYCLE * 2));
+    SSF_ASSERT(strcmp(_ssfsmUTTranTrace, cycle) == 0);
+    SSF_ASSERT((exec->tranCacheHits == 0) && (exec->tranCacheMisses == 0));
+
+    /* With the cache only the first time a transition is taken queries the super states */
+    SSFSMExecEnableTranCache(exec, true);
+    SSF_ASSERT(_SSFSMUTTranCycle() == (SSFSM_UT_TRAN_CYCLE * 2));
+    SSF_ASSERT(strcmp(_ssfsmUTTranTrace, cycle) == 0);
+    SSF_ASSERT(_SSFSMUTTranCycle() == 0);
+    SSF_ASSERT(strcmp(_ssfsmUTTranTrace, cycle) == 0);
+    SSF_ASSERT((exec->tranCacheHits == SSFSM_UT_TRAN_CYCLE) &&
+               (exec->tranCacheMisses == SSFSM_UT_TRAN_CYCLE));
+
+    /* Enabling again empties the cache */
+    SSFSMExecEnableTranCache(exec, true);
+    SSF_ASSERT(_SSFSMUTTranCycle() == (SSFSM_UT_TRAN_CYCLE * 2));
+    SSF_ASSERT(_SSFSMUTTranCycle() == 0);
+    SSF_ASSERT((exec->tranCacheHits == (SSFSM_UT_TRAN_CYCLE * 2)) &&
+               (exec->tranCacheMisses == (SSFSM_UT_TRAN_CYCLE * 2)));
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    for (i = 0; i < 2; i++)
+    {
+        SSFSMExecEnableTranCache(exec, i == 1);
+        start = SSFPortGetHRTick64();
+        for (j = 0; j < SSFSM_UT_TRAN_BENCH_EVENTS; j++)
+        {
+            _ssfsmUTTranTraceLen = 0;
+            SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UNIT_TEST_1);
+            SSFSMExecTask(exec, NULL);
+        }
+        ticks = SSFPortGetHRTick64() - start;
+        printf("\r\n  Transitions %s cache: %llu transitions/sec\r\n", i == 1 ? "with" : "without",
+               (unsigned long long)((SSFSM_UT_TRAN_BENCH_EVENTS * SSF_HR_TICKS_PER_SEC) /
+                                    (ticks == 0 ? 1 : ticks)));
+    }
+#endif
+    SSFSMExecDeInit(exec);
+    SSFSMDeInit();
+}
+#endif /* SSF_SM_TRAN_CACHE_SIZE */
+
+#if SSF_SM_CONFIG_ENABLE_TICK_SOURCE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Simulation test handler, retries hourly with exponential backoff until UNIT_TEST_2 arrives.   */
+/* --------------------------------------------------------------------------------------------- */
+void UTSimHandler(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+                  SSFVoidFn_t *superHandler)
+{
+    SSF_UNUSED_PTR(data);
+    SSF_UNUSED_PTR(superHandler);
+
+    switch (eid)
+    {
+    case SSF_SM_EVENT_ENTRY:
+        _ssfsmUTSimBackoff = SSFSM_UT_SIM_HOUR;
+        SSFSMStartTimer(SSF_SM_EVENT_UNIT_TEST_1, _ssfsmUTSimBackoff);
+        break;
+    case SSF_SM_EVENT_UNIT_TEST_1:
+        _ssfsmUTSimRetries++;
+        _ssfsmUTSimLastRetry = SSFSMSimGetTick();
+        _ssfsmUTSimBackoff *= 2;
+        if (_ssfsmUTSimBackoff > SSFSM_UT_SIM_MAX_BACKOFF)
+        { _ssfsmUTSimBackoff = SSFSM_UT_SIM_MAX_BACKOFF; }
+        SSFSMStartTimer(SSF_SM_EVENT_UNIT_TEST_1, _ssfsmUTSimBackoff);
+        break;
+    case SSF_SM_EVENT_UNIT_TEST_2:
+        SSFSMStopTimer(SSF_SM_EVENT_UNIT_TEST_1);
+        break;
+    default:
+        break;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns a tick count controlled by the unit test.                                             */
+/* --------------------------------------------------------------------------------------------- */
+static SSFSMTimeout_t _SSFSMUTGetTick(void)
+{
+    return _ssfsmUTSimTick;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Verifies timers run on a pluggable tick source and the virtual clock jumps to timer expiries. */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTSim(void)
+{
+    SSFSMTimeout_t start = 1000;
+    SSFSMTimeout_t nextTimeout;
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    uint64_t hrStart;
+    uint64_t ticks;
+#endif
+
+    /* Virtual clock functions are only valid while it is the tick source */
+    SSF_ASSERT_TEST(SSFSMSimDeInit());
+    SSF_ASSERT_TEST(SSFSMSimAdvance(1));
+    SSF_ASSERT_TEST(SSFSMSimRun(1));
+
+    SSFSMSimInit(start);
+    SSF_ASSERT(SSFSMSimGetTick() == start);
+    SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSF_ASSERT_TEST(SSFSMExecSimRun(NULL, 1));
+    SSF_ASSERT_TEST(SSFSMSimAdvance(SSF_SM_MAX_TIMEOUT));
+    SSF_ASSERT_TEST(SSFSMSimRun(SSF_SM_MAX_TIMEOUT));
+
+    /* Timers only expire as the virtual clock advances */
+    _ssfsmUTSimRetries = 0;
+    SSFSMInitHandler(SSF_SM_UNIT_TEST_1, UTSimHandler);
+    SSF_ASSERT(SSFSMTask(&nextTimeout));
+    SSF_ASSERT(nextTimeout == SSFSM_UT_SIM_HOUR);
+    SSFSMSimAdvance(SSFSM_UT_SIM_HOUR - 1);
+    SSF_ASSERT(SSFSMTask(&nextTimeout));
+    SSF_ASSERT((nextTimeout == 1) && (_ssfsmUTSimRetries == 0));
+    SSFSMSimAdvance(1);
+    SSF_ASSERT(SSFSMTask(&nextTimeout));
+    SSF_ASSERT(_ssfsmUTSimRetries == 1);
+    SSF_ASSERT(_ssfsmUTSimLastRetry == (start + SSFSM_UT_SIM_HOUR));
+    SSF_ASSERT(nextTimeout == (2 * SSFSM_UT_SIM_HOUR));
+
+    /* A simulated day of backoff retries at hours 3, 7, 15 and 23 */
+    SSF_ASSERT(SSFSMSimRun(23 * SSFSM_UT_SIM_HOUR));
+    SSF_ASSERT(_ssfsmUTSimRetries == 5);
+    SSF_ASSERT(_ssfsmUTSimLastRetry == (start + (23 * SSFSM_UT_SIM_HOUR)));
+    SSF_ASSERT(SSFSMSimGetTick() == (start + (24 * SSFSM_UT_SIM_HOUR)));
+
+    /* Ending exactly on an expiry runs it */
+    SSF_ASSERT(SSFSMSimRun(7 * SSFSM_UT_SIM_HOUR));
+    SSF_ASSERT(_ssfsmUTSimRetries == 6);
+    SSF_ASSERT(_ssfsmUTSimLastRetry == SSFSMSimGetTick());
+
+    /* With nothing pending the clock still moves by the whole duration */
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UNIT_TEST_2);
+    SSF_ASSERT(SSFSMSimRun(100 * SSFSM_UT_SIM_HOUR) == false);
+    SSF_ASSERT(_ssfsmUTSimRetries == 6);
+    SSF_ASSERT(SSFSMSimGetTick() == (start + (131 * SSFSM_UT_SIM_HOUR)));
+    SSFSMDeInit();
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSFSMInitHandler(SSF_SM_UNIT_TEST_1, UTSimHandler);
+    _ssfsmUTSimRetries = 0;
+    hrStart = SSFPortGetHRTick64();
+    SSFSMSimRun(SSFSM_UT_SIM_BENCH_HOURS * SSFSM_UT_SIM_HOUR);
+    ticks = SSFPortGetHRTick64() - hrStart;
+    printf("\r\n  Simulated %llu hours, %lu timer events: %llu events/sec\r\n",
+           (unsigned long long)SSFSM_UT_SIM_BENCH_HOURS, (unsigned long)_ssfsmUTSimRetries,
+           (unsigned long long)((((uint64_t)_ssfsmUTSimRetries) * SSF_HR_TICKS_PER_SEC) /
+                                (ticks == 0 ? 1 : ticks)));
+    SSFSMDeInit();
+#endif
+    SSFSMSimDeInit();
+
+    /* Any tick source may drive the timers */
+    _ssfsmUTSimTick = 0;
+    SSFSMSetTickFn(_SSFSMUTGetTick);
+    SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    _ssfsmUTSimRetries = 0;
+    SSFSMInitHandler(SSF_SM_UNIT_TEST_1, UTSimHandler);
+    SSF_ASSERT(SSFSMTask(&nextTimeout));
+    SSF_ASSERT(nextTimeout == SSFSM_UT_SIM_HOUR);
+    _ssfsmUTSimTick = SSFSM_UT_SIM_HOUR;
+    SSF_ASSERT(SSFSMTask(&nextTimeout));
+    SSF_ASSERT(_ssfsmUTSimRetries == 1);
+    SSF_ASSERT_TEST(SSFSMSimRun(1));
+
+    /* Tick source cannot change while any executor is initialized */
+    SSF_ASSERT_TEST(SSFSMSetTickFn(NULL));
+    SSF_ASSERT_TEST(SSFSMSimInit(0));
+    SSFSMExecInit(&_ssfsmUTExec, SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSFSMDeInit();
+    SSF_ASSERT_TEST(SSFSMSetTickFn(NULL));
+    SSFSMExecDeInit(&_ssfsmUTExec);
+    SSFSMSetTickFn(NULL);
+}
+#endif /* SSF_SM_CONFIG_ENABLE_TICK_SOURCE */
+
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+void UTProfHandlerB(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+                    SSFVoidFn_t *superHandler);
+
+/* --------------------------------------------------------------------------------------------- */
+/* Profile test handler, transitions to UTProfHandlerB() on UNIT_TEST_1.                         */
+/* --------------------------------------------------------------------------------------------- */
+void UTProfHandlerA(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+                    SSFVoidFn_t *superHandler)
+{
+    SSF_UNUSED_PTR(data);
+    SSF_UNUSED_PTR(superHandler);
+
+    if (eid == SSF_SM_EVENT_UNIT_TEST_1) SSFSMTran(UTProfHandlerB);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Profile test handler, starts a timer on entry and transitions back on UNIT_TEST_1.            */
+/* --------------------------------------------------------------------------------------------- */
+void UTProfHandlerB(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+                    SSFVoidFn_t *superHandler)
+{
+    SSF_UNUSED_PTR(data);
+    SSF_UNUSED_PTR(superHandler);
+
+    switch (eid)
+    {
+    case SSF_SM_EVENT_ENTRY:
+        SSFSMStartTimer(SSF_SM_EVENT_UNIT_TEST_2, 0);
+        break;
+    case SSF_SM_EVENT_UNIT_TEST_1:
+        SSFSMTran(UTProfHandlerA);
+        break;
+    default:
+        break;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Captures profile output.                                                                      */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTProfileWrite(const uint8_t *data, size_t dataLen)
+{
+    SSF_ASSERT((_ssfsmUTProfileOutLen + dataLen) < sizeof(_ssfsmUTProfileOut));
+    memcpy(&_ssfsmUTProfileOut[_ssfsmUTProfileOutLen], data, dataLen);
+    _ssfsmUTProfileOutLen += dataLen;
+    _ssfsmUTProfileOut[_ssfsmUTProfileOutLen] = 0;
+}
+
+#if SSF_SM_CONFIG_ENABLE_PROFILE_CLI == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Runs the profile CLI handler on cmdLine, returns its result with the output captured.         */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFSMUTProfileCLI(const char *cmdLine)
+{
+    SSFGObj_t *gobj = NULL;
+    SSFGObj_t *gobjParent;
+    SSFGObj_t *gobjs[3];
+    uint32_t numOpts;
+    uint32_t numArgs;
+    char *path[SSF_GOBJ_CONFIG_MAX_IN_DEPTH + 1];
+    const char *keys[3] = { SSF_ARGV_CMD_CSTR, SSF_ARGV_OPTS_CSTR, SSF_ARGV_ARGS_CSTR };
+    uint8_t i;
+    bool result;
+
+    SSF_ASSERT(SSFArgvInit(cmdLine, strlen(cmdLine) + 1, &gobj, SSF_CLI_MAX_OPTS,
+                           SSF_CLI_MAX_ARGS));
+    memset(path, 0, sizeof(path));
+    for (i = 0; i < 3; i++)
+    {
+        gobjParent = NULL;
+        gobjs[i] = NULL;
+        path[0] = (char *)keys[i];
+        SSF_ASSERT(SSFGObjFindPath(gobj, (SSFCStrIn_t *)path, &gobjParent, &gobjs[i]));
+    }
+    SSF_ASSERT(SSFGObjGetObjectLen(gobjs[1], &numOpts));
+    SSF_ASSERT(SSFGObjGetArrayLen(gobjs[2], &numArgs));
+
+    _ssfsmUTProfileOutLen = 0;
+    _ssfsmUTProfileOut[0] = 0;
+    result = SSFSMProfileCLIHandler(gobjs[0], numOpts, gobjs[1], numArgs, gobjs[2],
+                                    _SSFSMUTProfileWrite);
+    SSFArgvDeInit(&gobj);
+    return result;
+}
+#endif /* SSF_SM_CONFIG_ENABLE_PROFILE_CLI */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the sum of a profile histogram's bins.                                                */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFSMUTProfileHistSum(const uint32_t *hist)
+{
+    uint32_t sum = 0;
+    uint8_t i;
+
+    for (i = 0; i < SSF_SM_PROFILE_HIST_BINS; i++) sum += hist[i];
+    return sum;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Verifies state dwell, event latency and timer lateness are profiled and reported.             */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTProfile(void)
+{
+    SSFSMProfile_t *p = &_ssfsmUTProfile;
+    SSFSMProfileEvent_t *pe;
+    SSFSMTimeout_t nextTimeout;
+    uint64_t dwell;
+
+    SSF_ASSERT_TEST(SSFSMExecGetProfile(NULL, p));
+    SSF_ASSERT_TEST(SSFSMExecResetProfile(NULL));
+    SSF_ASSERT_TEST(SSFSMProfilePrint(NULL, _SSFSMUTProfileWrite));
+
+    SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSF_ASSERT_TEST(SSFSMGetProfile(NULL));
+    SSF_ASSERT_TEST(SSFSMProfilePrint(p, NULL));
+
+    /* Initial state is entered once, nothing else has happened */
+    SSFSMInitHandler(SSF_SM_UNIT_TEST_1, UTProfHandlerA);
+    SSFSMGetProfile(p);
+    SSF_ASSERT(p->states[SSF_SM_UNIT_TEST_1][0].state == UTProfHandlerA);
+    SSF_ASSERT(p->states[SSF_SM_UNIT_TEST_1][0].entries == 1);
+    SSF_ASSERT(p->states[SSF_SM_UNIT_TEST_1][1].state == NULL);
+    SSF_ASSERT(p->events[SSF_SM_EVENT_UNIT_TEST_1].count == 0);
+    SSF_ASSERT(p->timersFired == 0);
+
+    /* Reset keeps the current state with no entries */
+    SSFSMResetProfile();
+    SSFSMGetProfile(p);
+    SSF_ASSERT(p->states[SSF_SM_UNIT_TEST_1][0].state == UTProfHandlerA);
+    SSF_ASSERT(p->states[SSF_SM_UNIT_TEST_1][0].entries == 0);
+    SSF_ASSERT(p->states[SSF_SM_UNIT_TEST_1][0].dwell <= p->elapsed);
+
+    /* A -> B, B's timer fires, B -> A */
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UNIT_TEST_1);
+    SSFSMTask(&nextTimeout);
+    SSFSMTask(&nextTimeout);
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UNIT_TEST_1);
+    SSFSMTask(&nextTimeout);
+    SSF_ASSERT(nextTimeout == SSF_SM_MAX_TIMEOUT);
+
+    SSFSMGetProfile(p);
+    SSF_ASSERT(p->states[SSF_SM_UNIT_TEST_1][0].state == UTProfHandlerA);
+    SSF_ASSERT(p->states[SSF_SM_UNIT_TEST_1][0].entries == 1);
+    SSF_ASSERT(p->states[SSF_SM_UNIT_TEST_1][1].state == UTProfHandlerB);
+    SSF_ASSERT(p->states[SSF_SM_UNIT_TEST_1][1].entries == 1);
+    SSF_ASSERT(p->statesDropped == 0);
+    dwell = p->states[SSF_SM_UNIT_TEST_1][0].dwell + p->states[SSF_SM_UNIT_TEST_1][1].dwell;
+    SSF_ASSERT(dwell <= p->elapsed);
+
+    pe = &(p->events[SSF_SM_EVENT_UNIT_TEST_1]);
+    SSF_ASSERT(pe->count == 2);
+    SSF_ASSERT(pe->handlerMax <= pe->handlerTotal);
+    SSF_ASSERT(_SSFSMUTProfileHistSum(pe->queueDelay) == 2);
+    SSF_ASSERT(_SSFSMUTProfileHistSum(pe->handlerTime) == 2);
+    pe = &(p->events[SSF_SM_EVENT_UNIT_TEST_2]);
+    SSF_ASSERT(pe->count == 1);
+    SSF_ASSERT(_SSFSMUTProfileHistSum(pe->queueDelay) == 1);
+    SSF_ASSERT(p->events[SSF_SM_EVENT_ENTRY].count == 0);
+    SSF_ASSERT(p->timersFired == 1);
+    SSF_ASSERT(_SSFSMUTProfileHistSum(p->timerLateness) == 1);
+
+    /* Printed report covers states, events and timers */
+    _ssfsmUTProfileOutLen = 0;
+    SSFSMProfilePrint(p, _SSFSMUTProfileWrite);
+    SSF_ASSERT(strstr(_ssfsmUTProfileOut, "State machine profile over ") == _ssfsmUTProfileOut);
+    SSF_ASSERT(strstr(_ssfsmUTProfileOut, "entries 1, dwell ") != NULL);
+    SSF_ASSERT(strstr(_ssfsmUTProfileOut, "count 2, avg ") != NULL);
+    SSF_ASSERT(strstr(_ssfsmUTProfileOut, "queued ns:") != NULL);
+    SSF_ASSERT(strstr(_ssfsmUTProfileOut, "timers fired 1\r\n") != NULL);
+    SSF_ASSERT(strstr(_ssfsmUTProfileOut, "late ns:") != NULL);
+
+#if SSF_SM_CONFIG_ENABLE_PROFILE_CLI == 1
+    /* CLI command prints, and with //reset clears, the default executor's profile */
+    SSF_ASSERT(_SSFSMUTProfileCLI("smprof extra") == false);
+    SSF_ASSERT(_SSFSMUTProfileCLI("smprof //other") == false);
+    SSF_ASSERT(_SSFSMUTProfileCLI("smprof"));
+    SSF_ASSERT(strstr(_ssfsmUTProfileOut, "timers fired 1\r\n") != NULL);
+    SSF_ASSERT(_SSFSMUTProfileCLI("smprof //reset"));
+    SSF_ASSERT(strstr(_ssfsmUTProfileOut, "timers fired 1\r\n") != NULL);
+    SSF_ASSERT(_SSFSMUTProfileCLI("smprof"));
+    SSF_ASSERT(strstr(_ssfsmUTProfileOut, "timers fired 0\r\n") != NULL);
+    SSF_ASSERT(strstr(_ssfsmUTProfileOut, "event ") == NULL);
+#endif /* SSF_SM_CONFIG_ENABLE_PROFILE_CLI */
+
+    /* Leaving the state ends its dwell */
+    SSFSMDeInitHandler(SSF_SM_UNIT_TEST_1);
+    SSFSMGetProfile(p);
+    dwell = p->states[SSF_SM_UNIT_TEST_1][0].dwell;
+    SSFSMGetProfile(p);
+    SSF_ASSERT(p->states[SSF_SM_UNIT_TEST_1][0].dwell == dwell);
+    SSFSMDeInit();
+}
+#endif /* SSF_SM_CONFIG_ENABLE_PROFILE */
+
+#if SSF_SM_EPOLL == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Epoll test handler, drains ready file descriptors and counts timer and wake events.           */
+/* --------------------------------------------------------------------------------------------- */
+void UTEpollHandler(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+                    SSFVoidFn_t *superHandler)
+{
+    SSFSMEpollEvent_t d;
+    uint8_t buf[16];
+    ssize_t n;
+
+    SSF_UNUSED_PTR(superHandler);
+
+    switch (eid)
+    {
+    case SSF_SM_EVENT_UNIT_TEST_1:
+        SSF_ASSERT(dataLen == sizeof(d));
+        memcpy(&d, data, sizeof(d));
+        SSF_ASSERT(_ssfsmUTEpollNumReady < SSFSM_UT_EPOLL_MAX_READY);
+        _ssfsmUTEpollReady[_ssfsmUTEpollNumReady] = d;
+        _ssfsmUTEpollNumReady++;
+        if ((d.events & EPOLLIN) == 0) break;
+        n = read(d.fd, buf, sizeof(buf));
+        SSF_ASSERT(n >= 0);
+        _ssfsmUTEpollBytes += (size_t)n;
+        break;
+    case SSF_SM_EVENT_UNIT_TEST_2:
+        _ssfsmUTEpollTimers++;
+        break;
+    case SSF_SM_EVENT_UTX_1:
+        SSFSMStartTimer(SSF_SM_EVENT_UNIT_TEST_2, SSFSM_UT_EPOLL_TIMER);
+        break;
+    case SSF_SM_EVENT_UTX_2:
+        _ssfsmUTEpollWakes++;
+        break;
+    default:
+        break;
+    }
+}
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Posts an event while the epoll loop is blocked.                                               */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFSMUTEpollThread(void *arg)
+{
+    struct timespec ts = { 0, 50000000l };
+
+    SSF_UNUSED_PTR(arg);
+
+    nanosleep(&ts, NULL);
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_2);
+    return NULL;
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/* Clears the record of ready file descriptors delivered to the epoll test handler.              */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTEpollClear(void)
+{
+    memset(_ssfsmUTEpollReady, 0, sizeof(_ssfsmUTEpollReady));
+    _ssfsmUTEpollNumReady = 0;
+    _ssfsmUTEpollBytes = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Verifies ready file descriptors post events and timers bound how long the epoll loop waits.   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTEpoll(void)
+{
+    SSFSMEpoll_t ep;
+    int p[2];
+    int sv[2];
+    uint64_t start;
+    uint64_t elapsed;
+#if SSF_SM_LOCK_FREE == 1
+    uint64_t count;
+#endif
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    pthread_t thread;
+#endif
+
+    memset(&ep, 0, sizeof(ep));
+    SSF_ASSERT_TEST(SSFSMEpollInit(NULL));
+    SSF_ASSERT_TEST(SSFSMEpollTask(&ep, 0));
+    SSF_ASSERT_TEST(SSFSMEpollDeInit(&ep));
+
+    SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+    SSFSMInitHandler(SSF_SM_UNIT_TEST_1, UTEpollHandler);
+    SSFSMEpollInit(&ep);
+    SSF_ASSERT_TEST(SSFSMEpollInit(&ep));
+    SSF_ASSERT_TEST(SSFSMDeInit());
+    SSF_ASSERT(pipe(p) == 0);
+    SSF_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+
+    SSF_ASSERT_TEST(SSFSMEpollAdd(&ep, p[0], EPOLLIN, SSF_SM_MAX, SSF_SM_EVENT_UNIT_TEST_1));
+    SSF_ASSERT_TEST(SSFSMEpollAdd(&ep, p[0], EPOLLIN, SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_EXIT));
+    SSF_ASSERT(SSFSMEpollAdd(&ep, -1, EPOLLIN, SSF_SM_UNIT_TEST_1,
+                             SSF_SM_EVENT_UNIT_TEST_1) == false);
+    SSF_ASSERT(SSFSMEpollAdd(&ep, p[0], EPOLLIN, SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UNIT_TEST_1));
+    SSF_ASSERT(SSFSMEpollAdd(&ep, p[0], EPOLLIN, SSF_SM_UNIT_TEST_1,
+                             SSF_SM_EVENT_UNIT_TEST_1) == false);
+    SSF_ASSERT(SSFSMEpollAdd(&ep, sv[0], EPOLLIN, SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UNIT_TEST_1));
+
+    /* Nothing ready, nothing posted */
+    _SSFSMUTEpollClear();
+    SSF_ASSERT(SSFSMEpollTask(&ep, 0) == false);
+    SSF_ASSERT(_ssfsmUTEpollNumReady == 0);
+
+    /* A ready pipe posts its fd to the state machine */
+    SSF_ASSERT(write(p[1], "abc", 3) == 3);
+    SSF_ASSERT(SSFSMEpollTask(&ep, 0) == false);
+    SSF_ASSERT(_ssfsmUTEpollNumReady == 1);
+    SSF_ASSERT(_ssfsmUTEpollReady[0].fd == p[0]);
+    SSF_ASSERT(_ssfsmUTEpollReady[0].events == EPOLLIN);
+    SSF_ASSERT(_ssfsmUTEpollBytes == 3);
+
+    /* Drained fds are not posted again */
+    _SSFSMUTEpollClear();
+    SSF_ASSERT(SSFSMEpollTask(&ep, 0) == false);
+    SSF_ASSERT(_ssfsmUTEpollNumReady == 0);
+
+    /* Several ready fds are dispatched in one pass */
+    SSF_ASSERT(write(p[1], "de", 2) == 2);
+    SSF_ASSERT(write(sv[1], "fghi", 4) == 4);
+    SSF_ASSERT(SSFSMEpollTask(&ep, 0) == false);
+    SSF_ASSERT(_ssfsmUTEpollNumReady == 2);
+    SSF_ASSERT(((_ssfsmUTEpollReady[0].fd == p[0]) && (_ssfsmUTEpollReady[1].fd == sv[0])) ||
+               ((_ssfsmUTEpollReady[0].fd == sv[0]) && (_ssfsmUTEpollReady[1].fd == p[0])));
+    SSF_ASSERT(_ssfsmUTEpollBytes == 6);
+
+#if SSF_SM_LOCK_FREE == 1
+    /* Posts made by the loop itself do not write its wake fd */
+    SSF_ASSERT((read(ep.wakeFd, &count, sizeof(count)) < 0) && (errno == EAGAIN));
+#endif
+
+    /* Peer close is reported as a hang up */
+    _SSFSMUTEpollClear();
+    SSF_ASSERT(close(sv[1]) == 0);
+    SSF_ASSERT(SSFSMEpollTask(&ep, 0) == false);
+    SSF_ASSERT(_ssfsmUTEpollNumReady == 1);
+    SSF_ASSERT(_ssfsmUTEpollReady[0].fd == sv[0]);
+    SSF_ASSERT((_ssfsmUTEpollReady[0].events & EPOLLHUP) != 0);
+    SSF_ASSERT(_ssfsmUTEpollBytes == 0);
+    SSF_ASSERT(SSFSMEpollRemove(&ep, sv[0]));
+    SSF_ASSERT(SSFSMEpollRemove(&ep, sv[0]) == false);
+    _SSFSMUTEpollClear();
+    SSF_ASSERT(SSFSMEpollTask(&ep, 0) == false);
+    SSF_ASSERT(_ssfsmUTEpollNumReady == 0);
+
+    /* Waits until the next timer expires but no longer */
+    _ssfsmUTEpollTimers = 0;
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_1);
+    start = SSFPortGetTick64();
+    while (SSFSMEpollTask(&ep, SSF_SM_MAX_TIMEOUT)) { }
+    elapsed = SSFPortGetTick64() - start;
+    SSF_ASSERT(_ssfsmUTEpollTimers == 1);
+    SSF_ASSERT((elapsed >= SSFSM_UT_EPOLL_TIMER) && (elapsed < SSF_TICKS_PER_SEC));
+
+    /* Waits no longer than maxWait */
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_1);
+    SSF_ASSERT(SSFSMEpollTask(&ep, 0));
+    SSF_ASSERT(_ssfsmUTEpollTimers == 1);
+    while (SSFSMEpollTask(&ep, SSF_SM_MAX_TIMEOUT)) { }
+    SSF_ASSERT(_ssfsmUTEpollTimers == 2);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    /* An event posted by another thread wakes the blocked loop */
+    _ssfsmUTEpollWakes = 0;
+    SSF_ASSERT(pthread_create(&thread, NULL, _SSFSMUTEpollThread, NULL) == 0);
+    start = SSFPortGetTick64();
+    while (_ssfsmUTEpollWakes == 0) SSFSMEpollTask(&ep, 10 * SSF_TICKS_PER_SEC);
+    elapsed = SSFPortGetTick64() - start;
+    SSF_ASSERT(elapsed < SSF_TICKS_PER_SEC);
+    SSF_ASSERT(pthread_join(thread, NULL) == 0);
+#endif
+
+    SSF_ASSERT(SSFSMEpollRemove(&ep, p[0]));
+    SSFSMEpollDeInit(&ep);
+    SSF_ASSERT(close(p[0]) == 0);
+    SSF_ASSERT(close(p[1]) == 0);
+    SSF_ASSERT(close(sv[0]) == 0);
+    SSFSMDeInit();
+}
+#endif /* SSF_SM_EPOLL */
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+/* --------------------------------------------------------------------------------------------- */
+/* State machine 4 test handler 3, verifies per producer ordering of multi-producer events.      */
+/* --------------------------------------------------------------------------------------------- */
+void UT4TestHandler3(SSFSMEventId_t eid, const SSFSMData_t *data, SSFSMDataLen_t dataLen,
+                     SSFVoidFn_t *superHandler)
+{
+    SSFSMUTMPData_t d;
+
+    SSF_UNUSED_PTR(superHandler);
+
+    switch (eid)
+    {
+    case SSF_SM_EVENT_UTX_1:
+        SSF_ASSERT(dataLen == sizeof(d));
+        memcpy(&d, data, sizeof(d));
+        SSF_ASSERT(d.producer < SSFSM_UT_MP_NUM_PRODUCERS);
+        SSF_ASSERT(d.check == (d.producer ^ d.seq));
+        SSF_ASSERT(_ssfsmUTMPNextSeq[d.producer] == d.seq);
+        _ssfsmUTMPNextSeq[d.producer]++;
+        _ssfsmUTMPReceived++;
+        break;
+    default:
+        break;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Producer thread, posts events with data to state machine 4.                                   */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFSMUTProducerThread(void *arg)
+{
+    SSFSMUTMPData_t d;
+    uint32_t i;
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    uint64_t start;
+#endif
+
+    d.producer = (uint32_t)(uintptr_t)arg;
+    for (i = 0; i < SSFSM_UT_MP_EVENTS_PER_PRODUCER; i++)
+    {
+        d.seq = i;
+        d.check = d.producer ^ i;
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+        start = SSFPortGetHRTick64();
+#endif
+        SSFSMPutEventData(SSF_SM_UNIT_TEST_4, SSF_SM_EVENT_UTX_1, (SSFSMData_t *)&d, sizeof(d));
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+        _ssfsmUTMPLatency[(d.producer * SSFSM_UT_MP_EVENTS_PER_PRODUCER) + i] =
+            SSFPortGetHRTick64() - start;
+#endif
+    }
+    return NULL;
+}
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Returns <0, 0, >0 for qsort() on uint64_t.                                                    */
+/* --------------------------------------------------------------------------------------------- */
+static int _SSFSMUTCmpU64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/* Posts events from many threads while the main thread runs SSFSMTask().                        */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSMUTMultiProducer(void)
+{
+    pthread_t threads[SSFSM_UT_MP_NUM_PRODUCERS];
+    uint32_t total = SSFSM_UT_MP_NUM_PRODUCERS * SSFSM_UT_MP_EVENTS_PER_PRODUCER;
+    uint32_t i;
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    SSF_ASSERT((_ssfsmUTMPLatency = (uint64_t *)malloc(total * sizeof(uint64_t))) != NULL);
+#endif
+    memset(_ssfsmUTMPNextSeq, 0, sizeof(_ssfsmUTMPNextSeq));
+    _ssfsmUTMPReceived = 0;
+
+    /* Size event pool so producers can never exhaust it */
+    SSFSMInit(total, SSFSM_UT_MAX_TIMERS);
+    SSFSMInitHandler(SSF_SM_UNIT_TEST_4, UT4TestHandler3);
+
+    for (i = 0; i < SSFSM_UT_MP_NUM_PRODUCERS; i++)
+    {
+        SSF_ASSERT(pthread_create(&threads[i], NULL, _SSFSMUTProducerThread,
+                                  (void *)(uintptr_t)i) == 0);
+    }
+    while (_ssfsmUTMPReceived < total)
+    {
+        SSF_SM_THREAD_WAKE_WAIT(SSF_TICKS_PER_SEC);
+        SSFSMTask(NULL);
+    }
+    for (i = 0; i < SSFSM_UT_MP_NUM_PRODUCERS; i++)
+    { SSF_ASSERT(pthread_join(threads[i], NULL) == 0); }
+
+    SSF_ASSERT(SSFSMTask(NULL) == false);
+    SSF_ASSERT(_ssfsmUTMPReceived == total);
+    for (i = 0; i < SSFSM_UT_MP_NUM_PRODUCERS; i++)
+    { SSF_ASSERT(_ssfsmUTMPNextSeq[i] == SSFSM_UT_MP_EVENTS_PER_PRODUCER); }
+    SSFSMDeInit();
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    qsort(_ssfsmUTMPLatency, total, sizeof(uint64_t), _SSFSMUTCmpU64);
+    printf("\r\n  SSFSMPutEventData() latency, %u producers: "
+           "p50=%lluns p99=%lluns p99.9=%lluns max=%lluns\r\n",
+           (unsigned int)SSFSM_UT_MP_NUM_PRODUCERS,
+           (unsigned long long)(_ssfsmUTMPLatency[(total * 50ull) / 100] *
+                                1000000000ull / SSF_HR_TICKS_PER_SEC),
+           (unsigned long long)(_ssfsmUTMPLatency[(total * 99ull) / 100] *
+                                1000000000ull / SSF_HR_TICKS_PER_SEC),
+           (unsigned long long)(_ssfsmUTMPLatency[(total * 999ull) / 1000] *
+                                1000000000ull / SSF_HR_TICKS_PER_SEC),
+           (unsigned long long)(_ssfsmUTMPLatency[total - 1] *
+                                1000000000ull / SSF_HR_TICKS_PER_SEC));
+    free(_ssfsmUTMPLatency);
+    _ssfsmUTMPLatency = NULL;
+#endif
+}
+#endif /* (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32) */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Performs unit test on ssfll's external interface.                                             */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSMUnitTest(void)
+{
+    SSFSMTimeout_t nextTimeout;
+    SSFSMTimeout_t lastTimeout;
+    SSFSMTimeout_t start;
+    SSFSMTimeout_t delta;
+
+    SSF_ASSERT_TEST(SSFSMDeInit());
+    memset(_ssfsmFlags, 0, sizeof(_ssfsmFlags));
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    SSF_ASSERT_TEST(SSFSMInitHandler(SSF_SM_UNIT_TEST_1, UT1TestHandler1));
+    SSF_ASSERT_TEST(SSFSMInitHandler(SSF_SM_UNIT_TEST_2, UT2TestHandler1));
+    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UT1_1));
+    SSF_ASSERT_TEST(SSFSMTask(NULL));
+    SSF_ASSERT_TEST(SSFSMTask(&nextTimeout));
+
+    SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    start = SSFPortGetTick64();
+    SSF_SM_THREAD_WAKE_WAIT(SSF_TICKS_PER_SEC);
+    delta = SSFPortGetTick64() - start;
+    SSF_ASSERT((delta > (SSF_TICKS_PER_SEC * 0.9)) && (delta < (SSF_TICKS_PER_SEC * 1.1)));
+#endif
+
+    SSF_ASSERT_TEST(SSFSMInit(SSFSM_UT_MAX_EVENTS, SSFSM_UT_MAX_TIMERS));
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    SSFSMInitHandler(SSF_SM_UNIT_TEST_1, UT1TestHandler1);
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_ENTRY);
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UT1_1);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    start = SSFPortGetTick64();
+    SSF_SM_THREAD_WAKE_WAIT(SSF_TICKS_PER_SEC);
+    delta = SSFPortGetTick64() - start;
+    SSF_ASSERT(delta < (SSF_TICKS_PER_SEC * 0.1));
+
+    start = SSFPortGetTick64();
+    SSF_SM_THREAD_WAKE_WAIT(SSF_TICKS_PER_SEC);
+    delta = SSFPortGetTick64() - start;
+    SSF_ASSERT((delta > (SSF_TICKS_PER_SEC * 0.9)) && (delta < (SSF_TICKS_PER_SEC * 1.1)));
+#endif
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    while (SSFSMTask(NULL));
+#endif
+
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UT1_1);
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    SSFSMInitHandler(SSF_SM_UNIT_TEST_2, UT2TestHandler1);
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_2, 0, SSF_SM_EVENT_ENTRY);
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+
+    SSF_ASSERT_TEST(SSFSMTran(UT1TestHandler2));
+    SSF_ASSERT_TEST(SSFSMStartTimerData(SSF_SM_EVENT_UT1_1, 1, (SSFSMData_t *)"a", 1));
+    SSF_ASSERT_TEST(SSFSMStartTimer(SSF_SM_EVENT_UT1_1, 1));
+    SSF_ASSERT_TEST(SSFSMStopTimer(SSF_SM_EVENT_UT1_1));
+    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_MIN, SSF_SM_EVENT_UT1_1));
+    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_MAX, SSF_SM_EVENT_UT1_1));
+    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MIN));
+    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MAX));
+    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_ENTRY));
+    SSF_ASSERT_TEST(SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_EXIT));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_MIN, SSF_SM_EVENT_UT1_1, NULL, 0));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_MAX, SSF_SM_EVENT_UT1_1, NULL, 0));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MIN, NULL, 0));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MAX, NULL, 0));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_ENTRY, NULL, 0));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_EXIT, NULL, 0));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UT1_1, (SSFSMData_t *)"a", 0));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UT1_1, NULL, 1));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_MIN, SSF_SM_EVENT_UT1_1, (SSFSMData_t *)"a", 1));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_MAX, SSF_SM_EVENT_UT1_1, (SSFSMData_t *)"a", 1));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MIN, (SSFSMData_t *)"a", 1));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MAX, (SSFSMData_t *)"a", 1));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_ENTRY, (SSFSMData_t *)"a", 1));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_EXIT, (SSFSMData_t *)"a", 1));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_MIN, SSF_SM_EVENT_UT1_1,
+                                      (SSFSMData_t *)"1234567890", 10));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_MAX, SSF_SM_EVENT_UT1_1,
+                                      (SSFSMData_t *)"1234567890", 10));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MIN,
+                                      (SSFSMData_t *)"1234567890", 10));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_MAX,
+                                      (SSFSMData_t *)"1234567890", 10));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_ENTRY,
+                                      (SSFSMData_t *)"1234567890", 10));
+    SSF_ASSERT_TEST(SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_EXIT,
+                                      (SSFSMData_t *)"1234567890", 10));
+    SSF_ASSERT(SSFSMTask(NULL) == false);
+    nextTimeout = 0;
+    SSF_ASSERT(SSFSMTask(&nextTimeout) == false);
+    SSF_ASSERT(nextTimeout == SSF_SM_MAX_TIMEOUT);
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UT1_2);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    while (SSFSMTask(NULL));
+#endif
+
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UT1_2);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    while (SSFSMTask(NULL));
+#else
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    nextTimeout = 0;
+    SSF_ASSERT(SSFSMTask(&nextTimeout) == false);
+    SSF_ASSERT(nextTimeout == SSF_SM_MAX_TIMEOUT);
+#endif
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UT1_1);
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UTX_1);
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_2, 0, SSF_SM_EVENT_UT1_1);
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_2, 0, SSF_SM_EVENT_UT1_2);
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    SSFSMPutEvent(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_2);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    while (SSFSMTask(NULL));
+#endif
+
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UTX_2);
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_2, NULL, 0);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    while (SSFSMTask(NULL));
+#endif
+
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UTX_2);
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_2, (SSFSMData_t *)"a", 1);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    while (SSFSMTask(NULL));
+#endif
+
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UTX_2);
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_EXIT);
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 1, SSF_SM_EVENT_ENTRY);
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_2, NULL, 0);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    while (SSFSMTask(NULL));
+#endif
+
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 1, SSF_SM_EVENT_UTX_2);
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_2, (SSFSMData_t *)"a", 1);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    while (SSFSMTask(NULL));
+#endif
+
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 1, SSF_SM_EVENT_UTX_2);
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_2, (SSFSMData_t *)"1234567890", 10);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    while (SSFSMTask(NULL));
+#endif
+
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 1, SSF_SM_EVENT_UTX_2);
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 1, SSF_SM_EVENT_EXIT);
+    SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_ENTRY);
+    SSF_ASSERT(_SSFSMFlagsAreCleared());
+    start = SSFPortGetTick64();
+    SSFSMPutEventData(SSF_SM_UNIT_TEST_1, SSF_SM_EVENT_UTX_1, (SSFSMData_t *)"t", 1);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSFSMTask(NULL);
+#endif
 
     SSF_ASSERT_CLEAR(SSF_SM_UNIT_TEST_1, 0, SSF_SM_EVENT_UTX_1);
     SSF_ASSERT(_SSFSMFlagsAreCleared());
@@ -837,5 +2349,44 @@ void SSFSMUnitTest(void)
     /* End test */
     SSFSMDeInit();
     SSF_ASSERT_TEST(SSFSMDeInit());
+
+    /* Verify state machines can be split across executors */
+    _SSFSMUTExec();
+
+    /* Verify event data is pooled and only allocated from the heap when it does not fit */
+    _SSFSMUTEventData();
+
+    /* Verify events are processed by priority within a time budget */
+    _SSFSMUTPriority();
+
+#if SSF_SM_CONFIG_ENABLE_COALESCE == 1
+    /* Verify replaceable events are coalesced */
+    _SSFSMUTCoalesce();
+#endif
+
+#if SSF_SM_TRAN_CACHE_SIZE > 0
+    /* Verify cached transitions run the same exits and entries */
+    _SSFSMUTTranCache();
+#endif
+
+#if SSF_SM_CONFIG_ENABLE_TICK_SOURCE == 1
+    /* Verify timers run on a virtual clock that jumps to the next expiry */
+    _SSFSMUTSim();
+#endif
+
+#if SSF_SM_EPOLL == 1
+    /* Verify ready file descriptors and timers drive the epoll loop */
+    _SSFSMUTEpoll();
+#endif
+
+#if SSF_SM_CONFIG_ENABLE_PROFILE == 1
+    /* Verify state dwell, event latency and timer lateness are profiled */
+    _SSFSMUTProfile();
+#endif
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+    /* Verify events posted concurrently by many threads are all delivered in per thread order */
+    _SSFSMUTMultiProducer();
+#endif
 }
 #endif /* SSF_CONFIG_SM_UNIT_TEST */
@@ -31,10 +31,20 @@
 /* --------------------------------------------------------------------------------------------- */
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "ssfport.h"
 #include "ssfassert.h"
 #include "ssfcfg.h"
 #include "ssfcrc16.h"
+#if SSF_CFG_ENABLE_COMPRESSION == 1
+#include "ssflz.h"
+#endif
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 /* --------------------------------------------------------------------------------------------- */
 /* Defines                                                                                       */
@@ -45,171 +55,1807 @@ SSF_CFG_TYPEDEF_STRUCT SSFCfgHeader
     dataId_t dataId;
     dataVersion_t dataVersion;
     uint16_t dataCRC;
-    uint32_t magic;
+    uint32_t magic; /* SSF_CFG_MAGIC, or SSF_CFG_MAGIC_LZ if the data is compressed */
     /* ...data follows */
 } SSFCfgHeader_t;
 
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+SSF_CFG_TYPEDEF_STRUCT SSFCfgLogSector
+{
+    uint32_t magic;
+    uint32_t seq; /* Log sequence number when the sector was formatted */
+    uint16_t crc; /* CRC of the fields above */
+} SSFCfgLogSector_t;
+
+SSF_CFG_TYPEDEF_STRUCT SSFCfgLogRecord
+{
+    SSFCfgHeader_t header;
+    uint32_t seq; /* Log sequence number, the highest record of a dataId is its latest */
+    uint16_t crc; /* CRC of the fields above */
+    /* ...data follows */
+} SSFCfgLogRecord_t;
+
+/* Data of a transaction record is a packed sequence of entries */
+SSF_CFG_TYPEDEF_STRUCT SSFCfgLogTxEntry
+{
+    dataId_t dataId;
+    dataVersion_t dataVersion;
+    uint16_t dataLen;
+    uint16_t dataCRC;
+    /* ...data follows */
+} SSFCfgLogTxEntry_t;
+
+typedef enum
+{
+    SSF_CFG_LOG_REC_VALID, /* Header and data intact */
+    SSF_CFG_LOG_REC_TORN,  /* Header intact, data write interrupted */
+    SSF_CFG_LOG_REC_END,   /* No further records in the sector */
+} SSFCfgLogRecStatus_t;
+#endif /* SSF_CFG_ENABLE_LOG_STORAGE */
+
 #define SSF_CFG_STORAGE_LIMIT (65536ul)
 #if SSF_CFG_MAX_STORAGE_SIZE > SSF_CFG_STORAGE_LIMIT
 #error SSF_CFG_MAX_STORAGE_SIZE must be <= SSF_CFG_STORAGE_LIMIT
 #endif
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+#if SSF_CFG_LOG_NUM_SECTORS < 2
+#error SSF_CFG_LOG_NUM_SECTORS must be >= 2
+#endif
+#if (SSF_CFG_ENABLE_STORAGE_RAM == 1) && (SSF_CFG_LOG_NUM_SECTORS > SSF_MAX_CFG_RAM_SECTORS)
+#error SSF_CFG_LOG_NUM_SECTORS must be <= SSF_MAX_CFG_RAM_SECTORS
+#endif
+#if (SSF_CFG_MAX_STORAGE_SIZE % 4u) != 0
+#error SSF_CFG_MAX_STORAGE_SIZE must be a multiple of 4
+#endif
+#define SSF_CFG_LOG_ALIGN(len) (((len) + 3u) & ~((size_t)3u))
+#define SSF_CFG_LOG_FIRST SSF_CFG_LOG_ALIGN(sizeof(SSFCfgLogSector_t))
+#define SSF_MAX_CFG_DATA_SIZE \
+    (SSF_CFG_MAX_STORAGE_SIZE - SSF_CFG_LOG_FIRST - sizeof(SSFCfgLogRecord_t))
+#define SSF_CFG_MAX_DATA_IDS SSF_CFG_LOG_MAX_IDS
+#define SSF_CFG_LOG_SECTOR_MAGIC (0x474F4C53ul)
+#define SSF_CFG_LOG_LOC_NONE (0xfffffffful)
+#define SSF_CFG_LOG_LOC_TX (0x80000000ul) /* Location is a transaction entry */
+#define SSF_CFG_LOG_LOC(sector, offset) \
+    ((uint32_t)(((sector) * SSF_CFG_MAX_STORAGE_SIZE) + (offset)))
+#define SSF_CFG_LOG_GC_FREE (SSF_CFG_MAX_STORAGE_SIZE / 4u)
+#define SSF_CFG_LOG_TX_ID (0xfffffffeul) /* dataId of a transaction record */
+#if (SSF_CFG_LOG_NUM_SECTORS * SSF_CFG_MAX_STORAGE_SIZE) >= SSF_CFG_LOG_LOC_TX
+#error SSF_CFG_LOG_NUM_SECTORS * SSF_CFG_MAX_STORAGE_SIZE too large for log locations
+#endif
+#else
 #define SSF_MAX_CFG_DATA_SIZE (SSF_CFG_MAX_STORAGE_SIZE - sizeof(SSFCfgHeader_t))
+#define SSF_CFG_MAX_DATA_IDS SSF_MAX_CFG_RAM_SECTORS
+#endif /* SSF_CFG_ENABLE_LOG_STORAGE */
 #define SSF_CFG_MAGIC (0x52504F57ul)
+#define SSF_CFG_MAGIC_LZ (0x5A4C4F57ul)
+#define SSF_CFG_IS_MAGIC(magic) (((magic) == SSF_CFG_MAGIC) || ((magic) == SSF_CFG_MAGIC_LZ))
+
+/* Sector writes otherwise run in parallel, but a compressed write holds the one encoder buffer */
+/* until it is written, and file storage shares the range of the file not yet synced          */
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && (SSF_CFG_ENABLE_LOG_STORAGE == 0) && \
+    ((SSF_CFG_ENABLE_COMPRESSION == 1) || (SSF_CFG_STORAGE_FILE == 1))
+#define SSF_CFG_WRITE_SYNC (1u)
+#else
+#define SSF_CFG_WRITE_SYNC (0u)
+#endif
+
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+typedef struct SSFCfgCacheEntry
+{
+    uint32_t seq; /* Odd while the entry is being changed, lets reads skip the lock */
+    bool isValid;
+    uint16_t dataLen;
+    dataVersion_t dataVersion;
+    uint16_t dataCRC;
+    uint8_t data[SSF_CFG_READ_CACHE_MAX_DATA_LEN];
+} SSFCfgCacheEntry_t;
+#endif /* SSF_CFG_ENABLE_READ_CACHE */
+
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+typedef enum
+{
+    SSF_CFG_QUEUE_FREE,
+    SSF_CFG_QUEUE_PENDING,  /* Waiting for SSFCfgTask() */
+    SSF_CFG_QUEUE_WRITING,  /* Being written by SSFCfgTask(), reads still see it */
+    SSF_CFG_QUEUE_CANCELED, /* Superseded by a synchronous write, completes as not written */
+} SSFCfgQueueState_t;
+
+typedef struct SSFCfgQueueEntry
+{
+    SSFCfgQueueState_t state;
+    uint32_t seq; /* Order queued, the oldest entry is completed first */
+    uint16_t dataLen;
+    dataVersion_t dataVersion;
+    SSFCfgWriteDoneFn_t done;
+    void *doneParam;
+    uint8_t data[SSF_CFG_QUEUE_MAX_DATA_LEN];
+} SSFCfgQueueEntry_t;
+#endif /* SSF_CFG_ENABLE_WRITE_QUEUE */
 
 /* --------------------------------------------------------------------------------------------- */
 /* Virtual NV Storage in RAM                                                                     */
 /* --------------------------------------------------------------------------------------------- */
 #if SSF_CFG_ENABLE_STORAGE_RAM == 1
 uint8_t _ssfCfgStorageRAM[SSF_MAX_CFG_RAM_SECTORS][SSF_CFG_MAX_STORAGE_SIZE];
+uint32_t _ssfCfgStorageRAMErases[SSF_MAX_CFG_RAM_SECTORS];
+uint32_t _ssfCfgStorageRAMPowerFail = UINT32_MAX; /* Bytes erased or written until power loss */
+uint32_t _ssfCfgStorageRAMReadDelay; /* HR ticks each read takes, simulates slow flash */
+uint32_t _ssfCfgStorageRAMWriteDelay; /* HR ticks each byte programmed takes */
+static uint8_t (*_ssfCfgStorage)[SSF_CFG_MAX_STORAGE_SIZE] = _ssfCfgStorageRAM;
 #endif
 
+#if SSF_CFG_STORAGE_FILE == 1
+static int _ssfCfgFileFd = -1;
+static SSFCfgFileDurability_t _ssfCfgFileDurability;
+static size_t _ssfCfgFileDirtyStart;
+static size_t _ssfCfgFileDirtyEnd;
+static uint32_t _ssfCfgFileUnsynced;
+#endif /* SSF_CFG_STORAGE_FILE */
+
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+static uint32_t _ssfCfgLogLoc[SSF_CFG_LOG_MAX_IDS];
+static uint32_t _ssfCfgLogLocSeq[SSF_CFG_LOG_MAX_IDS];
+static uint16_t _ssfCfgLogLocLen[SSF_CFG_LOG_MAX_IDS];
+static uint32_t _ssfCfgLogActive;
+static size_t _ssfCfgLogOffset;
+static uint32_t _ssfCfgLogSeq;
+static bool _ssfCfgLogIsMounted;
+static uint8_t _ssfCfgTxBuf[SSF_CFG_TX_MAX_SIZE];
+static size_t _ssfCfgTxLen;
+static bool _ssfCfgTxIsOpen;
+#endif /* SSF_CFG_ENABLE_LOG_STORAGE */
+
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+static SSFCfgCacheEntry_t _ssfCfgCache[SSF_CFG_MAX_DATA_IDS];
+#endif /* SSF_CFG_ENABLE_READ_CACHE */
+
+#if SSF_CFG_ENABLE_COMPRESSION == 1
+static SSFLZEncodeContext_t _ssfCfgLZContext;
+static uint8_t _ssfCfgLZBuf[SSF_MAX_CFG_DATA_SIZE];
+#endif /* SSF_CFG_ENABLE_COMPRESSION */
+
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+static SSFCfgQueueEntry_t _ssfCfgQueue[SSF_CFG_MAX_DATA_IDS];
+static uint32_t _ssfCfgQueueLen; /* Entries not free, reads skip the queue while it is 0 */
+static uint32_t _ssfCfgQueueSeq;
+#endif /* SSF_CFG_ENABLE_WRITE_QUEUE */
+
 #if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
 bool _ssfcfgIsInited; 
 SSF_CFG_THREAD_SYNC_DECLARATION;
+#if SSF_CFG_ENABLE_LOG_STORAGE == 0
+SSF_CFG_SECTOR_SYNC_DECLARATION;
+#endif /* SSF_CFG_ENABLE_LOG_STORAGE */
+#if SSF_CFG_WRITE_SYNC == 1
+SSF_CFG_WRITE_SYNC_DECLARATION;
+#endif /* SSF_CFG_WRITE_SYNC */
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+SSF_CFG_QUEUE_SYNC_DECLARATION;
+#endif /* SSF_CFG_ENABLE_WRITE_QUEUE */
 #endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+#if SSF_CFG_STORAGE_FILE == 1
 /* --------------------------------------------------------------------------------------------- */
-/* Initializes the ssfcfg interface.                                                             */
+/* Adds len bytes at offset of the mapped file to the range not yet synced.                      */
 /* --------------------------------------------------------------------------------------------- */
-void SSFCfgInit(void)
+static void _SSFCfgFileDirty(size_t offset, size_t len)
 {
-    SSF_ASSERT(_ssfcfgIsInited == false);
-    SSF_CFG_THREAD_SYNC_INIT();
-    _ssfcfgIsInited = true;
+    if ((_ssfCfgFileFd < 0) || (len == 0)) return;
+#if (SSF_CFG_WRITE_SYNC == 1) && (SSF_CFG_ENABLE_COMPRESSION == 0)
+    SSF_CFG_WRITE_SYNC_ACQUIRE();
+#endif
+    if (_ssfCfgFileDirtyStart == _ssfCfgFileDirtyEnd)
+    {
+        _ssfCfgFileDirtyStart = offset;
+        _ssfCfgFileDirtyEnd = offset + len;
+    }
+    else
+    {
+        if (offset < _ssfCfgFileDirtyStart) _ssfCfgFileDirtyStart = offset;
+        if ((offset + len) > _ssfCfgFileDirtyEnd) _ssfCfgFileDirtyEnd = offset + len;
+    }
+#if (SSF_CFG_WRITE_SYNC == 1) && (SSF_CFG_ENABLE_COMPRESSION == 0)
+    SSF_CFG_WRITE_SYNC_RELEASE();
+#endif
 }
+
 /* --------------------------------------------------------------------------------------------- */
-/* Deinitializes the ssfcfg interface.                                                           */
+/* Syncs the pages of the mapped file covering the dirty range with msync flags.                 */
 /* --------------------------------------------------------------------------------------------- */
-void SSFCfgDeInit(void)
+static void _SSFCfgFileFlush(int flags)
 {
-    SSF_ASSERT(_ssfcfgIsInited);
-    _ssfcfgIsInited = false;
-    SSF_CFG_THREAD_SYNC_DEINIT();
+    size_t start;
+
+    if (_ssfCfgFileDirtyStart == _ssfCfgFileDirtyEnd) return;
+    start = _ssfCfgFileDirtyStart & ~((size_t)sysconf(_SC_PAGESIZE) - 1);
+    SSF_ASSERT(msync(((uint8_t *)_ssfCfgStorage) + start, _ssfCfgFileDirtyEnd - start,
+                     flags) == 0);
+    _ssfCfgFileDirtyStart = 0;
+    _ssfCfgFileDirtyEnd = 0;
+    _ssfCfgFileUnsynced = 0;
 }
-#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
 
 /* --------------------------------------------------------------------------------------------- */
-/* Returns true if data written to storage, else false if data matched existing storage.         */
+/* Makes storage changes of a completed operation durable as the durability mode requires.       */
 /* --------------------------------------------------------------------------------------------- */
-bool SSFCfgWrite(uint8_t *data, uint16_t dataLen, dataId_t dataId, dataVersion_t dataVersion)
+static void _SSFCfgFileCommit(void)
 {
-    SSFCfgHeader_t header;
-    uint8_t tmp[SSF_CFG_WRITE_CHECK_CHUNK_SIZE];
+    if (_ssfCfgFileFd < 0) return;
+#if (SSF_CFG_WRITE_SYNC == 1) && (SSF_CFG_ENABLE_COMPRESSION == 0)
+    SSF_CFG_WRITE_SYNC_ACQUIRE();
+#endif
+    if (_ssfCfgFileDirtyStart != _ssfCfgFileDirtyEnd)
+    {
+        switch (_ssfCfgFileDurability)
+        {
+        case SSF_CFG_FILE_SYNC:
+            _SSFCfgFileFlush(MS_SYNC);
+            break;
+        case SSF_CFG_FILE_ASYNC:
+            _SSFCfgFileFlush(MS_ASYNC);
+            break;
+        default:
+            _ssfCfgFileUnsynced++;
+            if (_ssfCfgFileUnsynced >= SSF_CFG_FILE_BATCH_WRITES) _SSFCfgFileFlush(MS_SYNC);
+            break;
+        }
+    }
+#if (SSF_CFG_WRITE_SYNC == 1) && (SSF_CFG_ENABLE_COMPRESSION == 0)
+    SSF_CFG_WRITE_SYNC_RELEASE();
+#endif
+}
+#endif /* SSF_CFG_STORAGE_FILE */
 
-    uint16_t remainingLen;
-    uint16_t chunkLen;
-    size_t offset = 0;
-    uint16_t crcStorage = SSF_CRC16_INITIAL;
-    uint16_t crcData;
-    bool retVal = true;
+#if SSF_CFG_ENABLE_STORAGE_RAM == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Erases a RAM sector, stopping early if the simulated power fails.                             */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgStorageRAMErase(uint32_t sector)
+{
+    uint32_t len = SSF_CFG_MAX_STORAGE_SIZE;
+
+    SSF_REQUIRE(sector < SSF_MAX_CFG_RAM_SECTORS);
+
+    if (len > _ssfCfgStorageRAMPowerFail) len = _ssfCfgStorageRAMPowerFail;
+    if (_ssfCfgStorageRAMPowerFail != UINT32_MAX) _ssfCfgStorageRAMPowerFail -= len;
+    memset(_ssfCfgStorage[sector], 0xff, len);
+    _ssfCfgStorageRAMErases[sector]++;
+#if SSF_CFG_STORAGE_FILE == 1
+    _SSFCfgFileDirty(sector * SSF_CFG_MAX_STORAGE_SIZE, len);
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Programs a RAM sector like NOR flash, stopping early if the simulated power fails.            */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgStorageRAMWrite(const uint8_t *data, size_t dataLen, uint32_t sector,
+                                   size_t offset)
+{
+    uint64_t start;
+    uint64_t delay;
+    size_t i;
 
     SSF_REQUIRE(data != NULL);
-    SSF_REQUIRE(dataLen <= SSF_MAX_CFG_DATA_SIZE);
-    SSF_REQUIRE(dataId < SSF_MAX_CFG_RAM_SECTORS);
-    SSF_REQUIRE(dataVersion >= 0);
+    SSF_REQUIRE(sector < SSF_MAX_CFG_RAM_SECTORS);
+    SSF_REQUIRE((offset + dataLen) <= SSF_CFG_MAX_STORAGE_SIZE);
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    SSF_ASSERT(_ssfcfgIsInited);
-    SSF_CFG_THREAD_SYNC_ACQUIRE();
-#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+    if (_ssfCfgStorageRAMWriteDelay != 0)
+    {
+        delay = (uint64_t)_ssfCfgStorageRAMWriteDelay * dataLen;
+        start = SSFPortGetHRTick64();
+        while ((SSFPortGetHRTick64() - start) < delay) {}
+    }
+    if (dataLen > _ssfCfgStorageRAMPowerFail) dataLen = _ssfCfgStorageRAMPowerFail;
+    if (_ssfCfgStorageRAMPowerFail != UINT32_MAX)
+    { _ssfCfgStorageRAMPowerFail -= (uint32_t)dataLen; }
 
-    /* Is data already stored as expected in normal location? */
-    SSF_CFG_READ_STORAGE((uint8_t *)&header, sizeof(header), dataId, offset);
+    /* Programming can only clear bits */
+    for (i = 0; i < dataLen; i++) _ssfCfgStorage[sector][offset + i] &= data[i];
+#if SSF_CFG_STORAGE_FILE == 1
+    _SSFCfgFileDirty((sector * SSF_CFG_MAX_STORAGE_SIZE) + offset, dataLen);
+#endif
+}
 
-    /* Does the length, id, version, and magic match what is stored? */
-    if ((header.dataLen == dataLen) &&
-        (header.dataId == dataId) &&
-        (header.dataVersion == dataVersion) &&
-        (header.magic == SSF_CFG_MAGIC))
+/* --------------------------------------------------------------------------------------------- */
+/* Reads from a RAM sector, taking at least _ssfCfgStorageRAMReadDelay HR ticks.                 */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgStorageRAMRead(uint8_t *data, size_t dataSize, uint32_t sector, size_t offset)
+{
+    uint64_t start;
+
+    SSF_REQUIRE(data != NULL);
+    SSF_REQUIRE(sector < SSF_MAX_CFG_RAM_SECTORS);
+    SSF_REQUIRE((offset + dataSize) <= SSF_CFG_MAX_STORAGE_SIZE);
+
+    if (_ssfCfgStorageRAMReadDelay != 0)
     {
-        /* Yes, read data in chunks from storage to compute CRC */
-        remainingLen = header.dataLen;
-        offset += sizeof(header);
-        while (remainingLen)
-        {
-            chunkLen = (uint16_t) sizeof(tmp);
-            if (chunkLen > remainingLen) chunkLen = remainingLen;
-            SSF_CFG_READ_STORAGE(tmp, chunkLen, dataId, offset);
-            crcStorage = SSFCRC16(tmp, chunkLen, crcStorage);
-            offset += chunkLen;
-            remainingLen -= chunkLen;
-        }
+        start = SSFPortGetHRTick64();
+        while ((SSFPortGetHRTick64() - start) < _ssfCfgStorageRAMReadDelay) {}
+    }
+    memcpy(data, &_ssfCfgStorage[sector][offset], dataSize);
+}
+#endif /* SSF_CFG_ENABLE_STORAGE_RAM */
+
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if the entry of dataId is now held for changing, else false if already held.     */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgCacheHold(dataId_t dataId)
+{
+    uint32_t seq = SSF_ATOMIC_LOAD_U32(&_ssfCfgCache[dataId].seq);
 
-        /* Compute data CRC*/
-        crcData = SSFCRC16(data, dataLen, SSF_CRC16_INITIAL);
+    return ((seq & 1u) == 0) && SSF_ATOMIC_CAS_U32(&_ssfCfgCache[dataId].seq, seq, seq + 1);
+}
 
-        /* If computed CRC matches data then nothing to do */
-        if (crcData == crcStorage)
-        { 
-            retVal = false;
-            goto _ssfcfgReadExit;
-        }
+/* --------------------------------------------------------------------------------------------- */
+/* Releases the entry of dataId after changing it.                                               */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgCacheUnhold(dataId_t dataId)
+{
+    SSF_ATOMIC_STORE_U32(&_ssfCfgCache[dataId].seq, _ssfCfgCache[dataId].seq + 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Caches a record just read and validated from storage if it is small enough.                   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgCacheFill(const uint8_t *data, uint16_t dataLen, dataId_t dataId,
+                             dataVersion_t dataVersion, uint16_t dataCRC)
+{
+    SSFCfgCacheEntry_t *entry = &_ssfCfgCache[dataId];
+
+    /* Skipped if a concurrent reader of the same dataId is filling the entry */
+    if ((dataLen > SSF_CFG_READ_CACHE_MAX_DATA_LEN) || (_SSFCfgCacheHold(dataId) == false))
+    { return; }
+    memcpy(entry->data, data, dataLen);
+    entry->dataLen = dataLen;
+    entry->dataVersion = dataVersion;
+    entry->dataCRC = dataCRC;
+    entry->isValid = true;
+    _SSFCfgCacheUnhold(dataId);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Discards the cached record of dataId, the write lock of dataId must be held.                  */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgCacheDrop(dataId_t dataId)
+{
+    if (_ssfCfgCache[dataId].isValid == false) return;
+    SSF_ASSERT(_SSFCfgCacheHold(dataId));
+    _ssfCfgCache[dataId].isValid = false;
+    _SSFCfgCacheUnhold(dataId);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if dataId is cached with dataVersion set, else false if storage must be read.    */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgCacheRead(uint8_t *data, uint16_t *dataLen, size_t dataSize,
+                             dataId_t dataId, dataVersion_t *dataVersion)
+{
+    SSFCfgCacheEntry_t *entry = &_ssfCfgCache[dataId];
+    uint32_t seq;
+    uint16_t len;
+    dataVersion_t version;
+
+    /* Copy is retried if the entry changed while it was being read */
+    do
+    {
+        seq = SSF_ATOMIC_LOAD_U32(&entry->seq);
+        if (((seq & 1u) != 0) || (entry->isValid == false)) return false;
+        len = entry->dataLen;
+        version = entry->dataVersion;
+        if (len > SSF_CFG_READ_CACHE_MAX_DATA_LEN) return false;
+        if (len <= dataSize) memcpy(data, entry->data, len);
+        SSF_ATOMIC_FENCE();
+    } while (SSF_ATOMIC_LOAD_U32(&entry->seq) != seq);
+
+    if (len > dataSize)
+    {
+        *dataVersion = SSF_CFG_DATA_VERSION_INVALID;
+        return true;
     }
+    *dataLen = len;
+    *dataVersion = version;
+    return true;
+}
 
-    /* New data, write data to storage */
-    header.dataLen = dataLen;
-    header.dataId = dataId;
-    header.dataVersion = dataVersion;
-    header.dataCRC = SSFCRC16(data, dataLen, SSF_CRC16_INITIAL);
-    header.magic = SSF_CFG_MAGIC;
-    SSF_CFG_ERASE_STORAGE(dataId);
-    SSF_CFG_WRITE_STORAGE((uint8_t *)&header, sizeof(header), dataId, 0);
-    SSF_CFG_WRITE_STORAGE(data, dataLen, dataId, sizeof(header));
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if dataId is cached with the same length, version, and data CRC, else false.     */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgCacheIsSame(uint16_t dataLen, dataId_t dataId, dataVersion_t dataVersion,
+                               uint16_t dataCRC)
+{
+    SSFCfgCacheEntry_t *entry = &_ssfCfgCache[dataId];
 
-_ssfcfgReadExit:
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    SSF_CFG_THREAD_SYNC_RELEASE();
-#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
-    return retVal;
+    return entry->isValid && (entry->dataLen == dataLen) &&
+           (entry->dataVersion == dataVersion) && (entry->dataCRC == dataCRC);
 }
 
 /* --------------------------------------------------------------------------------------------- */
-/* Returns SSF_CFG_DATA_VERSION_INVALID if cfg bad, else version with data and dataLen set.      */
+/* Discards every cached record, the lock must be held exclusively.                              */
 /* --------------------------------------------------------------------------------------------- */
-dataVersion_t SSFCfgRead(uint8_t *data, uint16_t *dataLen, size_t dataSize, dataId_t dataId)
+static void _SSFCfgCacheInvalidate(void)
 {
-    SSFCfgHeader_t header;
-    dataVersion_t dataVersion = SSF_CFG_DATA_VERSION_INVALID;
-    uint16_t crcData;
+    dataId_t dataId;
 
-    SSF_REQUIRE(data != NULL);
-    SSF_REQUIRE(dataLen != NULL);
-    SSF_REQUIRE(dataId < SSF_MAX_CFG_RAM_SECTORS);
+    for (dataId = 0; dataId < SSF_CFG_MAX_DATA_IDS; dataId++) _SSFCfgCacheDrop(dataId);
+}
+#endif /* SSF_CFG_ENABLE_READ_CACHE */
 
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Acquires the queue lock, which is only ever held briefly and never while storage is accessed. */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgQueueAcquire(void)
+{
 #if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    SSF_ASSERT(_ssfcfgIsInited);
-    SSF_CFG_THREAD_SYNC_ACQUIRE();
+    SSF_CFG_QUEUE_SYNC_ACQUIRE();
 #endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+}
 
-    /* Read Header */
-    SSF_CFG_READ_STORAGE((uint8_t *)&header, sizeof(header), dataId, 0);
+/* --------------------------------------------------------------------------------------------- */
+/* Releases the queue lock.                                                                      */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgQueueRelease(void)
+{
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_CFG_QUEUE_SYNC_RELEASE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+}
 
-    /* Is header OK? */
-    if ((header.dataLen <= SSF_MAX_CFG_DATA_SIZE) &&
-        (header.dataLen <= dataSize) &&
-        (header.dataId == dataId) &&
-        (header.dataVersion >= 0) &&
-        (header.magic == SSF_CFG_MAGIC))
-    {
-        /* Yes, read data */
-        SSF_CFG_READ_STORAGE(data, header.dataLen, dataId, sizeof(header));
+/* --------------------------------------------------------------------------------------------- */
+/* Sets the state of entry keeping count of entries in use, the queue lock must be held.         */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgQueueSet(SSFCfgQueueEntry_t *entry, SSFCfgQueueState_t state)
+{
+    if ((entry->state == SSF_CFG_QUEUE_FREE) && (state != SSF_CFG_QUEUE_FREE))
+    { SSF_ATOMIC_STORE_U32(&_ssfCfgQueueLen, _ssfCfgQueueLen + 1); }
+    else if ((entry->state != SSF_CFG_QUEUE_FREE) && (state == SSF_CFG_QUEUE_FREE))
+    { SSF_ATOMIC_STORE_U32(&_ssfCfgQueueLen, _ssfCfgQueueLen - 1); }
+    entry->state = state;
+}
 
-        /* Compute CRC */
-        crcData = SSFCRC16(data, header.dataLen, SSF_CRC16_INITIAL);
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if a write of dataId is queued with dataVersion set, else false.                 */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgQueueRead(uint8_t *data, uint16_t *dataLen, size_t dataSize,
+                             dataId_t dataId, dataVersion_t *dataVersion)
+{
+    SSFCfgQueueEntry_t *entry = &_ssfCfgQueue[dataId];
+    bool isQueued;
 
-        /* Does CRC match header? */
-        if (crcData == header.dataCRC)
+    if (SSF_ATOMIC_LOAD_U32(&_ssfCfgQueueLen) == 0) return false;
+    _SSFCfgQueueAcquire();
+    isQueued = (entry->state == SSF_CFG_QUEUE_PENDING) || (entry->state == SSF_CFG_QUEUE_WRITING);
+    if (isQueued)
+    {
+        *dataVersion = SSF_CFG_DATA_VERSION_INVALID;
+        if (entry->dataLen <= dataSize)
         {
-            /* Yes, report back that valid data has been read */
-            *dataLen = header.dataLen;
-            dataVersion = header.dataVersion;
+            memcpy(data, entry->data, entry->dataLen);
+            *dataLen = entry->dataLen;
+            *dataVersion = entry->dataVersion;
         }
     }
+    _SSFCfgQueueRelease();
+    return isQueued;
+}
 
-#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-    SSF_CFG_THREAD_SYNC_RELEASE();
-#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
-    return dataVersion;
+/* --------------------------------------------------------------------------------------------- */
+/* Cancels a queued write of dataId about to be superseded, its write lock must be held.        */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgQueueCancel(dataId_t dataId)
+{
+    if (SSF_ATOMIC_LOAD_U32(&_ssfCfgQueueLen) == 0) return;
+    _SSFCfgQueueAcquire();
+    if (_ssfCfgQueue[dataId].state == SSF_CFG_QUEUE_PENDING)
+    { _SSFCfgQueueSet(&_ssfCfgQueue[dataId], SSF_CFG_QUEUE_CANCELED); }
+    _SSFCfgQueueRelease();
+}
+#endif /* SSF_CFG_ENABLE_WRITE_QUEUE */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns crc updated with len bytes of storage read in chunks.                                 */
+/* --------------------------------------------------------------------------------------------- */
+static uint16_t _SSFCfgStorageCRC(uint32_t sector, size_t offset, uint16_t len, uint16_t crc)
+{
+    uint8_t tmp[SSF_CFG_WRITE_CHECK_CHUNK_SIZE];
+    uint16_t chunkLen;
+
+    while (len)
+    {
+        chunkLen = (uint16_t) sizeof(tmp);
+        if (chunkLen > len) chunkLen = len;
+        SSF_CFG_READ_STORAGE(tmp, chunkLen, sector, offset);
+        crc = SSFCRC16(tmp, chunkLen, crc);
+        offset += chunkLen;
+        len -= chunkLen;
+    }
+    return crc;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true with data, dataLen, and magic set to the record data to store, else false if it  */
+/* does not fit in a record.                                                                     */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgEncode(uint8_t **data, uint16_t *dataLen, uint32_t *magic)
+{
+#if SSF_CFG_ENABLE_COMPRESSION == 1
+    size_t len;
+#endif
+
+    *magic = SSF_CFG_MAGIC;
+#if SSF_CFG_ENABLE_COMPRESSION == 1
+    /* Compressed data is stored only if smaller, the encoder is shared by all writes */
+    if ((*dataLen >= SSF_CFG_COMPRESS_MIN_DATA_LEN) &&
+        SSFLZEncode(&_ssfCfgLZContext, *data, *dataLen, _ssfCfgLZBuf, sizeof(_ssfCfgLZBuf),
+                    &len) &&
+        (len < *dataLen))
+    {
+        *data = _ssfCfgLZBuf;
+        *dataLen = (uint16_t)len;
+        *magic = SSF_CFG_MAGIC_LZ;
+    }
+#endif
+    return *dataLen <= SSF_MAX_CFG_DATA_SIZE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if the data of the record with header is intact, with it read into data, its     */
+/* length in dataLen, and the CRC of what was read in dataCRC, else false.                       */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgReadData(uint8_t *data, uint16_t *dataLen, size_t dataSize,
+                            const SSFCfgHeader_t *header, uint32_t sector, size_t dataOffset,
+                            uint16_t *dataCRC)
+{
+#if SSF_CFG_ENABLE_COMPRESSION == 1
+    SSFLZDecodeContext_t context;
+    uint8_t tmp[SSF_CFG_WRITE_CHECK_CHUNK_SIZE];
+    uint16_t remainingLen = header->dataLen;
+    uint16_t chunkLen;
+    uint16_t crc = SSF_CRC16_INITIAL;
+    size_t len;
+    bool isDecoded = true;
+#endif
+
+    SSF_ASSERT(header->dataLen <= dataSize);
+
+    if (header->magic == SSF_CFG_MAGIC)
+    {
+        SSF_CFG_READ_STORAGE(data, header->dataLen, sector, dataOffset);
+        *dataCRC = SSFCRC16(data, header->dataLen, SSF_CRC16_INITIAL);
+        *dataLen = header->dataLen;
+        return *dataCRC == header->dataCRC;
+    }
+#if SSF_CFG_ENABLE_COMPRESSION == 1
+    /* Compressed data is decoded as it is read, so it needs no buffer of its own */
+    SSFLZDecodeBegin(&context, data, (dataSize < UINT16_MAX) ? dataSize : UINT16_MAX);
+    while (remainingLen && isDecoded)
+    {
+        chunkLen = (uint16_t) sizeof(tmp);
+        if (chunkLen > remainingLen) chunkLen = remainingLen;
+        SSF_CFG_READ_STORAGE(tmp, chunkLen, sector, dataOffset);
+        crc = SSFCRC16(tmp, chunkLen, crc);
+        isDecoded = SSFLZDecodeUpdate(&context, tmp, chunkLen);
+        dataOffset += chunkLen;
+        remainingLen -= chunkLen;
+    }
+    if ((SSFLZDecodeEnd(&context, &len) == false) || (isDecoded == false) ||
+        (crc != header->dataCRC)) return false;
+    *dataCRC = SSFCRC16(data, (uint16_t)len, SSF_CRC16_INITIAL);
+    *dataLen = (uint16_t)len;
+    return true;
+#else
+    /* Compressed records can only be read with SSF_CFG_ENABLE_COMPRESSION */
+    return false;
+#endif
+}
+
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if len bytes of storage at offset are erased, else false.                        */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgLogIsErased(uint32_t sector, size_t offset, size_t len)
+{
+    uint8_t tmp[SSF_CFG_WRITE_CHECK_CHUNK_SIZE];
+    size_t chunkLen;
+    size_t i;
+
+    if (offset >= SSF_CFG_MAX_STORAGE_SIZE) return true;
+    if (len > (SSF_CFG_MAX_STORAGE_SIZE - offset)) len = SSF_CFG_MAX_STORAGE_SIZE - offset;
+    while (len)
+    {
+        chunkLen = sizeof(tmp);
+        if (chunkLen > len) chunkLen = len;
+        SSF_CFG_READ_STORAGE(tmp, chunkLen, sector, offset);
+        for (i = 0; i < chunkLen; i++) { if (tmp[i] != 0xff) return false; }
+        offset += chunkLen;
+        len -= chunkLen;
+    }
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if sector is formatted with seq set, else false.                                 */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgLogReadSector(uint32_t sector, uint32_t *seq)
+{
+    SSFCfgLogSector_t sh;
+
+    SSF_CFG_READ_STORAGE((uint8_t *)&sh, sizeof(sh), sector, 0);
+    if ((sh.magic != SSF_CFG_LOG_SECTOR_MAGIC) ||
+        (sh.crc != SSFCRC16((uint8_t *)&sh, (uint16_t)offsetof(SSFCfgLogSector_t, crc),
+                            SSF_CRC16_INITIAL))) return false;
+    *seq = sh.seq;
+    return true;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/* Returns status of the record at offset with its header read into rec.                         */
+/* --------------------------------------------------------------------------------------------- */
+static SSFCfgLogRecStatus_t _SSFCfgLogReadRecord(uint32_t sector, size_t offset,
+                                                 SSFCfgLogRecord_t *rec)
+{
+    if ((offset + sizeof(SSFCfgLogRecord_t)) > SSF_CFG_MAX_STORAGE_SIZE)
+    { return SSF_CFG_LOG_REC_END; }
+    SSF_CFG_READ_STORAGE((uint8_t *)rec, sizeof(SSFCfgLogRecord_t), sector, offset);
+
+    /* Erased, or header write interrupted? */
+    if ((rec->crc != SSFCRC16((uint8_t *)rec, (uint16_t)offsetof(SSFCfgLogRecord_t, crc),
+                              SSF_CRC16_INITIAL)) ||
+        (SSF_CFG_IS_MAGIC(rec->header.magic) == false) ||
+        (rec->header.dataLen > SSF_MAX_CFG_DATA_SIZE) ||
+        ((offset + SSF_CFG_LOG_ALIGN(sizeof(SSFCfgLogRecord_t) + rec->header.dataLen)) >
+         SSF_CFG_MAX_STORAGE_SIZE)) return SSF_CFG_LOG_REC_END;
+
+    /* Data write interrupted? */
+    if (_SSFCfgStorageCRC(sector, offset + sizeof(SSFCfgLogRecord_t), rec->header.dataLen,
+                          SSF_CRC16_INITIAL) != rec->header.dataCRC) return SSF_CFG_LOG_REC_TORN;
+    return SSF_CFG_LOG_REC_VALID;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Appends a record header and makes it the latest record of its dataId.                         */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgLogAppendHeader(SSFCfgLogRecord_t *rec)
+{
+    dataId_t dataId = rec->header.dataId;
+
+    SSF_ASSERT((_ssfCfgLogOffset + SSF_CFG_LOG_ALIGN(sizeof(SSFCfgLogRecord_t) +
+                                                     rec->header.dataLen)) <=
+               SSF_CFG_MAX_STORAGE_SIZE);
+
+    /* Header is written before data so an interrupted write never leaves space unaccounted */
+    rec->seq = _ssfCfgLogSeq++;
+    rec->crc = SSFCRC16((uint8_t *)rec, (uint16_t)offsetof(SSFCfgLogRecord_t, crc),
+                        SSF_CRC16_INITIAL);
+    SSF_CFG_WRITE_STORAGE((uint8_t *)rec, sizeof(SSFCfgLogRecord_t), _ssfCfgLogActive,
+                          _ssfCfgLogOffset);
+    if (dataId == SSF_CFG_LOG_TX_ID) return;
+    _ssfCfgLogLoc[dataId] = SSF_CFG_LOG_LOC(_ssfCfgLogActive, _ssfCfgLogOffset);
+    _ssfCfgLogLocSeq[dataId] = rec->seq;
+    _ssfCfgLogLocLen[dataId] = rec->header.dataLen;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if a transaction entry within end is at offset with it read into entry.          */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgLogReadTxEntry(uint32_t sector, size_t offset, size_t end,
+                                  SSFCfgLogTxEntry_t *entry)
+{
+    if ((offset + sizeof(SSFCfgLogTxEntry_t)) > end) return false;
+    SSF_CFG_READ_STORAGE((uint8_t *)entry, sizeof(SSFCfgLogTxEntry_t), sector, offset);
+    return entry->dataLen <= (end - offset - sizeof(SSFCfgLogTxEntry_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Makes loc the latest record of dataId unless the index holds a newer one.                     */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgLogIndex(dataId_t dataId, uint32_t loc, uint32_t seq, uint16_t dataLen)
+{
+    /* Entries of one transaction share seq */
+    if ((dataId < SSF_CFG_LOG_MAX_IDS) &&
+        ((_ssfCfgLogLoc[dataId] == SSF_CFG_LOG_LOC_NONE) || (seq >= _ssfCfgLogLocSeq[dataId])))
+    {
+        _ssfCfgLogLoc[dataId] = loc;
+        _ssfCfgLogLocSeq[dataId] = seq;
+        _ssfCfgLogLocLen[dataId] = dataLen;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Copies live data at offset of sector to a new record at the end of the active sector.        */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgLogCopy(uint32_t sector, size_t offset, SSFCfgLogRecord_t *rec)
+{
+    uint8_t tmp[SSF_CFG_WRITE_CHECK_CHUNK_SIZE];
+    uint16_t remainingLen = rec->header.dataLen;
+    uint16_t chunkLen;
+    size_t to = _ssfCfgLogOffset + sizeof(SSFCfgLogRecord_t);
+
+    _SSFCfgLogAppendHeader(rec);
+    while (remainingLen)
+    {
+        chunkLen = (uint16_t) sizeof(tmp);
+        if (chunkLen > remainingLen) chunkLen = remainingLen;
+        SSF_CFG_READ_STORAGE(tmp, chunkLen, sector, offset);
+        SSF_CFG_WRITE_STORAGE(tmp, chunkLen, _ssfCfgLogActive, to);
+        offset += chunkLen;
+        to += chunkLen;
+        remainingLen -= chunkLen;
+    }
+    _ssfCfgLogOffset += SSF_CFG_LOG_ALIGN(sizeof(SSFCfgLogRecord_t) + rec->header.dataLen);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Erases sector if needed and makes it the active sector.                                       */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgLogFormat(uint32_t sector)
+{
+    SSFCfgLogSector_t sh;
+
+    if (_SSFCfgLogIsErased(sector, 0, SSF_CFG_MAX_STORAGE_SIZE) == false)
+    { SSF_CFG_ERASE_STORAGE(sector); }
+    memset(&sh, 0, sizeof(sh));
+    sh.magic = SSF_CFG_LOG_SECTOR_MAGIC;
+    sh.seq = _ssfCfgLogSeq++;
+    sh.crc = SSFCRC16((uint8_t *)&sh, (uint16_t)offsetof(SSFCfgLogSector_t, crc),
+                      SSF_CRC16_INITIAL);
+    SSF_CFG_WRITE_STORAGE((uint8_t *)&sh, sizeof(sh), sector, 0);
+    _ssfCfgLogActive = sector;
+    _ssfCfgLogOffset = SSF_CFG_LOG_FIRST;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Copies the live records of sector to the active sector, then erases sector.                   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgLogCompact(uint32_t sector)
+{
+    SSFCfgLogRecord_t rec;
+    SSFCfgLogRecord_t copy;
+    SSFCfgLogRecStatus_t status;
+    SSFCfgLogTxEntry_t entry;
+    size_t offset;
+    size_t entryOffset;
+    size_t end;
+    uint32_t seq;
+
+    SSF_REQUIRE(sector != _ssfCfgLogActive);
+
+    if (_SSFCfgLogReadSector(sector, &seq))
+    {
+        for (offset = SSF_CFG_LOG_FIRST;
+             (status = _SSFCfgLogReadRecord(sector, offset, &rec)) != SSF_CFG_LOG_REC_END;
+             offset += SSF_CFG_LOG_ALIGN(sizeof(SSFCfgLogRecord_t) + rec.header.dataLen))
+        {
+            if (status != SSF_CFG_LOG_REC_VALID) continue;
+
+            /* Only the latest record of each dataId is live */
+            if ((rec.header.dataId < SSF_CFG_LOG_MAX_IDS) &&
+                (_ssfCfgLogLoc[rec.header.dataId] == SSF_CFG_LOG_LOC(sector, offset)))
+            { _SSFCfgLogCopy(sector, offset + sizeof(SSFCfgLogRecord_t), &rec); }
+            if (rec.header.dataId != SSF_CFG_LOG_TX_ID) continue;
+
+            /* Live entries of a committed transaction are copied as ordinary records */
+            end = offset + sizeof(SSFCfgLogRecord_t) + rec.header.dataLen;
+            for (entryOffset = offset + sizeof(SSFCfgLogRecord_t);
+                 _SSFCfgLogReadTxEntry(sector, entryOffset, end, &entry);
+                 entryOffset += sizeof(SSFCfgLogTxEntry_t) + entry.dataLen)
+            {
+                if ((entry.dataId >= SSF_CFG_LOG_MAX_IDS) ||
+                    (_ssfCfgLogLoc[entry.dataId] !=
+                     (SSF_CFG_LOG_LOC(sector, entryOffset) | SSF_CFG_LOG_LOC_TX))) continue;
+                memset(&copy, 0, sizeof(copy));
+                copy.header.dataLen = entry.dataLen;
+                copy.header.dataId = entry.dataId;
+                copy.header.dataVersion = entry.dataVersion;
+                copy.header.dataCRC = entry.dataCRC;
+                copy.header.magic = SSF_CFG_MAGIC;
+                _SSFCfgLogCopy(sector, entryOffset + sizeof(SSFCfgLogTxEntry_t), &copy);
+            }
+        }
+    }
+    if (_SSFCfgLogIsErased(sector, 0, SSF_CFG_MAX_STORAGE_SIZE) == false)
+    { SSF_CFG_ERASE_STORAGE(sector); }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Moves writes to the spare sector and compacts the oldest sector into the new spare.           */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgLogAdvance(void)
+{
+    _SSFCfgLogFormat((_ssfCfgLogActive + 1) % SSF_CFG_LOG_NUM_SECTORS);
+    _SSFCfgLogCompact((_ssfCfgLogActive + 1) % SSF_CFG_LOG_NUM_SECTORS);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Rebuilds the RAM index from storage and restores the erased spare sector.                     */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgLogRecover(void)
+{
+    SSFCfgLogRecord_t rec;
+    SSFCfgLogRecStatus_t status;
+    SSFCfgLogTxEntry_t entry;
+    size_t offset;
+    size_t entryOffset;
+    size_t end;
+    uint32_t sector;
+    uint32_t seq;
+    uint32_t activeSeq = 0;
+    bool isFormatted = false;
+
+    memset(_ssfCfgLogLoc, 0xff, sizeof(_ssfCfgLogLoc));
+    memset(_ssfCfgLogLocSeq, 0, sizeof(_ssfCfgLogLocSeq));
+    _ssfCfgLogSeq = 0;
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+    _SSFCfgCacheInvalidate();
+#endif
+
+    for (sector = 0; sector < SSF_CFG_LOG_NUM_SECTORS; sector++)
+    {
+        if (_SSFCfgLogReadSector(sector, &seq) == false) continue;
+        if (seq >= _ssfCfgLogSeq) _ssfCfgLogSeq = seq + 1;
+
+        /* Index the latest intact record of each dataId */
+        for (offset = SSF_CFG_LOG_FIRST;
+             (status = _SSFCfgLogReadRecord(sector, offset, &rec)) != SSF_CFG_LOG_REC_END;
+             offset += SSF_CFG_LOG_ALIGN(sizeof(SSFCfgLogRecord_t) + rec.header.dataLen))
+        {
+            if (rec.seq >= _ssfCfgLogSeq) _ssfCfgLogSeq = rec.seq + 1;
+            if (status != SSF_CFG_LOG_REC_VALID) continue;
+            if (rec.header.dataId != SSF_CFG_LOG_TX_ID)
+            {
+                _SSFCfgLogIndex(rec.header.dataId, SSF_CFG_LOG_LOC(sector, offset), rec.seq,
+                                rec.header.dataLen);
+                continue;
+            }
+
+            /* Intact transaction record commits all of its entries at once */
+            end = offset + sizeof(SSFCfgLogRecord_t) + rec.header.dataLen;
+            for (entryOffset = offset + sizeof(SSFCfgLogRecord_t);
+                 _SSFCfgLogReadTxEntry(sector, entryOffset, end, &entry);
+                 entryOffset += sizeof(SSFCfgLogTxEntry_t) + entry.dataLen)
+            {
+                _SSFCfgLogIndex(entry.dataId,
+                                SSF_CFG_LOG_LOC(sector, entryOffset) | SSF_CFG_LOG_LOC_TX,
+                                rec.seq, entry.dataLen);
+            }
+        }
+
+        /* Most recently formatted sector is active, appends resume after its last record */
+        if ((isFormatted == false) || (seq > activeSeq))
+        {
+            isFormatted = true;
+            activeSeq = seq;
+            _ssfCfgLogActive = sector;
+            _ssfCfgLogOffset = offset;
+
+            /* Interrupted header write leaves no safe place to append in this sector */
+            if (_SSFCfgLogIsErased(sector, offset, sizeof(SSFCfgLogRecord_t)) == false)
+            { _ssfCfgLogOffset = SSF_CFG_MAX_STORAGE_SIZE; }
+        }
+    }
+
+    /* Blank storage? */
+    if (isFormatted == false) _SSFCfgLogFormat(0);
+
+    /* Finish a compaction or format interrupted by power loss */
+    sector = (_ssfCfgLogActive + 1) % SSF_CFG_LOG_NUM_SECTORS;
+    if (_SSFCfgLogIsErased(sector, 0, SSF_CFG_MAX_STORAGE_SIZE) == false)
+    { _SSFCfgLogCompact(sector); }
+    _ssfCfgLogIsMounted = true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if the latest record of dataId has an intact header, else false.                 */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgLogLocate(dataId_t dataId, SSFCfgHeader_t *header, uint32_t *sector,
+                             size_t *dataOffset)
+{
+    SSFCfgLogRecord_t rec;
+    SSFCfgLogTxEntry_t entry;
+    uint32_t loc = _ssfCfgLogLoc[dataId];
+
+    if (loc == SSF_CFG_LOG_LOC_NONE) return false;
+    *sector = (loc & ~SSF_CFG_LOG_LOC_TX) / SSF_CFG_MAX_STORAGE_SIZE;
+    *dataOffset = (loc & ~SSF_CFG_LOG_LOC_TX) % SSF_CFG_MAX_STORAGE_SIZE;
+
+    /* Transaction entry was checked with its record's CRC when indexed */
+    if (loc & SSF_CFG_LOG_LOC_TX)
+    {
+        SSF_CFG_READ_STORAGE((uint8_t *)&entry, sizeof(entry), *sector, *dataOffset);
+        *dataOffset += sizeof(entry);
+        header->dataLen = entry.dataLen;
+        header->dataId = entry.dataId;
+        header->dataVersion = entry.dataVersion;
+        header->dataCRC = entry.dataCRC;
+        header->magic = SSF_CFG_MAGIC;
+    }
+    else
+    {
+        SSF_CFG_READ_STORAGE((uint8_t *)&rec, sizeof(rec), *sector, *dataOffset);
+        *dataOffset += sizeof(rec);
+        if (rec.crc != SSFCRC16((uint8_t *)&rec, (uint16_t)offsetof(SSFCfgLogRecord_t, crc),
+                                SSF_CRC16_INITIAL)) return false;
+        *header = rec.header;
+    }
+    return SSF_CFG_IS_MAGIC(header->magic) && (header->dataId == dataId) &&
+           (header->dataLen <= SSF_MAX_CFG_DATA_SIZE) &&
+           ((*dataOffset + header->dataLen) <= SSF_CFG_MAX_STORAGE_SIZE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if the latest record of dataId holds the same stored length, version, and data.  */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgLogIsSame(uint16_t dataLen, dataId_t dataId, dataVersion_t dataVersion,
+                             uint16_t dataCRC, uint32_t magic)
+{
+    SSFCfgHeader_t header;
+    uint32_t sector;
+    size_t dataOffset;
+
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+    /* Cache holds data as read, which is only the data as stored if it is not compressed */
+    if ((magic == SSF_CFG_MAGIC) && _SSFCfgCacheIsSame(dataLen, dataId, dataVersion, dataCRC))
+    { return true; }
+#endif
+    return _SSFCfgLogLocate(dataId, &header, &sector, &dataOffset) &&
+           (header.dataLen == dataLen) &&
+           (header.dataVersion == dataVersion) &&
+           (header.dataCRC == dataCRC) &&
+           (header.magic == magic) &&
+           (_SSFCfgStorageCRC(sector, dataOffset, dataLen, SSF_CRC16_INITIAL) == dataCRC);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if the live records other than replaced's, compacted, and size more bytes fit in */
+/* one sector, else false.                                                                       */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgLogFits(size_t size, dataId_t replaced)
+{
+    dataId_t dataId;
+
+    /* Compacting a sector copies at most the live records, so they never overflow the next one */
+    size += SSF_CFG_LOG_FIRST;
+    for (dataId = 0; dataId < SSF_CFG_LOG_MAX_IDS; dataId++)
+    {
+        if ((dataId == replaced) || (_ssfCfgLogLoc[dataId] == SSF_CFG_LOG_LOC_NONE)) continue;
+        size += SSF_CFG_LOG_ALIGN(sizeof(SSFCfgLogRecord_t) + _ssfCfgLogLocLen[dataId]);
+    }
+    return size <= SSF_CFG_MAX_STORAGE_SIZE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Moves on to the next sector until size bytes fit in the active sector.                        */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgLogReserve(size_t size)
+{
+    uint32_t tries;
+
+    for (tries = 0; (_ssfCfgLogOffset + size) > SSF_CFG_MAX_STORAGE_SIZE; tries++)
+    {
+        /* _SSFCfgLogFits() checked that one of the next two compacted sectors has room */
+        SSF_ASSERT(tries < SSF_CFG_LOG_NUM_SECTORS);
+        _SSFCfgLogAdvance();
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if data appended to the log, else false if it matched the latest record or would */
+/* not fit in the log.                                                                           */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgLogWrite(uint8_t *data, uint16_t dataLen, dataId_t dataId,
+                            dataVersion_t dataVersion)
+{
+    SSFCfgLogRecord_t rec;
+    uint16_t crcData;
+    uint32_t magic;
+    size_t size;
+
+    if (_ssfCfgLogIsMounted == false) _SSFCfgLogRecover();
+    if (_SSFCfgEncode(&data, &dataLen, &magic) == false) return false;
+
+    /* Does the latest record already hold the same length, version, and data? */
+    crcData = SSFCRC16(data, dataLen, SSF_CRC16_INITIAL);
+    if (_SSFCfgLogIsSame(dataLen, dataId, dataVersion, crcData, magic)) return false;
+    size = SSF_CFG_LOG_ALIGN(sizeof(SSFCfgLogRecord_t) + dataLen);
+
+    /* With 3 or more sectors the old record is left behind within two compactions */
+    if (_SSFCfgLogFits(size, (SSF_CFG_LOG_NUM_SECTORS > 2) ? dataId : SSF_CFG_LOG_TX_ID) == false)
+    { return false; }
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+    _SSFCfgCacheDrop(dataId);
+#endif
+    _SSFCfgLogReserve(size);
+
+    /* Append new record */
+    memset(&rec, 0, sizeof(rec));
+    rec.header.dataLen = dataLen;
+    rec.header.dataId = dataId;
+    rec.header.dataVersion = dataVersion;
+    rec.header.dataCRC = crcData;
+    rec.header.magic = magic;
+    _SSFCfgLogAppendHeader(&rec);
+    SSF_CFG_WRITE_STORAGE(data, dataLen, _ssfCfgLogActive,
+                          _ssfCfgLogOffset + sizeof(SSFCfgLogRecord_t));
+    _ssfCfgLogOffset += size;
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if the staged transaction was appended as one record, else false if unchanged or */
+/* if it would not fit in the log.                                                               */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgLogTxCommit(void)
+{
+    SSFCfgLogRecord_t rec;
+    SSFCfgLogTxEntry_t entry;
+    size_t from;
+    size_t to = 0;
+    size_t entryLen;
+    size_t dataOffset;
+    size_t size = 0;
+
+    if (_ssfCfgLogIsMounted == false) _SSFCfgLogRecover();
+
+    /* Compaction copies each entry as a record of its own, which may take more than the tx */
+    for (from = 0; from < _ssfCfgTxLen; from += sizeof(entry) + entry.dataLen)
+    {
+        memcpy(&entry, &_ssfCfgTxBuf[from], sizeof(entry));
+        size += SSF_CFG_LOG_ALIGN(sizeof(SSFCfgLogRecord_t) + entry.dataLen);
+    }
+    if (size < SSF_CFG_LOG_ALIGN(sizeof(SSFCfgLogRecord_t) + _ssfCfgTxLen))
+    { size = SSF_CFG_LOG_ALIGN(sizeof(SSFCfgLogRecord_t) + _ssfCfgTxLen); }
+    if (_SSFCfgLogFits(size, SSF_CFG_LOG_TX_ID) == false) return false;
+
+    /* Drop entries that match storage */
+    for (from = 0; from < _ssfCfgTxLen; from += entryLen)
+    {
+        memcpy(&entry, &_ssfCfgTxBuf[from], sizeof(entry));
+        entryLen = sizeof(entry) + entry.dataLen;
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+        _SSFCfgQueueCancel(entry.dataId);
+#endif
+        if (_SSFCfgLogIsSame(entry.dataLen, entry.dataId, entry.dataVersion, entry.dataCRC,
+                             SSF_CFG_MAGIC)) continue;
+        if (to != from) memmove(&_ssfCfgTxBuf[to], &_ssfCfgTxBuf[from], entryLen);
+        to += entryLen;
+    }
+    _ssfCfgTxLen = to;
+    if (_ssfCfgTxLen == 0) return false;
+    _SSFCfgLogReserve(SSF_CFG_LOG_ALIGN(sizeof(SSFCfgLogRecord_t) + _ssfCfgTxLen));
+
+    /* One record CRC covers every entry, so power loss commits all or none of them */
+    memset(&rec, 0, sizeof(rec));
+    rec.header.dataLen = (uint16_t)_ssfCfgTxLen;
+    rec.header.dataId = SSF_CFG_LOG_TX_ID;
+    rec.header.dataCRC = SSFCRC16(_ssfCfgTxBuf, (uint16_t)_ssfCfgTxLen, SSF_CRC16_INITIAL);
+    rec.header.magic = SSF_CFG_MAGIC;
+    _SSFCfgLogAppendHeader(&rec);
+    dataOffset = _ssfCfgLogOffset + sizeof(SSFCfgLogRecord_t);
+    SSF_CFG_WRITE_STORAGE(_ssfCfgTxBuf, _ssfCfgTxLen, _ssfCfgLogActive, dataOffset);
+
+    /* Index entries once the whole record is written */
+    for (from = 0; from < _ssfCfgTxLen; from += sizeof(entry) + entry.dataLen)
+    {
+        memcpy(&entry, &_ssfCfgTxBuf[from], sizeof(entry));
+        _SSFCfgLogIndex(entry.dataId,
+                        SSF_CFG_LOG_LOC(_ssfCfgLogActive, dataOffset + from) | SSF_CFG_LOG_LOC_TX,
+                        rec.seq, entry.dataLen);
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+        _SSFCfgCacheDrop(entry.dataId);
+#endif
+    }
+    _ssfCfgLogOffset += SSF_CFG_LOG_ALIGN(sizeof(SSFCfgLogRecord_t) + _ssfCfgTxLen);
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns SSF_CFG_DATA_VERSION_INVALID if cfg bad, else version with data and dataLen set.      */
+/* --------------------------------------------------------------------------------------------- */
+static dataVersion_t _SSFCfgLogRead(uint8_t *data, uint16_t *dataLen, size_t dataSize,
+                                    dataId_t dataId)
+{
+    SSFCfgHeader_t header;
+    uint32_t sector;
+    size_t dataOffset;
+    uint16_t len;
+    uint16_t crcData;
+
+    /* RAM index locates the latest record, is header OK? */
+    if ((_SSFCfgLogLocate(dataId, &header, &sector, &dataOffset) == false) ||
+        (header.dataLen > dataSize) ||
+        (header.dataVersion < 0)) return SSF_CFG_DATA_VERSION_INVALID;
+
+    /* Read data, does CRC match header? */
+    if (_SSFCfgReadData(data, &len, dataSize, &header, sector, dataOffset, &crcData) == false)
+    { return SSF_CFG_DATA_VERSION_INVALID; }
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+    _SSFCfgCacheFill(data, len, dataId, header.dataVersion, crcData);
+#endif
+    *dataLen = len;
+    return header.dataVersion;
+}
+#else /* SSF_CFG_ENABLE_LOG_STORAGE */
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if data written to its sector, else false if data matched existing storage.      */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgSectorWrite(uint8_t *data, uint16_t dataLen, dataId_t dataId,
+                               dataVersion_t dataVersion)
+{
+    SSFCfgHeader_t header;
+    uint16_t crcStorage;
+    uint16_t crcData;
+    uint32_t magic;
+
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+    /* Is data already cached as stored? */
+    if (_SSFCfgCacheIsSame(dataLen, dataId, dataVersion,
+                           SSFCRC16(data, dataLen, SSF_CRC16_INITIAL))) return false;
+    _SSFCfgCacheDrop(dataId);
+#endif
+    if (_SSFCfgEncode(&data, &dataLen, &magic) == false) return false;
+
+    /* Is data already stored as expected in normal location? */
+    SSF_CFG_READ_STORAGE((uint8_t *)&header, sizeof(header), dataId, 0);
+
+    /* Compute data CRC*/
+    crcData = SSFCRC16(data, dataLen, SSF_CRC16_INITIAL);
+
+    /* Does the length, id, version, and magic match what is stored? */
+    if ((header.dataLen == dataLen) &&
+        (header.dataId == dataId) &&
+        (header.dataVersion == dataVersion) &&
+        (header.magic == magic))
+    {
+        /* Yes, read data in chunks from storage to compute CRC */
+        crcStorage = _SSFCfgStorageCRC(dataId, sizeof(header), header.dataLen,
+                                       SSF_CRC16_INITIAL);
+
+        /* If computed CRC matches data then nothing to do */
+        if (crcData == crcStorage) return false;
+    }
+
+    /* New data, write data to storage */
+    header.dataLen = dataLen;
+    header.dataId = dataId;
+    header.dataVersion = dataVersion;
+    header.dataCRC = crcData;
+    header.magic = magic;
+    SSF_CFG_ERASE_STORAGE(dataId);
+    SSF_CFG_WRITE_STORAGE((uint8_t *)&header, sizeof(header), dataId, 0);
+    SSF_CFG_WRITE_STORAGE(data, dataLen, dataId, sizeof(header));
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns SSF_CFG_DATA_VERSION_INVALID if cfg bad, else version with data and dataLen set.      */
+/* --------------------------------------------------------------------------------------------- */
+static dataVersion_t _SSFCfgSectorRead(uint8_t *data, uint16_t *dataLen, size_t dataSize,
+                                       dataId_t dataId)
+{
+    SSFCfgHeader_t header;
+    dataVersion_t dataVersion = SSF_CFG_DATA_VERSION_INVALID;
+    uint16_t len;
+    uint16_t crcData;
+
+    /* Read Header */
+    SSF_CFG_READ_STORAGE((uint8_t *)&header, sizeof(header), dataId, 0);
+
+    /* Is header OK? */
+    if ((header.dataLen <= SSF_MAX_CFG_DATA_SIZE) &&
+        (header.dataLen <= dataSize) &&
+        (header.dataId == dataId) &&
+        (header.dataVersion >= 0) &&
+        SSF_CFG_IS_MAGIC(header.magic))
+    {
+        /* Yes, read data, does CRC match header? */
+        if (_SSFCfgReadData(data, &len, dataSize, &header, dataId, sizeof(header), &crcData))
+        {
+            /* Yes, report back that valid data has been read */
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+            _SSFCfgCacheFill(data, len, dataId, header.dataVersion, crcData);
+#endif
+            *dataLen = len;
+            dataVersion = header.dataVersion;
+        }
+    }
+    return dataVersion;
+}
+#endif /* SSF_CFG_ENABLE_LOG_STORAGE */
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes the ssfcfg interface.                                                             */
+/* --------------------------------------------------------------------------------------------- */
+void SSFCfgInit(void)
+{
+#if SSF_CFG_ENABLE_LOG_STORAGE == 0
+    dataId_t dataId;
+#endif
+
+    SSF_ASSERT(_ssfcfgIsInited == false);
+    SSF_CFG_THREAD_SYNC_INIT();
+#if SSF_CFG_ENABLE_LOG_STORAGE == 0
+    for (dataId = 0; dataId < SSF_CFG_MAX_DATA_IDS; dataId++) SSF_CFG_SECTOR_SYNC_INIT(dataId);
+#endif
+#if SSF_CFG_WRITE_SYNC == 1
+    SSF_CFG_WRITE_SYNC_INIT();
+#endif
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+    SSF_CFG_QUEUE_SYNC_INIT();
+#endif
+    _ssfcfgIsInited = true;
+}
+/* --------------------------------------------------------------------------------------------- */
+/* Deinitializes the ssfcfg interface.                                                           */
+/* --------------------------------------------------------------------------------------------- */
+void SSFCfgDeInit(void)
+{
+#if SSF_CFG_ENABLE_LOG_STORAGE == 0
+    dataId_t dataId;
+#endif
+
+    SSF_ASSERT(_ssfcfgIsInited);
+    _ssfcfgIsInited = false;
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+    SSF_CFG_QUEUE_SYNC_DEINIT();
+#endif
+#if SSF_CFG_WRITE_SYNC == 1
+    SSF_CFG_WRITE_SYNC_DEINIT();
+#endif
+#if SSF_CFG_ENABLE_LOG_STORAGE == 0
+    for (dataId = 0; dataId < SSF_CFG_MAX_DATA_IDS; dataId++) SSF_CFG_SECTOR_SYNC_DEINIT(dataId);
+#endif
+    SSF_CFG_THREAD_SYNC_DEINIT();
+}
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Acquires the write lock of dataId, the log is shared by every dataId so it is locked whole.   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgWriteAcquire(dataId_t dataId)
+{
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    SSF_CFG_THREAD_SYNC_ACQUIRE();
+#else
+    /* Reads and writes of other sectors go on in parallel */
+    SSF_CFG_THREAD_SYNC_ACQUIRE_SHARED();
+    SSF_CFG_SECTOR_SYNC_ACQUIRE(dataId);
+#endif /* SSF_CFG_ENABLE_LOG_STORAGE */
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Releases the write lock of dataId.                                                            */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgWriteRelease(dataId_t dataId)
+{
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    SSF_CFG_THREAD_SYNC_RELEASE();
+#else
+    SSF_CFG_SECTOR_SYNC_RELEASE(dataId);
+    SSF_CFG_THREAD_SYNC_RELEASE_SHARED();
+#endif /* SSF_CFG_ENABLE_LOG_STORAGE */
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if data written to storage, else false, the write lock of dataId must be held.   */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgWrite(uint8_t *data, uint16_t dataLen, dataId_t dataId,
+                         dataVersion_t dataVersion)
+{
+    bool retVal;
+
+#if (SSF_CFG_WRITE_SYNC == 1) && (SSF_CFG_ENABLE_COMPRESSION == 1)
+    SSF_CFG_WRITE_SYNC_ACQUIRE();
+#endif
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    retVal = _SSFCfgLogWrite(data, dataLen, dataId, dataVersion);
+#else
+    retVal = _SSFCfgSectorWrite(data, dataLen, dataId, dataVersion);
+#endif
+#if SSF_CFG_STORAGE_FILE == 1
+    _SSFCfgFileCommit();
+#endif
+#if (SSF_CFG_WRITE_SYNC == 1) && (SSF_CFG_ENABLE_COMPRESSION == 1)
+    SSF_CFG_WRITE_SYNC_RELEASE();
+#endif
+    return retVal;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if data written to storage, else false if data matched existing storage or, even  */
+/* compressed, does not fit.                                                                     */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFCfgWrite(uint8_t *data, uint16_t dataLen, dataId_t dataId, dataVersion_t dataVersion)
+{
+    bool retVal;
+
+    SSF_REQUIRE(data != NULL);
+#if SSF_CFG_ENABLE_COMPRESSION == 0
+    SSF_REQUIRE(dataLen <= SSF_MAX_CFG_DATA_SIZE);
+#endif
+    SSF_REQUIRE(dataId < SSF_CFG_MAX_DATA_IDS);
+    SSF_REQUIRE(dataVersion >= 0);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_ASSERT(_ssfcfgIsInited);
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+
+    _SSFCfgWriteAcquire(dataId);
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+    _SSFCfgQueueCancel(dataId);
+#endif
+    retVal = _SSFCfgWrite(data, dataLen, dataId, dataVersion);
+    _SSFCfgWriteRelease(dataId);
+    return retVal;
+}
+
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if the write is queued for SSFCfgTask(), else false if dataLen is too long.      */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFCfgWriteAsync(uint8_t *data, uint16_t dataLen, dataId_t dataId, dataVersion_t dataVersion,
+                      SSFCfgWriteDoneFn_t done, void *doneParam)
+{
+    SSFCfgQueueEntry_t *entry;
+    SSFCfgWriteDoneFn_t canceledDone = NULL;
+    void *canceledDoneParam = NULL;
+    dataVersion_t canceledVersion = 0;
+
+    SSF_REQUIRE(data != NULL);
+    SSF_REQUIRE(dataId < SSF_CFG_MAX_DATA_IDS);
+    SSF_REQUIRE(dataVersion >= 0);
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_ASSERT(_ssfcfgIsInited);
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+
+    if (dataLen > SSF_CFG_QUEUE_MAX_DATA_LEN) return false;
+
+    /* A write of dataId still pending is replaced in place, so only its latest data is written */
+    _SSFCfgQueueAcquire();
+    entry = &_ssfCfgQueue[dataId];
+    if (entry->state == SSF_CFG_QUEUE_CANCELED)
+    {
+        /* Canceled write not yet completed by SSFCfgTask(), complete it here as not written */
+        canceledDone = entry->done;
+        canceledDoneParam = entry->doneParam;
+        canceledVersion = entry->dataVersion;
+    }
+    if (entry->state != SSF_CFG_QUEUE_PENDING) entry->seq = _ssfCfgQueueSeq++;
+    memcpy(entry->data, data, dataLen);
+    entry->dataLen = dataLen;
+    entry->dataVersion = dataVersion;
+    entry->done = done;
+    entry->doneParam = doneParam;
+    _SSFCfgQueueSet(entry, SSF_CFG_QUEUE_PENDING);
+    _SSFCfgQueueRelease();
+
+    if (canceledDone != NULL) canceledDone(dataId, canceledVersion, false, canceledDoneParam);
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if the oldest queued write was completed, else false if the queue is empty.      */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFCfgTask(void)
+{
+    SSFCfgQueueEntry_t *entry;
+    SSFCfgWriteDoneFn_t done;
+    void *doneParam;
+    dataId_t dataId;
+    dataVersion_t dataVersion;
+    uint16_t dataLen;
+    bool isCanceled;
+    bool isWritten = false;
+    uint8_t data[SSF_CFG_QUEUE_MAX_DATA_LEN];
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_ASSERT(_ssfcfgIsInited);
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+
+    while (true)
+    {
+        if (SSF_ATOMIC_LOAD_U32(&_ssfCfgQueueLen) == 0) return false;
+
+        entry = NULL;
+        _SSFCfgQueueAcquire();
+        for (dataId = 0; dataId < SSF_CFG_MAX_DATA_IDS; dataId++)
+        {
+            if (((_ssfCfgQueue[dataId].state == SSF_CFG_QUEUE_PENDING) ||
+                 (_ssfCfgQueue[dataId].state == SSF_CFG_QUEUE_CANCELED)) &&
+                ((entry == NULL) || ((int32_t)(_ssfCfgQueue[dataId].seq - entry->seq) < 0)))
+            { entry = &_ssfCfgQueue[dataId]; }
+        }
+        _SSFCfgQueueRelease();
+        if (entry == NULL) return false;
+        dataId = (dataId_t)(entry - _ssfCfgQueue);
+
+        /* Only the write lock of dataId is held across the write, and the queue lock is always */
+        /* taken after it, so the entry is checked again once the write lock is held            */
+        _SSFCfgWriteAcquire(dataId);
+        _SSFCfgQueueAcquire();
+        if ((entry->state == SSF_CFG_QUEUE_PENDING) || (entry->state == SSF_CFG_QUEUE_CANCELED))
+        { break; }
+
+        /* Another SSFCfgTask() completed the entry meanwhile, look again */
+        _SSFCfgQueueRelease();
+        _SSFCfgWriteRelease(dataId);
+    }
+    dataVersion = entry->dataVersion;
+    dataLen = entry->dataLen;
+    done = entry->done;
+    doneParam = entry->doneParam;
+    isCanceled = (entry->state == SSF_CFG_QUEUE_CANCELED);
+    if (isCanceled == false) memcpy(data, entry->data, dataLen);
+    _SSFCfgQueueSet(entry, isCanceled ? SSF_CFG_QUEUE_FREE : SSF_CFG_QUEUE_WRITING);
+    _SSFCfgQueueRelease();
+
+    if (isCanceled == false)
+    {
+        /* Entry stays readable until written, unless queued again meanwhile */
+        isWritten = _SSFCfgWrite(data, dataLen, dataId, dataVersion);
+        _SSFCfgQueueAcquire();
+        if (entry->state == SSF_CFG_QUEUE_WRITING) _SSFCfgQueueSet(entry, SSF_CFG_QUEUE_FREE);
+        _SSFCfgQueueRelease();
+    }
+    _SSFCfgWriteRelease(dataId);
+
+    if (done != NULL) done(dataId, dataVersion, isWritten, doneParam);
+    return true;
+}
+#endif /* SSF_CFG_ENABLE_WRITE_QUEUE */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Acquires the read lock of dataId, shared with other reads, once the log is mounted.           */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgReadAcquire(dataId_t dataId)
+{
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    while (true)
+    {
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+        SSF_CFG_THREAD_SYNC_ACQUIRE_SHARED();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+        if (_ssfCfgLogIsMounted) return;
+
+        /* Mounting builds the index, so it needs the lock exclusively */
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+        SSF_CFG_THREAD_SYNC_RELEASE_SHARED();
+        SSF_CFG_THREAD_SYNC_ACQUIRE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+        if (_ssfCfgLogIsMounted == false)
+        {
+            _SSFCfgLogRecover();
+#if SSF_CFG_STORAGE_FILE == 1
+            _SSFCfgFileCommit();
+#endif
+        }
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+        SSF_CFG_THREAD_SYNC_RELEASE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+    }
+#elif SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    /* Only a write of the same sector holds the read up */
+    SSF_CFG_THREAD_SYNC_ACQUIRE_SHARED();
+    SSF_CFG_SECTOR_SYNC_ACQUIRE_SHARED(dataId);
+#endif /* SSF_CFG_ENABLE_LOG_STORAGE */
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Releases the read lock of dataId.                                                             */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgReadRelease(dataId_t dataId)
+{
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+#if SSF_CFG_ENABLE_LOG_STORAGE == 0
+    SSF_CFG_SECTOR_SYNC_RELEASE_SHARED(dataId);
+#endif /* SSF_CFG_ENABLE_LOG_STORAGE */
+    SSF_CFG_THREAD_SYNC_RELEASE_SHARED();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns SSF_CFG_DATA_VERSION_INVALID if cfg bad, else version with data and dataLen set.      */
+/* --------------------------------------------------------------------------------------------- */
+dataVersion_t SSFCfgRead(uint8_t *data, uint16_t *dataLen, size_t dataSize, dataId_t dataId)
+{
+    dataVersion_t dataVersion;
+
+    SSF_REQUIRE(data != NULL);
+    SSF_REQUIRE(dataLen != NULL);
+    SSF_REQUIRE(dataId < SSF_CFG_MAX_DATA_IDS);
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_ASSERT(_ssfcfgIsInited);
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+    /* Queued writes are read first, so they are seen before SSFCfgTask() completes them */
+    if (_SSFCfgQueueRead(data, dataLen, dataSize, dataId, &dataVersion)) return dataVersion;
+#endif
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+    /* Cached records are read without the lock, so reads are not held up by writes */
+    if (_SSFCfgCacheRead(data, dataLen, dataSize, dataId, &dataVersion)) return dataVersion;
+#endif
+
+    /* Readers share the lock, so reads of storage run in parallel */
+    _SSFCfgReadAcquire(dataId);
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    dataVersion = _SSFCfgLogRead(data, dataLen, dataSize, dataId);
+#else
+    dataVersion = _SSFCfgSectorRead(data, dataLen, dataSize, dataId);
+#endif
+    _SSFCfgReadRelease(dataId);
+    return dataVersion;
+}
+
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Rebuilds the log's RAM index from storage, finishing any compaction cut short by power loss.  */
+/* --------------------------------------------------------------------------------------------- */
+void SSFCfgRecover(void)
+{
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_ASSERT(_ssfcfgIsInited);
+    SSF_CFG_THREAD_SYNC_ACQUIRE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+
+    _SSFCfgLogRecover();
+#if SSF_CFG_STORAGE_FILE == 1
+    _SSFCfgFileCommit();
+#endif
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_CFG_THREAD_SYNC_RELEASE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if the nearly full active sector was retired and the oldest sector compacted,    */
+/* so following writes do not pay for compaction, else false.                                    */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFCfgGC(void)
+{
+    bool retVal = false;
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_ASSERT(_ssfcfgIsInited);
+    SSF_CFG_THREAD_SYNC_ACQUIRE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+
+    if (_ssfCfgLogIsMounted == false) _SSFCfgLogRecover();
+    if ((SSF_CFG_MAX_STORAGE_SIZE - _ssfCfgLogOffset) < SSF_CFG_LOG_GC_FREE)
+    {
+        _SSFCfgLogAdvance();
+        retVal = true;
+    }
+#if SSF_CFG_STORAGE_FILE == 1
+    _SSFCfgFileCommit();
+#endif
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_CFG_THREAD_SYNC_RELEASE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+    return retVal;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Opens a transaction, its staged writes take effect together when committed.                   */
+/* --------------------------------------------------------------------------------------------- */
+void SSFCfgTxBegin(void)
+{
+    SSF_ASSERT(_ssfCfgTxIsOpen == false);
+
+    _ssfCfgTxLen = 0;
+    _ssfCfgTxIsOpen = true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if write staged in the open transaction, else false if staging buffer is full.   */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFCfgTxWrite(uint8_t *data, uint16_t dataLen, dataId_t dataId, dataVersion_t dataVersion)
+{
+    SSFCfgLogTxEntry_t entry;
+    size_t offset;
+
+    SSF_REQUIRE(data != NULL);
+    SSF_REQUIRE(dataLen <= SSF_MAX_CFG_DATA_SIZE);
+    SSF_REQUIRE(dataId < SSF_CFG_LOG_MAX_IDS);
+    SSF_REQUIRE(dataVersion >= 0);
+    SSF_ASSERT(_ssfCfgTxIsOpen);
+
+    /* Each dataId may be staged once per transaction */
+    for (offset = 0; offset < _ssfCfgTxLen; offset += sizeof(entry) + entry.dataLen)
+    {
+        memcpy(&entry, &_ssfCfgTxBuf[offset], sizeof(entry));
+        SSF_REQUIRE(entry.dataId != dataId);
+    }
+
+    /* Whole transaction must fit in one record */
+    if (((_ssfCfgTxLen + sizeof(entry) + dataLen) > sizeof(_ssfCfgTxBuf)) ||
+        ((_ssfCfgTxLen + sizeof(entry) + dataLen) > SSF_MAX_CFG_DATA_SIZE)) return false;
+
+    entry.dataId = dataId;
+    entry.dataVersion = dataVersion;
+    entry.dataLen = dataLen;
+    entry.dataCRC = SSFCRC16(data, dataLen, SSF_CRC16_INITIAL);
+    memcpy(&_ssfCfgTxBuf[_ssfCfgTxLen], &entry, sizeof(entry));
+    memcpy(&_ssfCfgTxBuf[_ssfCfgTxLen + sizeof(entry)], data, dataLen);
+    _ssfCfgTxLen += sizeof(entry) + dataLen;
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if staged writes committed atomically, else false if all matched storage.        */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFCfgTxCommit(void)
+{
+    bool retVal;
+
+    SSF_ASSERT(_ssfCfgTxIsOpen);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_ASSERT(_ssfcfgIsInited);
+    SSF_CFG_THREAD_SYNC_ACQUIRE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+
+    retVal = _SSFCfgLogTxCommit();
+#if SSF_CFG_STORAGE_FILE == 1
+    _SSFCfgFileCommit();
+#endif
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_CFG_THREAD_SYNC_RELEASE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+    _ssfCfgTxIsOpen = false;
+    return retVal;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Discards the writes staged in the open transaction.                                           */
+/* --------------------------------------------------------------------------------------------- */
+void SSFCfgTxAbort(void)
+{
+    SSF_ASSERT(_ssfCfgTxIsOpen);
+
+    _ssfCfgTxIsOpen = false;
+}
+#endif /* SSF_CFG_ENABLE_LOG_STORAGE */
+
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Discards every cached record, so the next reads validate storage again.                       */
+/* --------------------------------------------------------------------------------------------- */
+void SSFCfgCacheInvalidate(void)
+{
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_ASSERT(_ssfcfgIsInited);
+    SSF_CFG_THREAD_SYNC_ACQUIRE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+
+    _SSFCfgCacheInvalidate();
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_CFG_THREAD_SYNC_RELEASE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+}
+#endif /* SSF_CFG_ENABLE_READ_CACHE */
+
+#if SSF_CFG_STORAGE_FILE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if storage is now the memory-mapped file at path, else false.                    */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFCfgFileOpen(const char *path, SSFCfgFileDurability_t durability)
+{
+    struct stat st;
+    void *map;
+    int fd;
+    bool retVal = false;
+
+    SSF_REQUIRE(path != NULL);
+    SSF_REQUIRE(durability < SSF_CFG_FILE_MAX);
+    SSF_ASSERT(_ssfCfgFileFd < 0);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_ASSERT(_ssfcfgIsInited);
+    SSF_CFG_THREAD_SYNC_ACQUIRE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+
+    /* File must be new or have the geometry of RAM storage */
+    fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) goto _ssfcfgFileOpenExit;
+    if ((fstat(fd, &st) != 0) ||
+        ((st.st_size != 0) && (st.st_size != (off_t)sizeof(_ssfCfgStorageRAM))) ||
+        ((st.st_size == 0) && (ftruncate(fd, (off_t)sizeof(_ssfCfgStorageRAM)) != 0)))
+    {
+        close(fd);
+        goto _ssfcfgFileOpenExit;
+    }
+    map = mmap(NULL, sizeof(_ssfCfgStorageRAM), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        close(fd);
+        goto _ssfcfgFileOpenExit;
+    }
+
+    /* Reads and writes go straight to the mapping */
+    _ssfCfgStorage = (uint8_t (*)[SSF_CFG_MAX_STORAGE_SIZE])map;
+    _ssfCfgFileFd = fd;
+    _ssfCfgFileDurability = durability;
+    _ssfCfgFileDirtyStart = 0;
+    _ssfCfgFileDirtyEnd = 0;
+    _ssfCfgFileUnsynced = 0;
+
+    /* New file starts out erased */
+    if (st.st_size == 0)
+    {
+        memset(map, 0xff, sizeof(_ssfCfgStorageRAM));
+        _SSFCfgFileDirty(0, sizeof(_ssfCfgStorageRAM));
+        _SSFCfgFileFlush(MS_SYNC);
+    }
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    _ssfCfgLogIsMounted = false;
+#endif
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+    _SSFCfgCacheInvalidate();
+#endif
+    retVal = true;
+
+_ssfcfgFileOpenExit:
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_CFG_THREAD_SYNC_RELEASE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+    return retVal;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Syncs all writes not yet on disk to the memory-mapped file.                                   */
+/* --------------------------------------------------------------------------------------------- */
+void SSFCfgFileSync(void)
+{
+    SSF_ASSERT(_ssfCfgFileFd >= 0);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_ASSERT(_ssfcfgIsInited);
+    SSF_CFG_THREAD_SYNC_ACQUIRE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+
+    _SSFCfgFileFlush(MS_SYNC);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_CFG_THREAD_SYNC_RELEASE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Syncs and unmaps the storage file, storage reverts to RAM.                                    */
+/* --------------------------------------------------------------------------------------------- */
+void SSFCfgFileClose(void)
+{
+    SSF_ASSERT(_ssfCfgFileFd >= 0);
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_ASSERT(_ssfcfgIsInited);
+    SSF_CFG_THREAD_SYNC_ACQUIRE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+
+    _SSFCfgFileFlush(MS_SYNC);
+    SSF_ASSERT(munmap(_ssfCfgStorage, sizeof(_ssfCfgStorageRAM)) == 0);
+    SSF_ASSERT(close(_ssfCfgFileFd) == 0);
+    _ssfCfgFileFd = -1;
+    _ssfCfgStorage = _ssfCfgStorageRAM;
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    _ssfCfgLogIsMounted = false;
+#endif
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+    _SSFCfgCacheInvalidate();
+#endif
+
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_CFG_THREAD_SYNC_RELEASE();
+#endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+}
+#endif /* SSF_CFG_STORAGE_FILE */
@@ -42,9 +42,32 @@ extern "C" {
 
 #define SSF_CFG_DATA_VERSION_INVALID (-1)
 
+#if (SSF_CFG_ENABLE_STORAGE_RAM == 1) && (SSF_CFG_ENABLE_STORAGE_FILE == 1) && defined(__linux__)
+#define SSF_CFG_STORAGE_FILE (1u)
+#else
+#define SSF_CFG_STORAGE_FILE (0u)
+#endif
+
 typedef uint32_t dataId_t;
 typedef int16_t dataVersion_t;
 
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+/* Called once a queued write completes, isWritten false if storage unchanged; normally called */
+/* by SSFCfgTask(), or by SSFCfgWriteAsync() when it queues over a write a sync write canceled  */
+typedef void (*SSFCfgWriteDoneFn_t)(dataId_t dataId, dataVersion_t dataVersion, bool isWritten,
+                                    void *param);
+#endif /* SSF_CFG_ENABLE_WRITE_QUEUE */
+
+#if SSF_CFG_STORAGE_FILE == 1
+typedef enum
+{
+    SSF_CFG_FILE_SYNC,    /* Each write is on disk before SSFCfgWrite() returns */
+    SSF_CFG_FILE_ASYNC,   /* Each write is scheduled for writeback before SSFCfgWrite() returns */
+    SSF_CFG_FILE_BATCHED, /* Writes are synced in batches of SSF_CFG_FILE_BATCH_WRITES */
+    SSF_CFG_FILE_MAX,
+} SSFCfgFileDurability_t;
+#endif /* SSF_CFG_STORAGE_FILE */
+
 /* --------------------------------------------------------------------------------------------- */
 /* External Interface                                                                            */
 /* --------------------------------------------------------------------------------------------- */
@@ -54,6 +77,27 @@ void SSFCfgDeInit(void);
 #endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
 bool SSFCfgWrite(uint8_t *data, uint16_t dataLen, dataId_t dataId, dataVersion_t dataVersion);
 dataVersion_t SSFCfgRead(uint8_t *data, uint16_t *datalen, size_t dataSize, dataId_t dataId);
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+bool SSFCfgWriteAsync(uint8_t *data, uint16_t dataLen, dataId_t dataId, dataVersion_t dataVersion,
+                      SSFCfgWriteDoneFn_t done, void *doneParam);
+bool SSFCfgTask(void);
+#endif /* SSF_CFG_ENABLE_WRITE_QUEUE */
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+void SSFCfgRecover(void);
+bool SSFCfgGC(void);
+void SSFCfgTxBegin(void);
+bool SSFCfgTxWrite(uint8_t *data, uint16_t dataLen, dataId_t dataId, dataVersion_t dataVersion);
+bool SSFCfgTxCommit(void);
+void SSFCfgTxAbort(void);
+#endif /* SSF_CFG_ENABLE_LOG_STORAGE */
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+void SSFCfgCacheInvalidate(void);
+#endif /* SSF_CFG_ENABLE_READ_CACHE */
+#if SSF_CFG_STORAGE_FILE == 1
+bool SSFCfgFileOpen(const char *path, SSFCfgFileDurability_t durability);
+void SSFCfgFileSync(void);
+void SSFCfgFileClose(void);
+#endif /* SSF_CFG_STORAGE_FILE */
 
 /* --------------------------------------------------------------------------------------------- */
 /* Unit test                                                                                     */
@@ -35,9 +35,26 @@
 #include "ssfassert.h"
 #include "ssfcfg.h"
 #include "ssfcrc16.h"
+#if SSF_CFG_ENABLE_COMPRESSION == 1
+#include <stdlib.h>
+#include "ssflz.h"
+#endif
+#if SSF_CFG_STORAGE_FILE == 1
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #if SSF_CFG_ENABLE_STORAGE_RAM == 1
 extern uint8_t _ssfCfgStorageRAM[SSF_MAX_CFG_RAM_SECTORS][SSF_CFG_MAX_STORAGE_SIZE];
+extern uint32_t _ssfCfgStorageRAMErases[SSF_MAX_CFG_RAM_SECTORS];
+extern uint32_t _ssfCfgStorageRAMPowerFail;
+extern uint32_t _ssfCfgStorageRAMReadDelay;
+extern uint32_t _ssfCfgStorageRAMWriteDelay;
 #else
 #error ssfcfg_ut.c requires that SSF_CFG_ENABLE_STORAGE_RAM set to 1.
 #endif
@@ -46,6 +63,1282 @@ extern uint8_t _ssfCfgStorageRAM[SSF_MAX_CFG_RAM_SECTORS][SSF_CFG_MAX_STORAGE_SI
 #error ssfcfg_ut.c requires at least 2 RAM sectors.
 #endif
 
+/* --------------------------------------------------------------------------------------------- */
+/* Corrupts the last copy of data found in RAM storage.                                          */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTCorrupt(const uint8_t *data, size_t dataLen)
+{
+    uint8_t *last = NULL;
+    uint32_t sector;
+    size_t i;
+
+    for (sector = 0; sector < SSF_MAX_CFG_RAM_SECTORS; sector++)
+    {
+        for (i = 0; (i + dataLen) <= SSF_CFG_MAX_STORAGE_SIZE; i++)
+        {
+            if (memcmp(&_ssfCfgStorageRAM[sector][i], data, dataLen) == 0)
+            { last = &_ssfCfgStorageRAM[sector][i]; }
+        }
+    }
+    SSF_ASSERT(last != NULL);
+    last[0] ^= 0xff;
+}
+
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+#define SSF_CFG_UT_LOG_IDS (4u)
+#define SSF_CFG_UT_LOG_WRITES (2000u)
+#define SSF_CFG_UT_LOG_FAIL_WRITES (300u)
+#define SSF_CFG_UT_LOG_FAIL_POINTS (600u)
+#define SSF_CFG_UT_LOG_MAX_LEN (80u)
+#define SSF_CFG_UT_LOG_STATIC (12345u)
+#define SSF_CFG_UT_LOG_BIG_LEN (SSF_CFG_MAX_STORAGE_SIZE - SSF_CFG_TX_MAX_SIZE)
+#define SSF_CFG_UT_TX_IDS (3u)
+#define SSF_CFG_UT_TX_COMMITS (600u)
+#define SSF_CFG_UT_TX_FAIL_COMMITS (60u)
+
+/* --------------------------------------------------------------------------------------------- */
+/* Fills data with the contents of write number n, returns its length.                          */
+/* --------------------------------------------------------------------------------------------- */
+static uint16_t _SSFCfgUTLogData(uint8_t *data, uint32_t n)
+{
+    uint16_t len = (uint16_t)(8u + ((n * 7u) % (SSF_CFG_UT_LOG_MAX_LEN - 8u)));
+    uint16_t i;
+
+    for (i = 0; i < len; i++) data[i] = (uint8_t)((n * 31u) + i);
+    return len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Asserts dataId reads as write number n, or is unwritten if n is UINT32_MAX.                   */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFCfgUTLogIs(dataId_t dataId, uint32_t n)
+{
+    uint8_t expected[SSF_CFG_UT_LOG_MAX_LEN];
+    uint8_t data[SSF_CFG_UT_LOG_MAX_LEN];
+    uint16_t expectedLen;
+    uint16_t dataLen;
+    dataVersion_t version;
+
+    version = SSFCfgRead(data, &dataLen, sizeof(data), dataId);
+    if (n == UINT32_MAX) return version == SSF_CFG_DATA_VERSION_INVALID;
+    expectedLen = _SSFCfgUTLogData(expected, n);
+    return (version == (dataVersion_t)(n & 0x7fff)) && (dataLen == expectedLen) &&
+           (memcmp(data, expected, dataLen) == 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Writes write number n to dataId.                                                              */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTLogWrite(dataId_t dataId, uint32_t n)
+{
+    uint8_t data[SSF_CFG_UT_LOG_MAX_LEN];
+    uint16_t dataLen;
+
+    dataLen = _SSFCfgUTLogData(data, n);
+    SSF_ASSERT(SSFCfgWrite(data, dataLen, dataId, (dataVersion_t)(n & 0x7fff)));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Erases RAM storage as if the device were new.                                                 */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTLogBlank(void)
+{
+    memset(_ssfCfgStorageRAM, 0xff, sizeof(_ssfCfgStorageRAM));
+    SSFCfgRecover();
+    memset(_ssfCfgStorageRAMErases, 0, sizeof(_ssfCfgStorageRAMErases));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Unit tests the log-structured storage: wear leveling, compaction, and power-fail recovery.    */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTLog(void)
+{
+    static uint8_t snapshot[sizeof(_ssfCfgStorageRAM)];
+    static uint8_t big[SSF_CFG_UT_LOG_BIG_LEN];
+    volatile uint32_t seed = 1;
+    uint32_t latest[SSF_CFG_UT_LOG_IDS];
+    uint32_t inflight;
+    uint32_t minErases;
+    uint32_t maxErases;
+    uint32_t total;
+    uint32_t point;
+    uint32_t sector;
+    uint32_t n;
+    dataId_t id;
+    uint8_t data[SSF_CFG_UT_LOG_MAX_LEN];
+    uint16_t dataLen;
+
+    SSF_ASSERT_TEST(SSFCfgWrite(data, 1, SSF_CFG_LOG_MAX_IDS, 0));
+    SSF_ASSERT_TEST(SSFCfgRead(data, &dataLen, sizeof(data), SSF_CFG_LOG_MAX_IDS));
+
+    /* Blank storage reads as unwritten */
+    _SSFCfgUTLogBlank();
+    for (id = 0; id < SSF_CFG_UT_LOG_IDS; id++) SSF_ASSERT(_SSFCfgUTLogIs(id, UINT32_MAX));
+
+    /* Small updates rotate evenly through the sectors instead of erasing on every write */
+    for (n = 0; n < SSF_CFG_UT_LOG_WRITES; n++)
+    {
+        id = n % SSF_CFG_UT_LOG_IDS;
+        _SSFCfgUTLogWrite(id, n);
+        SSF_ASSERT(_SSFCfgUTLogIs(id, n));
+        latest[id] = n;
+    }
+    minErases = UINT32_MAX;
+    maxErases = 0;
+    total = 0;
+    for (sector = 0; sector < SSF_CFG_LOG_NUM_SECTORS; sector++)
+    {
+        if (_ssfCfgStorageRAMErases[sector] < minErases)
+        { minErases = _ssfCfgStorageRAMErases[sector]; }
+        if (_ssfCfgStorageRAMErases[sector] > maxErases)
+        { maxErases = _ssfCfgStorageRAMErases[sector]; }
+        total += _ssfCfgStorageRAMErases[sector];
+    }
+    SSF_ASSERT(minErases > 0);
+    SSF_ASSERT((maxErases - minErases) <= 1);
+    SSF_ASSERT(total < (SSF_CFG_UT_LOG_WRITES / 10u));
+
+    /* Unchanged data is not appended again */
+    for (id = 0; id < SSF_CFG_UT_LOG_IDS; id++)
+    {
+        SSF_ASSERT(SSFCfgWrite(data, _SSFCfgUTLogData(data, latest[id]), id,
+                               (dataVersion_t)(latest[id] & 0x7fff)) == false);
+    }
+
+    /* Index is rebuilt from storage */
+    SSFCfgRecover();
+    for (id = 0; id < SSF_CFG_UT_LOG_IDS; id++) SSF_ASSERT(_SSFCfgUTLogIs(id, latest[id]));
+
+    /* Compaction ahead of time only once the active sector is nearly full */
+    while (SSFCfgGC() == false)
+    {
+        id = n % SSF_CFG_UT_LOG_IDS;
+        _SSFCfgUTLogWrite(id, n);
+        latest[id] = n;
+        n++;
+    }
+    SSF_ASSERT(SSFCfgGC() == false);
+    for (id = 0; id < SSF_CFG_UT_LOG_IDS; id++) SSF_ASSERT(_SSFCfgUTLogIs(id, latest[id]));
+
+    /* Power lost at points spread over a run of writes, appends and compactions */
+    _SSFCfgUTLogBlank();
+    _SSFCfgUTLogWrite(SSF_CFG_UT_LOG_IDS, SSF_CFG_UT_LOG_STATIC);
+    memcpy(snapshot, _ssfCfgStorageRAM, sizeof(snapshot));
+    _ssfCfgStorageRAMPowerFail = UINT32_MAX - 1;
+    for (n = 0; n < SSF_CFG_UT_LOG_FAIL_WRITES; n++)
+    { _SSFCfgUTLogWrite(n % SSF_CFG_UT_LOG_IDS, n); }
+    total = (UINT32_MAX - 1) - _ssfCfgStorageRAMPowerFail;
+    _ssfCfgStorageRAMPowerFail = UINT32_MAX;
+    for (point = 0; point <= total; point += (total / SSF_CFG_UT_LOG_FAIL_POINTS) + 1)
+    {
+        memcpy(_ssfCfgStorageRAM, snapshot, sizeof(snapshot));
+        SSFCfgRecover();
+        memset(latest, 0xff, sizeof(latest));
+        inflight = UINT32_MAX;
+        _ssfCfgStorageRAMPowerFail = point;
+        for (n = 0; n < SSF_CFG_UT_LOG_FAIL_WRITES; n++)
+        {
+            _SSFCfgUTLogWrite(n % SSF_CFG_UT_LOG_IDS, n);
+            if (_ssfCfgStorageRAMPowerFail == 0)
+            {
+                inflight = n;
+                break;
+            }
+            latest[n % SSF_CFG_UT_LOG_IDS] = n;
+        }
+
+        /* Power restored, each dataId holds its last completed write or the interrupted one */
+        _ssfCfgStorageRAMPowerFail = UINT32_MAX;
+        SSFCfgRecover();
+        for (id = 0; id < SSF_CFG_UT_LOG_IDS; id++)
+        {
+            SSF_ASSERT(_SSFCfgUTLogIs(id, latest[id]) ||
+                       ((inflight != UINT32_MAX) && ((inflight % SSF_CFG_UT_LOG_IDS) == id) &&
+                        _SSFCfgUTLogIs(id, inflight)));
+        }
+
+        /* Log keeps working, never rewritten data survives the compactions */
+        for (n = SSF_CFG_UT_LOG_FAIL_WRITES; n < (2 * SSF_CFG_UT_LOG_FAIL_WRITES); n++)
+        {
+            _SSFCfgUTLogWrite(n % SSF_CFG_UT_LOG_IDS, n);
+            SSF_ASSERT(_SSFCfgUTLogIs(n % SSF_CFG_UT_LOG_IDS, n));
+        }
+        SSF_ASSERT(_SSFCfgUTLogIs(SSF_CFG_UT_LOG_IDS, SSF_CFG_UT_LOG_STATIC));
+    }
+
+    /* Writes that would leave more live data than fits in one sector fail instead of asserting */
+    _SSFCfgUTLogBlank();
+    for (n = 0; n < sizeof(big); n++)
+    {
+        seed = (seed * 1103515245ul) + 12345ul;
+        big[n] = (uint8_t)(seed >> 16);
+    }
+    SSF_ASSERT(SSFCfgWrite(big, sizeof(big), 0, 0));
+    SSF_ASSERT(SSFCfgWrite(big, sizeof(big), 1, 0) == false);
+    SSF_ASSERT(SSFCfgWrite(big, sizeof(big), 2, 0) == false);
+    SSF_ASSERT(SSFCfgRead(snapshot, &dataLen, sizeof(snapshot), 1) == SSF_CFG_DATA_VERSION_INVALID);
+    SSFCfgTxBegin();
+    SSF_ASSERT(SSFCfgTxWrite(big, SSF_CFG_TX_MAX_SIZE - 32u, 1, 0));
+    SSF_ASSERT(SSFCfgTxCommit() == false);
+    SSF_ASSERT(SSFCfgRead(snapshot, &dataLen, sizeof(snapshot), 1) == SSF_CFG_DATA_VERSION_INVALID);
+
+    /* A record too big to fit twice in a sector can still be rewritten */
+    for (n = 1; n < (2 * SSF_CFG_LOG_NUM_SECTORS); n++)
+    {
+        big[0] = (uint8_t)n;
+        SSF_ASSERT(SSFCfgWrite(big, sizeof(big), 0, (dataVersion_t)n) ==
+                   (SSF_CFG_LOG_NUM_SECTORS > 2));
+    }
+    SSFCfgRecover();
+    SSF_ASSERT(SSFCfgRead(snapshot, &dataLen, sizeof(snapshot), 0) ==
+               ((SSF_CFG_LOG_NUM_SECTORS > 2) ? (dataVersion_t)(n - 1) : 0));
+    SSF_ASSERT((dataLen == sizeof(big)) && (memcmp(&snapshot[1], &big[1], sizeof(big) - 1) == 0));
+    _SSFCfgUTLogBlank();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the total number of log sector erases.                                                */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFCfgUTLogErases(void)
+{
+    uint32_t total = 0;
+    uint32_t sector;
+
+    for (sector = 0; sector < SSF_CFG_LOG_NUM_SECTORS; sector++)
+    { total += _ssfCfgStorageRAMErases[sector]; }
+    return total;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Commits write number (gen * SSF_CFG_UT_TX_IDS) + dataId to each dataId in one transaction.    */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTTxCommit(uint32_t gen)
+{
+    uint8_t data[SSF_CFG_UT_LOG_MAX_LEN];
+    uint16_t dataLen;
+    uint32_t n;
+    dataId_t id;
+
+    SSFCfgTxBegin();
+    for (id = 0; id < SSF_CFG_UT_TX_IDS; id++)
+    {
+        n = (gen * SSF_CFG_UT_TX_IDS) + id;
+        dataLen = _SSFCfgUTLogData(data, n);
+        SSF_ASSERT(SSFCfgTxWrite(data, dataLen, id, (dataVersion_t)(n & 0x7fff)));
+    }
+    SSF_ASSERT(SSFCfgTxCommit());
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the transaction all dataIds were last written by, or UINT32_MAX if they disagree.     */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFCfgUTTxGen(void)
+{
+    uint8_t data[SSF_CFG_UT_LOG_MAX_LEN];
+    uint16_t dataLen;
+    dataVersion_t version;
+    uint32_t gen;
+    dataId_t id;
+
+    version = SSFCfgRead(data, &dataLen, sizeof(data), 0);
+    if (version == SSF_CFG_DATA_VERSION_INVALID) return UINT32_MAX;
+    gen = (uint32_t)version / SSF_CFG_UT_TX_IDS;
+    for (id = 0; id < SSF_CFG_UT_TX_IDS; id++)
+    { if (_SSFCfgUTLogIs(id, (gen * SSF_CFG_UT_TX_IDS) + id) == false) return UINT32_MAX; }
+    return gen;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Unit tests transactions: all staged writes are committed together or not at all.              */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTTx(void)
+{
+    static uint8_t snapshot[sizeof(_ssfCfgStorageRAM)];
+    uint8_t data[SSF_CFG_UT_LOG_MAX_LEN];
+    uint8_t big[SSF_CFG_TX_MAX_SIZE];
+    uint16_t dataLen;
+    uint32_t erases;
+    uint32_t total;
+    uint32_t point;
+    uint32_t done;
+    uint32_t gen;
+    uint32_t n;
+
+    memset(data, 0, sizeof(data));
+    SSF_ASSERT_TEST(SSFCfgTxWrite(data, 1, 0, 0));
+    SSF_ASSERT_TEST(SSFCfgTxCommit());
+    SSF_ASSERT_TEST(SSFCfgTxAbort());
+    SSFCfgTxBegin();
+    SSF_ASSERT_TEST(SSFCfgTxBegin());
+    SSF_ASSERT_TEST(SSFCfgTxWrite(NULL, 1, 0, 0));
+    SSF_ASSERT_TEST(SSFCfgTxWrite(data, 1, SSF_CFG_LOG_MAX_IDS, 0));
+    SSF_ASSERT_TEST(SSFCfgTxWrite(data, 1, 0, SSF_CFG_DATA_VERSION_INVALID));
+    SSF_ASSERT(SSFCfgTxWrite(data, 1, 0, 0));
+    SSF_ASSERT_TEST(SSFCfgTxWrite(data, 1, 0, 0));
+    SSF_ASSERT(SSFCfgTxWrite(big, sizeof(big), 1, 0) == false);
+    SSFCfgTxAbort();
+
+    /* Staged writes are not visible until committed */
+    _SSFCfgUTLogBlank();
+    SSFCfgTxBegin();
+    dataLen = _SSFCfgUTLogData(data, 0);
+    SSF_ASSERT(SSFCfgTxWrite(data, dataLen, 0, 0));
+    SSF_ASSERT(_SSFCfgUTLogIs(0, UINT32_MAX));
+    SSFCfgTxAbort();
+    SSF_ASSERT(_SSFCfgUTLogIs(0, UINT32_MAX));
+    SSF_ASSERT(_SSFCfgUTLogErases() == 0);
+
+    /* Commit applies every staged write */
+    _SSFCfgUTTxCommit(1);
+    SSF_ASSERT(_SSFCfgUTTxGen() == 1);
+
+    /* Unchanged writes are dropped, nothing left to commit writes nothing */
+    SSFCfgTxBegin();
+    for (n = SSF_CFG_UT_TX_IDS; n < (2 * SSF_CFG_UT_TX_IDS); n++)
+    {
+        dataLen = _SSFCfgUTLogData(data, n);
+        SSF_ASSERT(SSFCfgTxWrite(data, dataLen, n % SSF_CFG_UT_TX_IDS, (dataVersion_t)n));
+    }
+    SSF_ASSERT(SSFCfgTxCommit() == false);
+    SSFCfgTxBegin();
+    dataLen = _SSFCfgUTLogData(data, 100);
+    SSF_ASSERT(SSFCfgTxWrite(data, dataLen, 0, 100));
+    dataLen = _SSFCfgUTLogData(data, SSF_CFG_UT_TX_IDS + 1);
+    SSF_ASSERT(SSFCfgTxWrite(data, dataLen, 1, SSF_CFG_UT_TX_IDS + 1));
+    SSF_ASSERT(SSFCfgTxCommit());
+    SSF_ASSERT(_SSFCfgUTLogIs(0, 100));
+    SSF_ASSERT(_SSFCfgUTLogIs(1, SSF_CFG_UT_TX_IDS + 1));
+
+    /* Later ordinary write supersedes a committed entry, also after recovery */
+    _SSFCfgUTLogWrite(1, 101);
+    SSFCfgRecover();
+    SSF_ASSERT(_SSFCfgUTLogIs(0, 100));
+    SSF_ASSERT(_SSFCfgUTLogIs(1, 101));
+    SSF_ASSERT(_SSFCfgUTLogIs(2, SSF_CFG_UT_TX_IDS + 2));
+
+    /* Committed entries survive compactions and recovery */
+    for (gen = 2; gen < (SSF_CFG_UT_TX_COMMITS / 4u); gen++)
+    {
+        _SSFCfgUTTxCommit(gen);
+        SSF_ASSERT(_SSFCfgUTTxGen() == gen);
+        if ((gen % 7u) == 0) _SSFCfgUTLogWrite(SSF_CFG_UT_TX_IDS, gen);
+    }
+    SSF_ASSERT(_SSFCfgUTLogErases() > SSF_CFG_LOG_NUM_SECTORS);
+    SSFCfgRecover();
+    SSF_ASSERT(_SSFCfgUTTxGen() == ((SSF_CFG_UT_TX_COMMITS / 4u) - 1));
+
+    /* Batched commits erase less than the same writes made one at a time */
+    _SSFCfgUTLogBlank();
+    for (n = 0; n < (SSF_CFG_UT_TX_COMMITS * SSF_CFG_UT_TX_IDS); n++)
+    { _SSFCfgUTLogWrite(n % SSF_CFG_UT_TX_IDS, n); }
+    erases = _SSFCfgUTLogErases();
+    _SSFCfgUTLogBlank();
+    for (gen = 0; gen < SSF_CFG_UT_TX_COMMITS; gen++) _SSFCfgUTTxCommit(gen);
+    SSF_ASSERT(_SSFCfgUTLogErases() < erases);
+
+    /* Power lost at points spread over a run of commits */
+    _SSFCfgUTLogBlank();
+    _SSFCfgUTTxCommit(0);
+    memcpy(snapshot, _ssfCfgStorageRAM, sizeof(snapshot));
+    _ssfCfgStorageRAMPowerFail = UINT32_MAX - 1;
+    for (gen = 1; gen <= SSF_CFG_UT_TX_FAIL_COMMITS; gen++) _SSFCfgUTTxCommit(gen);
+    total = (UINT32_MAX - 1) - _ssfCfgStorageRAMPowerFail;
+    _ssfCfgStorageRAMPowerFail = UINT32_MAX;
+    for (point = 0; point <= total; point += (total / SSF_CFG_UT_LOG_FAIL_POINTS) + 1)
+    {
+        memcpy(_ssfCfgStorageRAM, snapshot, sizeof(snapshot));
+        SSFCfgRecover();
+        done = 0;
+        _ssfCfgStorageRAMPowerFail = point;
+        for (gen = 1; gen <= SSF_CFG_UT_TX_FAIL_COMMITS; gen++)
+        {
+            _SSFCfgUTTxCommit(gen);
+            if (_ssfCfgStorageRAMPowerFail == 0) break;
+            done = gen;
+        }
+
+        /* Power restored, all dataIds hold the last completed commit or the interrupted one */
+        _ssfCfgStorageRAMPowerFail = UINT32_MAX;
+        SSFCfgRecover();
+        gen = _SSFCfgUTTxGen();
+        SSF_ASSERT((gen == done) || ((gen == (done + 1)) && (gen <= SSF_CFG_UT_TX_FAIL_COMMITS)));
+
+        /* Log keeps working */
+        _SSFCfgUTTxCommit(SSF_CFG_UT_TX_FAIL_COMMITS + 1);
+        SSF_ASSERT(_SSFCfgUTTxGen() == (SSF_CFG_UT_TX_FAIL_COMMITS + 1));
+    }
+    _SSFCfgUTLogBlank();
+}
+#endif /* SSF_CFG_ENABLE_LOG_STORAGE */
+
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+#define SSF_CFG_UT_CACHE_BENCH_OPS (2000u)
+#define SSF_CFG_UT_CACHE_READ_DELAY (1000u) /* HR ticks per storage read, like a slow SPI flash */
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/* Corrupts the stored record of dataId holding data behind the cache's back.                    */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTCacheCorrupt(dataId_t dataId, const uint8_t *data, size_t dataLen)
+{
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    SSF_UNUSED_INT(dataId);
+    _SSFCfgUTCorrupt(data, dataLen);
+#else
+    SSF_UNUSED_PTR(data);
+    SSF_UNUSED_INT(dataLen);
+    _ssfCfgStorageRAM[dataId][0] ^= 0xff;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Unit tests the read cache of validated records.                                               */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTCache(void)
+{
+    uint8_t data1[SSF_CFG_READ_CACHE_MAX_DATA_LEN + 1];
+    uint8_t data2[SSF_CFG_READ_CACHE_MAX_DATA_LEN + 1];
+    uint16_t data2Len;
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    uint64_t start;
+    uint64_t readTicks[2];
+    uint64_t writeTicks[2];
+    uint32_t i;
+    uint32_t j;
+#endif
+
+    /* Read validates storage once, then hits the cache */
+    memset(data1, 0x5a, sizeof(data1));
+    SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_READ_CACHE_MAX_DATA_LEN, 1, 7));
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == 7);
+    _SSFCfgUTCacheCorrupt(1, data1, SSF_CFG_READ_CACHE_MAX_DATA_LEN);
+    memset(data2, 0, sizeof(data2));
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == 7);
+    SSF_ASSERT((data2Len == SSF_CFG_READ_CACHE_MAX_DATA_LEN) &&
+               (memcmp(data1, data2, data2Len) == 0));
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, data2Len - 1, 1) == SSF_CFG_DATA_VERSION_INVALID);
+
+    /* Unchanged write is detected from the cache alone */
+    SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_READ_CACHE_MAX_DATA_LEN, 1, 7) == false);
+    SSFCfgCacheInvalidate();
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == SSF_CFG_DATA_VERSION_INVALID);
+
+    /* Write invalidates, the next read caches the new record */
+    SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_READ_CACHE_MAX_DATA_LEN, 1, 7));
+    data1[0] = 0xa5;
+    SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_READ_CACHE_MAX_DATA_LEN, 1, 7));
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == 7);
+    SSF_ASSERT((data2Len == SSF_CFG_READ_CACHE_MAX_DATA_LEN) &&
+               (memcmp(data1, data2, data2Len) == 0));
+    SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_READ_CACHE_MAX_DATA_LEN, 1, 8));
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == 8);
+
+    /* Records too large for the cache are always read from storage */
+    SSF_ASSERT(SSFCfgWrite(data1, sizeof(data1), 1, 9));
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == 9);
+    SSF_ASSERT((data2Len == sizeof(data1)) && (memcmp(data1, data2, data2Len) == 0));
+    _SSFCfgUTCacheCorrupt(1, data1, sizeof(data1));
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == SSF_CFG_DATA_VERSION_INVALID);
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    /* Uncached (i == 0) versus cached (i == 1) reads and unchanged writes */
+    SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_READ_CACHE_MAX_DATA_LEN, 1, 10));
+    _ssfCfgStorageRAMReadDelay = SSF_CFG_UT_CACHE_READ_DELAY;
+    for (i = 0; i < 2; i++)
+    {
+        start = SSFPortGetHRTick64();
+        for (j = 0; j < SSF_CFG_UT_CACHE_BENCH_OPS; j++)
+        {
+            if (i == 0) SSFCfgCacheInvalidate();
+            SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == 10);
+        }
+        readTicks[i] = SSFPortGetHRTick64() - start;
+        start = SSFPortGetHRTick64();
+        for (j = 0; j < SSF_CFG_UT_CACHE_BENCH_OPS; j++)
+        {
+            if (i == 0) SSFCfgCacheInvalidate();
+            SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_READ_CACHE_MAX_DATA_LEN, 1, 10) == false);
+        }
+        writeTicks[i] = SSFPortGetHRTick64() - start;
+        if (i == 0) SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == 10);
+    }
+    _ssfCfgStorageRAMReadDelay = 0;
+    for (i = 0; i < 2; i++)
+    {
+        printf("\r\n  Cfg slow flash %s: %llu reads/sec, %llu unchanged writes/sec\r\n",
+               (i == 0) ? "uncached" : "cached",
+               (unsigned long long)((SSF_CFG_UT_CACHE_BENCH_OPS * SSF_HR_TICKS_PER_SEC) /
+                                    (readTicks[i] == 0 ? 1 : readTicks[i])),
+               (unsigned long long)((SSF_CFG_UT_CACHE_BENCH_OPS * SSF_HR_TICKS_PER_SEC) /
+                                    (writeTicks[i] == 0 ? 1 : writeTicks[i])));
+    }
+#endif
+    SSFCfgCacheInvalidate();
+}
+#endif /* SSF_CFG_ENABLE_READ_CACHE */
+
+#if SSF_CFG_ENABLE_COMPRESSION == 1
+#define SSF_CFG_UT_LZ_ID (2u)
+#define SSF_CFG_UT_LZ_MAX_LEN (32768u)
+#define SSF_CFG_UT_LZ_LEN (6000u) /* Larger than SSF_MAX_CFG_DATA_SIZE unless compressed */
+#define SSF_CFG_UT_LZ_WRITES (200u)
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+#define SSF_CFG_UT_LZ_BENCH_LEN (2048u)
+#define SSF_CFG_UT_LZ_BENCH_WRITES (200u)
+#define SSF_CFG_UT_LZ_WRITE_DELAY (50u) /* HR ticks per byte programmed, like a slow NOR flash */
+static const char *_ssfCfgUTLZKinds[] = { "JSON", "binary", "random" };
+#endif
+
+static uint8_t _ssfCfgUTLZData1[SSF_CFG_UT_LZ_MAX_LEN];
+static uint8_t _ssfCfgUTLZData2[SSF_CFG_UT_LZ_MAX_LEN];
+static uint8_t _ssfCfgUTLZEncoded[SSF_LZ_ENCODE_MAX_LEN(SSF_CFG_UT_LZ_MAX_LEN)];
+static SSFLZEncodeContext_t _ssfCfgUTLZContext;
+
+/* --------------------------------------------------------------------------------------------- */
+/* Fills data with len bytes of JSON config text that varies with n.                             */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTLZJSON(uint8_t *data, uint16_t len, uint32_t n)
+{
+    char rec[96];
+    int recLen;
+    uint16_t i = 0;
+
+    while (i < len)
+    {
+        recLen = snprintf(rec, sizeof(rec),
+                          "{\"id\":%u,\"name\":\"sensor%u\",\"enabled\":%s,\"rate\":%u},",
+                          (unsigned int)i, (unsigned int)(n % 32u),
+                          ((n + i) & 1u) ? "true" : "false", (unsigned int)((n * 10u) % 1000u));
+        SSF_ASSERT((recLen > 0) && ((size_t)recLen < sizeof(rec)));
+        if (recLen > (len - i)) recLen = len - i;
+        memcpy(&data[i], rec, (size_t)recLen);
+        i += (uint16_t)recLen;
+        n++;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Fills data with len bytes of random data.                                                     */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTLZRandom(uint8_t *data, uint16_t len)
+{
+    uint16_t i;
+
+    for (i = 0; i < len; i++) data[i] = (uint8_t)rand();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the length data is stored with, compressed only if that is smaller.                   */
+/* --------------------------------------------------------------------------------------------- */
+static uint16_t _SSFCfgUTLZStoredLen(const uint8_t *data, uint16_t len)
+{
+    size_t encodedLen;
+
+    if ((len >= SSF_CFG_COMPRESS_MIN_DATA_LEN) &&
+        SSFLZEncode(&_ssfCfgUTLZContext, data, len, _ssfCfgUTLZEncoded,
+                    sizeof(_ssfCfgUTLZEncoded), &encodedLen) &&
+        (encodedLen < len)) return (uint16_t)encodedLen;
+    return len;
+}
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Fills data with len bytes of kind (0 JSON, 1 binary, 2 random) that varies with n.            */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTLZBenchData(uint8_t *data, uint16_t len, uint32_t kind, uint32_t n)
+{
+    uint16_t i;
+
+    if (kind == 0) _SSFCfgUTLZJSON(data, len, n);
+    else if (kind == 2) _SSFCfgUTLZRandom(data, len);
+    else
+    {
+        /* Calibration table of 16 byte entries, a 32-bit index, a small value, then padding */
+        memset(data, 0, len);
+        for (i = 0; i < len; i++)
+        {
+            if ((i % 16u) < 2u) data[i] = (uint8_t)((i / 16u) >> ((i % 16u) * 8u));
+            else if ((i % 16u) == 4u) data[i] = (uint8_t)((n + (i / 16u)) % 7u);
+        }
+    }
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/* Unit tests LZ compressed records.                                                             */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTLZ(void)
+{
+    uint8_t *data1 = _ssfCfgUTLZData1;
+    uint8_t *data2 = _ssfCfgUTLZData2;
+    uint16_t data2Len;
+    uint16_t encodedLen;
+    uint32_t i;
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    uint64_t start;
+    uint64_t ticks;
+    uint32_t kind;
+    uint16_t len;
+#endif
+
+    /* Compressible record larger than SSF_MAX_CFG_DATA_SIZE is stored compressed */
+    _SSFCfgUTLZJSON(data1, SSF_CFG_UT_LZ_LEN, 0);
+    SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_UT_LZ_LEN, SSF_CFG_UT_LZ_ID, 1));
+    memset(data2, 0, SSF_CFG_UT_LZ_MAX_LEN);
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, SSF_CFG_UT_LZ_MAX_LEN, SSF_CFG_UT_LZ_ID) == 1);
+    SSF_ASSERT((data2Len == SSF_CFG_UT_LZ_LEN) && (memcmp(data1, data2, data2Len) == 0));
+    SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_UT_LZ_LEN, SSF_CFG_UT_LZ_ID, 1) == false);
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, SSF_CFG_UT_LZ_LEN - 1, SSF_CFG_UT_LZ_ID) ==
+               SSF_CFG_DATA_VERSION_INVALID);
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, SSF_CFG_UT_LZ_LEN, SSF_CFG_UT_LZ_ID) == 1);
+
+    /* Incompressible record too large even compressed is not written */
+    _SSFCfgUTLZRandom(data1, SSF_CFG_UT_LZ_LEN);
+    SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_UT_LZ_LEN, SSF_CFG_UT_LZ_ID, 2) == false);
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, SSF_CFG_UT_LZ_MAX_LEN, SSF_CFG_UT_LZ_ID) == 1);
+    SSF_ASSERT(data2Len == SSF_CFG_UT_LZ_LEN);
+
+    /* Incompressible and short records are stored as is */
+    SSF_ASSERT(SSFCfgWrite(data1, 1000, SSF_CFG_UT_LZ_ID, 2));
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, SSF_CFG_UT_LZ_MAX_LEN, SSF_CFG_UT_LZ_ID) == 2);
+    SSF_ASSERT((data2Len == 1000) && (memcmp(data1, data2, data2Len) == 0));
+    _SSFCfgUTCorrupt(data1, 1000);
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, SSF_CFG_UT_LZ_MAX_LEN, SSF_CFG_UT_LZ_ID) ==
+               SSF_CFG_DATA_VERSION_INVALID);
+    memset(data1, 'a', SSF_CFG_COMPRESS_MIN_DATA_LEN - 1);
+    SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_COMPRESS_MIN_DATA_LEN - 1, SSF_CFG_UT_LZ_ID, 3));
+    _SSFCfgUTCorrupt(data1, SSF_CFG_COMPRESS_MIN_DATA_LEN - 1);
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+    SSFCfgCacheInvalidate();
+#endif
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, SSF_CFG_UT_LZ_MAX_LEN, SSF_CFG_UT_LZ_ID) ==
+               SSF_CFG_DATA_VERSION_INVALID);
+
+    /* Corrupted compressed data is detected */
+    _SSFCfgUTLZJSON(data1, SSF_CFG_UT_LZ_LEN, 1);
+    SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_UT_LZ_LEN, SSF_CFG_UT_LZ_ID, 4));
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, SSF_CFG_UT_LZ_MAX_LEN, SSF_CFG_UT_LZ_ID) == 4);
+    encodedLen = _SSFCfgUTLZStoredLen(data1, SSF_CFG_UT_LZ_LEN);
+    SSF_ASSERT(encodedLen < (SSF_CFG_UT_LZ_LEN / 2u));
+    _SSFCfgUTCorrupt(_ssfCfgUTLZEncoded, encodedLen);
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, SSF_CFG_UT_LZ_MAX_LEN, SSF_CFG_UT_LZ_ID) ==
+               SSF_CFG_DATA_VERSION_INVALID);
+
+    /* Compressed records survive rewrites, compaction, and recovery */
+    for (i = 0; i < SSF_CFG_UT_LZ_WRITES; i++)
+    {
+        _SSFCfgUTLZJSON(data1, SSF_CFG_UT_LZ_LEN / 2u, i);
+        SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_UT_LZ_LEN / 2u, SSF_CFG_UT_LZ_ID, 5));
+    }
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    SSFCfgRecover();
+#endif
+    memset(data2, 0, SSF_CFG_UT_LZ_MAX_LEN);
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, SSF_CFG_UT_LZ_MAX_LEN, SSF_CFG_UT_LZ_ID) == 5);
+    SSF_ASSERT((data2Len == (SSF_CFG_UT_LZ_LEN / 2u)) && (memcmp(data1, data2, data2Len) == 0));
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    /* Write throughput to slow flash by kind of data, random data stays uncompressed */
+    _ssfCfgStorageRAMWriteDelay = SSF_CFG_UT_LZ_WRITE_DELAY;
+    for (kind = 0; kind < 3u; kind++)
+    {
+        _SSFCfgUTLZBenchData(data1, SSF_CFG_UT_LZ_BENCH_LEN, kind, 0);
+        encodedLen = _SSFCfgUTLZStoredLen(data1, SSF_CFG_UT_LZ_BENCH_LEN);
+        start = SSFPortGetHRTick64();
+        for (i = 0; i < SSF_CFG_UT_LZ_BENCH_WRITES; i++)
+        {
+            _SSFCfgUTLZBenchData(data1, SSF_CFG_UT_LZ_BENCH_LEN, kind, i + 1u);
+            SSF_ASSERT(SSFCfgWrite(data1, SSF_CFG_UT_LZ_BENCH_LEN, SSF_CFG_UT_LZ_ID, 6));
+        }
+        ticks = SSFPortGetHRTick64() - start;
+        SSF_ASSERT(SSFCfgRead(data2, &data2Len, SSF_CFG_UT_LZ_MAX_LEN, SSF_CFG_UT_LZ_ID) == 6);
+        SSF_ASSERT((data2Len == SSF_CFG_UT_LZ_BENCH_LEN) &&
+                   (memcmp(data1, data2, data2Len) == 0));
+        printf("\r\n  Cfg LZ %s: %u bytes stored as %u (%u%%), %llu writes/sec\r\n",
+               _ssfCfgUTLZKinds[kind], (unsigned int)SSF_CFG_UT_LZ_BENCH_LEN,
+               (unsigned int)encodedLen,
+               (unsigned int)((encodedLen * 100u) / SSF_CFG_UT_LZ_BENCH_LEN),
+               (unsigned long long)((SSF_CFG_UT_LZ_BENCH_WRITES * SSF_HR_TICKS_PER_SEC) /
+                                    (ticks == 0 ? 1 : ticks)));
+    }
+    _ssfCfgStorageRAMWriteDelay = 0;
+
+    /* Largest records that fit, random data shows the uncompressed limit */
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    memset(_ssfCfgStorageRAM, 0xFF, sizeof(_ssfCfgStorageRAM));
+    SSFCfgRecover();
+#endif
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+    SSFCfgCacheInvalidate();
+#endif
+    for (kind = 0; kind < 3u; kind += 2u)
+    {
+        for (len = 0; (len + 64u) <= SSF_CFG_UT_LZ_MAX_LEN; len += 64u)
+        {
+            _SSFCfgUTLZBenchData(data1, (uint16_t)(len + 64u), kind, 0);
+            if (SSFCfgWrite(data1, (uint16_t)(len + 64u), SSF_CFG_UT_LZ_ID, 7) == false) break;
+        }
+        printf("\r\n  Cfg LZ capacity: %s records up to %u bytes fit\r\n",
+               _ssfCfgUTLZKinds[kind], (unsigned int)len);
+    }
+#endif
+}
+#endif /* SSF_CFG_ENABLE_COMPRESSION */
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+#define SSF_CFG_UT_MT_MAX_READERS (4u)
+#define SSF_CFG_UT_MT_IDS (2u)
+#define SSF_CFG_UT_MT_WRITES (2000u)
+#define SSF_CFG_UT_MT_MAX_LEN (48u)
+#define SSF_CFG_UT_MT_SLOW_LEN (256u) /* Longer than any cached record, so storage is read */
+#define SSF_CFG_UT_MT_SLOW_DELAY (1000000u) /* HR ticks per byte programmed by the slow write */
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+#define SSF_CFG_UT_MT_BENCH_WRITES (200u)
+#define SSF_CFG_UT_MT_READ_DELAY (1000u) /* HR ticks per storage read, like a slow SPI flash */
+#endif
+
+static uint32_t _ssfCfgUTMTStop;
+static uint32_t _ssfCfgUTMTStarted;
+static uint32_t _ssfCfgUTMTReads[SSF_CFG_UT_MT_MAX_READERS];
+#if SSF_CFG_ENABLE_LOG_STORAGE == 0
+static uint8_t _ssfCfgUTMTSlow[SSF_CFG_UT_MT_SLOW_LEN];
+static uint32_t _ssfCfgUTMTSlowDone;
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/* Fills data with the contents of write number n, returns its length.                          */
+/* --------------------------------------------------------------------------------------------- */
+static uint16_t _SSFCfgUTMTData(uint8_t *data, uint32_t n)
+{
+    uint16_t len = (uint16_t)(8u + (n % (SSF_CFG_UT_MT_MAX_LEN - 8u)));
+
+    memset(data, (int)(n & 0xffu), len);
+    return len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Reads the test dataIds until stopped, asserting each read is one whole write.                 */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFCfgUTMTReader(void *arg)
+{
+    uint8_t data[SSF_CFG_UT_MT_MAX_LEN];
+    uint8_t expected[SSF_CFG_UT_MT_MAX_LEN];
+    uint16_t dataLen;
+    dataVersion_t version;
+    uint32_t reads;
+
+    SSF_ATOMIC_ADD_U32(&_ssfCfgUTMTStarted, 1u);
+    for (reads = 0; SSF_ATOMIC_LOAD_U32(&_ssfCfgUTMTStop) == 0; reads++)
+    {
+        version = SSFCfgRead(data, &dataLen, sizeof(data), reads % SSF_CFG_UT_MT_IDS);
+        SSF_ASSERT(version != SSF_CFG_DATA_VERSION_INVALID);
+        SSF_ASSERT(((uint32_t)version % SSF_CFG_UT_MT_IDS) == (reads % SSF_CFG_UT_MT_IDS));
+        SSF_ASSERT(dataLen == _SSFCfgUTMTData(expected, (uint32_t)version));
+        SSF_ASSERT(memcmp(data, expected, dataLen) == 0);
+        if ((reads % 64u) == 63u) { sched_yield(); }
+    }
+    _ssfCfgUTMTReads[(uintptr_t)arg] = reads;
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Runs readers against writes, returns the total reads with the HR ticks taken in ticks.        */
+/* --------------------------------------------------------------------------------------------- */
+static uint64_t _SSFCfgUTMTRun(uint32_t readers, uint32_t writes, uint64_t *ticks)
+{
+    pthread_t threads[SSF_CFG_UT_MT_MAX_READERS];
+    uint8_t data[SSF_CFG_UT_MT_MAX_LEN];
+    uint64_t start;
+    uint64_t total = 0;
+    uint32_t n;
+    uint32_t i;
+
+    SSF_REQUIRE(readers <= SSF_CFG_UT_MT_MAX_READERS);
+
+    for (n = 0; n < SSF_CFG_UT_MT_IDS; n++)
+    { SSFCfgWrite(data, _SSFCfgUTMTData(data, n), n, (dataVersion_t)n); }
+    SSF_ATOMIC_STORE_U32(&_ssfCfgUTMTStop, 0);
+    SSF_ATOMIC_STORE_U32(&_ssfCfgUTMTStarted, 0);
+    start = SSFPortGetHRTick64();
+    for (i = 0; i < readers; i++)
+    {
+        SSF_ASSERT(pthread_create(&threads[i], NULL, _SSFCfgUTMTReader, (void *)(uintptr_t)i) ==
+                   0);
+    }
+    /* Writes start once every reader is running so each reader sees them */
+    while (SSF_ATOMIC_LOAD_U32(&_ssfCfgUTMTStarted) < readers) { sched_yield(); }
+    for (n = SSF_CFG_UT_MT_IDS; n < (SSF_CFG_UT_MT_IDS + writes); n++)
+    {
+        SSF_ASSERT(SSFCfgWrite(data, _SSFCfgUTMTData(data, n), n % SSF_CFG_UT_MT_IDS,
+                               (dataVersion_t)n));
+        sched_yield();
+    }
+    SSF_ATOMIC_STORE_U32(&_ssfCfgUTMTStop, 1);
+    for (i = 0; i < readers; i++)
+    {
+        SSF_ASSERT(pthread_join(threads[i], NULL) == 0);
+        total += _ssfCfgUTMTReads[i];
+    }
+    *ticks = SSFPortGetHRTick64() - start;
+    return total;
+}
+
+#if SSF_CFG_ENABLE_LOG_STORAGE == 0
+/* --------------------------------------------------------------------------------------------- */
+/* Writes new data to dataId 0 one slow byte at a time, then flags that the write is done.       */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFCfgUTMTSlowWriter(void *arg)
+{
+    memset(_ssfCfgUTMTSlow, 0xa5, sizeof(_ssfCfgUTMTSlow));
+    SSF_ASSERT(SSFCfgWrite(_ssfCfgUTMTSlow, sizeof(_ssfCfgUTMTSlow), 0,
+                           (dataVersion_t)(uintptr_t)arg));
+    SSF_ATOMIC_STORE_U32(&_ssfCfgUTMTSlowDone, 1u);
+    return NULL;
+}
+#endif /* SSF_CFG_ENABLE_LOG_STORAGE */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Unit tests reads running in parallel with each other and with writes.                         */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTMT(void)
+{
+    uint64_t ticks;
+    uint32_t i;
+#if SSF_CFG_ENABLE_LOG_STORAGE == 0
+    pthread_t thread;
+    uint8_t data[SSF_CFG_UT_MT_SLOW_LEN];
+    uint16_t dataLen;
+    uint32_t erases;
+    uint64_t start;
+#endif
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    uint64_t reads;
+    uint32_t readers;
+#endif
+
+    /* Every read returns one whole write while another thread writes */
+    SSF_ASSERT(_SSFCfgUTMTRun(SSF_CFG_UT_MT_MAX_READERS, SSF_CFG_UT_MT_WRITES, &ticks) > 0);
+    for (i = 0; i < SSF_CFG_UT_MT_MAX_READERS; i++) SSF_ASSERT(_ssfCfgUTMTReads[i] > 0);
+
+#if SSF_CFG_ENABLE_LOG_STORAGE == 0
+    /* A storage read or write of one sector completes while another sector is being written */
+    memset(data, 0x3c, sizeof(data));
+    SSFCfgWrite(data, sizeof(data), 1, 1);
+    erases = SSF_ATOMIC_LOAD_U32(&_ssfCfgStorageRAMErases[0]);
+    SSF_ATOMIC_STORE_U32(&_ssfCfgUTMTSlowDone, 0);
+    _ssfCfgStorageRAMWriteDelay = SSF_CFG_UT_MT_SLOW_DELAY;
+    SSF_ASSERT(pthread_create(&thread, NULL, _SSFCfgUTMTSlowWriter, (void *)(uintptr_t)0x7fff) ==
+               0);
+    while (SSF_ATOMIC_LOAD_U32(&_ssfCfgStorageRAMErases[0]) == erases) { sched_yield(); }
+    memset(data, 0, sizeof(data));
+    start = SSFPortGetHRTick64();
+    SSF_ASSERT(SSFCfgRead(data, &dataLen, sizeof(data), 1) == 1);
+    SSF_ASSERT((SSFPortGetHRTick64() - start) <
+               ((uint64_t)SSF_CFG_UT_MT_SLOW_DELAY * SSF_CFG_UT_MT_SLOW_LEN / 4u));
+    SSF_ASSERT((dataLen == sizeof(data)) && (data[0] == 0x3c) && (data[sizeof(data) - 1] == 0x3c));
+#if SSF_CFG_ENABLE_COMPRESSION == 0
+    /* Compressed writes share one encoder buffer, so only uncompressed writes run in parallel */
+    data[0] = 0x3d;
+    start = SSFPortGetHRTick64();
+    SSF_ASSERT(SSFCfgWrite(data, 1, 2, 2));
+    SSF_ASSERT((SSFPortGetHRTick64() - start) <
+               ((uint64_t)SSF_CFG_UT_MT_SLOW_DELAY * SSF_CFG_UT_MT_SLOW_LEN / 4u));
+#endif
+    SSF_ASSERT(SSF_ATOMIC_LOAD_U32(&_ssfCfgUTMTSlowDone) == 0);
+    SSF_ASSERT(pthread_join(thread, NULL) == 0);
+    _ssfCfgStorageRAMWriteDelay = 0;
+    SSF_ASSERT(SSFCfgRead(data, &dataLen, sizeof(data), 0) == 0x7fff);
+    SSF_ASSERT((dataLen == sizeof(data)) && (data[0] == 0xa5));
+#if SSF_CFG_ENABLE_COMPRESSION == 0
+    SSF_ASSERT(SSFCfgRead(data, &dataLen, sizeof(data), 2) == 2);
+    SSF_ASSERT((dataLen == 1) && (data[0] == 0x3d));
+#endif
+#endif
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    _ssfCfgStorageRAMReadDelay = SSF_CFG_UT_MT_READ_DELAY;
+    for (readers = 1; readers <= SSF_CFG_UT_MT_MAX_READERS; readers *= 2)
+    {
+        reads = _SSFCfgUTMTRun(readers, SSF_CFG_UT_MT_BENCH_WRITES, &ticks);
+        printf("\r\n  Cfg slow flash %u reader(s) + 1 writer: %llu reads/sec, %llu writes/sec\r\n",
+               (unsigned int)readers,
+               (unsigned long long)((reads * SSF_HR_TICKS_PER_SEC) / (ticks == 0 ? 1 : ticks)),
+               (unsigned long long)((SSF_CFG_UT_MT_BENCH_WRITES * SSF_HR_TICKS_PER_SEC) /
+                                    (ticks == 0 ? 1 : ticks)));
+    }
+    _ssfCfgStorageRAMReadDelay = 0;
+#endif
+}
+#endif /* (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32) */
+
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+#define SSF_CFG_UT_QUEUE_ID (1u)
+#define SSF_CFG_UT_QUEUE_WRITES (2000u)
+#define SSF_CFG_UT_QUEUE_SLOW_DELAY (1000000u) /* HR ticks per byte programmed, a very slow flash */
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+#define SSF_CFG_UT_QUEUE_BENCH_WRITES (500u)
+#define SSF_CFG_UT_QUEUE_WRITE_DELAY (2000u) /* HR ticks per byte programmed, like a slow flash */
+#endif
+
+static uint32_t _ssfCfgUTQueueDone;
+static dataId_t _ssfCfgUTQueueDoneId;
+static dataVersion_t _ssfCfgUTQueueDoneVersion;
+static bool _ssfCfgUTQueueDoneIsWritten;
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+static uint32_t _ssfCfgUTQueueStop;
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+static uint64_t _ssfCfgUTQueueTicks[SSF_CFG_UT_QUEUE_BENCH_WRITES];
+#endif
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/* Records the completion of a queued write.                                                     */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTQueueDoneFn(dataId_t dataId, dataVersion_t dataVersion, bool isWritten,
+                                 void *param)
+{
+    SSF_ASSERT(param == &_ssfCfgUTQueueDone);
+    SSF_ATOMIC_ADD_U32(&_ssfCfgUTQueueDone, 1u);
+    _ssfCfgUTQueueDoneId = dataId;
+    _ssfCfgUTQueueDoneVersion = dataVersion;
+    _ssfCfgUTQueueDoneIsWritten = isWritten;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Asserts dataId reads back as len bytes of value with dataVersion.                             */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTQueueIs(dataId_t dataId, uint8_t value, uint16_t len,
+                             dataVersion_t dataVersion)
+{
+    uint8_t data[SSF_CFG_QUEUE_MAX_DATA_LEN];
+    uint16_t dataLen;
+    uint16_t i;
+
+    SSF_ASSERT(SSFCfgRead(data, &dataLen, sizeof(data), dataId) == dataVersion);
+    SSF_ASSERT(dataLen == len);
+    for (i = 0; i < len; i++) SSF_ASSERT(data[i] == value);
+}
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+/* --------------------------------------------------------------------------------------------- */
+/* Completes queued writes until stopped, like a background thread of an application.           */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFCfgUTQueueTask(void *arg)
+{
+    SSF_UNUSED_PTR(arg);
+    while (SSF_ATOMIC_LOAD_U32(&_ssfCfgUTQueueStop) == 0)
+    {
+        if (SSFCfgTask() == false) sched_yield();
+    }
+    while (SSFCfgTask()) {}
+    return NULL;
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/* Unit tests the write-behind queue.                                                            */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTQueue(void)
+{
+    uint8_t data[SSF_CFG_QUEUE_MAX_DATA_LEN + 1];
+    uint16_t dataLen;
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+    pthread_t thread;
+    uint32_t n;
+#if ((SSF_CFG_ENABLE_LOG_STORAGE == 0) && (SSF_CFG_ENABLE_COMPRESSION == 0)) || \
+    (SSF_CONFIG_UNIT_TEST_BENCHMARK == 1)
+    uint64_t start;
+#endif
+#if (SSF_CFG_ENABLE_LOG_STORAGE == 0) && (SSF_CFG_ENABLE_COMPRESSION == 0)
+    uint32_t erases;
+    uint32_t done;
+#endif
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    uint32_t i;
+    uint32_t j;
+    uint64_t tmp;
+#endif
+#endif
+
+    /* Check SSFCfgWriteAsync requirements */
+    SSF_ASSERT_TEST(SSFCfgWriteAsync(NULL, 1, 0, 0, NULL, NULL));
+    SSF_ASSERT_TEST(SSFCfgWriteAsync(data, 1, 0, SSF_CFG_DATA_VERSION_INVALID, NULL, NULL));
+
+    /* Only records that fit in the queue are queued */
+    memset(data, 0x31, sizeof(data));
+    SSF_ASSERT(SSFCfgWriteAsync(data, sizeof(data), SSF_CFG_UT_QUEUE_ID, 1, NULL, NULL) ==
+               false);
+    SSF_ASSERT(SSFCfgTask() == false);
+
+    /* Queued write is read back before it completes */
+    SSF_ASSERT(SSFCfgWrite(data, 16, SSF_CFG_UT_QUEUE_ID, 1));
+    memset(data, 0x32, sizeof(data));
+    _ssfCfgUTQueueDone = 0;
+    SSF_ASSERT(SSFCfgWriteAsync(data, 20, SSF_CFG_UT_QUEUE_ID, 2, _SSFCfgUTQueueDoneFn,
+                                &_ssfCfgUTQueueDone));
+    _SSFCfgUTQueueIs(SSF_CFG_UT_QUEUE_ID, 0x32, 20, 2);
+    SSF_ASSERT(SSFCfgRead(data, &dataLen, 19, SSF_CFG_UT_QUEUE_ID) ==
+               SSF_CFG_DATA_VERSION_INVALID);
+    SSF_ASSERT(_ssfCfgUTQueueDone == 0);
+
+    /* Repeated writes of a dataId coalesce into one storage write */
+    memset(data, 0x33, sizeof(data));
+    SSF_ASSERT(SSFCfgWriteAsync(data, 24, SSF_CFG_UT_QUEUE_ID, 3, _SSFCfgUTQueueDoneFn,
+                                &_ssfCfgUTQueueDone));
+    _SSFCfgUTQueueIs(SSF_CFG_UT_QUEUE_ID, 0x33, 24, 3);
+    SSF_ASSERT(SSFCfgTask());
+    SSF_ASSERT(SSFCfgTask() == false);
+    SSF_ASSERT((_ssfCfgUTQueueDone == 1) && (_ssfCfgUTQueueDoneId == SSF_CFG_UT_QUEUE_ID) &&
+               (_ssfCfgUTQueueDoneVersion == 3) && _ssfCfgUTQueueDoneIsWritten);
+    _SSFCfgUTQueueIs(SSF_CFG_UT_QUEUE_ID, 0x33, 24, 3);
+
+    /* Unchanged data completes without writing */
+    SSF_ASSERT(SSFCfgWriteAsync(data, 24, SSF_CFG_UT_QUEUE_ID, 3, _SSFCfgUTQueueDoneFn,
+                                &_ssfCfgUTQueueDone));
+    SSF_ASSERT(SSFCfgTask());
+    SSF_ASSERT((_ssfCfgUTQueueDone == 2) && (_ssfCfgUTQueueDoneIsWritten == false));
+
+    /* Writes complete oldest first */
+    SSF_ASSERT(SSFCfgWriteAsync(data, 8, 0, 4, _SSFCfgUTQueueDoneFn, &_ssfCfgUTQueueDone));
+    SSF_ASSERT(SSFCfgWriteAsync(data, 8, SSF_CFG_UT_QUEUE_ID, 4, _SSFCfgUTQueueDoneFn,
+                                &_ssfCfgUTQueueDone));
+    SSF_ASSERT(SSFCfgWriteAsync(data, 9, 0, 4, _SSFCfgUTQueueDoneFn, &_ssfCfgUTQueueDone));
+    SSF_ASSERT(SSFCfgTask() && (_ssfCfgUTQueueDoneId == 0));
+    SSF_ASSERT(SSFCfgTask() && (_ssfCfgUTQueueDoneId == SSF_CFG_UT_QUEUE_ID));
+    SSF_ASSERT(SSFCfgTask() == false);
+    SSF_ASSERT(_ssfCfgUTQueueDone == 4);
+    _SSFCfgUTQueueIs(0, 0x33, 9, 4);
+    _SSFCfgUTQueueIs(SSF_CFG_UT_QUEUE_ID, 0x33, 8, 4);
+
+    /* Synchronous write supersedes a queued write, which completes as not written */
+    SSF_ASSERT(SSFCfgWriteAsync(data, 10, SSF_CFG_UT_QUEUE_ID, 5, _SSFCfgUTQueueDoneFn,
+                                &_ssfCfgUTQueueDone));
+    memset(data, 0x34, sizeof(data));
+    SSF_ASSERT(SSFCfgWrite(data, 11, SSF_CFG_UT_QUEUE_ID, 6));
+    _SSFCfgUTQueueIs(SSF_CFG_UT_QUEUE_ID, 0x34, 11, 6);
+    SSF_ASSERT(SSFCfgTask());
+    SSF_ASSERT((_ssfCfgUTQueueDone == 5) && (_ssfCfgUTQueueDoneVersion == 5) &&
+               (_ssfCfgUTQueueDoneIsWritten == false));
+    _SSFCfgUTQueueIs(SSF_CFG_UT_QUEUE_ID, 0x34, 11, 6);
+
+    /* Queuing over a canceled write completes the canceled write first, as not written */
+    SSF_ASSERT(SSFCfgWriteAsync(data, 12, SSF_CFG_UT_QUEUE_ID, 7, _SSFCfgUTQueueDoneFn,
+                                &_ssfCfgUTQueueDone));
+    memset(data, 0x36, sizeof(data));
+    SSF_ASSERT(SSFCfgWrite(data, 13, SSF_CFG_UT_QUEUE_ID, 8));
+    SSF_ASSERT(_ssfCfgUTQueueDone == 5);
+    SSF_ASSERT(SSFCfgWriteAsync(data, 14, SSF_CFG_UT_QUEUE_ID, 9, _SSFCfgUTQueueDoneFn,
+                                &_ssfCfgUTQueueDone));
+    SSF_ASSERT((_ssfCfgUTQueueDone == 6) && (_ssfCfgUTQueueDoneVersion == 7) &&
+               (_ssfCfgUTQueueDoneIsWritten == false));
+    _SSFCfgUTQueueIs(SSF_CFG_UT_QUEUE_ID, 0x36, 14, 9);
+    SSF_ASSERT(SSFCfgTask());
+    SSF_ASSERT(SSFCfgTask() == false);
+    SSF_ASSERT((_ssfCfgUTQueueDone == 7) && (_ssfCfgUTQueueDoneVersion == 9) &&
+               _ssfCfgUTQueueDoneIsWritten);
+    _SSFCfgUTQueueIs(SSF_CFG_UT_QUEUE_ID, 0x36, 14, 9);
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    SSF_ASSERT(SSFCfgWriteAsync(data, 12, SSF_CFG_UT_QUEUE_ID, 7, NULL, NULL));
+    memset(data, 0x35, sizeof(data));
+    SSFCfgTxBegin();
+    SSF_ASSERT(SSFCfgTxWrite(data, 13, SSF_CFG_UT_QUEUE_ID, 8));
+    SSF_ASSERT(SSFCfgTxCommit());
+    SSF_ASSERT(SSFCfgTask());
+    SSF_ASSERT(SSFCfgTask() == false);
+    _SSFCfgUTQueueIs(SSF_CFG_UT_QUEUE_ID, 0x35, 13, 8);
+#endif
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+    /* Every read sees the caller's latest write while a background thread completes them */
+    SSF_ATOMIC_STORE_U32(&_ssfCfgUTQueueStop, 0);
+    SSF_ASSERT(pthread_create(&thread, NULL, _SSFCfgUTQueueTask, NULL) == 0);
+    for (n = 0; n < SSF_CFG_UT_QUEUE_WRITES; n++)
+    {
+        memset(data, (int)(n & 0xffu), sizeof(data));
+        SSF_ASSERT(SSFCfgWriteAsync(data, (uint16_t)(n % SSF_CFG_QUEUE_MAX_DATA_LEN),
+                                    SSF_CFG_UT_QUEUE_ID, (dataVersion_t)(n % 1000u), NULL,
+                                    NULL));
+        _SSFCfgUTQueueIs(SSF_CFG_UT_QUEUE_ID, (uint8_t)n,
+                         (uint16_t)(n % SSF_CFG_QUEUE_MAX_DATA_LEN), (dataVersion_t)(n % 1000u));
+        if ((n % 16u) == 15u) sched_yield();
+    }
+    SSF_ATOMIC_STORE_U32(&_ssfCfgUTQueueStop, 1);
+    SSF_ASSERT(pthread_join(thread, NULL) == 0);
+    SSF_ASSERT(SSFCfgTask() == false);
+    n--;
+    _SSFCfgUTQueueIs(SSF_CFG_UT_QUEUE_ID, (uint8_t)n, (uint16_t)(n % SSF_CFG_QUEUE_MAX_DATA_LEN),
+                     (dataVersion_t)(n % 1000u));
+
+#if (SSF_CFG_ENABLE_LOG_STORAGE == 0) && (SSF_CFG_ENABLE_COMPRESSION == 0)
+    /* A slow queued write to one sector does not hold up a synchronous write to another */
+    done = _ssfCfgUTQueueDone;
+    erases = SSF_ATOMIC_LOAD_U32(&_ssfCfgStorageRAMErases[0]);
+    _ssfCfgStorageRAMWriteDelay = SSF_CFG_UT_QUEUE_SLOW_DELAY;
+    memset(data, 0x5a, sizeof(data));
+    SSF_ASSERT(SSFCfgWriteAsync(data, SSF_CFG_QUEUE_MAX_DATA_LEN, 0, 10, _SSFCfgUTQueueDoneFn,
+                                &_ssfCfgUTQueueDone));
+    SSF_ATOMIC_STORE_U32(&_ssfCfgUTQueueStop, 0);
+    SSF_ASSERT(pthread_create(&thread, NULL, _SSFCfgUTQueueTask, NULL) == 0);
+    while (SSF_ATOMIC_LOAD_U32(&_ssfCfgStorageRAMErases[0]) == erases) { sched_yield(); }
+    memset(data, 0x5b, sizeof(data));
+    start = SSFPortGetHRTick64();
+    SSF_ASSERT(SSFCfgWrite(data, 1, SSF_CFG_UT_QUEUE_ID, 11));
+    SSF_ASSERT((SSFPortGetHRTick64() - start) <
+               ((uint64_t)SSF_CFG_UT_QUEUE_SLOW_DELAY * SSF_CFG_QUEUE_MAX_DATA_LEN / 4u));
+    SSF_ASSERT(SSF_ATOMIC_LOAD_U32(&_ssfCfgUTQueueDone) == done);
+    SSF_ATOMIC_STORE_U32(&_ssfCfgUTQueueStop, 1);
+    SSF_ASSERT(pthread_join(thread, NULL) == 0);
+    _ssfCfgStorageRAMWriteDelay = 0;
+    SSF_ASSERT((_ssfCfgUTQueueDone == (done + 1u)) && (_ssfCfgUTQueueDoneId == 0) &&
+               _ssfCfgUTQueueDoneIsWritten);
+    _SSFCfgUTQueueIs(0, 0x5a, SSF_CFG_QUEUE_MAX_DATA_LEN, 10);
+    _SSFCfgUTQueueIs(SSF_CFG_UT_QUEUE_ID, 0x5b, 1, 11);
+#endif
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    /* Caller latency of synchronous (i == 0) versus queued (i == 1) writes to slow flash */
+    _ssfCfgStorageRAMWriteDelay = SSF_CFG_UT_QUEUE_WRITE_DELAY;
+    for (i = 0; i < 2; i++)
+    {
+        SSF_ATOMIC_STORE_U32(&_ssfCfgUTQueueStop, 0);
+        SSF_ASSERT(pthread_create(&thread, NULL, _SSFCfgUTQueueTask, NULL) == 0);
+        for (n = 0; n < SSF_CFG_UT_QUEUE_BENCH_WRITES; n++)
+        {
+            memset(data, (int)(n & 0xffu), sizeof(data));
+            start = SSFPortGetHRTick64();
+            if (i == 0) SSF_ASSERT(SSFCfgWrite(data, 32, SSF_CFG_UT_QUEUE_ID, 9));
+            else SSF_ASSERT(SSFCfgWriteAsync(data, 32, SSF_CFG_UT_QUEUE_ID, 9, NULL, NULL));
+            _ssfCfgUTQueueTicks[n] = SSFPortGetHRTick64() - start;
+            sched_yield();
+        }
+        SSF_ATOMIC_STORE_U32(&_ssfCfgUTQueueStop, 1);
+        SSF_ASSERT(pthread_join(thread, NULL) == 0);
+
+        /* Insertion sort for the percentiles */
+        for (n = 1; n < SSF_CFG_UT_QUEUE_BENCH_WRITES; n++)
+        {
+            tmp = _ssfCfgUTQueueTicks[n];
+            for (j = n; (j > 0) && (_ssfCfgUTQueueTicks[j - 1] > tmp); j--)
+            { _ssfCfgUTQueueTicks[j] = _ssfCfgUTQueueTicks[j - 1]; }
+            _ssfCfgUTQueueTicks[j] = tmp;
+        }
+        printf("\r\n  Cfg %s write latency: p50 %llu ns, p99 %llu ns\r\n",
+               (i == 0) ? "sync" : "async",
+               (unsigned long long)((_ssfCfgUTQueueTicks[SSF_CFG_UT_QUEUE_BENCH_WRITES / 2u] *
+                                     1000000000ull) / SSF_HR_TICKS_PER_SEC),
+               (unsigned long long)((_ssfCfgUTQueueTicks[(SSF_CFG_UT_QUEUE_BENCH_WRITES * 99u) /
+                                                         100u] * 1000000000ull) /
+                                    SSF_HR_TICKS_PER_SEC));
+    }
+    _ssfCfgStorageRAMWriteDelay = 0;
+#endif
+#endif
+}
+#endif /* SSF_CFG_ENABLE_WRITE_QUEUE */
+
+#if SSF_CFG_STORAGE_FILE == 1
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+#define SSF_CFG_UT_FILE_BENCH_OPS (2000u)
+static const char *_ssfCfgUTFileModes[SSF_CFG_FILE_MAX] = { "sync", "async", "batched" };
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/* Unit tests storage in a memory-mapped file.                                                   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFCfgUTFile(void)
+{
+    static uint8_t ram[sizeof(_ssfCfgStorageRAM)];
+    char path[] = "/tmp/ssfcfg_ut_XXXXXX";
+    uint8_t data1[32];
+    uint8_t data2[32];
+    uint16_t data2Len;
+    int fd;
+    uint32_t d;
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    uint64_t start;
+    uint64_t writeTicks;
+    uint64_t readTicks;
+    uint32_t i;
+#endif
+
+    SSF_ASSERT_TEST(SSFCfgFileOpen(NULL, SSF_CFG_FILE_SYNC));
+    SSF_ASSERT_TEST(SSFCfgFileOpen(path, SSF_CFG_FILE_MAX));
+    SSF_ASSERT_TEST(SSFCfgFileSync());
+    SSF_ASSERT_TEST(SSFCfgFileClose());
+
+    fd = mkstemp(path);
+    SSF_ASSERT(fd >= 0);
+    SSF_ASSERT(close(fd) == 0);
+
+    /* File must be creatable and new or sized like RAM storage */
+    SSF_ASSERT(SSFCfgFileOpen("/nonexistent/ssfcfg", SSF_CFG_FILE_SYNC) == false);
+    SSF_ASSERT(truncate(path, 1) == 0);
+    SSF_ASSERT(SSFCfgFileOpen(path, SSF_CFG_FILE_SYNC) == false);
+    SSF_ASSERT(truncate(path, 0) == 0);
+    SSF_ASSERT(SSFCfgFileOpen(path, SSF_CFG_FILE_SYNC));
+    SSF_ASSERT_TEST(SSFCfgFileOpen(path, SSF_CFG_FILE_SYNC));
+    SSFCfgFileClose();
+
+    for (d = 0; d < SSF_CFG_FILE_MAX; d++)
+    {
+        SSF_ASSERT(truncate(path, 0) == 0);
+        memcpy(ram, _ssfCfgStorageRAM, sizeof(ram));
+        SSF_ASSERT(SSFCfgFileOpen(path, (SSFCfgFileDurability_t)d));
+
+        /* New file is blank */
+        SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 0) == SSF_CFG_DATA_VERSION_INVALID);
+        memset(data1, (int)d, sizeof(data1));
+        SSF_ASSERT(SSFCfgWrite(data1, sizeof(data1), 0, 1));
+        SSF_ASSERT(SSFCfgWrite(data1, sizeof(data1), 0, 1) == false);
+        SSF_ASSERT(SSFCfgWrite(data1, sizeof(data1) / 2, 1, 2));
+        SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 0) == 1);
+        SSF_ASSERT((data2Len == sizeof(data1)) && (memcmp(data1, data2, data2Len) == 0));
+        SSFCfgFileSync();
+        SSFCfgFileClose();
+
+        /* RAM storage is untouched while the file is open */
+        SSF_ASSERT(memcmp(ram, _ssfCfgStorageRAM, sizeof(ram)) == 0);
+
+        /* Data persists in the file */
+        SSF_ASSERT(SSFCfgFileOpen(path, (SSFCfgFileDurability_t)d));
+        memset(data2, 0xff, sizeof(data2));
+        SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 0) == 1);
+        SSF_ASSERT((data2Len == sizeof(data1)) && (memcmp(data1, data2, data2Len) == 0));
+        SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == 2);
+        SSF_ASSERT((data2Len == (sizeof(data1) / 2)) && (memcmp(data1, data2, data2Len) == 0));
+        SSFCfgFileClose();
+    }
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    for (d = 0; d < SSF_CFG_FILE_MAX; d++)
+    {
+        SSF_ASSERT(truncate(path, 0) == 0);
+        SSF_ASSERT(SSFCfgFileOpen(path, (SSFCfgFileDurability_t)d));
+        start = SSFPortGetHRTick64();
+        for (i = 0; i < SSF_CFG_UT_FILE_BENCH_OPS; i++)
+        {
+            memset(data1, (int)i, sizeof(data1));
+            SSF_ASSERT(SSFCfgWrite(data1, sizeof(data1), i & 3u, 1));
+        }
+        writeTicks = SSFPortGetHRTick64() - start;
+        start = SSFPortGetHRTick64();
+        for (i = 0; i < SSF_CFG_UT_FILE_BENCH_OPS; i++)
+        { SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), i & 3u) == 1); }
+        readTicks = SSFPortGetHRTick64() - start;
+        SSFCfgFileClose();
+        printf("\r\n  File storage %s: %llu writes/sec, %llu reads/sec\r\n",
+               _ssfCfgUTFileModes[d],
+               (unsigned long long)((SSF_CFG_UT_FILE_BENCH_OPS * SSF_HR_TICKS_PER_SEC) /
+                                    (writeTicks == 0 ? 1 : writeTicks)),
+               (unsigned long long)((SSF_CFG_UT_FILE_BENCH_OPS * SSF_HR_TICKS_PER_SEC) /
+                                    (readTicks == 0 ? 1 : readTicks)));
+    }
+#endif
+    SSF_ASSERT(unlink(path) == 0);
+}
+#endif /* SSF_CFG_STORAGE_FILE */
+
 /* --------------------------------------------------------------------------------------------- */
 /* Units tests the for configuration data storage interface.                                     */
 /* --------------------------------------------------------------------------------------------- */
@@ -58,7 +1351,9 @@ void SSFCfgUnitTest(void)
 
     /* Check SSFCfgWrite requirements */
     SSF_ASSERT_TEST(SSFCfgWrite(NULL, 1, 0, 0));
+#if SSF_CFG_ENABLE_COMPRESSION == 0
     SSF_ASSERT_TEST(SSFCfgWrite(data1, 65535, 0, 0));
+#endif
     SSF_ASSERT_TEST(SSFCfgWrite(data1, 1, 0, SSF_CFG_DATA_VERSION_INVALID));
 #if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
     SSF_ASSERT_TEST(SSFCfgWrite(data1, 1, 0, 0));
@@ -118,7 +1413,16 @@ void SSFCfgUnitTest(void)
     SSF_ASSERT(memcmp(data1, data2, data2Len) == 0);
     SSF_ASSERT(SSFCfgWrite(data1, sizeof(data1), 0, 1) == false);
 
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    _SSFCfgUTCorrupt(data1, sizeof(data1));
+#else
     _ssfCfgStorageRAM[0][0] = 0;
+#endif
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+    /* Validated record stays cached until the cache is invalidated */
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 0) == 1);
+    SSFCfgCacheInvalidate();
+#endif
     SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 0) == SSF_CFG_DATA_VERSION_INVALID);
 
     memset(data1, 0x01, sizeof(data1));
@@ -154,12 +1458,26 @@ void SSFCfgUnitTest(void)
     SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data1), 0) == 3);
     SSF_ASSERT(data2Len == sizeof(data1));
 
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    /* Read from pristine/erased log (never written, all 0xFF) */
+    memset(_ssfCfgStorageRAM, 0xFF, sizeof(_ssfCfgStorageRAM));
+    SSFCfgRecover();
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == SSF_CFG_DATA_VERSION_INVALID);
+    /* All zeros is also invalid (magic won't match) */
+    memset(_ssfCfgStorageRAM, 0x00, sizeof(_ssfCfgStorageRAM));
+    SSFCfgRecover();
+    SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == SSF_CFG_DATA_VERSION_INVALID);
+#else
     /* Read from pristine/erased sector (never written, all 0xFF) */
     memset(_ssfCfgStorageRAM[1], 0xFF, SSF_CFG_MAX_STORAGE_SIZE);
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+    SSFCfgCacheInvalidate();
+#endif
     SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == SSF_CFG_DATA_VERSION_INVALID);
     /* All zeros is also invalid (magic won't match) */
     memset(_ssfCfgStorageRAM[1], 0x00, SSF_CFG_MAX_STORAGE_SIZE);
     SSF_ASSERT(SSFCfgRead(data2, &data2Len, sizeof(data2), 1) == SSF_CFG_DATA_VERSION_INVALID);
+#endif
 
     /* Write different data to same sector overwrites previous */
     memset(data1, 0xBB, sizeof(data1));
@@ -190,6 +1508,31 @@ void SSFCfgUnitTest(void)
     SSF_ASSERT(memcmp(data1, data2, data2Len) == 0);
     SSF_ASSERT(data2[0] == 0xEE);
 
+#if SSF_CFG_ENABLE_LOG_STORAGE == 1
+    _SSFCfgUTLog();
+    _SSFCfgUTTx();
+#endif
+
+#if SSF_CFG_ENABLE_READ_CACHE == 1
+    _SSFCfgUTCache();
+#endif
+
+#if SSF_CFG_ENABLE_COMPRESSION == 1
+    _SSFCfgUTLZ();
+#endif
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+    _SSFCfgUTMT();
+#endif
+
+#if SSF_CFG_ENABLE_WRITE_QUEUE == 1
+    _SSFCfgUTQueue();
+#endif
+
+#if SSF_CFG_STORAGE_FILE == 1
+    _SSFCfgUTFile();
+#endif
+
 #if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
     SSF_ASSERT_TEST(SSFCfgInit());
     SSFCfgDeInit();
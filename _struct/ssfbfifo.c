@@ -30,9 +30,48 @@
 /* OF THE POSSIBILITY OF SUCH DAMAGE.                                                            */
 /* --------------------------------------------------------------------------------------------- */
 #include "ssfbfifo.h"
+#if SSF_BFIFO_MIRROR_MAP == 1
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
 
 #define SSF_BFIFO_INIT_MAGIC (0x42120716ul)
 
+/* Number of bytes in the ring buffer, one more than the fifo capacity */
+#if SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE == SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE_255
+#define SSF_BFIFO_RING_SIZE(fifo) ((uint32_t)(SSF_BFIFO_255 + 1ul))
+#else
+#define SSF_BFIFO_RING_SIZE(fifo) ((fifo)->size)
+#endif
+
+/* Wraps an index advanced by less than the ring size back into the ring */
+#if SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE == SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE_POW2_MINUS1
+#define SSF_BFIFO_WRAP(fifo, index) ((index) & (fifo)->mask)
+#else
+#define SSF_BFIFO_WRAP(fifo, index) \
+    (((index) >= SSF_BFIFO_RING_SIZE(fifo)) ? ((index) - SSF_BFIFO_RING_SIZE(fifo)) : (index))
+#endif
+
+/* Copies of up to this many bytes are done a byte at a time */
+#define SSF_BFIFO_SHORT_COPY_LEN (16u)
+
+/* Number of bytes in the fifo */
+#define SSF_BFIFO_USED(fifo) (((fifo)->head >= (fifo)->tail) ? \
+    (uint32_t)((fifo)->head - (fifo)->tail) : \
+    (uint32_t)(SSF_BFIFO_RING_SIZE(fifo) - (uint32_t)((fifo)->tail - (fifo)->head)))
+#if SSF_BFIFO_CONFIG_ENABLE_SPSC == 1
+#define SSF_BFIFO_SPSC_INIT_MAGIC (0x42535053ul)
+#endif
+#if SSF_BFIFO_CONFIG_ENABLE_MIRROR == 1
+#define SSF_BFIFO_MIRROR_INIT_MAGIC (0x424d4952ul)
+#endif
+#if SSF_BFIFO_CONFIG_ENABLE_BCAST == 1
+#define SSF_BFIFO_BCAST_INIT_MAGIC (0x42424341ul)
+#define SSF_BFIFO_BCAST_READER_INIT_MAGIC (0x42425244ul)
+#endif
+
 /* --------------------------------------------------------------------------------------------- */
 /* Initializes a byte fifo.                                                                      */
 /* --------------------------------------------------------------------------------------------- */
@@ -204,29 +243,78 @@ ssfbf_uint_t SSFBFifoUnused(const SSFBFifo_t *fifo)
     return SSFBFifoSize(fifo) - SSFBFifoLen(fifo);
 }
 
+#if (SSF_BFIFO_MULTI_BYTE_ENABLE == 1) || (SSF_BFIFO_CONFIG_ENABLE_SPSC == 1) || \
+    (SSF_BFIFO_CONFIG_ENABLE_MIRROR == 1) || (SSF_BFIFO_CONFIG_ENABLE_BCAST == 1)
+/* --------------------------------------------------------------------------------------------- */
+/* Copies len bytes, short copies use a loop because a memcpy() call costs more than it saves.   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoCopy(uint8_t *dst, const uint8_t *src, uint32_t len)
+{
+    if (len > SSF_BFIFO_SHORT_COPY_LEN) { memcpy(dst, src, len); return; }
+    while (len)
+    {
+        *dst = *src;
+        dst++;
+        src++;
+        len--;
+    }
+}
+#endif
+
+#if (SSF_BFIFO_MULTI_BYTE_ENABLE == 1) || (SSF_BFIFO_CONFIG_ENABLE_SPSC == 1)
+/* --------------------------------------------------------------------------------------------- */
+/* Sets span to the len bytes of a ring buffer of ringSize bytes starting at index.              */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoSetSpan(uint8_t *buffer, uint32_t ringSize, uint32_t index, uint32_t len,
+                             SSFBFifoSpan_t *span)
+{
+    uint32_t first;
+
+    first = ringSize - index;
+    if (first > len) first = len;
+    span->ptr[0] = &buffer[index];
+    span->len[0] = first;
+    span->len[1] = len - first;
+    span->ptr[1] = (span->len[1] == 0) ? NULL : buffer;
+}
+#endif
+
 #if SSF_BFIFO_MULTI_BYTE_ENABLE == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Copies len bytes out of the fifo buffer starting at index, in at most two blocks.             */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoCopyOut(const SSFBFifo_t *fifo, uint32_t index, uint8_t *outBytes,
+                             uint32_t len)
+{
+    uint32_t first;
+
+    first = SSF_BFIFO_RING_SIZE(fifo) - index;
+    if (first > len) first = len;
+    _SSFBFifoCopy(outBytes, &fifo->buffer[index], first);
+    if (len > first) _SSFBFifoCopy(&outBytes[first], fifo->buffer, len - first);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /* Puts bytes into the fifo.                                                                     */
 /* --------------------------------------------------------------------------------------------- */
 void SSFBFifoPutBytes(SSFBFifo_t *fifo, const uint8_t *inBytes, uint32_t inBytesLen)
 {
+    uint32_t head;
+    uint32_t first;
+
     SSF_REQUIRE(fifo != NULL);
     SSF_REQUIRE(inBytes != NULL);
     SSF_REQUIRE(fifo->magic == SSF_BFIFO_INIT_MAGIC);
+    SSF_REQUIRE(inBytesLen < (SSF_BFIFO_RING_SIZE(fifo) - SSF_BFIFO_USED(fifo)));
 
-    while (inBytesLen)
-    {
-        fifo->buffer[fifo->head] = *inBytes;
-        fifo->head++;
-#if SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE == SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE_POW2_MINUS1
-        fifo->head &= fifo->mask;
-#elif SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE == SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE_ANY
-        if (fifo->head == fifo->size) fifo->head = 0;
-#endif
-        SSF_ENSURE(fifo->head != fifo->tail);
-        inBytesLen--;
-        inBytes++;
-    }
+    /* Copy up to the end of the buffer, then the rest from the start */
+    head = fifo->head;
+    first = SSF_BFIFO_RING_SIZE(fifo) - head;
+    if (first > inBytesLen) first = inBytesLen;
+    _SSFBFifoCopy(&fifo->buffer[head], inBytes, first);
+    if (inBytesLen > first) _SSFBFifoCopy(fifo->buffer, &inBytes[first], inBytesLen - first);
+
+    fifo->head = (ssfbf_uint_t)SSF_BFIFO_WRAP(fifo, head + inBytesLen);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -235,8 +323,7 @@ void SSFBFifoPutBytes(SSFBFifo_t *fifo, const uint8_t *inBytes, uint32_t inBytes
 bool SSFBFifoPeekBytes(const SSFBFifo_t *fifo, uint8_t *outBytes, uint32_t outBytesSize,
                        uint32_t *outBytesLen)
 {
-    ssfbf_uint_t head;
-    ssfbf_uint_t tail;
+    uint32_t len;
 
     SSF_REQUIRE(fifo != NULL);
     SSF_REQUIRE(outBytes != NULL);
@@ -245,22 +332,10 @@ bool SSFBFifoPeekBytes(const SSFBFifo_t *fifo, uint8_t *outBytes, uint32_t outBy
 
     if (fifo->head == fifo->tail) return false;
 
-    head = fifo->head;
-    tail = fifo->tail;
-    *outBytesLen = 0;
-    while (outBytesSize && (head != tail))
-    {
-        *outBytes = fifo->buffer[tail];
-        tail++;
-#if SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE == SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE_POW2_MINUS1
-        tail &= fifo->mask;
-#elif SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE == SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE_ANY
-        if (tail == fifo->size) tail = 0;
-#endif
-        outBytesSize--;
-        outBytes++;
-        (*outBytesLen)++;
-    }
+    len = SSF_BFIFO_USED(fifo);
+    if (len > outBytesSize) len = outBytesSize;
+    _SSFBFifoCopyOut(fifo, fifo->tail, outBytes, len);
+    *outBytesLen = len;
     return true;
 }
 
@@ -270,6 +345,9 @@ bool SSFBFifoPeekBytes(const SSFBFifo_t *fifo, uint8_t *outBytes, uint32_t outBy
 bool SSFBFifoGetBytes(SSFBFifo_t *fifo, uint8_t *outBytes, uint32_t outBytesSize,
                       uint32_t *outBytesLen)
 {
+    uint32_t tail;
+    uint32_t len;
+
     SSF_REQUIRE(fifo != NULL);
     SSF_REQUIRE(outBytes != NULL);
     SSF_REQUIRE(outBytesLen != NULL);
@@ -277,21 +355,776 @@ bool SSFBFifoGetBytes(SSFBFifo_t *fifo, uint8_t *outBytes, uint32_t outBytesSize
 
     if (fifo->head == fifo->tail) return false;
 
-    *outBytesLen = 0;
-    while (outBytesSize && (fifo->head != fifo->tail))
+    tail = fifo->tail;
+    len = SSF_BFIFO_USED(fifo);
+    if (len > outBytesSize) len = outBytesSize;
+    _SSFBFifoCopyOut(fifo, tail, outBytes, len);
+
+    fifo->tail = (ssfbf_uint_t)SSF_BFIFO_WRAP(fifo, tail + len);
+    *outBytesLen = len;
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Sets span to up to len free bytes after the head, returns the span's total length.            */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoReserve(SSFBFifo_t *fifo, uint32_t len, SSFBFifoSpan_t *span)
+{
+    uint32_t unused;
+
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(span != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_INIT_MAGIC);
+
+    unused = SSF_BFIFO_RING_SIZE(fifo) - 1 - SSF_BFIFO_USED(fifo);
+    if (len > unused) len = unused;
+    _SSFBFifoSetSpan(fifo->buffer, SSF_BFIFO_RING_SIZE(fifo), fifo->head, len, span);
+    return len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Adds len bytes written into a span from SSFBFifoReserve() to the fifo.                        */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoCommit(SSFBFifo_t *fifo, uint32_t len)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_INIT_MAGIC);
+    SSF_REQUIRE(len < (SSF_BFIFO_RING_SIZE(fifo) - SSF_BFIFO_USED(fifo)));
+
+    fifo->head = (ssfbf_uint_t)SSF_BFIFO_WRAP(fifo, (uint32_t)fifo->head + len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Sets span to all bytes in the fifo without removing them, returns the span's total length.    */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoPeekSpan(const SSFBFifo_t *fifo, SSFBFifoSpan_t *span)
+{
+    uint32_t len;
+
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(span != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_INIT_MAGIC);
+
+    len = SSF_BFIFO_USED(fifo);
+    _SSFBFifoSetSpan(fifo->buffer, SSF_BFIFO_RING_SIZE(fifo), fifo->tail, len, span);
+    return len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Removes len bytes from the fifo, usually after processing them in place via a peeked span.    */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoConsume(SSFBFifo_t *fifo, uint32_t len)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_INIT_MAGIC);
+    SSF_REQUIRE(len <= SSF_BFIFO_USED(fifo));
+
+    fifo->tail = (ssfbf_uint_t)SSF_BFIFO_WRAP(fifo, (uint32_t)fifo->tail + len);
+}
+#endif /* SSF_BFIFO_MULTI_BYTE_ENABLE */
+
+#if SSF_BFIFO_CONFIG_ENABLE_SPSC == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes a lock-free SPSC byte fifo, fifoSize must be a power of 2.                        */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoSPSCInit(SSFBFifoSPSC_t *fifo, uint32_t fifoSize, uint8_t *buffer,
+                      uint32_t bufferSize)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifoSize > 0);
+    SSF_REQUIRE((fifoSize & (fifoSize - 1)) == 0);
+    SSF_REQUIRE(fifoSize <= 0x80000000ul);
+    SSF_REQUIRE(buffer != NULL);
+    SSF_REQUIRE(bufferSize >= fifoSize);
+    SSF_REQUIRE(fifo->magic != SSF_BFIFO_SPSC_INIT_MAGIC);
+
+    memset(fifo, 0, sizeof(SSFBFifoSPSC_t));
+    fifo->buffer = buffer;
+    fifo->size = fifoSize;
+    fifo->mask = fifoSize - 1;
+    fifo->magic = SSF_BFIFO_SPSC_INIT_MAGIC;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Deinitializes a lock-free SPSC byte fifo, producer and consumer must be stopped.              */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoSPSCDeInit(SSFBFifoSPSC_t *fifo)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_SPSC_INIT_MAGIC);
+
+    memset(fifo, 0, sizeof(SSFBFifoSPSC_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the number of bytes the producer may write, rereads tail only if the cache is short.  */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFBFifoSPSCUnused(SSFBFifoSPSC_t *fifo, uint32_t head, uint32_t needed)
+{
+    uint32_t unused;
+
+    unused = fifo->size - (head - fifo->tailCache);
+    if (unused < needed)
     {
-        *outBytes = fifo->buffer[fifo->tail];
-        fifo->tail++;
-#if SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE == SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE_POW2_MINUS1
-        fifo->tail &= fifo->mask;
-#elif SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE == SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE_ANY
-        if (fifo->tail == fifo->size) fifo->tail = 0;
+        fifo->tailCache = SSF_ATOMIC_LOAD_U32(&fifo->tail);
+        unused = fifo->size - (head - fifo->tailCache);
+    }
+    return unused;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the number of bytes the consumer may read, rereads head only if the cache is short.   */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFBFifoSPSCUsed(SSFBFifoSPSC_t *fifo, uint32_t tail, uint32_t needed)
+{
+    uint32_t used;
+
+    used = fifo->headCache - tail;
+    if ((used == 0) || (used < needed))
+    {
+        fifo->headCache = SSF_ATOMIC_LOAD_U32(&fifo->head);
+        used = fifo->headCache - tail;
+    }
+    return used;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Producer only; returns true if byte put into fifo, else false if fifo full.                   */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFBFifoSPSCPutByte(SSFBFifoSPSC_t *fifo, uint8_t inByte)
+{
+    uint32_t head;
+
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_SPSC_INIT_MAGIC);
+
+    head = fifo->head;
+    if (_SSFBFifoSPSCUnused(fifo, head, 1) == 0) return false;
+
+    fifo->buffer[head & fifo->mask] = inByte;
+    SSF_ATOMIC_STORE_U32(&fifo->head, head + 1);
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Producer only; puts up to inBytesLen bytes into fifo, returns number of bytes put.            */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoSPSCPutBytes(SSFBFifoSPSC_t *fifo, const uint8_t *inBytes, uint32_t inBytesLen)
+{
+    uint32_t head;
+    uint32_t offset;
+    uint32_t len;
+    uint32_t first;
+
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(inBytes != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_SPSC_INIT_MAGIC);
+
+    head = fifo->head;
+    len = _SSFBFifoSPSCUnused(fifo, head, inBytesLen);
+    if (len > inBytesLen) len = inBytesLen;
+    if (len == 0) return 0;
+
+    /* Copy up to the end of the buffer, then the rest from the start */
+    offset = head & fifo->mask;
+    first = fifo->size - offset;
+    if (first > len) first = len;
+    _SSFBFifoCopy(&fifo->buffer[offset], inBytes, first);
+    if (len > first) _SSFBFifoCopy(fifo->buffer, &inBytes[first], len - first);
+    SSF_ATOMIC_STORE_U32(&fifo->head, head + len);
+    return len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Consumer only; returns true if byte removed from fifo into outByte, else false if empty.      */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFBFifoSPSCGetByte(SSFBFifoSPSC_t *fifo, uint8_t *outByte)
+{
+    uint32_t tail;
+
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(outByte != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_SPSC_INIT_MAGIC);
+
+    tail = fifo->tail;
+    if (_SSFBFifoSPSCUsed(fifo, tail, 1) == 0) return false;
+
+    *outByte = fifo->buffer[tail & fifo->mask];
+    SSF_ATOMIC_STORE_U32(&fifo->tail, tail + 1);
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Consumer only; returns true if bytes avail, removes up to size into out, updates len.         */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFBFifoSPSCGetBytes(SSFBFifoSPSC_t *fifo, uint8_t *outBytes, uint32_t outBytesSize,
+                          uint32_t *outBytesLen)
+{
+    uint32_t tail;
+    uint32_t offset;
+    uint32_t len;
+    uint32_t first;
+
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(outBytes != NULL);
+    SSF_REQUIRE(outBytesLen != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_SPSC_INIT_MAGIC);
+
+    tail = fifo->tail;
+    len = _SSFBFifoSPSCUsed(fifo, tail, outBytesSize);
+    if (len == 0) return false;
+    if (len > outBytesSize) len = outBytesSize;
+
+    offset = tail & fifo->mask;
+    first = fifo->size - offset;
+    if (first > len) first = len;
+    _SSFBFifoCopy(outBytes, &fifo->buffer[offset], first);
+    if (len > first) _SSFBFifoCopy(&outBytes[first], fifo->buffer, len - first);
+    SSF_ATOMIC_STORE_U32(&fifo->tail, tail + len);
+    *outBytesLen = len;
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the maximum number of bytes the fifo can store.                                       */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoSPSCSize(const SSFBFifoSPSC_t *fifo)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_SPSC_INIT_MAGIC);
+
+    return fifo->size;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns a snapshot of the number of bytes in the fifo, callable from any thread.              */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoSPSCLen(const SSFBFifoSPSC_t *fifo)
+{
+    uint32_t tail;
+    uint32_t used;
+
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_SPSC_INIT_MAGIC);
+
+    /* Load tail first so head can only be ahead of it, clamp if both moved between the loads */
+    tail = SSF_ATOMIC_LOAD_U32(&fifo->tail);
+    used = SSF_ATOMIC_LOAD_U32(&fifo->head) - tail;
+    if (used > fifo->size) used = fifo->size;
+    return used;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns a snapshot of the number of unused bytes in the fifo, callable from any thread.       */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoSPSCUnused(const SSFBFifoSPSC_t *fifo)
+{
+    return SSFBFifoSPSCSize(fifo) - SSFBFifoSPSCLen(fifo);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Producer only; sets span to up to len free bytes, returns the span's total length.            */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoSPSCReserve(SSFBFifoSPSC_t *fifo, uint32_t len, SSFBFifoSpan_t *span)
+{
+    uint32_t head;
+    uint32_t unused;
+
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(span != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_SPSC_INIT_MAGIC);
+
+    head = fifo->head;
+    unused = _SSFBFifoSPSCUnused(fifo, head, len);
+    if (len > unused) len = unused;
+    _SSFBFifoSetSpan(fifo->buffer, fifo->size, head & fifo->mask, len, span);
+    return len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Producer only; publishes len bytes written into a span from SSFBFifoSPSCReserve().            */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoSPSCCommit(SSFBFifoSPSC_t *fifo, uint32_t len)
+{
+    uint32_t head;
+
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_SPSC_INIT_MAGIC);
+
+    head = fifo->head;
+    SSF_REQUIRE(len <= (fifo->size - (head - fifo->tailCache)));
+    SSF_ATOMIC_STORE_U32(&fifo->head, head + len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Consumer only; sets span to all published bytes, returns the span's total length.             */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoSPSCPeekSpan(SSFBFifoSPSC_t *fifo, SSFBFifoSpan_t *span)
+{
+    uint32_t tail;
+    uint32_t len;
+
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(span != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_SPSC_INIT_MAGIC);
+
+    tail = fifo->tail;
+    len = _SSFBFifoSPSCUsed(fifo, tail, fifo->size);
+    _SSFBFifoSetSpan(fifo->buffer, fifo->size, tail & fifo->mask, len, span);
+    return len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Consumer only; removes len bytes, usually after processing them in place via a peeked span.   */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoSPSCConsume(SSFBFifoSPSC_t *fifo, uint32_t len)
+{
+    uint32_t tail;
+
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_SPSC_INIT_MAGIC);
+
+    tail = fifo->tail;
+    SSF_REQUIRE(len <= (fifo->headCache - tail));
+    SSF_ATOMIC_STORE_U32(&fifo->tail, tail + len);
+}
+#endif /* SSF_BFIFO_CONFIG_ENABLE_SPSC */
+
+#if SSF_BFIFO_CONFIG_ENABLE_MIRROR == 1
+#if SSF_BFIFO_MIRROR_MAP == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if fifoSize bytes of memfd pages were mapped twice back to back, else false.     */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFBFifoMirrorMap(SSFBFifoMirror_t *fifo, uint32_t fifoSize)
+{
+    long pageSize;
+    int fd;
+    uint8_t *base = (uint8_t *)MAP_FAILED;
+
+    pageSize = sysconf(_SC_PAGESIZE);
+    if ((pageSize <= 0) || ((fifoSize % (uint32_t)pageSize) != 0)) return false;
+#if SIZE_MAX <= 0xfffffffful
+    if (fifoSize > (SIZE_MAX >> 1)) return false;
+#endif
+#ifdef SYS_memfd_create
+    fd = (int)syscall(SYS_memfd_create, "ssfbfifo", 0u);
+#else
+    fd = -1;
 #endif
-        outBytesSize--;
-        outBytes++;
-        (*outBytesLen)++;
+    if (fd < 0) return false;
+
+    if (ftruncate(fd, (off_t)fifoSize) == 0)
+    {
+        /* Reserve address space for both copies, then map the same pages over each half */
+        base = (uint8_t *)mmap(NULL, (size_t)fifoSize << 1, PROT_NONE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if ((base != (uint8_t *)MAP_FAILED) &&
+            ((mmap(base, fifoSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) ==
+              MAP_FAILED) ||
+             (mmap(&base[fifoSize], fifoSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd,
+                   0) == MAP_FAILED)))
+        {
+            munmap(base, (size_t)fifoSize << 1);
+            base = (uint8_t *)MAP_FAILED;
+        }
     }
+    close(fd);
+    if (base == (uint8_t *)MAP_FAILED) return false;
+
+    fifo->buffer = base;
     return true;
 }
-#endif /* SSF_BFIFO_MULTI_BYTE_ENABLE */
+#endif /* SSF_BFIFO_MIRROR_MAP */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if mirror fifo initialized, else false if it could not be mapped and no buffer.  */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFBFifoMirrorInit(SSFBFifoMirror_t *fifo, uint32_t fifoSize, uint8_t *buffer,
+                        uint32_t bufferSize)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifoSize > 0);
+    SSF_REQUIRE(fifoSize <= 0x80000000ul);
+    SSF_REQUIRE((buffer == NULL) || (bufferSize >= fifoSize));
+    SSF_REQUIRE(fifo->magic != SSF_BFIFO_MIRROR_INIT_MAGIC);
+
+    memset(fifo, 0, sizeof(SSFBFifoMirror_t));
+#if SSF_BFIFO_MIRROR_MAP == 1
+    fifo->isMapped = _SSFBFifoMirrorMap(fifo, fifoSize);
+#endif
+    if (fifo->isMapped == false)
+    {
+        /* Fall back to the plain buffer */
+        if (buffer == NULL) return false;
+        fifo->buffer = buffer;
+    }
+    fifo->size = fifoSize;
+    fifo->magic = SSF_BFIFO_MIRROR_INIT_MAGIC;
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Deinitializes a mirror fifo, unmapping its buffer if mapped.                                  */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoMirrorDeInit(SSFBFifoMirror_t *fifo)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_MIRROR_INIT_MAGIC);
+
+#if SSF_BFIFO_MIRROR_MAP == 1
+    if (fifo->isMapped) SSF_ASSERT(munmap(fifo->buffer, (size_t)fifo->size << 1) == 0);
+#endif
+    memset(fifo, 0, sizeof(SSFBFifoMirror_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if the buffer is mirrored memfd pages, else false if it is the plain buffer.     */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFBFifoMirrorIsMapped(const SSFBFifoMirror_t *fifo)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_MIRROR_INIT_MAGIC);
+
+    return fifo->isMapped;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Sets ptr to up to len contiguous free bytes, returns their length.                            */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoMirrorReserve(SSFBFifoMirror_t *fifo, uint32_t len, uint8_t **ptr)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(ptr != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_MIRROR_INIT_MAGIC);
+
+    if (len > (fifo->size - fifo->len)) len = fifo->size - fifo->len;
+
+    /* A plain buffer's free bytes are made contiguous by moving the queued bytes to its start */
+    if ((fifo->isMapped == false) && ((fifo->tail + fifo->len + len) > fifo->size))
+    {
+        memmove(fifo->buffer, &fifo->buffer[fifo->tail], fifo->len);
+        fifo->tail = 0;
+    }
+    *ptr = &fifo->buffer[fifo->tail + fifo->len];
+    return len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Adds len bytes written into the region from SSFBFifoMirrorReserve() to the fifo.              */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoMirrorCommit(SSFBFifoMirror_t *fifo, uint32_t len)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_MIRROR_INIT_MAGIC);
+    SSF_REQUIRE(len <= (fifo->size - fifo->len));
+    SSF_REQUIRE(fifo->isMapped || ((fifo->tail + fifo->len + len) <= fifo->size));
+
+    fifo->len += len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Sets ptr to all bytes in the fifo as one contiguous region, returns their length.             */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoMirrorPeekSpan(const SSFBFifoMirror_t *fifo, const uint8_t **ptr)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(ptr != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_MIRROR_INIT_MAGIC);
+
+    *ptr = &fifo->buffer[fifo->tail];
+    return fifo->len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Removes len bytes from the fifo, usually after processing them in place.                      */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoMirrorConsume(SSFBFifoMirror_t *fifo, uint32_t len)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_MIRROR_INIT_MAGIC);
+    SSF_REQUIRE(len <= fifo->len);
+
+    fifo->len -= len;
+    fifo->tail += len;
+    if (fifo->len == 0) fifo->tail = 0;
+    else if (fifo->tail >= fifo->size) fifo->tail -= fifo->size;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Puts bytes into the mirror fifo, asserts if they do not fit.                                  */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoMirrorPutBytes(SSFBFifoMirror_t *fifo, const uint8_t *inBytes, uint32_t inBytesLen)
+{
+    uint8_t *ptr;
+
+    SSF_REQUIRE(inBytes != NULL);
+    SSF_REQUIRE(SSFBFifoMirrorReserve(fifo, inBytesLen, &ptr) == inBytesLen);
+
+    _SSFBFifoCopy(ptr, inBytes, inBytesLen);
+    fifo->len += inBytesLen;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if bytes avail, removes up to size into out, updates len, else false.            */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFBFifoMirrorGetBytes(SSFBFifoMirror_t *fifo, uint8_t *outBytes, uint32_t outBytesSize,
+                            uint32_t *outBytesLen)
+{
+    const uint8_t *ptr;
+    uint32_t len;
+
+    SSF_REQUIRE(outBytes != NULL);
+    SSF_REQUIRE(outBytesLen != NULL);
+
+    len = SSFBFifoMirrorPeekSpan(fifo, &ptr);
+    if (len == 0) return false;
+    if (len > outBytesSize) len = outBytesSize;
+    _SSFBFifoCopy(outBytes, ptr, len);
+    SSFBFifoMirrorConsume(fifo, len);
+    *outBytesLen = len;
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the maximum number of bytes the mirror fifo can store.                                */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoMirrorSize(const SSFBFifoMirror_t *fifo)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_MIRROR_INIT_MAGIC);
+
+    return fifo->size;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the number of bytes in the mirror fifo.                                               */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoMirrorLen(const SSFBFifoMirror_t *fifo)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(fifo->magic == SSF_BFIFO_MIRROR_INIT_MAGIC);
+
+    return fifo->len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the number of unused bytes in the mirror fifo.                                        */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoMirrorUnused(const SSFBFifoMirror_t *fifo)
+{
+    return SSFBFifoMirrorSize(fifo) - SSFBFifoMirrorLen(fifo);
+}
+#endif /* SSF_BFIFO_CONFIG_ENABLE_MIRROR */
+
+#if SSF_BFIFO_CONFIG_ENABLE_BCAST == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes a broadcast byte ring, ringSize must be a power of 2.                             */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoBcastInit(SSFBFifoBcast_t *ring, uint32_t ringSize, uint8_t *buffer,
+                       uint32_t bufferSize)
+{
+    SSF_REQUIRE(ring != NULL);
+    SSF_REQUIRE(ringSize > 0);
+    SSF_REQUIRE((ringSize & (ringSize - 1)) == 0);
+    SSF_REQUIRE(ringSize <= 0x80000000ul);
+    SSF_REQUIRE(buffer != NULL);
+    SSF_REQUIRE(bufferSize >= ringSize);
+    SSF_REQUIRE(ring->magic != SSF_BFIFO_BCAST_INIT_MAGIC);
+
+    memset(ring, 0, sizeof(SSFBFifoBcast_t));
+    ring->buffer = buffer;
+    ring->size = ringSize;
+    ring->mask = ringSize - 1;
+    ring->magic = SSF_BFIFO_BCAST_INIT_MAGIC;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Deinitializes a broadcast byte ring, the producer and all readers must be stopped.            */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoBcastDeInit(SSFBFifoBcast_t *ring)
+{
+    SSF_REQUIRE(ring != NULL);
+    SSF_REQUIRE(ring->magic == SSF_BFIFO_BCAST_INIT_MAGIC);
+
+    memset(ring, 0, sizeof(SSFBFifoBcast_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Producer only; puts bytes into the ring for all readers, overwriting the oldest bytes.        */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoBcastPutBytes(SSFBFifoBcast_t *ring, const uint8_t *inBytes, uint32_t inBytesLen)
+{
+    uint32_t head;
+    uint32_t offset;
+    uint32_t first;
+
+    SSF_REQUIRE(ring != NULL);
+    SSF_REQUIRE(inBytes != NULL);
+    SSF_REQUIRE(ring->magic == SSF_BFIFO_BCAST_INIT_MAGIC);
+    SSF_REQUIRE(inBytesLen <= ring->size);
+
+    if (inBytesLen == 0) return;
+
+    /* Readers must see the overwritten region grow before any byte in it changes */
+    head = ring->head;
+    SSF_ATOMIC_STORE_U32(&ring->reserve, head + inBytesLen);
+    SSF_ATOMIC_FENCE();
+
+    offset = head & ring->mask;
+    first = ring->size - offset;
+    if (first > inBytesLen) first = inBytesLen;
+    _SSFBFifoCopy(&ring->buffer[offset], inBytes, first);
+    if (inBytesLen > first) _SSFBFifoCopy(ring->buffer, &inBytes[first], inBytesLen - first);
+    SSF_ATOMIC_STORE_U32(&ring->head, head + inBytesLen);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the number of bytes the broadcast ring holds for each reader.                         */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoBcastSize(const SSFBFifoBcast_t *ring)
+{
+    SSF_REQUIRE(ring != NULL);
+    SSF_REQUIRE(ring->magic == SSF_BFIFO_BCAST_INIT_MAGIC);
+
+    return ring->size;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes a reader that receives bytes put into the ring from now on.                       */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoBcastReaderInit(SSFBFifoBcastReader_t *reader, SSFBFifoBcast_t *ring,
+                             bool dropOnOverrun)
+{
+    SSF_REQUIRE(reader != NULL);
+    SSF_REQUIRE(ring != NULL);
+    SSF_REQUIRE(ring->magic == SSF_BFIFO_BCAST_INIT_MAGIC);
+    SSF_REQUIRE(reader->magic != SSF_BFIFO_BCAST_READER_INIT_MAGIC);
+
+    memset(reader, 0, sizeof(SSFBFifoBcastReader_t));
+    reader->ring = ring;
+    reader->cursor = SSF_ATOMIC_LOAD_U32(&ring->head);
+    reader->dropOnOverrun = dropOnOverrun;
+    reader->magic = SSF_BFIFO_BCAST_READER_INIT_MAGIC;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Deinitializes a reader, the producer may keep running.                                        */
+/* --------------------------------------------------------------------------------------------- */
+void SSFBFifoBcastReaderDeInit(SSFBFifoBcastReader_t *reader)
+{
+    SSF_REQUIRE(reader != NULL);
+    SSF_REQUIRE(reader->magic == SSF_BFIFO_BCAST_READER_INIT_MAGIC);
 
+    memset(reader, 0, sizeof(SSFBFifoBcastReader_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Handles an overrun reader, drops it or moves its cursor to the oldest byte, returns lost len. */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFBFifoBcastOverrun(SSFBFifoBcastReader_t *reader)
+{
+    uint32_t oldest;
+    uint32_t lost;
+
+    if (reader->dropOnOverrun)
+    {
+        reader->isDropped = true;
+        return 0;
+    }
+    oldest = SSF_ATOMIC_LOAD_U32(&reader->ring->reserve) - reader->ring->size;
+    lost = oldest - reader->cursor;
+    reader->cursor = oldest;
+    return lost;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if bytes read into out and/or bytes lost to an overrun, else false.              */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFBFifoBcastGetBytes(SSFBFifoBcastReader_t *reader, uint8_t *outBytes,
+                           uint32_t outBytesSize, uint32_t *outBytesLen, uint32_t *lostLen)
+{
+    SSFBFifoBcast_t *ring;
+    uint32_t cursor;
+    uint32_t offset;
+    uint32_t first;
+    uint32_t len;
+
+    SSF_REQUIRE(reader != NULL);
+    SSF_REQUIRE(outBytes != NULL);
+    SSF_REQUIRE(outBytesLen != NULL);
+    SSF_REQUIRE(lostLen != NULL);
+    SSF_REQUIRE(reader->magic == SSF_BFIFO_BCAST_READER_INIT_MAGIC);
+
+    *outBytesLen = 0;
+    *lostLen = 0;
+    if (reader->isDropped) return false;
+
+    ring = reader->ring;
+    cursor = reader->cursor;
+    len = SSF_ATOMIC_LOAD_U32(&ring->head) - cursor;
+    if (len > ring->size)
+    {
+        *lostLen = _SSFBFifoBcastOverrun(reader);
+        return *lostLen != 0;
+    }
+    if (len > outBytesSize) len = outBytesSize;
+    if (len == 0) return false;
+
+    offset = cursor & ring->mask;
+    first = ring->size - offset;
+    if (first > len) first = len;
+    _SSFBFifoCopy(outBytes, &ring->buffer[offset], first);
+    if (len > first) _SSFBFifoCopy(&outBytes[first], ring->buffer, len - first);
+
+    /* The copy is only valid if the producer did not start overwriting it meanwhile */
+    SSF_ATOMIC_FENCE();
+    if ((SSF_ATOMIC_LOAD_U32(&ring->reserve) - cursor) > ring->size)
+    {
+        *lostLen = _SSFBFifoBcastOverrun(reader);
+        return *lostLen != 0;
+    }
+    reader->cursor = cursor + len;
+    *outBytesLen = len;
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the number of bytes the reader is behind the producer, more than size if overrun.     */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoBcastReaderLen(const SSFBFifoBcastReader_t *reader)
+{
+    SSF_REQUIRE(reader != NULL);
+    SSF_REQUIRE(reader->magic == SSF_BFIFO_BCAST_READER_INIT_MAGIC);
+
+    return SSF_ATOMIC_LOAD_U32(&reader->ring->head) - reader->cursor;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if the reader was dropped because it was overrun, else false.                   */
+/* --------------------------------------------------------------------------------------------- */
+bool SSFBFifoBcastReaderIsDropped(const SSFBFifoBcastReader_t *reader)
+{
+    SSF_REQUIRE(reader != NULL);
+    SSF_REQUIRE(reader->magic == SSF_BFIFO_BCAST_READER_INIT_MAGIC);
+
+    return reader->isDropped;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Moves the reader to the newest byte and undrops it, returns the number of bytes skipped.      */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFBFifoBcastReaderResync(SSFBFifoBcastReader_t *reader)
+{
+    uint32_t head;
+    uint32_t skipped;
+
+    SSF_REQUIRE(reader != NULL);
+    SSF_REQUIRE(reader->magic == SSF_BFIFO_BCAST_READER_INIT_MAGIC);
+
+    head = SSF_ATOMIC_LOAD_U32(&reader->ring->head);
+    skipped = head - reader->cursor;
+    reader->cursor = head;
+    reader->isDropped = false;
+    return skipped;
+}
+#endif /* SSF_BFIFO_CONFIG_ENABLE_BCAST */
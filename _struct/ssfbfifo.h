@@ -48,6 +48,10 @@ extern "C" {
 #define SSF_BFIFO_255   (255ul)
 #define SSF_BFIFO_65535 (65535ul)
 
+#if SSF_BFIFO_CONFIG_MAX_BFIFO_SIZE > 0x7ffffffful
+#error SSF_BFIFO_CONFIG_MAX_BFIFO_SIZE must be less than 2^31
+#endif
+
 #if (SSF_BFIFO_CONFIG_MAX_BFIFO_SIZE <= SSF_BFIFO_255) || \
     (SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE == SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE_255)
 typedef uint8_t ssfbf_uint_t;
@@ -69,6 +73,83 @@ typedef struct SSFBFifo
     uint32_t magic;
 } SSFBFifo_t;
 
+#if (SSF_BFIFO_MULTI_BYTE_ENABLE == 1) || (SSF_BFIFO_CONFIG_ENABLE_SPSC == 1)
+/* Up to two contiguous regions of a fifo buffer, len[1] is 0 and ptr[1] NULL unless it wraps */
+typedef struct
+{
+    uint8_t *ptr[2];
+    uint32_t len[2];
+} SSFBFifoSpan_t;
+#endif
+
+#if SSF_BFIFO_CONFIG_ENABLE_SPSC == 1
+#if (SSF_BFIFO_SPSC_CACHE_LINE_SIZE & (SSF_BFIFO_SPSC_CACHE_LINE_SIZE - 1)) != 0
+#error SSF_BFIFO_SPSC_CACHE_LINE_SIZE must be a power of 2
+#endif
+
+/* Lock-free fifo for one producer thread and one consumer thread, fields are private. head and */
+/* tail are free running byte counts published with release and read with acquire; each side */
+/* caches the other side's count on its own cache line to avoid false sharing. */
+typedef struct SSFBFifoSPSC
+{
+    uint32_t head;        /* Written only by the producer */
+    uint32_t tailCache;   /* Producer's last read of tail */
+    uint8_t producerPad[SSF_BFIFO_SPSC_CACHE_LINE_SIZE - (2u * sizeof(uint32_t))];
+    uint32_t tail;        /* Written only by the consumer */
+    uint32_t headCache;   /* Consumer's last read of head */
+    uint8_t consumerPad[SSF_BFIFO_SPSC_CACHE_LINE_SIZE - (2u * sizeof(uint32_t))];
+    uint8_t *buffer;
+    uint32_t size;
+    uint32_t mask;
+    uint32_t magic;
+} SSFBFifoSPSC_t;
+#endif /* SSF_BFIFO_CONFIG_ENABLE_SPSC */
+
+#if (SSF_BFIFO_CONFIG_ENABLE_MIRROR == 1) && defined(__linux__)
+#define SSF_BFIFO_MIRROR_MAP (1u)
+#else
+#define SSF_BFIFO_MIRROR_MAP (0u)
+#endif
+
+#if SSF_BFIFO_CONFIG_ENABLE_MIRROR == 1
+/* Byte fifo whose queued bytes and free bytes are each one contiguous region, fields are */
+/* private. If mapped, buffer is size bytes of memfd pages mapped twice back to back, else it is */
+/* a plain buffer whose queued bytes are moved to its start when the free region is too short. */
+typedef struct SSFBFifoMirror
+{
+    uint8_t *buffer;
+    uint32_t size;
+    uint32_t tail;        /* Offset of the oldest byte */
+    uint32_t len;         /* Number of bytes in the fifo */
+    bool isMapped;
+    uint32_t magic;
+} SSFBFifoMirror_t;
+#endif /* SSF_BFIFO_CONFIG_ENABLE_MIRROR */
+
+#if SSF_BFIFO_CONFIG_ENABLE_BCAST == 1
+/* Broadcast byte ring, fields are private. The producer never waits for readers; it publishes */
+/* the end of the region it is about to overwrite in reserve before copying, then advances head. */
+typedef struct SSFBFifoBcast
+{
+    uint32_t head;        /* Written only by the producer, bytes before it are readable */
+    uint32_t reserve;     /* Written only by the producer, bytes before it minus size are lost */
+    uint8_t *buffer;
+    uint32_t size;
+    uint32_t mask;
+    uint32_t magic;
+} SSFBFifoBcast_t;
+
+/* Broadcast ring reader, fields are private. Each reader is used by one thread at a time. */
+typedef struct SSFBFifoBcastReader
+{
+    SSFBFifoBcast_t *ring;
+    uint32_t cursor;      /* Index of the next byte to read */
+    bool dropOnOverrun;   /* true to stop reading when overrun, else skip ahead and report */
+    bool isDropped;
+    uint32_t magic;
+} SSFBFifoBcastReader_t;
+#endif /* SSF_BFIFO_CONFIG_ENABLE_BCAST */
+
 /* --------------------------------------------------------------------------------------------- */
 /* External interface                                                                            */
 /* --------------------------------------------------------------------------------------------- */
@@ -89,8 +170,64 @@ bool SSFBFifoPeekBytes(const SSFBFifo_t *fifo, uint8_t *outBytes, uint32_t outBy
                        uint32_t *outBytesLen);
 bool SSFBFifoGetBytes(SSFBFifo_t *fifo, uint8_t *outBytes, uint32_t outBytesSize,
                       uint32_t *outBytesLen);
+uint32_t SSFBFifoReserve(SSFBFifo_t *fifo, uint32_t len, SSFBFifoSpan_t *span);
+void SSFBFifoCommit(SSFBFifo_t *fifo, uint32_t len);
+uint32_t SSFBFifoPeekSpan(const SSFBFifo_t *fifo, SSFBFifoSpan_t *span);
+void SSFBFifoConsume(SSFBFifo_t *fifo, uint32_t len);
 #endif /* SSF_BFIFO_MULTI_BYTE_ENABLE */
 
+#if SSF_BFIFO_CONFIG_ENABLE_SPSC == 1
+void SSFBFifoSPSCInit(SSFBFifoSPSC_t *fifo, uint32_t fifoSize, uint8_t *buffer,
+                      uint32_t bufferSize);
+void SSFBFifoSPSCDeInit(SSFBFifoSPSC_t *fifo);
+bool SSFBFifoSPSCPutByte(SSFBFifoSPSC_t *fifo, uint8_t inByte);
+uint32_t SSFBFifoSPSCPutBytes(SSFBFifoSPSC_t *fifo, const uint8_t *inBytes, uint32_t inBytesLen);
+bool SSFBFifoSPSCGetByte(SSFBFifoSPSC_t *fifo, uint8_t *outByte);
+bool SSFBFifoSPSCGetBytes(SSFBFifoSPSC_t *fifo, uint8_t *outBytes, uint32_t outBytesSize,
+                          uint32_t *outBytesLen);
+uint32_t SSFBFifoSPSCSize(const SSFBFifoSPSC_t *fifo);
+uint32_t SSFBFifoSPSCLen(const SSFBFifoSPSC_t *fifo);
+uint32_t SSFBFifoSPSCUnused(const SSFBFifoSPSC_t *fifo);
+uint32_t SSFBFifoSPSCReserve(SSFBFifoSPSC_t *fifo, uint32_t len, SSFBFifoSpan_t *span);
+void SSFBFifoSPSCCommit(SSFBFifoSPSC_t *fifo, uint32_t len);
+uint32_t SSFBFifoSPSCPeekSpan(SSFBFifoSPSC_t *fifo, SSFBFifoSpan_t *span);
+void SSFBFifoSPSCConsume(SSFBFifoSPSC_t *fifo, uint32_t len);
+#endif /* SSF_BFIFO_CONFIG_ENABLE_SPSC */
+
+#if SSF_BFIFO_CONFIG_ENABLE_MIRROR == 1
+bool SSFBFifoMirrorInit(SSFBFifoMirror_t *fifo, uint32_t fifoSize, uint8_t *buffer,
+                        uint32_t bufferSize);
+void SSFBFifoMirrorDeInit(SSFBFifoMirror_t *fifo);
+bool SSFBFifoMirrorIsMapped(const SSFBFifoMirror_t *fifo);
+void SSFBFifoMirrorPutBytes(SSFBFifoMirror_t *fifo, const uint8_t *inBytes, uint32_t inBytesLen);
+bool SSFBFifoMirrorGetBytes(SSFBFifoMirror_t *fifo, uint8_t *outBytes, uint32_t outBytesSize,
+                            uint32_t *outBytesLen);
+uint32_t SSFBFifoMirrorReserve(SSFBFifoMirror_t *fifo, uint32_t len, uint8_t **ptr);
+void SSFBFifoMirrorCommit(SSFBFifoMirror_t *fifo, uint32_t len);
+uint32_t SSFBFifoMirrorPeekSpan(const SSFBFifoMirror_t *fifo, const uint8_t **ptr);
+void SSFBFifoMirrorConsume(SSFBFifoMirror_t *fifo, uint32_t len);
+uint32_t SSFBFifoMirrorSize(const SSFBFifoMirror_t *fifo);
+uint32_t SSFBFifoMirrorLen(const SSFBFifoMirror_t *fifo);
+uint32_t SSFBFifoMirrorUnused(const SSFBFifoMirror_t *fifo);
+#endif /* SSF_BFIFO_CONFIG_ENABLE_MIRROR */
+
+#if SSF_BFIFO_CONFIG_ENABLE_BCAST == 1
+void SSFBFifoBcastInit(SSFBFifoBcast_t *ring, uint32_t ringSize, uint8_t *buffer,
+                       uint32_t bufferSize);
+void SSFBFifoBcastDeInit(SSFBFifoBcast_t *ring);
+void SSFBFifoBcastPutBytes(SSFBFifoBcast_t *ring, const uint8_t *inBytes, uint32_t inBytesLen);
+uint32_t SSFBFifoBcastSize(const SSFBFifoBcast_t *ring);
+
+void SSFBFifoBcastReaderInit(SSFBFifoBcastReader_t *reader, SSFBFifoBcast_t *ring,
+                             bool dropOnOverrun);
+void SSFBFifoBcastReaderDeInit(SSFBFifoBcastReader_t *reader);
+bool SSFBFifoBcastGetBytes(SSFBFifoBcastReader_t *reader, uint8_t *outBytes,
+                           uint32_t outBytesSize, uint32_t *outBytesLen, uint32_t *lostLen);
+uint32_t SSFBFifoBcastReaderLen(const SSFBFifoBcastReader_t *reader);
+bool SSFBFifoBcastReaderIsDropped(const SSFBFifoBcastReader_t *reader);
+uint32_t SSFBFifoBcastReaderResync(SSFBFifoBcastReader_t *reader);
+#endif /* SSF_BFIFO_CONFIG_ENABLE_BCAST */
+
 /* --------------------------------------------------------------------------------------------- */
 /* High performance external interface                                                           */
 /* --------------------------------------------------------------------------------------------- */
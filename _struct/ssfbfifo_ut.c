@@ -30,8 +30,18 @@
 /* OF THE POSSIBILITY OF SUCH DAMAGE.                                                            */
 /* --------------------------------------------------------------------------------------------- */
 #include <string.h>
+#include <stdlib.h>
 #include "ssfbfifo.h"
 #include "ssfport.h"
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#if (SSF_BFIFO_MULTI_BYTE_ENABLE == 1) && !defined(_WIN32)
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
 
 #if SSF_CONFIG_BFIFO_UNIT_TEST == 1
     #if SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE == SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE_255
@@ -47,8 +57,1342 @@ static SSFBFifo_t _sbfFifos[SBF_TEST_NUM_FIFOS];
 static uint8_t _sbfBuffers[SBF_TEST_NUM_FIFOS][SSF_TEST_BFIFO_SIZE +(1UL)];
     #if SSF_BFIFO_MULTI_BYTE_ENABLE == 1
 static uint8_t _sbfReadBuf[SSF_TEST_BFIFO_SIZE];
+static uint8_t _sbfWriteBuf[SSF_TEST_BFIFO_SIZE];
     #endif /* SSF_BFIFO_MULTI_BYTE_ENABLE */
 
+#if (SSF_BFIFO_MULTI_BYTE_ENABLE == 1) && !defined(_WIN32)
+/* --------------------------------------------------------------------------------------------- */
+/* Moves bytes between sockets and a fifo with readv()/writev() straight into and out of spans.  */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoUTSpanSocket(SSFBFifo_t *fifo)
+{
+    int fds[2];
+    struct iovec iov[2];
+    SSFBFifoSpan_t span;
+    uint32_t len;
+    uint32_t i;
+    ssize_t n;
+
+    SSF_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    for (i = 0; i < 16u; i++)
+    {
+        /* recv straight into the fifo */
+        len = (SSF_TEST_BFIFO_SIZE / 3u) + i;
+        SSF_ASSERT(write(fds[0], &_sbfWriteBuf[i], len) == (ssize_t)len);
+        SSF_ASSERT(SSFBFifoReserve(fifo, len, &span) == len);
+        iov[0].iov_base = span.ptr[0];
+        iov[0].iov_len = span.len[0];
+        iov[1].iov_base = span.ptr[1];
+        iov[1].iov_len = span.len[1];
+        SSF_ASSERT((n = readv(fds[1], iov, (span.len[1] == 0) ? 1 : 2)) == (ssize_t)len);
+        SSFBFifoCommit(fifo, (uint32_t)n);
+
+        /* send straight out of the fifo */
+        SSF_ASSERT(SSFBFifoPeekSpan(fifo, &span) == len);
+        iov[0].iov_base = span.ptr[0];
+        iov[0].iov_len = span.len[0];
+        iov[1].iov_base = span.ptr[1];
+        iov[1].iov_len = span.len[1];
+        SSF_ASSERT((n = writev(fds[1], iov, (span.len[1] == 0) ? 1 : 2)) == (ssize_t)len);
+        SSFBFifoConsume(fifo, (uint32_t)n);
+        SSF_ASSERT(SSFBFifoIsEmpty(fifo));
+        SSF_ASSERT(read(fds[0], _sbfReadBuf, sizeof(_sbfReadBuf)) == (ssize_t)len);
+        SSF_ASSERT(memcmp(_sbfReadBuf, &_sbfWriteBuf[i], len) == 0);
+    }
+    close(fds[0]);
+    close(fds[1]);
+}
+#endif /* (SSF_BFIFO_MULTI_BYTE_ENABLE == 1) && !defined(_WIN32) */
+
+#if (SSF_BFIFO_MULTI_BYTE_ENABLE == 1) && (SSF_CONFIG_UNIT_TEST_BENCHMARK == 1)
+#define SSF_TEST_BFIFO_BLOCK_BENCH_BYTES (256ul * 1024ul * 1024ul)
+#define SSF_TEST_BFIFO_BLOCK_BENCH_CHUNKS (3u)
+static const uint32_t _sbfBlockBenchChunks[SSF_TEST_BFIFO_BLOCK_BENCH_CHUNKS] = { 16u, 100u, 200u };
+
+/* --------------------------------------------------------------------------------------------- */
+/* The per byte SSFBFifoPutBytes() loop that block copies replaced, for benchmark comparison.    */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoUTPutBytesLoop(SSFBFifo_t *fifo, const uint8_t *inBytes,
+                                    uint32_t inBytesLen)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(inBytes != NULL);
+
+    while (inBytesLen)
+    {
+        SSF_BFIFO_PUT_BYTE(fifo, *inBytes);
+        inBytesLen--;
+        inBytes++;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* The per byte SSFBFifoGetBytes() loop that block copies replaced, for benchmark comparison.    */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFBFifoUTGetBytesLoop(SSFBFifo_t *fifo, uint8_t *outBytes, uint32_t outBytesSize,
+                                    uint32_t *outBytesLen)
+{
+    SSF_REQUIRE(fifo != NULL);
+    SSF_REQUIRE(outBytes != NULL);
+    SSF_REQUIRE(outBytesLen != NULL);
+
+    if (SSF_BFIFO_IS_EMPTY(fifo)) return false;
+
+    *outBytesLen = 0;
+    while (outBytesSize && (SSF_BFIFO_IS_EMPTY(fifo) == false))
+    {
+        SSF_BFIFO_GET_BYTE(fifo, *outBytes);
+        outBytesSize--;
+        outBytes++;
+        (*outBytesLen)++;
+    }
+    return true;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Prints MB/s through a fifo moving one byte at a time vs block copies.                         */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoUTBlockBench(SSFBFifo_t *fifo)
+{
+    uint64_t start;
+    uint64_t ticks[2];
+    uint32_t moved;
+    uint32_t chunk;
+    uint32_t outLen;
+    uint32_t i;
+    uint32_t k;
+
+    for (i = 0; i < SSF_TEST_BFIFO_BLOCK_BENCH_CHUNKS; i++)
+    {
+        chunk = _sbfBlockBenchChunks[i];
+        for (k = 0; k < 2; k++)
+        {
+            start = SSFPortGetHRTick64();
+            for (moved = 0; moved < SSF_TEST_BFIFO_BLOCK_BENCH_BYTES; moved += chunk)
+            {
+                if (k == 0)
+                {
+                    _SSFBFifoUTPutBytesLoop(fifo, _sbfWriteBuf, chunk);
+                    SSF_ASSERT(_SSFBFifoUTGetBytesLoop(fifo, _sbfReadBuf, chunk, &outLen));
+                }
+                else
+                {
+                    SSFBFifoPutBytes(fifo, _sbfWriteBuf, chunk);
+                    SSF_ASSERT(SSFBFifoGetBytes(fifo, _sbfReadBuf, chunk, &outLen));
+                }
+            }
+            ticks[k] = SSFPortGetHRTick64() - start + 1;
+            SSF_ASSERT(memcmp(_sbfReadBuf, _sbfWriteBuf, chunk) == 0);
+        }
+        printf("\r\n  %3u byte chunks: byte loop %llu MB/s, block copy %llu MB/s\r\n",
+               (unsigned int)chunk,
+               (unsigned long long)((SSF_TEST_BFIFO_BLOCK_BENCH_BYTES * SSF_HR_TICKS_PER_SEC) /
+                                    (ticks[0] * 1000000ull)),
+               (unsigned long long)((SSF_TEST_BFIFO_BLOCK_BENCH_BYTES * SSF_HR_TICKS_PER_SEC) /
+                                    (ticks[1] * 1000000ull)));
+    }
+}
+#endif /* SSF_CONFIG_UNIT_TEST_BENCHMARK */
+
+#if SSF_BFIFO_CONFIG_ENABLE_SPSC == 1
+#define SSF_TEST_BFIFO_SPSC_SIZE (256UL)
+static SSFBFifoSPSC_t _sbfSPSC;
+static uint8_t _sbfSPSCBuffer[SSF_TEST_BFIFO_SPSC_SIZE];
+static uint8_t _sbfSPSCIn[SSF_TEST_BFIFO_SPSC_SIZE];
+static uint8_t _sbfSPSCOut[SSF_TEST_BFIFO_SPSC_SIZE];
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+#define SSF_TEST_BFIFO_SPSC_MT_BYTES (2000000ul)
+#define SSF_TEST_BFIFO_SPSC_BYTE(i) ((uint8_t)((i) ^ ((i) >> 8) ^ ((i) >> 16)))
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+#define SSF_TEST_BFIFO_BENCH_BYTES (64ul * 1024ul * 1024ul)
+#define SSF_TEST_BFIFO_BENCH_CHUNK (64u)
+#define SSF_TEST_BFIFO_BENCH_TRIPS (100000ul)
+static SSFBFifoSPSC_t _sbfSPSCBack;
+static uint8_t _sbfSPSCBackBuffer[SSF_TEST_BFIFO_SPSC_SIZE];
+static bool _sbfBenchIsSPSC;
+#if SSF_BFIFO_MULTI_BYTE_ENABLE == 1
+static SSF_MUTEX_DECLARATION(_sbfBenchSync);
+#endif
+#endif /* SSF_CONFIG_UNIT_TEST_BENCHMARK */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Producer thread, puts a known byte sequence into _sbfSPSC in varying chunk sizes.             */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFBFifoUTSPSCProducer(void *arg)
+{
+    uint32_t i = 0;
+    uint32_t j;
+    uint32_t chunk = 1;
+    uint32_t len;
+    SSFBFifoSpan_t span;
+
+    SSF_UNUSED_PTR(arg);
+    while (i < SSF_TEST_BFIFO_SPSC_MT_BYTES)
+    {
+        if ((chunk & 3u) == 0)
+        {
+            if (SSFBFifoSPSCPutByte(&_sbfSPSC, SSF_TEST_BFIFO_SPSC_BYTE(i))) i++;
+            else sched_yield();
+        }
+        else if ((chunk & 3u) == 2u)
+        {
+            len = chunk;
+            if (len > (SSF_TEST_BFIFO_SPSC_MT_BYTES - i)) len = SSF_TEST_BFIFO_SPSC_MT_BYTES - i;
+            len = SSFBFifoSPSCReserve(&_sbfSPSC, len, &span);
+            for (j = 0; j < len; j++)
+            {
+                if (j < span.len[0]) span.ptr[0][j] = SSF_TEST_BFIFO_SPSC_BYTE(i + j);
+                else span.ptr[1][j - span.len[0]] = SSF_TEST_BFIFO_SPSC_BYTE(i + j);
+            }
+            SSFBFifoSPSCCommit(&_sbfSPSC, len);
+            if (len == 0) sched_yield();
+            i += len;
+        }
+        else
+        {
+            len = chunk;
+            if (len > (SSF_TEST_BFIFO_SPSC_MT_BYTES - i)) len = SSF_TEST_BFIFO_SPSC_MT_BYTES - i;
+            for (j = 0; j < len; j++) _sbfSPSCIn[j] = SSF_TEST_BFIFO_SPSC_BYTE(i + j);
+            len = SSFBFifoSPSCPutBytes(&_sbfSPSC, _sbfSPSCIn, len);
+            if (len == 0) sched_yield();
+            i += len;
+        }
+        chunk = (chunk % 97u) + 1u;
+    }
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Checks that bytes put by a producer thread arrive in order at the consumer.                   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoUTSPSCThreads(void)
+{
+    pthread_t thread;
+    uint32_t i = 0;
+    uint32_t j;
+    uint32_t chunk = 1;
+    uint32_t len;
+    uint8_t outByte;
+    SSFBFifoSpan_t span;
+
+    SSFBFifoSPSCInit(&_sbfSPSC, SSF_TEST_BFIFO_SPSC_SIZE, _sbfSPSCBuffer,
+                     sizeof(_sbfSPSCBuffer));
+    SSF_ASSERT(pthread_create(&thread, NULL, _SSFBFifoUTSPSCProducer, NULL) == 0);
+    while (i < SSF_TEST_BFIFO_SPSC_MT_BYTES)
+    {
+        if ((chunk % 3u) == 0)
+        {
+            if (SSFBFifoSPSCGetByte(&_sbfSPSC, &outByte))
+            {
+                SSF_ASSERT(outByte == SSF_TEST_BFIFO_SPSC_BYTE(i));
+                i++;
+            }
+            else sched_yield();
+        }
+        else if ((chunk % 3u) == 2u)
+        {
+            len = SSFBFifoSPSCPeekSpan(&_sbfSPSC, &span);
+            if (len > chunk) len = chunk;
+            for (j = 0; j < len; j++)
+            {
+                outByte = (j < span.len[0]) ? span.ptr[0][j] : span.ptr[1][j - span.len[0]];
+                SSF_ASSERT(outByte == SSF_TEST_BFIFO_SPSC_BYTE(i + j));
+            }
+            SSFBFifoSPSCConsume(&_sbfSPSC, len);
+            if (len == 0) sched_yield();
+            i += len;
+        }
+        else if (SSFBFifoSPSCGetBytes(&_sbfSPSC, _sbfSPSCOut, chunk, &len))
+        {
+            SSF_ASSERT((len > 0) && (len <= chunk));
+            for (j = 0; j < len; j++) SSF_ASSERT(_sbfSPSCOut[j] == SSF_TEST_BFIFO_SPSC_BYTE(i + j));
+            i += len;
+        }
+        else sched_yield();
+        SSF_ASSERT(SSFBFifoSPSCLen(&_sbfSPSC) <= SSF_TEST_BFIFO_SPSC_SIZE);
+        chunk = (chunk % 89u) + 1u;
+    }
+    SSF_ASSERT(pthread_join(thread, NULL) == 0);
+    SSF_ASSERT(SSFBFifoSPSCLen(&_sbfSPSC) == 0);
+    SSFBFifoSPSCDeInit(&_sbfSPSC);
+}
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Returns <0, 0, >0 for qsort() on uint64_t.                                                    */
+/* --------------------------------------------------------------------------------------------- */
+static int _SSFBFifoUTCmpU64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Puts up to len bytes into the benchmark forward fifo, returns number put.                     */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFBFifoUTBenchPut(const uint8_t *in, uint32_t len)
+{
+#if SSF_BFIFO_MULTI_BYTE_ENABLE == 1
+    uint32_t unused;
+
+    if (_sbfBenchIsSPSC == false)
+    {
+        SSF_MUTEX_ACQUIRE(_sbfBenchSync);
+        unused = SSFBFifoUnused(&_sbfFifos[0]);
+        if (len > unused) len = unused;
+        SSFBFifoPutBytes(&_sbfFifos[0], in, len);
+        SSF_MUTEX_RELEASE(_sbfBenchSync);
+        return len;
+    }
+#endif
+    return SSFBFifoSPSCPutBytes(&_sbfSPSC, in, len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Gets up to size bytes from the benchmark forward fifo, returns number got.                    */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFBFifoUTBenchGet(uint8_t *out, uint32_t size)
+{
+    uint32_t len = 0;
+
+#if SSF_BFIFO_MULTI_BYTE_ENABLE == 1
+    if (_sbfBenchIsSPSC == false)
+    {
+        SSF_MUTEX_ACQUIRE(_sbfBenchSync);
+        SSFBFifoGetBytes(&_sbfFifos[0], out, size, &len);
+        SSF_MUTEX_RELEASE(_sbfBenchSync);
+        return len;
+    }
+#endif
+    SSFBFifoSPSCGetBytes(&_sbfSPSC, out, size, &len);
+    return len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Benchmark producer thread, streams SSF_TEST_BFIFO_BENCH_BYTES bytes in fixed size chunks.     */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFBFifoUTBenchProducer(void *arg)
+{
+    uint32_t sent = 0;
+    uint32_t len;
+
+    SSF_UNUSED_PTR(arg);
+    while (sent < SSF_TEST_BFIFO_BENCH_BYTES)
+    {
+        len = _SSFBFifoUTBenchPut(_sbfSPSCIn, SSF_TEST_BFIFO_BENCH_CHUNK);
+        if (len == 0) sched_yield();
+        sent += len;
+    }
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Benchmark echo thread, returns each byte received on _sbfSPSC through _sbfSPSCBack.           */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFBFifoUTBenchEcho(void *arg)
+{
+    uint32_t i;
+    uint8_t b;
+
+    SSF_UNUSED_PTR(arg);
+    for (i = 0; i < SSF_TEST_BFIFO_BENCH_TRIPS; i++)
+    {
+        while (SSFBFifoSPSCGetByte(&_sbfSPSC, &b) == false) sched_yield();
+        SSF_ASSERT(SSFBFifoSPSCPutByte(&_sbfSPSCBack, b));
+    }
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Prints two thread throughput with and without a mutex, and SPSC round trip latency.          */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoUTSPSCBench(void)
+{
+    pthread_t thread;
+    uint64_t start;
+    uint64_t ticks;
+    uint64_t *trips;
+    uint32_t received;
+    uint32_t len;
+    uint32_t i;
+    uint8_t b;
+
+    for (i = 0; i < 2; i++)
+    {
+        _sbfBenchIsSPSC = (i == 1);
+#if SSF_BFIFO_MULTI_BYTE_ENABLE == 1
+        if (_sbfBenchIsSPSC == false)
+        {
+            SSF_MUTEX_INIT(_sbfBenchSync);
+            SSFBFifoInit(&_sbfFifos[0], SSF_TEST_BFIFO_SIZE, _sbfBuffers[0],
+                         SSF_TEST_BFIFO_SIZE + (1UL));
+        }
+#else
+        if (_sbfBenchIsSPSC == false) continue;
+#endif
+        if (_sbfBenchIsSPSC)
+        {
+            SSFBFifoSPSCInit(&_sbfSPSC, SSF_TEST_BFIFO_SPSC_SIZE, _sbfSPSCBuffer,
+                             sizeof(_sbfSPSCBuffer));
+        }
+        received = 0;
+        start = SSFPortGetHRTick64();
+        SSF_ASSERT(pthread_create(&thread, NULL, _SSFBFifoUTBenchProducer, NULL) == 0);
+        while (received < SSF_TEST_BFIFO_BENCH_BYTES)
+        {
+            len = _SSFBFifoUTBenchGet(_sbfSPSCOut, sizeof(_sbfSPSCOut));
+            if (len == 0) sched_yield();
+            received += len;
+        }
+        SSF_ASSERT(pthread_join(thread, NULL) == 0);
+        ticks = SSFPortGetHRTick64() - start;
+        if (_sbfBenchIsSPSC) { SSFBFifoSPSCDeInit(&_sbfSPSC); }
+#if SSF_BFIFO_MULTI_BYTE_ENABLE == 1
+        else
+        {
+            SSFBFifoDeInit(&_sbfFifos[0]);
+            SSF_MUTEX_DEINIT(_sbfBenchSync);
+        }
+#endif
+        printf("\r\n  Two thread %s %lu byte fifo, %u byte chunks: %llu MB/s\r\n",
+               _sbfBenchIsSPSC ? "SPSC" : "mutex locked",
+               _sbfBenchIsSPSC ? SSF_TEST_BFIFO_SPSC_SIZE : SSF_TEST_BFIFO_SIZE,
+               (unsigned int)SSF_TEST_BFIFO_BENCH_CHUNK,
+               (unsigned long long)((SSF_TEST_BFIFO_BENCH_BYTES * SSF_HR_TICKS_PER_SEC) /
+                                    ((ticks + 1) * 1000000ull)));
+    }
+
+    SSF_ASSERT((trips = (uint64_t *)malloc(SSF_TEST_BFIFO_BENCH_TRIPS * sizeof(uint64_t))) != NULL);
+    SSFBFifoSPSCInit(&_sbfSPSC, SSF_TEST_BFIFO_SPSC_SIZE, _sbfSPSCBuffer, sizeof(_sbfSPSCBuffer));
+    SSFBFifoSPSCInit(&_sbfSPSCBack, SSF_TEST_BFIFO_SPSC_SIZE, _sbfSPSCBackBuffer,
+                     sizeof(_sbfSPSCBackBuffer));
+    SSF_ASSERT(pthread_create(&thread, NULL, _SSFBFifoUTBenchEcho, NULL) == 0);
+    for (i = 0; i < SSF_TEST_BFIFO_BENCH_TRIPS; i++)
+    {
+        start = SSFPortGetHRTick64();
+        SSF_ASSERT(SSFBFifoSPSCPutByte(&_sbfSPSC, (uint8_t)i));
+        while (SSFBFifoSPSCGetByte(&_sbfSPSCBack, &b) == false) sched_yield();
+        trips[i] = SSFPortGetHRTick64() - start;
+        SSF_ASSERT(b == (uint8_t)i);
+    }
+    SSF_ASSERT(pthread_join(thread, NULL) == 0);
+    SSFBFifoSPSCDeInit(&_sbfSPSCBack);
+    SSFBFifoSPSCDeInit(&_sbfSPSC);
+
+    qsort(trips, SSF_TEST_BFIFO_BENCH_TRIPS, sizeof(uint64_t), _SSFBFifoUTCmpU64);
+    printf("\r\n  SPSC byte fifo round trip latency: p50=%lluns p99=%lluns max=%lluns\r\n",
+           (unsigned long long)(trips[(SSF_TEST_BFIFO_BENCH_TRIPS * 50ull) / 100] *
+                                1000000000ull / SSF_HR_TICKS_PER_SEC),
+           (unsigned long long)(trips[(SSF_TEST_BFIFO_BENCH_TRIPS * 99ull) / 100] *
+                                1000000000ull / SSF_HR_TICKS_PER_SEC),
+           (unsigned long long)(trips[SSF_TEST_BFIFO_BENCH_TRIPS - 1] *
+                                1000000000ull / SSF_HR_TICKS_PER_SEC));
+    free(trips);
+}
+#endif /* SSF_CONFIG_UNIT_TEST_BENCHMARK */
+#endif /* (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32) */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Performs unit test on the lock-free SPSC byte fifo interface from a single thread.            */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoUTSPSC(void)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t k;
+    volatile uint32_t put;
+    volatile uint32_t got;
+    uint32_t outLen;
+    uint8_t outByte;
+    SSFBFifoSPSC_t fifoZero;
+    SSFBFifoSpan_t span;
+    volatile uint32_t wraps;
+
+    SSF_ASSERT_TEST(SSFBFifoSPSCInit(NULL, SSF_TEST_BFIFO_SPSC_SIZE, _sbfSPSCBuffer,
+                                     sizeof(_sbfSPSCBuffer)));
+    SSF_ASSERT_TEST(SSFBFifoSPSCInit(&_sbfSPSC, 0, _sbfSPSCBuffer, sizeof(_sbfSPSCBuffer)));
+    SSF_ASSERT_TEST(SSFBFifoSPSCInit(&_sbfSPSC, SSF_TEST_BFIFO_SPSC_SIZE - 1, _sbfSPSCBuffer,
+                                     sizeof(_sbfSPSCBuffer)));
+    SSF_ASSERT_TEST(SSFBFifoSPSCInit(&_sbfSPSC, SSF_TEST_BFIFO_SPSC_SIZE, NULL,
+                                     sizeof(_sbfSPSCBuffer)));
+    SSF_ASSERT_TEST(SSFBFifoSPSCInit(&_sbfSPSC, SSF_TEST_BFIFO_SPSC_SIZE, _sbfSPSCBuffer,
+                                     SSF_TEST_BFIFO_SPSC_SIZE - 1));
+    SSF_ASSERT_TEST(SSFBFifoSPSCDeInit(NULL));
+    SSF_ASSERT_TEST(SSFBFifoSPSCDeInit(&_sbfSPSC));
+    SSF_ASSERT_TEST(SSFBFifoSPSCPutByte(&_sbfSPSC, 0));
+    SSF_ASSERT_TEST(SSFBFifoSPSCPutBytes(&_sbfSPSC, _sbfSPSCIn, 1));
+    SSF_ASSERT_TEST(SSFBFifoSPSCGetByte(&_sbfSPSC, &outByte));
+    SSF_ASSERT_TEST(SSFBFifoSPSCGetBytes(&_sbfSPSC, _sbfSPSCOut, 1, &outLen));
+    SSF_ASSERT_TEST(SSFBFifoSPSCSize(&_sbfSPSC));
+    SSF_ASSERT_TEST(SSFBFifoSPSCLen(&_sbfSPSC));
+    SSF_ASSERT_TEST(SSFBFifoSPSCUnused(&_sbfSPSC));
+
+    SSFBFifoSPSCInit(&_sbfSPSC, SSF_TEST_BFIFO_SPSC_SIZE, _sbfSPSCBuffer, sizeof(_sbfSPSCBuffer));
+    SSF_ASSERT_TEST(SSFBFifoSPSCInit(&_sbfSPSC, SSF_TEST_BFIFO_SPSC_SIZE, _sbfSPSCBuffer,
+                                     sizeof(_sbfSPSCBuffer)));
+    SSF_ASSERT_TEST(SSFBFifoSPSCPutByte(NULL, 0));
+    SSF_ASSERT_TEST(SSFBFifoSPSCPutBytes(NULL, _sbfSPSCIn, 1));
+    SSF_ASSERT_TEST(SSFBFifoSPSCPutBytes(&_sbfSPSC, NULL, 1));
+    SSF_ASSERT_TEST(SSFBFifoSPSCGetByte(NULL, &outByte));
+    SSF_ASSERT_TEST(SSFBFifoSPSCGetByte(&_sbfSPSC, NULL));
+    SSF_ASSERT_TEST(SSFBFifoSPSCGetBytes(NULL, _sbfSPSCOut, 1, &outLen));
+    SSF_ASSERT_TEST(SSFBFifoSPSCGetBytes(&_sbfSPSC, NULL, 1, &outLen));
+    SSF_ASSERT_TEST(SSFBFifoSPSCGetBytes(&_sbfSPSC, _sbfSPSCOut, 1, NULL));
+    SSF_ASSERT_TEST(SSFBFifoSPSCSize(NULL));
+    SSF_ASSERT_TEST(SSFBFifoSPSCLen(NULL));
+    SSF_ASSERT_TEST(SSFBFifoSPSCUnused(NULL));
+
+    /* Producer and consumer indices never share a cache line */
+    SSF_ASSERT(((uintptr_t)&_sbfSPSC.tail - (uintptr_t)&_sbfSPSC.head) >=
+               SSF_BFIFO_SPSC_CACHE_LINE_SIZE);
+    SSF_ASSERT(((uintptr_t)&_sbfSPSC.buffer - (uintptr_t)&_sbfSPSC.tail) >=
+               SSF_BFIFO_SPSC_CACHE_LINE_SIZE);
+
+    /* Empty */
+    SSF_ASSERT(SSFBFifoSPSCSize(&_sbfSPSC) == SSF_TEST_BFIFO_SPSC_SIZE);
+    SSF_ASSERT(SSFBFifoSPSCLen(&_sbfSPSC) == 0);
+    SSF_ASSERT(SSFBFifoSPSCUnused(&_sbfSPSC) == SSF_TEST_BFIFO_SPSC_SIZE);
+    SSF_ASSERT(SSFBFifoSPSCGetByte(&_sbfSPSC, &outByte) == false);
+    SSF_ASSERT(SSFBFifoSPSCGetBytes(&_sbfSPSC, _sbfSPSCOut, 1, &outLen) == false);
+    SSF_ASSERT(SSFBFifoSPSCGetBytes(&_sbfSPSC, _sbfSPSCOut, 0, &outLen) == false);
+
+    /* Whole buffer is usable, put fails when full */
+    for (i = 0; i < SSF_TEST_BFIFO_SPSC_SIZE; i++)
+    {
+        SSF_ASSERT(SSFBFifoSPSCPutByte(&_sbfSPSC, (uint8_t)(i + 1)));
+        SSF_ASSERT(SSFBFifoSPSCLen(&_sbfSPSC) == (i + 1));
+    }
+    SSF_ASSERT(SSFBFifoSPSCUnused(&_sbfSPSC) == 0);
+    SSF_ASSERT(SSFBFifoSPSCPutByte(&_sbfSPSC, 0) == false);
+    SSF_ASSERT(SSFBFifoSPSCPutBytes(&_sbfSPSC, _sbfSPSCIn, 1) == 0);
+    outLen = 0x12345678;
+    SSF_ASSERT(SSFBFifoSPSCGetBytes(&_sbfSPSC, _sbfSPSCOut, 0, &outLen));
+    SSF_ASSERT(outLen == 0);
+    for (i = 0; i < SSF_TEST_BFIFO_SPSC_SIZE; i++)
+    {
+        SSF_ASSERT(SSFBFifoSPSCGetByte(&_sbfSPSC, &outByte));
+        SSF_ASSERT(outByte == (uint8_t)(i + 1));
+    }
+    SSF_ASSERT(SSFBFifoSPSCGetByte(&_sbfSPSC, &outByte) == false);
+    SSF_ASSERT(SSFBFifoSPSCLen(&_sbfSPSC) == 0);
+
+    /* Partial puts and gets across the buffer wrap and the 32-bit index wrap */
+    SSFBFifoSPSCDeInit(&_sbfSPSC);
+    SSFBFifoSPSCInit(&_sbfSPSC, SSF_TEST_BFIFO_SPSC_SIZE, _sbfSPSCBuffer, sizeof(_sbfSPSCBuffer));
+    _sbfSPSC.head = 0xffffff00ul + 3u;
+    _sbfSPSC.tailCache = _sbfSPSC.head;
+    _sbfSPSC.tail = _sbfSPSC.head;
+    _sbfSPSC.headCache = _sbfSPSC.head;
+    put = 0;
+    got = 0;
+    for (i = 1; i < 2000u; i++)
+    {
+        k = (i * 37u) % (SSF_TEST_BFIFO_SPSC_SIZE + 20u);
+        for (j = 0; j < k; j++) _sbfSPSCIn[j % SSF_TEST_BFIFO_SPSC_SIZE] = (uint8_t)(put + j);
+        if (k > SSF_TEST_BFIFO_SPSC_SIZE) k = SSF_TEST_BFIFO_SPSC_SIZE;
+        j = SSFBFifoSPSCPutBytes(&_sbfSPSC, _sbfSPSCIn, k);
+        SSF_ASSERT(j == ((k < (SSF_TEST_BFIFO_SPSC_SIZE - (put - got))) ?
+                         k : (SSF_TEST_BFIFO_SPSC_SIZE - (put - got))));
+        put += j;
+        SSF_ASSERT(SSFBFifoSPSCLen(&_sbfSPSC) == (put - got));
+
+        k = (i * 53u) % SSF_TEST_BFIFO_SPSC_SIZE;
+        if (SSFBFifoSPSCGetBytes(&_sbfSPSC, _sbfSPSCOut, k, &outLen))
+        {
+            SSF_ASSERT(outLen == (((put - got) < k) ? (put - got) : k));
+            for (j = 0; j < outLen; j++) SSF_ASSERT(_sbfSPSCOut[j] == (uint8_t)(got + j));
+            got += outLen;
+        }
+        else SSF_ASSERT(put == got);
+    }
+    SSF_ASSERT(_sbfSPSC.head < 0xffffff00ul);
+    while (SSFBFifoSPSCGetByte(&_sbfSPSC, &outByte))
+    {
+        SSF_ASSERT(outByte == (uint8_t)got);
+        got++;
+    }
+    SSF_ASSERT(put == got);
+    SSF_ASSERT(SSFBFifoSPSCPutBytes(&_sbfSPSC, _sbfSPSCIn, 0) == 0);
+
+    /* Zero-copy spans across the buffer wrap */
+    SSF_ASSERT_TEST(SSFBFifoSPSCReserve(NULL, 1, &span));
+    SSF_ASSERT_TEST(SSFBFifoSPSCReserve(&_sbfSPSC, 1, NULL));
+    SSF_ASSERT_TEST(SSFBFifoSPSCCommit(NULL, 0));
+    SSF_ASSERT_TEST(SSFBFifoSPSCCommit(&_sbfSPSC, SSF_TEST_BFIFO_SPSC_SIZE + 1u));
+    SSF_ASSERT_TEST(SSFBFifoSPSCPeekSpan(NULL, &span));
+    SSF_ASSERT_TEST(SSFBFifoSPSCPeekSpan(&_sbfSPSC, NULL));
+    SSF_ASSERT_TEST(SSFBFifoSPSCConsume(NULL, 0));
+    SSF_ASSERT_TEST(SSFBFifoSPSCConsume(&_sbfSPSC, 1));
+    SSF_ASSERT(SSFBFifoSPSCPeekSpan(&_sbfSPSC, &span) == 0);
+    wraps = 0;
+    for (i = 0; i < 300u; i++)
+    {
+        k = (i * 29u) % (SSF_TEST_BFIFO_SPSC_SIZE + 1u);
+        SSF_ASSERT(SSFBFifoSPSCReserve(&_sbfSPSC, k + 1u, &span) ==
+                   ((k == SSF_TEST_BFIFO_SPSC_SIZE) ? k : (k + 1u)));
+        SSF_ASSERT((span.len[1] == 0) == (span.ptr[1] == NULL));
+        if (span.len[1] != 0) wraps++;
+        for (j = 0; j < k; j++)
+        {
+            if (j < span.len[0]) span.ptr[0][j] = (uint8_t)(put + j);
+            else span.ptr[1][j - span.len[0]] = (uint8_t)(put + j);
+        }
+        SSFBFifoSPSCCommit(&_sbfSPSC, k);
+        put += k;
+        SSF_ASSERT(SSFBFifoSPSCLen(&_sbfSPSC) == k);
+
+        SSF_ASSERT(SSFBFifoSPSCPeekSpan(&_sbfSPSC, &span) == k);
+        SSF_ASSERT((span.len[0] + span.len[1]) == k);
+        for (j = 0; j < k; j++)
+        {
+            outByte = (j < span.len[0]) ? span.ptr[0][j] : span.ptr[1][j - span.len[0]];
+            SSF_ASSERT(outByte == (uint8_t)(got + j));
+        }
+        SSF_ASSERT_TEST(SSFBFifoSPSCConsume(&_sbfSPSC, k + 1u));
+        SSFBFifoSPSCConsume(&_sbfSPSC, k);
+        got += k;
+        SSF_ASSERT(SSFBFifoSPSCLen(&_sbfSPSC) == 0);
+    }
+    SSF_ASSERT(wraps > 0);
+
+    memset(&fifoZero, 0, sizeof(fifoZero));
+    SSFBFifoSPSCDeInit(&_sbfSPSC);
+    SSF_ASSERT(memcmp(&_sbfSPSC, &fifoZero, sizeof(fifoZero)) == 0);
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+    _SSFBFifoUTSPSCThreads();
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    _SSFBFifoUTSPSCBench();
+#endif
+#endif
+}
+#endif /* SSF_BFIFO_CONFIG_ENABLE_SPSC */
+
+#if SSF_BFIFO_CONFIG_ENABLE_MIRROR == 1
+/* Mirror fifo size is a multiple of all common page sizes so it is mapped where supported */
+#define SSF_TEST_BFIFO_MIRROR_SIZE (65536ul)
+#define SSF_TEST_BFIFO_MIRROR_PLAIN_SIZE (1000ul)
+static SSFBFifoMirror_t _sbfMirror;
+static uint8_t _sbfMirrorBuffer[SSF_TEST_BFIFO_MIRROR_SIZE];
+static uint8_t _sbfMirrorIO[SSF_TEST_BFIFO_MIRROR_SIZE];
+
+/* --------------------------------------------------------------------------------------------- */
+/* Streams bytes through an initialized mirror fifo with mixed puts, gets, spans and checks.     */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoUTMirrorStream(SSFBFifoMirror_t *fifo)
+{
+    uint8_t *wptr;
+    const uint8_t *rptr;
+    uint32_t size;
+    volatile uint32_t put = 0;
+    volatile uint32_t got = 0;
+    uint32_t outLen;
+    uint32_t len;
+    uint32_t i;
+    uint32_t j;
+    volatile uint32_t k;
+
+    size = SSFBFifoMirrorSize(fifo);
+    SSF_ASSERT(SSFBFifoMirrorLen(fifo) == 0);
+    SSF_ASSERT(SSFBFifoMirrorUnused(fifo) == size);
+    SSF_ASSERT(SSFBFifoMirrorPeekSpan(fifo, &rptr) == 0);
+    SSF_ASSERT(SSFBFifoMirrorGetBytes(fifo, _sbfMirrorIO, sizeof(_sbfMirrorIO), &outLen) == false);
+
+    for (i = 0; i < 3000u; i++)
+    {
+        /* Fill a reserved region in place or put a copy */
+        k = ((i * 7919u) % size) + 1u;
+        if (i & 1u)
+        {
+            len = SSFBFifoMirrorReserve(fifo, k, &wptr);
+            SSF_ASSERT(len == ((k < (size - (put - got))) ? k : (size - (put - got))));
+            for (j = 0; j < len; j++) wptr[j] = (uint8_t)(put + j);
+            k = len - (len >> 2);
+            SSF_ASSERT_TEST(SSFBFifoMirrorCommit(fifo, size - (put - got) + 1u));
+            SSFBFifoMirrorCommit(fifo, k);
+        }
+        else
+        {
+            if (k > (size - (put - got))) k = size - (put - got);
+            for (j = 0; j < k; j++) _sbfMirrorIO[j] = (uint8_t)(put + j);
+            SSF_ASSERT_TEST(SSFBFifoMirrorPutBytes(fifo, _sbfMirrorIO, size - (put - got) + 1u));
+            SSFBFifoMirrorPutBytes(fifo, _sbfMirrorIO, k);
+        }
+        put += k;
+        SSF_ASSERT(SSFBFifoMirrorLen(fifo) == (put - got));
+        SSF_ASSERT(SSFBFifoMirrorUnused(fifo) == (size - (put - got)));
+
+        /* Everything queued is one contiguous region, consume it in place or get a copy */
+        len = SSFBFifoMirrorPeekSpan(fifo, &rptr);
+        SSF_ASSERT(len == (put - got));
+        for (j = 0; j < len; j++) SSF_ASSERT(rptr[j] == (uint8_t)(got + j));
+        k = (i * 104729u) % (size + 1u);
+        if (i % 3u)
+        {
+            if (k > len) k = len;
+            SSF_ASSERT_TEST(SSFBFifoMirrorConsume(fifo, len + 1u));
+            SSFBFifoMirrorConsume(fifo, k);
+        }
+        else if (SSFBFifoMirrorGetBytes(fifo, _sbfMirrorIO, k, &outLen))
+        {
+            SSF_ASSERT(outLen == ((len < k) ? len : k));
+            for (j = 0; j < outLen; j++) SSF_ASSERT(_sbfMirrorIO[j] == (uint8_t)(got + j));
+            k = outLen;
+        }
+        else
+        {
+            SSF_ASSERT(len == 0);
+            k = 0;
+        }
+        got += k;
+    }
+    SSF_ASSERT(put > (size * 100u));
+
+    len = SSFBFifoMirrorLen(fifo);
+    SSFBFifoMirrorConsume(fifo, len);
+    SSF_ASSERT(SSFBFifoMirrorLen(fifo) == 0);
+}
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+#define SSF_TEST_BFIFO_MIRROR_BENCH_BYTES (256ul * 1024ul * 1024ul)
+#define SSF_TEST_BFIFO_MIRROR_BENCH_CHUNK (1500u)
+#define SSF_TEST_BFIFO_MIRROR_BENCH_STREAM (SSF_TEST_BFIFO_MIRROR_SIZE * 4u)
+static uint8_t _sbfMirrorStream[SSF_TEST_BFIFO_MIRROR_BENCH_STREAM];
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns number of complete length, payload, checksum records parsed in place from the fifo.   */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFBFifoUTMirrorParse(SSFBFifoMirror_t *fifo)
+{
+    const uint8_t *ptr;
+    uint32_t avail;
+    uint32_t offset = 0;
+    uint32_t records = 0;
+    uint32_t recLen;
+    uint32_t i;
+    uint8_t sum;
+
+    avail = SSFBFifoMirrorPeekSpan(fifo, &ptr);
+    while ((avail - offset) >= 2u)
+    {
+        recLen = (uint32_t)ptr[offset] | ((uint32_t)ptr[offset + 1u] << 8);
+        if ((avail - offset) < (recLen + 3u)) break;
+        sum = 0;
+        for (i = 0; i < recLen; i++) sum += ptr[offset + 2u + i];
+        SSF_ASSERT(sum == ptr[offset + 2u + recLen]);
+        offset += recLen + 3u;
+        records++;
+    }
+    SSFBFifoMirrorConsume(fifo, offset);
+    return records;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Prints parse in place throughput of a record stream with and without the mirror mapping.      */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoUTMirrorBench(void)
+{
+    uint64_t start;
+    uint64_t ticks;
+    uint64_t moved;
+    uint32_t records;
+    uint32_t expected = 0;
+    uint32_t offset;
+    uint32_t recLen;
+    uint32_t seed = 1;
+    uint32_t len;
+    uint32_t i;
+    uint32_t j;
+    uint8_t *ptr;
+    uint8_t sum;
+
+    /* Build a repeating stream of records with 1 to 1024 byte payloads */
+    offset = 0;
+    while (true)
+    {
+        seed = (seed * 1103515245ul) + 12345ul;
+        recLen = ((seed >> 16) % 1024u) + 1u;
+        if ((offset + recLen + 3u) > sizeof(_sbfMirrorStream)) break;
+        _sbfMirrorStream[offset] = (uint8_t)recLen;
+        _sbfMirrorStream[offset + 1u] = (uint8_t)(recLen >> 8);
+        sum = 0;
+        for (j = 0; j < recLen; j++)
+        {
+            _sbfMirrorStream[offset + 2u + j] = (uint8_t)(seed + j);
+            sum += (uint8_t)(seed + j);
+        }
+        _sbfMirrorStream[offset + 2u + recLen] = sum;
+        offset += recLen + 3u;
+        expected++;
+    }
+    len = offset;
+
+    for (i = 0; i < 2u; i++)
+    {
+        /* A size that is not a page multiple forces the plain buffer */
+        SSF_ASSERT(SSFBFifoMirrorInit(&_sbfMirror, SSF_TEST_BFIFO_MIRROR_SIZE - i,
+                                      _sbfMirrorBuffer, sizeof(_sbfMirrorBuffer)));
+        if ((i == 0) && (SSFBFifoMirrorIsMapped(&_sbfMirror) == false))
+        {
+            SSFBFifoMirrorDeInit(&_sbfMirror);
+            continue;
+        }
+        records = 0;
+        moved = 0;
+        offset = 0;
+        start = SSFPortGetHRTick64();
+        while (moved < SSF_TEST_BFIFO_MIRROR_BENCH_BYTES)
+        {
+            j = SSFBFifoMirrorReserve(&_sbfMirror, SSF_TEST_BFIFO_MIRROR_BENCH_CHUNK, &ptr);
+            if (j > (len - offset)) j = len - offset;
+            memcpy(ptr, &_sbfMirrorStream[offset], j);
+            SSFBFifoMirrorCommit(&_sbfMirror, j);
+            offset += j;
+            if (offset == len) offset = 0;
+            moved += j;
+            records += _SSFBFifoUTMirrorParse(&_sbfMirror);
+        }
+        ticks = SSFPortGetHRTick64() - start;
+        SSF_ASSERT(records >= ((moved / len) * expected));
+        SSFBFifoMirrorDeInit(&_sbfMirror);
+        printf("\r\n  Parse in place %s %lu byte fifo, %u byte writes: %llu MB/s\r\n",
+               (i == 0) ? "mirrored" : "plain", SSF_TEST_BFIFO_MIRROR_SIZE - i,
+               (unsigned int)SSF_TEST_BFIFO_MIRROR_BENCH_CHUNK,
+               (unsigned long long)((moved * SSF_HR_TICKS_PER_SEC) /
+                                    ((ticks + 1) * 1000000ull)));
+    }
+}
+#endif /* SSF_CONFIG_UNIT_TEST_BENCHMARK */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Performs unit test on the mirror byte fifo interface, mapped where supported and plain.       */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoUTMirror(void)
+{
+    SSFBFifoMirror_t fifoZero;
+    uint8_t *wptr;
+    const uint8_t *rptr;
+    uint32_t outLen;
+    uint32_t i;
+
+    memset(&fifoZero, 0, sizeof(fifoZero));
+    SSF_ASSERT_TEST(SSFBFifoMirrorInit(NULL, SSF_TEST_BFIFO_MIRROR_SIZE, _sbfMirrorBuffer,
+                                       sizeof(_sbfMirrorBuffer)));
+    SSF_ASSERT_TEST(SSFBFifoMirrorInit(&_sbfMirror, 0, _sbfMirrorBuffer,
+                                       sizeof(_sbfMirrorBuffer)));
+    SSF_ASSERT_TEST(SSFBFifoMirrorInit(&_sbfMirror, 0x80000001ul, NULL, 0));
+    SSF_ASSERT_TEST(SSFBFifoMirrorInit(&_sbfMirror, SSF_TEST_BFIFO_MIRROR_SIZE, _sbfMirrorBuffer,
+                                       SSF_TEST_BFIFO_MIRROR_SIZE - 1u));
+    SSF_ASSERT_TEST(SSFBFifoMirrorDeInit(NULL));
+    SSF_ASSERT_TEST(SSFBFifoMirrorDeInit(&_sbfMirror));
+    SSF_ASSERT_TEST(SSFBFifoMirrorIsMapped(NULL));
+    SSF_ASSERT_TEST(SSFBFifoMirrorIsMapped(&_sbfMirror));
+    SSF_ASSERT_TEST(SSFBFifoMirrorReserve(&_sbfMirror, 1, &wptr));
+    SSF_ASSERT_TEST(SSFBFifoMirrorCommit(&_sbfMirror, 0));
+    SSF_ASSERT_TEST(SSFBFifoMirrorPeekSpan(&_sbfMirror, &rptr));
+    SSF_ASSERT_TEST(SSFBFifoMirrorConsume(&_sbfMirror, 0));
+    SSF_ASSERT_TEST(SSFBFifoMirrorLen(&_sbfMirror));
+
+    /* Plain buffer when the size is not a page multiple, fails without a buffer */
+    SSF_ASSERT(SSFBFifoMirrorInit(&_sbfMirror, SSF_TEST_BFIFO_MIRROR_PLAIN_SIZE, NULL, 0) ==
+               false);
+    SSF_ASSERT(memcmp(&_sbfMirror, &fifoZero, sizeof(fifoZero)) == 0);
+    SSF_ASSERT(SSFBFifoMirrorInit(&_sbfMirror, SSF_TEST_BFIFO_MIRROR_PLAIN_SIZE, _sbfMirrorBuffer,
+                                  sizeof(_sbfMirrorBuffer)));
+    SSF_ASSERT_TEST(SSFBFifoMirrorInit(&_sbfMirror, SSF_TEST_BFIFO_MIRROR_PLAIN_SIZE,
+                                       _sbfMirrorBuffer, sizeof(_sbfMirrorBuffer)));
+    SSF_ASSERT(SSFBFifoMirrorIsMapped(&_sbfMirror) == false);
+    SSF_ASSERT(SSFBFifoMirrorSize(&_sbfMirror) == SSF_TEST_BFIFO_MIRROR_PLAIN_SIZE);
+    SSF_ASSERT_TEST(SSFBFifoMirrorReserve(NULL, 1, &wptr));
+    SSF_ASSERT_TEST(SSFBFifoMirrorReserve(&_sbfMirror, 1, NULL));
+    SSF_ASSERT_TEST(SSFBFifoMirrorCommit(NULL, 0));
+    SSF_ASSERT_TEST(SSFBFifoMirrorPeekSpan(NULL, &rptr));
+    SSF_ASSERT_TEST(SSFBFifoMirrorPeekSpan(&_sbfMirror, NULL));
+    SSF_ASSERT_TEST(SSFBFifoMirrorConsume(NULL, 0));
+    SSF_ASSERT_TEST(SSFBFifoMirrorPutBytes(NULL, _sbfMirrorIO, 1));
+    SSF_ASSERT_TEST(SSFBFifoMirrorPutBytes(&_sbfMirror, NULL, 1));
+    SSF_ASSERT_TEST(SSFBFifoMirrorGetBytes(NULL, _sbfMirrorIO, 1, &outLen));
+    SSF_ASSERT_TEST(SSFBFifoMirrorGetBytes(&_sbfMirror, NULL, 1, &outLen));
+    SSF_ASSERT_TEST(SSFBFifoMirrorGetBytes(&_sbfMirror, _sbfMirrorIO, 1, NULL));
+    SSF_ASSERT_TEST(SSFBFifoMirrorSize(NULL));
+    SSF_ASSERT_TEST(SSFBFifoMirrorLen(NULL));
+    SSF_ASSERT_TEST(SSFBFifoMirrorUnused(NULL));
+    _SSFBFifoUTMirrorStream(&_sbfMirror);
+
+    /* Plain buffer commit is limited to the region returned by reserve */
+    SSFBFifoMirrorPutBytes(&_sbfMirror, _sbfMirrorIO, 10);
+    SSFBFifoMirrorConsume(&_sbfMirror, 5);
+    SSF_ASSERT_TEST(SSFBFifoMirrorCommit(&_sbfMirror, SSF_TEST_BFIFO_MIRROR_PLAIN_SIZE - 5u));
+    SSF_ASSERT(SSFBFifoMirrorReserve(&_sbfMirror, SSF_TEST_BFIFO_MIRROR_PLAIN_SIZE, &wptr) ==
+               (SSF_TEST_BFIFO_MIRROR_PLAIN_SIZE - 5u));
+    SSF_ASSERT(wptr == &_sbfMirrorBuffer[5]);
+    SSFBFifoMirrorCommit(&_sbfMirror, SSF_TEST_BFIFO_MIRROR_PLAIN_SIZE - 5u);
+    SSF_ASSERT(SSFBFifoMirrorUnused(&_sbfMirror) == 0);
+    SSFBFifoMirrorDeInit(&_sbfMirror);
+    SSF_ASSERT(memcmp(&_sbfMirror, &fifoZero, sizeof(fifoZero)) == 0);
+
+    /* Mapped where supported, both halves of the mapping alias the same pages */
+    SSF_ASSERT(SSFBFifoMirrorInit(&_sbfMirror, SSF_TEST_BFIFO_MIRROR_SIZE, _sbfMirrorBuffer,
+                                  sizeof(_sbfMirrorBuffer)));
+    SSF_ASSERT(SSFBFifoMirrorIsMapped(&_sbfMirror) == (SSF_BFIFO_MIRROR_MAP == 1));
+    if (SSFBFifoMirrorIsMapped(&_sbfMirror))
+    {
+        SSF_ASSERT(_sbfMirror.buffer != _sbfMirrorBuffer);
+        for (i = 0; i < SSF_TEST_BFIFO_MIRROR_SIZE; i += 997u)
+        {
+            _sbfMirror.buffer[i] = (uint8_t)(i + 1u);
+            SSF_ASSERT(_sbfMirror.buffer[i + SSF_TEST_BFIFO_MIRROR_SIZE] == (uint8_t)(i + 1u));
+            _sbfMirror.buffer[i + SSF_TEST_BFIFO_MIRROR_SIZE] = (uint8_t)i;
+            SSF_ASSERT(_sbfMirror.buffer[i] == (uint8_t)i);
+        }
+    }
+    _SSFBFifoUTMirrorStream(&_sbfMirror);
+    SSFBFifoMirrorDeInit(&_sbfMirror);
+    SSF_ASSERT(memcmp(&_sbfMirror, &fifoZero, sizeof(fifoZero)) == 0);
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    _SSFBFifoUTMirrorBench();
+#endif
+}
+#endif /* SSF_BFIFO_CONFIG_ENABLE_MIRROR */
+
+#if SSF_BFIFO_CONFIG_ENABLE_BCAST == 1
+#define SSF_TEST_BFIFO_BCAST_SIZE (256UL)
+#define SSF_TEST_BFIFO_BCAST_BYTE(i) ((uint8_t)((i) + ((i) >> 8)))
+static SSFBFifoBcast_t _sbfBcast;
+static uint8_t _sbfBcastBuffer[SSF_TEST_BFIFO_BCAST_SIZE];
+static uint8_t _sbfBcastIn[SSF_TEST_BFIFO_BCAST_SIZE];
+
+/* --------------------------------------------------------------------------------------------- */
+/* Puts len bytes of the test pattern starting at stream position pos into the broadcast ring.  */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoUTBcastPut(uint32_t pos, uint32_t len)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++) _sbfBcastIn[i] = SSF_TEST_BFIFO_BCAST_BYTE(pos + i);
+    SSFBFifoBcastPutBytes(&_sbfBcast, _sbfBcastIn, len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Reads up to size bytes, checks them against the pattern at *pos, returns true if any read.   */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFBFifoUTBcastGet(SSFBFifoBcastReader_t *reader, uint8_t *out, uint32_t size,
+                                uint32_t *pos, uint32_t *lost)
+{
+    uint32_t outLen;
+    uint32_t lostLen;
+    uint32_t i;
+    bool result;
+
+    result = SSFBFifoBcastGetBytes(reader, out, size, &outLen, &lostLen);
+    SSF_ASSERT(result == ((outLen != 0) || (lostLen != 0)));
+    SSF_ASSERT((outLen == 0) || (lostLen == 0));
+    SSF_ASSERT(outLen <= size);
+    *pos += lostLen;
+    *lost += lostLen;
+    for (i = 0; i < outLen; i++) SSF_ASSERT(out[i] == SSF_TEST_BFIFO_BCAST_BYTE(*pos + i));
+    *pos += outLen;
+    return outLen != 0;
+}
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+#define SSF_TEST_BFIFO_BCAST_MT_BYTES (4ul * 1024ul * 1024ul)
+#define SSF_TEST_BFIFO_BCAST_MT_READERS (3u)
+static SSFBFifoBcastReader_t _sbfBcastReaders[SSF_TEST_BFIFO_BCAST_MT_READERS];
+static uint32_t _sbfBcastLost[SSF_TEST_BFIFO_BCAST_MT_READERS];
+static uint32_t _sbfBcastGot[SSF_TEST_BFIFO_BCAST_MT_READERS];
+static uint32_t _sbfBcastPos[SSF_TEST_BFIFO_BCAST_MT_READERS];
+
+/* --------------------------------------------------------------------------------------------- */
+/* Broadcast reader thread, checks every byte it receives until the whole stream is accounted.  */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFBFifoUTBcastReader(void *arg)
+{
+    uint32_t index = (uint32_t)(uintptr_t)arg;
+    SSFBFifoBcastReader_t *reader = &_sbfBcastReaders[index];
+    uint8_t out[SSF_TEST_BFIFO_BCAST_SIZE];
+    uint32_t pos = 0;
+    uint32_t size = 1;
+    uint32_t got;
+
+    while (pos < SSF_TEST_BFIFO_BCAST_MT_BYTES)
+    {
+        got = pos;
+        if (_SSFBFifoUTBcastGet(reader, out, size, &pos, &_sbfBcastLost[index]))
+        {
+            _sbfBcastGot[index] += pos - got;
+        }
+        else if (SSFBFifoBcastReaderIsDropped(reader))
+        {
+            got = SSFBFifoBcastReaderResync(reader);
+            pos += got;
+            _sbfBcastLost[index] += got;
+        }
+        else sched_yield();
+        SSF_ATOMIC_STORE_U32(&_sbfBcastPos[index], pos);
+        size = (size % SSF_TEST_BFIFO_BCAST_SIZE) + 1u;
+    }
+    SSF_ASSERT(pos == SSF_TEST_BFIFO_BCAST_MT_BYTES);
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Streams bytes to report and drop reader threads, waiting for them over the first half only.  */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoUTBcastThreads(void)
+{
+    pthread_t threads[SSF_TEST_BFIFO_BCAST_MT_READERS];
+    uint32_t pos = 0;
+    uint32_t len = 1;
+    uint32_t i;
+
+    memset(_sbfBcastLost, 0, sizeof(_sbfBcastLost));
+    memset(_sbfBcastGot, 0, sizeof(_sbfBcastGot));
+    memset(_sbfBcastPos, 0, sizeof(_sbfBcastPos));
+    SSFBFifoBcastInit(&_sbfBcast, SSF_TEST_BFIFO_BCAST_SIZE, _sbfBcastBuffer,
+                      sizeof(_sbfBcastBuffer));
+    for (i = 0; i < SSF_TEST_BFIFO_BCAST_MT_READERS; i++)
+    {
+        SSFBFifoBcastReaderInit(&_sbfBcastReaders[i], &_sbfBcast, (i & 1u) != 0);
+        SSF_ASSERT(pthread_create(&threads[i], NULL, _SSFBFifoUTBcastReader,
+                                  (void *)(uintptr_t)i) == 0);
+    }
+    while (pos < SSF_TEST_BFIFO_BCAST_MT_BYTES)
+    {
+        if (len > (SSF_TEST_BFIFO_BCAST_MT_BYTES - pos)) len = SSF_TEST_BFIFO_BCAST_MT_BYTES - pos;
+        for (i = 0; (pos < (SSF_TEST_BFIFO_BCAST_MT_BYTES / 2u)) &&
+                    (i < SSF_TEST_BFIFO_BCAST_MT_READERS); i++)
+        {
+            while ((pos + len - SSF_ATOMIC_LOAD_U32(&_sbfBcastPos[i])) > SSF_TEST_BFIFO_BCAST_SIZE)
+            {
+                sched_yield();
+            }
+        }
+        _SSFBFifoUTBcastPut(pos, len);
+        pos += len;
+        if ((pos & 0x3ffu) < len) sched_yield();
+        len = (len % 97u) + 1u;
+    }
+    for (i = 0; i < SSF_TEST_BFIFO_BCAST_MT_READERS; i++)
+    {
+        SSF_ASSERT(pthread_join(threads[i], NULL) == 0);
+        SSF_ASSERT((_sbfBcastGot[i] + _sbfBcastLost[i]) == SSF_TEST_BFIFO_BCAST_MT_BYTES);
+        SSF_ASSERT(_sbfBcastGot[i] >= (SSF_TEST_BFIFO_BCAST_MT_BYTES / 2u));
+        SSFBFifoBcastReaderDeInit(&_sbfBcastReaders[i]);
+    }
+    SSFBFifoBcastDeInit(&_sbfBcast);
+}
+
+/* The benchmark compares against today's approach of one SPSC fifo per reader */
+#if (SSF_CONFIG_UNIT_TEST_BENCHMARK == 1) && (SSF_BFIFO_CONFIG_ENABLE_SPSC == 1)
+#define SSF_TEST_BFIFO_BCAST_BENCH_SIZE (65536UL)
+#define SSF_TEST_BFIFO_BCAST_BENCH_BYTES (64ul * 1024ul * 1024ul)
+#define SSF_TEST_BFIFO_BCAST_BENCH_CHUNK (256u)
+#define SSF_TEST_BFIFO_BCAST_BENCH_READERS (4u)
+static uint8_t _sbfBcastBenchBuffers[SSF_TEST_BFIFO_BCAST_BENCH_READERS]
+                                    [SSF_TEST_BFIFO_BCAST_BENCH_SIZE];
+static SSFBFifoSPSC_t _sbfBcastBenchSPSC[SSF_TEST_BFIFO_BCAST_BENCH_READERS];
+static SSFBFifoBcastReader_t _sbfBcastBenchReaders[SSF_TEST_BFIFO_BCAST_BENCH_READERS];
+static uint32_t _sbfBcastBenchLost[SSF_TEST_BFIFO_BCAST_BENCH_READERS];
+static bool _sbfBcastBenchIsBcast;
+
+/* --------------------------------------------------------------------------------------------- */
+/* Benchmark reader thread, reads until the whole stream is received or lost.                   */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFBFifoUTBcastBenchReader(void *arg)
+{
+    uint32_t index = (uint32_t)(uintptr_t)arg;
+    uint8_t out[4096];
+    uint64_t pos = 0;
+    uint32_t outLen;
+    uint32_t lostLen;
+
+    while (pos < SSF_TEST_BFIFO_BCAST_BENCH_BYTES)
+    {
+        outLen = 0;
+        lostLen = 0;
+        if (_sbfBcastBenchIsBcast)
+        {
+            SSFBFifoBcastGetBytes(&_sbfBcastBenchReaders[index], out, sizeof(out), &outLen,
+                                  &lostLen);
+        }
+        else SSFBFifoSPSCGetBytes(&_sbfBcastBenchSPSC[index], out, sizeof(out), &outLen);
+        if ((outLen == 0) && (lostLen == 0)) sched_yield();
+        pos += outLen + lostLen;
+        _sbfBcastBenchLost[index] += lostLen;
+    }
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Prints 1 producer/N reader throughput of the broadcast ring and of one SPSC fifo per reader. */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoUTBcastBench(void)
+{
+    pthread_t threads[SSF_TEST_BFIFO_BCAST_BENCH_READERS];
+    uint64_t start;
+    uint64_t ticks;
+    uint64_t lost;
+    uint32_t readers;
+    uint32_t sent;
+    uint32_t put;
+    uint32_t mode;
+    uint32_t i;
+
+    for (readers = 1; readers <= SSF_TEST_BFIFO_BCAST_BENCH_READERS; readers <<= 1)
+    {
+        for (mode = 0; mode < 2u; mode++)
+        {
+            _sbfBcastBenchIsBcast = (mode == 1u);
+            memset(_sbfBcastBenchLost, 0, sizeof(_sbfBcastBenchLost));
+            if (_sbfBcastBenchIsBcast)
+            {
+                SSFBFifoBcastInit(&_sbfBcast, SSF_TEST_BFIFO_BCAST_BENCH_SIZE,
+                                  _sbfBcastBenchBuffers[0], SSF_TEST_BFIFO_BCAST_BENCH_SIZE);
+            }
+            for (i = 0; i < readers; i++)
+            {
+                if (_sbfBcastBenchIsBcast)
+                {
+                    SSFBFifoBcastReaderInit(&_sbfBcastBenchReaders[i], &_sbfBcast, false);
+                }
+                else
+                {
+                    SSFBFifoSPSCInit(&_sbfBcastBenchSPSC[i], SSF_TEST_BFIFO_BCAST_BENCH_SIZE,
+                                     _sbfBcastBenchBuffers[i], SSF_TEST_BFIFO_BCAST_BENCH_SIZE);
+                }
+            }
+            start = SSFPortGetHRTick64();
+            for (i = 0; i < readers; i++)
+            {
+                SSF_ASSERT(pthread_create(&threads[i], NULL, _SSFBFifoUTBcastBenchReader,
+                                          (void *)(uintptr_t)i) == 0);
+            }
+            for (sent = 0; sent < SSF_TEST_BFIFO_BCAST_BENCH_BYTES;
+                 sent += SSF_TEST_BFIFO_BCAST_BENCH_CHUNK)
+            {
+                if (_sbfBcastBenchIsBcast)
+                {
+                    SSFBFifoBcastPutBytes(&_sbfBcast, _sbfSPSCIn, SSF_TEST_BFIFO_BCAST_BENCH_CHUNK);
+                    continue;
+                }
+                /* Today's approach, a lossless copy into each reader's own fifo */
+                for (i = 0; i < readers; i++)
+                {
+                    put = 0;
+                    while (put < SSF_TEST_BFIFO_BCAST_BENCH_CHUNK)
+                    {
+                        put += SSFBFifoSPSCPutBytes(&_sbfBcastBenchSPSC[i], &_sbfSPSCIn[put],
+                                                    SSF_TEST_BFIFO_BCAST_BENCH_CHUNK - put);
+                        if (put < SSF_TEST_BFIFO_BCAST_BENCH_CHUNK) sched_yield();
+                    }
+                }
+            }
+            for (i = 0; i < readers; i++) SSF_ASSERT(pthread_join(threads[i], NULL) == 0);
+            ticks = SSFPortGetHRTick64() - start;
+            lost = 0;
+            for (i = 0; i < readers; i++)
+            {
+                lost += _sbfBcastBenchLost[i];
+                if (_sbfBcastBenchIsBcast) SSFBFifoBcastReaderDeInit(&_sbfBcastBenchReaders[i]);
+                else SSFBFifoSPSCDeInit(&_sbfBcastBenchSPSC[i]);
+            }
+            if (_sbfBcastBenchIsBcast) SSFBFifoBcastDeInit(&_sbfBcast);
+            printf("\r\n  1 producer/%u readers, %s, %u byte puts: %llu MB/s, %llu%% lost\r\n",
+                   (unsigned int)readers,
+                   _sbfBcastBenchIsBcast ? "broadcast ring" : "SPSC fifo per reader",
+                   (unsigned int)SSF_TEST_BFIFO_BCAST_BENCH_CHUNK,
+                   (unsigned long long)((SSF_TEST_BFIFO_BCAST_BENCH_BYTES * SSF_HR_TICKS_PER_SEC) /
+                                        ((ticks + 1) * 1000000ull)),
+                   (unsigned long long)((lost * 100u) /
+                                        ((uint64_t)SSF_TEST_BFIFO_BCAST_BENCH_BYTES * readers)));
+        }
+    }
+}
+#endif /* SSF_CONFIG_UNIT_TEST_BENCHMARK && SSF_BFIFO_CONFIG_ENABLE_SPSC */
+#endif /* (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32) */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Performs unit test on the broadcast byte ring interface from a single thread.                 */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFBFifoUTBcast(void)
+{
+    SSFBFifoBcast_t ringZero;
+    SSFBFifoBcastReader_t readerZero;
+    SSFBFifoBcastReader_t fast;
+    SSFBFifoBcastReader_t slow;
+    SSFBFifoBcastReader_t drop;
+    uint8_t out[SSF_TEST_BFIFO_BCAST_SIZE];
+    volatile uint32_t pos;
+    uint32_t fastPos;
+    uint32_t slowPos;
+    uint32_t dropPos;
+    uint32_t lost;
+    uint32_t outLen;
+    uint32_t lostLen;
+    volatile uint32_t i;
+
+    memset(&ringZero, 0, sizeof(ringZero));
+    memset(&readerZero, 0, sizeof(readerZero));
+    memset(&fast, 0, sizeof(fast));
+    SSF_ASSERT_TEST(SSFBFifoBcastInit(NULL, SSF_TEST_BFIFO_BCAST_SIZE, _sbfBcastBuffer,
+                                      sizeof(_sbfBcastBuffer)));
+    SSF_ASSERT_TEST(SSFBFifoBcastInit(&_sbfBcast, 0, _sbfBcastBuffer, sizeof(_sbfBcastBuffer)));
+    SSF_ASSERT_TEST(SSFBFifoBcastInit(&_sbfBcast, SSF_TEST_BFIFO_BCAST_SIZE - 1u, _sbfBcastBuffer,
+                                      sizeof(_sbfBcastBuffer)));
+    SSF_ASSERT_TEST(SSFBFifoBcastInit(&_sbfBcast, SSF_TEST_BFIFO_BCAST_SIZE, NULL,
+                                      sizeof(_sbfBcastBuffer)));
+    SSF_ASSERT_TEST(SSFBFifoBcastInit(&_sbfBcast, SSF_TEST_BFIFO_BCAST_SIZE, _sbfBcastBuffer,
+                                      SSF_TEST_BFIFO_BCAST_SIZE - 1u));
+    SSF_ASSERT_TEST(SSFBFifoBcastDeInit(NULL));
+    SSF_ASSERT_TEST(SSFBFifoBcastDeInit(&_sbfBcast));
+    SSF_ASSERT_TEST(SSFBFifoBcastPutBytes(&_sbfBcast, _sbfBcastIn, 1));
+    SSF_ASSERT_TEST(SSFBFifoBcastSize(&_sbfBcast));
+    SSF_ASSERT_TEST(SSFBFifoBcastReaderInit(&fast, &_sbfBcast, false));
+    SSF_ASSERT_TEST(SSFBFifoBcastReaderDeInit(&fast));
+
+    SSFBFifoBcastInit(&_sbfBcast, SSF_TEST_BFIFO_BCAST_SIZE, _sbfBcastBuffer,
+                      sizeof(_sbfBcastBuffer));
+    SSF_ASSERT_TEST(SSFBFifoBcastInit(&_sbfBcast, SSF_TEST_BFIFO_BCAST_SIZE, _sbfBcastBuffer,
+                                      sizeof(_sbfBcastBuffer)));
+    SSF_ASSERT(SSFBFifoBcastSize(&_sbfBcast) == SSF_TEST_BFIFO_BCAST_SIZE);
+    SSF_ASSERT_TEST(SSFBFifoBcastSize(NULL));
+    SSF_ASSERT_TEST(SSFBFifoBcastPutBytes(NULL, _sbfBcastIn, 1));
+    SSF_ASSERT_TEST(SSFBFifoBcastPutBytes(&_sbfBcast, NULL, 1));
+    SSF_ASSERT_TEST(SSFBFifoBcastPutBytes(&_sbfBcast, _sbfBcastIn,
+                                          SSF_TEST_BFIFO_BCAST_SIZE + 1u));
+    SSF_ASSERT_TEST(SSFBFifoBcastReaderInit(NULL, &_sbfBcast, false));
+    SSF_ASSERT_TEST(SSFBFifoBcastReaderInit(&fast, NULL, false));
+    SSF_ASSERT_TEST(SSFBFifoBcastReaderInit(&fast, (SSFBFifoBcast_t *)&ringZero, false));
+    SSF_ASSERT_TEST(SSFBFifoBcastGetBytes(&fast, out, sizeof(out), &outLen, &lostLen));
+    SSF_ASSERT_TEST(SSFBFifoBcastReaderLen(&fast));
+    SSF_ASSERT_TEST(SSFBFifoBcastReaderIsDropped(&fast));
+    SSF_ASSERT_TEST(SSFBFifoBcastReaderResync(&fast));
+
+    /* A reader only receives bytes put after it is initialized */
+    _SSFBFifoUTBcastPut(1000u, 10u);
+    SSFBFifoBcastReaderInit(&fast, &_sbfBcast, false);
+    SSF_ASSERT_TEST(SSFBFifoBcastReaderInit(&fast, &_sbfBcast, false));
+    SSFBFifoBcastReaderInit(&slow, &_sbfBcast, false);
+    SSFBFifoBcastReaderInit(&drop, &_sbfBcast, true);
+    SSF_ASSERT_TEST(SSFBFifoBcastGetBytes(NULL, out, sizeof(out), &outLen, &lostLen));
+    SSF_ASSERT_TEST(SSFBFifoBcastGetBytes(&fast, NULL, sizeof(out), &outLen, &lostLen));
+    SSF_ASSERT_TEST(SSFBFifoBcastGetBytes(&fast, out, sizeof(out), NULL, &lostLen));
+    SSF_ASSERT_TEST(SSFBFifoBcastGetBytes(&fast, out, sizeof(out), &outLen, NULL));
+    SSF_ASSERT_TEST(SSFBFifoBcastReaderLen(NULL));
+    SSF_ASSERT_TEST(SSFBFifoBcastReaderIsDropped(NULL));
+    SSF_ASSERT_TEST(SSFBFifoBcastReaderResync(NULL));
+    SSF_ASSERT(SSFBFifoBcastGetBytes(&fast, out, sizeof(out), &outLen, &lostLen) == false);
+    SSF_ASSERT((outLen == 0) && (lostLen == 0));
+    SSF_ASSERT(SSFBFifoBcastReaderLen(&fast) == 0);
+
+    /* Every reader sees every byte while it keeps up, in any read size */
+    pos = 0;
+    fastPos = 0;
+    slowPos = 0;
+    dropPos = 0;
+    lost = 0;
+    for (i = 1; i < 2000u; i++)
+    {
+        _SSFBFifoUTBcastPut(pos, (i * 7u) % 64u);
+        pos += (i * 7u) % 64u;
+        SSF_ASSERT(SSFBFifoBcastReaderLen(&fast) == (pos - fastPos));
+        while (_SSFBFifoUTBcastGet(&fast, out, (i % 37u) + 1u, &fastPos, &lost));
+        SSF_ASSERT(fastPos == pos);
+        if ((i % 3u) == 0)
+        {
+            while (_SSFBFifoUTBcastGet(&slow, out, (i % 200u) + 1u, &slowPos, &lost));
+            while (_SSFBFifoUTBcastGet(&drop, out, (i % 200u) + 1u, &dropPos, &lost));
+        }
+    }
+    while (_SSFBFifoUTBcastGet(&slow, out, sizeof(out), &slowPos, &lost));
+    while (_SSFBFifoUTBcastGet(&drop, out, sizeof(out), &dropPos, &lost));
+    SSF_ASSERT(lost == 0);
+    SSF_ASSERT((slowPos == pos) && (dropPos == pos));
+    SSF_ASSERT(SSFBFifoBcastReaderIsDropped(&drop) == false);
+
+    /* An overrun reader is told exactly how many bytes it lost, or is dropped */
+    for (i = 0; i < 5u; i++)
+    {
+        _SSFBFifoUTBcastPut(pos, 100u);
+        pos += 100u;
+        while (_SSFBFifoUTBcastGet(&fast, out, sizeof(out), &fastPos, &lost));
+    }
+    SSF_ASSERT(SSFBFifoBcastReaderLen(&slow) == 500u);
+    SSF_ASSERT(SSFBFifoBcastGetBytes(&slow, out, sizeof(out), &outLen, &lostLen));
+    SSF_ASSERT((outLen == 0) && (lostLen == (500u - SSF_TEST_BFIFO_BCAST_SIZE)));
+    slowPos += lostLen;
+    SSF_ASSERT(SSFBFifoBcastReaderLen(&slow) == SSF_TEST_BFIFO_BCAST_SIZE);
+    lost = 0;
+    while (_SSFBFifoUTBcastGet(&slow, out, 100u, &slowPos, &lost));
+    SSF_ASSERT((lost == 0) && (slowPos == pos));
+
+    SSF_ASSERT(SSFBFifoBcastGetBytes(&drop, out, sizeof(out), &outLen, &lostLen) == false);
+    SSF_ASSERT((outLen == 0) && (lostLen == 0));
+    SSF_ASSERT(SSFBFifoBcastReaderIsDropped(&drop));
+    _SSFBFifoUTBcastPut(pos, 1u);
+    pos++;
+    SSF_ASSERT(SSFBFifoBcastGetBytes(&drop, out, sizeof(out), &outLen, &lostLen) == false);
+    SSF_ASSERT(SSFBFifoBcastReaderResync(&drop) == 501u);
+    dropPos = pos;
+    SSF_ASSERT(SSFBFifoBcastReaderIsDropped(&drop) == false);
+    _SSFBFifoUTBcastPut(pos, 3u);
+    pos += 3u;
+    while (_SSFBFifoUTBcastGet(&drop, out, 2u, &dropPos, &lost));
+    SSF_ASSERT((lost == 0) && (dropPos == pos));
+
+    /* A copy the producer started overwriting meanwhile is reported as lost, not returned */
+    while (_SSFBFifoUTBcastGet(&fast, out, sizeof(out), &fastPos, &lost));
+    _sbfBcast.reserve = _sbfBcast.head + 1u;
+    SSF_ASSERT(SSFBFifoBcastGetBytes(&fast, out, sizeof(out), &outLen, &lostLen) == false);
+    _SSFBFifoUTBcastPut(pos, SSF_TEST_BFIFO_BCAST_SIZE);
+    pos += SSF_TEST_BFIFO_BCAST_SIZE;
+    _sbfBcast.reserve = _sbfBcast.head + 1u;
+    SSF_ASSERT(SSFBFifoBcastGetBytes(&fast, out, sizeof(out), &outLen, &lostLen));
+    SSF_ASSERT((outLen == 0) && (lostLen == 1u));
+    _sbfBcast.reserve = _sbfBcast.head;
+    fastPos += lostLen;
+    lost = 0;
+    while (_SSFBFifoUTBcastGet(&fast, out, sizeof(out), &fastPos, &lost));
+    SSF_ASSERT((lost == 0) && (fastPos == pos));
+
+    /* Cursors wrap through 2^32 */
+    SSFBFifoBcastReaderDeInit(&fast);
+    SSF_ASSERT(memcmp(&fast, &readerZero, sizeof(readerZero)) == 0);
+    _sbfBcast.head = 0xffffff00ul;
+    _sbfBcast.reserve = _sbfBcast.head;
+    SSFBFifoBcastReaderInit(&fast, &_sbfBcast, false);
+    fastPos = pos;
+    for (i = 1; i < 40u; i++)
+    {
+        _SSFBFifoUTBcastPut(pos, i);
+        pos += i;
+        while (_SSFBFifoUTBcastGet(&fast, out, 7u, &fastPos, &lost));
+    }
+    SSF_ASSERT(_sbfBcast.head < 0xffffff00ul);
+    SSF_ASSERT((lost == 0) && (fastPos == pos));
+    SSFBFifoBcastPutBytes(&_sbfBcast, _sbfBcastIn, 0);
+    SSF_ASSERT(SSFBFifoBcastReaderLen(&fast) == 0);
+
+    SSFBFifoBcastReaderDeInit(&fast);
+    SSFBFifoBcastReaderDeInit(&slow);
+    SSFBFifoBcastReaderDeInit(&drop);
+    SSFBFifoBcastDeInit(&_sbfBcast);
+    SSF_ASSERT(memcmp(&_sbfBcast, &ringZero, sizeof(ringZero)) == 0);
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && !defined(_WIN32)
+    _SSFBFifoUTBcastThreads();
+#if (SSF_CONFIG_UNIT_TEST_BENCHMARK == 1) && (SSF_BFIFO_CONFIG_ENABLE_SPSC == 1)
+    _SSFBFifoUTBcastBench();
+#endif
+#endif
+}
+#endif /* SSF_BFIFO_CONFIG_ENABLE_BCAST */
+
 /* --------------------------------------------------------------------------------------------- */
 /* Performs unit test on ssfbfifo's external interface.                                          */
 /* --------------------------------------------------------------------------------------------- */
@@ -56,10 +1400,14 @@ void SSFBFifoUnitTest(void)
 {
     uint8_t outByte;
     volatile uint32_t i;
-    uint32_t j;
+    volatile uint32_t j;
     SSFBFifo_t fifoZero;
 #if SSF_BFIFO_MULTI_BYTE_ENABLE == 1
     uint32_t outLen;
+    volatile uint32_t k;
+    volatile uint32_t step;
+    SSFBFifoSpan_t span;
+    volatile uint32_t wraps;
 #endif /* SSF_BFIFO_MULTI_BYTE_ENABLE */
 
     /* Test assertions */
@@ -323,6 +1671,97 @@ void SSFBFifoUnitTest(void)
         SSF_ASSERT(outLen == 7);
         SSF_ASSERT(memcmp(_sbfReadBuf, "123456", outLen) == 0);
     }
+
+    /* Block copies starting at every ring offset, including ones that straddle the wrap */
+    SSF_ASSERT(SSFBFifoIsEmpty(&_sbfFifos[0]));
+    for (i = 0; i < sizeof(_sbfWriteBuf); i++) _sbfWriteBuf[i] = (uint8_t)((i * 7u) + 3u);
+    step = (SSF_TEST_BFIFO_SIZE / 128u) + 1u;
+    for (i = 0; i <= SSF_TEST_BFIFO_SIZE; i += step)
+    {
+        for (k = 0; k < 3; k++)
+        {
+            j = (k == 0) ? 1u : ((k == 1) ? (SSF_TEST_BFIFO_SIZE / 2u) : SSF_TEST_BFIFO_SIZE);
+            SSFBFifoPutBytes(&_sbfFifos[0], _sbfWriteBuf, j);
+            SSF_ASSERT(SSFBFifoLen(&_sbfFifos[0]) == j);
+            if (j == SSF_TEST_BFIFO_SIZE)
+            {
+                SSF_ASSERT(SSFBFifoIsFull(&_sbfFifos[0]));
+                SSF_ASSERT_TEST(SSFBFifoPutBytes(&_sbfFifos[0], _sbfWriteBuf, 1));
+            }
+            memset(_sbfReadBuf, 0xcc, sizeof(_sbfReadBuf));
+            SSF_ASSERT(SSFBFifoPeekBytes(&_sbfFifos[0], _sbfReadBuf, sizeof(_sbfReadBuf),
+                                         &outLen));
+            SSF_ASSERT(outLen == j);
+            SSF_ASSERT(memcmp(_sbfReadBuf, _sbfWriteBuf, j) == 0);
+            memset(_sbfReadBuf, 0xcc, sizeof(_sbfReadBuf));
+            SSF_ASSERT(SSFBFifoGetBytes(&_sbfFifos[0], _sbfReadBuf, j - (k >> 1), &outLen));
+            SSF_ASSERT(outLen == (j - (k >> 1)));
+            SSF_ASSERT(memcmp(_sbfReadBuf, _sbfWriteBuf, outLen) == 0);
+            if (k == 2)
+            {
+                SSF_ASSERT(SSFBFifoGetBytes(&_sbfFifos[0], _sbfReadBuf, 2, &outLen));
+                SSF_ASSERT((outLen == 1) && (_sbfReadBuf[0] == _sbfWriteBuf[j - 1]));
+            }
+            SSF_ASSERT(SSFBFifoIsEmpty(&_sbfFifos[0]));
+        }
+
+        /* Move the ring offset */
+        SSFBFifoPutBytes(&_sbfFifos[0], _sbfWriteBuf, step);
+        SSF_ASSERT(SSFBFifoGetBytes(&_sbfFifos[0], _sbfReadBuf, step, &outLen));
+        SSF_ASSERT(outLen == step);
+    }
+
+    /* Zero-copy spans starting at every ring offset */
+    SSF_ASSERT_TEST(SSFBFifoReserve(NULL, 1, &span));
+    SSF_ASSERT_TEST(SSFBFifoReserve(&_sbfFifos[0], 1, NULL));
+    SSF_ASSERT_TEST(SSFBFifoCommit(NULL, 0));
+    SSF_ASSERT_TEST(SSFBFifoPeekSpan(NULL, &span));
+    SSF_ASSERT_TEST(SSFBFifoPeekSpan(&_sbfFifos[0], NULL));
+    SSF_ASSERT_TEST(SSFBFifoConsume(NULL, 0));
+    SSF_ASSERT_TEST(SSFBFifoConsume(&_sbfFifos[0], 1));
+    SSF_ASSERT(SSFBFifoPeekSpan(&_sbfFifos[0], &span) == 0);
+    SSF_ASSERT((span.len[0] == 0) && (span.len[1] == 0) && (span.ptr[1] == NULL));
+    wraps = 0;
+    for (i = 0; i <= SSF_TEST_BFIFO_SIZE; i += step)
+    {
+        /* Reserve more than fits, fill both segments and commit */
+        SSF_ASSERT(SSFBFifoReserve(&_sbfFifos[0], SSF_TEST_BFIFO_SIZE + 1u, &span) ==
+                   SSF_TEST_BFIFO_SIZE);
+        SSF_ASSERT((span.len[0] + span.len[1]) == SSF_TEST_BFIFO_SIZE);
+        SSF_ASSERT((span.len[1] == 0) == (span.ptr[1] == NULL));
+        if (span.len[1] != 0) wraps++;
+        memcpy(span.ptr[0], _sbfWriteBuf, span.len[0]);
+        if (span.len[1] != 0) memcpy(span.ptr[1], &_sbfWriteBuf[span.len[0]], span.len[1]);
+        SSF_ASSERT_TEST(SSFBFifoCommit(&_sbfFifos[0], SSF_TEST_BFIFO_SIZE + 1u));
+        SSFBFifoCommit(&_sbfFifos[0], SSF_TEST_BFIFO_SIZE);
+        SSF_ASSERT(SSFBFifoIsFull(&_sbfFifos[0]));
+        SSF_ASSERT(SSFBFifoReserve(&_sbfFifos[0], 1, &span) == 0);
+
+        /* Scan in place, then consume in two steps */
+        SSF_ASSERT(SSFBFifoPeekSpan(&_sbfFifos[0], &span) == SSF_TEST_BFIFO_SIZE);
+        SSF_ASSERT(memcmp(span.ptr[0], _sbfWriteBuf, span.len[0]) == 0);
+        SSF_ASSERT((span.len[1] == 0) ||
+                   (memcmp(span.ptr[1], &_sbfWriteBuf[span.len[0]], span.len[1]) == 0));
+        SSF_ASSERT_TEST(SSFBFifoConsume(&_sbfFifos[0], SSF_TEST_BFIFO_SIZE + 1u));
+        SSFBFifoConsume(&_sbfFifos[0], 1);
+        SSF_ASSERT(SSFBFifoPeekSpan(&_sbfFifos[0], &span) == (SSF_TEST_BFIFO_SIZE - 1u));
+        SSF_ASSERT(span.ptr[0][0] == _sbfWriteBuf[1]);
+        SSFBFifoConsume(&_sbfFifos[0], SSF_TEST_BFIFO_SIZE - 1u);
+        SSF_ASSERT(SSFBFifoIsEmpty(&_sbfFifos[0]));
+
+        /* Move the ring offset */
+        SSF_ASSERT(SSFBFifoReserve(&_sbfFifos[0], step, &span) == step);
+        SSFBFifoCommit(&_sbfFifos[0], step);
+        SSFBFifoConsume(&_sbfFifos[0], step);
+    }
+    SSF_ASSERT(wraps > 0);
+#if !defined(_WIN32)
+    _SSFBFifoUTSpanSocket(&_sbfFifos[0]);
+#endif
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    _SSFBFifoUTBlockBench(&_sbfFifos[1]);
+#endif
 #endif /* SSF_BFIFO_MULTI_BYTE_ENABLE */
 
     /* PutByte on full FIFO fires ENSURE assertion */
@@ -465,6 +1904,16 @@ void SSFBFifoUnitTest(void)
         SSFBFifoDeInit(&_sbfFifos[i]);
         SSF_ASSERT(memcmp(&_sbfFifos[i], &fifoZero, sizeof(fifoZero)) == 0);
     }
+
+#if SSF_BFIFO_CONFIG_ENABLE_SPSC == 1
+    _SSFBFifoUTSPSC();
+#endif
+#if SSF_BFIFO_CONFIG_ENABLE_MIRROR == 1
+    _SSFBFifoUTMirror();
+#endif
+#if SSF_BFIFO_CONFIG_ENABLE_BCAST == 1
+    _SSFBFifoUTBcast();
+#endif
 }
 #endif /* SSF_CONFIG_BFIFO_UNIT_TEST */
 
@@ -180,6 +180,100 @@ bool SSFLLGetItem(SSFLL_t *ll, SSFLLItem_t **outItem, SSF_LL_LOC_t loc, SSFLLIte
     return false;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/* Puts the chain of n items linked by next from first at head or tail, as n puts in order would. */
+/* --------------------------------------------------------------------------------------------- */
+void SSFLLPutChain(SSFLL_t *ll, SSFLLItem_t *first, uint32_t n, SSF_LL_LOC_t loc)
+{
+    SSFLLItem_t *item;
+    SSFLLItem_t *next;
+    uint32_t i;
+
+    SSF_REQUIRE(ll != NULL);
+    SSF_REQUIRE((loc == SSF_LL_LOC_HEAD) || (loc == SSF_LL_LOC_TAIL));
+    SSF_REQUIRE(ll->magic == SSF_LL_INIT_MAGIC);
+    SSF_REQUIRE(n <= (ll->size - ll->items));
+
+    /* Check the whole chain before linking any of it */
+    item = first;
+    for (i = 0; i < n; i++)
+    {
+        SSF_REQUIRE(item != NULL);
+        SSF_REQUIRE(item->ll == NULL);
+        item = item->next;
+    }
+
+    item = first;
+    for (i = 0; i < n; i++)
+    {
+        next = item->next;
+        if (loc == SSF_LL_LOC_HEAD)
+        {
+            item->next = ll->head;
+            item->prev = NULL;
+            if (ll->head == NULL) ll->tail = item;
+            else ll->head->prev = item;
+            ll->head = item;
+        }
+        else
+        {
+            item->next = NULL;
+            item->prev = ll->tail;
+            if (ll->tail == NULL) ll->head = item;
+            else ll->tail->next = item;
+            ll->tail = item;
+        }
+        item->ll = ll;
+        item = next;
+    }
+    ll->items += n;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Removes up to n items from head or tail as a chain linked by next in removal order.           */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFLLGetChain(SSFLL_t *ll, SSFLLItem_t **outFirst, uint32_t n, SSF_LL_LOC_t loc)
+{
+    SSFLLItem_t *item;
+    SSFLLItem_t *next;
+    uint32_t i;
+
+    SSF_REQUIRE(ll != NULL);
+    SSF_REQUIRE(outFirst != NULL);
+    SSF_REQUIRE((loc == SSF_LL_LOC_HEAD) || (loc == SSF_LL_LOC_TAIL));
+    SSF_REQUIRE(ll->magic == SSF_LL_INIT_MAGIC);
+
+    if (n > ll->items) n = ll->items;
+    *outFirst = (loc == SSF_LL_LOC_HEAD) ? ll->head : ll->tail;
+    if (n == 0) return 0;
+
+    item = *outFirst;
+    for (i = 0; i < n; i++)
+    {
+        next = (loc == SSF_LL_LOC_HEAD) ? item->next : item->prev;
+        item->next = (i + 1 < n) ? next : NULL;
+        item->prev = NULL;
+        item->ll = NULL;
+        item = next;
+    }
+
+    /* item is the first one left on the list */
+    if (loc == SSF_LL_LOC_HEAD)
+    {
+        ll->head = item;
+        if (item == NULL) ll->tail = NULL;
+        else item->prev = NULL;
+    }
+    else
+    {
+        ll->tail = item;
+        if (item == NULL) ll->head = NULL;
+        else item->next = NULL;
+    }
+    ll->items -= n;
+    return n;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /* Returns true if list empty, else false.                                                       */
 /* --------------------------------------------------------------------------------------------- */
@@ -80,6 +80,8 @@ void SSFLLDeInit(SSFLL_t *ll);
 bool SSFLLIsInited(SSFLL_t *ll);
 void SSFLLPutItem(SSFLL_t *ll, SSFLLItem_t *inItem, SSF_LL_LOC_t loc, SSFLLItem_t *locItem);
 bool SSFLLGetItem(SSFLL_t *ll, SSFLLItem_t **outItem, SSF_LL_LOC_t loc, SSFLLItem_t *locItem);
+void SSFLLPutChain(SSFLL_t *ll, SSFLLItem_t *first, uint32_t n, SSF_LL_LOC_t loc);
+uint32_t SSFLLGetChain(SSFLL_t *ll, SSFLLItem_t **outFirst, uint32_t n, SSF_LL_LOC_t loc);
 bool SSFLLIsEmpty(const SSFLL_t *ll);
 bool SSFLLIsFull(const SSFLL_t *ll);
 uint32_t SSFLLSize(const SSFLL_t *ll);
@@ -471,6 +471,88 @@ void SSFLLUnitTest(void)
         SSF_ASSERT(SSFLLIsEmpty(&_sllTest));
     }
 
+    /* Chains put and got at head and tail, as the same single item calls in order would */
+    {
+        static const uint8_t order[] = { 3, 2, 1, 0, 4, 5 };
+        SSFLLItem_t *first;
+        SSFLLItem_t *cur;
+        uint32_t i;
+
+        SSF_ASSERT_TEST(SSFLLPutChain(NULL, &_sllItems[0].item, 1, SSF_LL_LOC_HEAD));
+        SSF_ASSERT_TEST(SSFLLPutChain(&_sllTest, &_sllItems[0].item, 1, SSF_LL_LOC_ITEM));
+        SSF_ASSERT_TEST(SSFLLPutChain(&_sllTest, &_sllItems[0].item, SLL_TEST_MAX_SIZE + 1,
+                                      SSF_LL_LOC_HEAD));
+        SSF_ASSERT_TEST(SSFLLGetChain(NULL, &first, 1, SSF_LL_LOC_HEAD));
+        SSF_ASSERT_TEST(SSFLLGetChain(&_sllTest, NULL, 1, SSF_LL_LOC_HEAD));
+        SSF_ASSERT_TEST(SSFLLGetChain(&_sllTest, &first, 1, SSF_LL_LOC_ITEM));
+        SSF_ASSERT(SSFLLGetChain(&_sllTest, &first, 4, SSF_LL_LOC_TAIL) == 0);
+        SSF_ASSERT(first == NULL);
+        SSFLLPutChain(&_sllTest, NULL, 0, SSF_LL_LOC_HEAD);
+        SSF_ASSERT(SSFLLIsEmpty(&_sllTest));
+
+        /* 0 to 3 at head leaves 3 at head, then 4 and 5 at tail */
+        for (i = 0; i < 3u; i++) _sllItems[i].item.next = &_sllItems[i + 1].item;
+        SSFLLPutChain(&_sllTest, &_sllItems[0].item, 4, SSF_LL_LOC_HEAD);
+        SSF_ASSERT(SSFLLLen(&_sllTest) == 4u);
+        _sllItems[4].item.next = &_sllItems[5].item;
+        SSFLLPutChain(&_sllTest, &_sllItems[4].item, 2, SSF_LL_LOC_TAIL);
+        SSF_ASSERT(SSFLLLen(&_sllTest) == 6u);
+
+        /* An item already on a list or a chain shorter than n asserts, list unchanged */
+        SSF_ASSERT_TEST(SSFLLPutChain(&_sllTest, &_sllItems[0].item, 1, SSF_LL_LOC_HEAD));
+        _sllItems[6].item.next = NULL;
+        SSF_ASSERT_TEST(SSFLLPutChain(&_sllTest, &_sllItems[6].item, 2, SSF_LL_LOC_TAIL));
+        SSF_ASSERT(SSFLLLen(&_sllTest) == 6u);
+        SSF_ASSERT(_sllItems[6].item.ll == NULL);
+
+        cur = SSF_LL_HEAD(&_sllTest);
+        for (i = 0; i < sizeof(order); i++)
+        {
+            SSF_ASSERT(cur == &_sllItems[order[i]].item);
+            SSF_ASSERT(cur->ll == &_sllTest);
+            SSF_ASSERT(SSF_LL_PREV_ITEM(cur) ==
+                       ((i == 0) ? NULL : &_sllItems[order[i - 1]].item));
+            cur = SSF_LL_NEXT_ITEM(cur);
+        }
+        SSF_ASSERT(cur == NULL);
+        SSF_ASSERT(SSF_LL_TAIL(&_sllTest) == &_sllItems[5].item);
+
+        /* 5 then 4 from tail */
+        SSF_ASSERT(SSFLLGetChain(&_sllTest, &first, 2, SSF_LL_LOC_TAIL) == 2u);
+        SSF_ASSERT(first == &_sllItems[5].item);
+        SSF_ASSERT(first->next == &_sllItems[4].item);
+        SSF_ASSERT(first->next->next == NULL);
+        SSF_ASSERT((first->ll == NULL) && (first->next->ll == NULL));
+        SSF_ASSERT(SSF_LL_TAIL(&_sllTest) == &_sllItems[0].item);
+        SSF_ASSERT(SSF_LL_NEXT_ITEM(SSF_LL_TAIL(&_sllTest)) == NULL);
+        SSF_ASSERT(SSFLLLen(&_sllTest) == 4u);
+
+        /* Asking for more than remain from head gets 3, 2, 1, 0 */
+        SSF_ASSERT(SSFLLGetChain(&_sllTest, &first, 10, SSF_LL_LOC_HEAD) == 4u);
+        for (i = 0; i < 4u; i++)
+        {
+            SSF_ASSERT(first == &_sllItems[order[i]].item);
+            SSF_ASSERT((first->ll == NULL) && (first->prev == NULL));
+            first = first->next;
+        }
+        SSF_ASSERT(first == NULL);
+        SSF_ASSERT(SSFLLIsEmpty(&_sllTest));
+        SSF_ASSERT((SSF_LL_HEAD(&_sllTest) == NULL) && (SSF_LL_TAIL(&_sllTest) == NULL));
+
+        /* Chains got from head and put back at head keep their items usable singly */
+        SSFLLPutItem(&_sllTest, &_sllItems[0].item, SSF_LL_LOC_HEAD, NULL);
+        SSFLLPutItem(&_sllTest, &_sllItems[1].item, SSF_LL_LOC_HEAD, NULL);
+        SSF_ASSERT(SSFLLGetChain(&_sllTest, &first, 1, SSF_LL_LOC_HEAD) == 1u);
+        SSF_ASSERT((first == &_sllItems[1].item) && (first->next == NULL));
+        SSF_ASSERT(SSF_LL_PREV_ITEM(SSF_LL_HEAD(&_sllTest)) == NULL);
+        SSFLLPutChain(&_sllTest, first, 1, SSF_LL_LOC_TAIL);
+        SSF_ASSERT(SSF_LL_TAIL(&_sllTest) == &_sllItems[1].item);
+        SSF_ASSERT(SSFLLGetItem(&_sllTest, &cur, SSF_LL_LOC_HEAD, NULL));
+        SSF_ASSERT(SSFLLGetItem(&_sllTest, &cur, SSF_LL_LOC_HEAD, NULL));
+        SSF_ASSERT(cur == &_sllItems[1].item);
+        SSF_ASSERT(SSFLLIsEmpty(&_sllTest));
+    }
+
     SSFLLDeInit(&_sllTest);
 }
 #endif /* SSF_CONFIG_LL_UNIT_TEST */
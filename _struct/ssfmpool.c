@@ -42,113 +42,489 @@
 /* --------------------------------------------------------------------------------------------- */
 #define SSF_MPOOL_INIT_MAGIC (0x43130817ul)
 
+#define SSF_MPOOL_CANARY "\x12\x34\x56\xff"
+
+/* Flips the first canary byte of blocks SSFMPoolFreeN() has checked */
+#define SSF_MPOOL_MARK (0x80u)
+
+#if SSF_MPOOL_CONCURRENT == 1
+#define SSF_MPOOL_TOP_TAG (0x100000000ull)
+
+/* State word of a concurrent pool block, free blocks are zeroed at init */
+#define SSF_MPOOL_STATE_FREE (0ul)
+#define SSF_MPOOL_STATE_ALLOCATED (0x414c4f43ul)
+
+/* A thread's cache of free block indexes for one concurrent pool */
+typedef struct
+{
+    const SSFMPool_t *pool;
+    uint32_t len;
+    uint32_t idx[SSF_MPOOL_CONFIG_MAGAZINE_SIZE];
+} SSFMPoolMagazine_t;
+
+/* --------------------------------------------------------------------------------------------- */
+/* Module variables                                                                              */
+/* --------------------------------------------------------------------------------------------- */
+static SSF_THREAD_LOCAL SSFMPoolMagazine_t _ssfmpMagazines[SSF_MPOOL_CONFIG_MAGAZINES];
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns pointer to the free list link in the list item header of block idx.                   */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t *_SSFMPoolNext(const SSFMPool_t *pool, uint32_t idx)
+{
+    return (uint32_t *)(pool->first + (idx * pool->stride) - sizeof(SSFLLItem_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns pointer to the allocated state word in the unused ll field of block mem's header.     */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t *_SSFMPoolState(const uint8_t *mem)
+{
+    return (uint32_t *)&(((SSFLLItem_t *)mem - 1)->ll);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Marks block mem of a concurrent pool free, asserts if it was not allocated.                   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolRelease(const uint8_t *mem)
+{
+    /* Only one of racing frees of the same block can win */
+    SSF_REQUIRE(SSF_ATOMIC_CAS_U32(_SSFMPoolState(mem), SSF_MPOOL_STATE_ALLOCATED,
+                                   SSF_MPOOL_STATE_FREE));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Pushes the n blocks linked from first to last onto the free list.                             */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolPush(SSFMPool_t *pool, uint32_t first, uint32_t last, uint32_t n)
+{
+    uint64_t top;
+
+    /* Count before publishing so len never undercounts and underflows in a racing pop */
+    SSF_ATOMIC_ADD_U32(&(pool->len), n);
+    do
+    {
+        top = SSF_ATOMIC_LOAD_U64(&(pool->top));
+        SSF_ATOMIC_STORE_U32(_SSFMPoolNext(pool, last), (uint32_t)top);
+    } while (SSF_ATOMIC_CAS_U64(&(pool->top), top,
+                                ((top + SSF_MPOOL_TOP_TAG) & ~0xffffffffull) |
+                                (uint64_t)(first + 1)) == false);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Pops up to n blocks from the free list to idx in one step, returns number popped.             */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFMPoolPop(SSFMPool_t *pool, uint32_t *idx, uint32_t n)
+{
+    uint64_t top;
+    uint32_t next;
+    uint32_t i;
+
+    do
+    {
+        top = SSF_ATOMIC_LOAD_U64(&(pool->top));
+        next = (uint32_t)top;
+        for (i = 0; (i < n) && (next != 0); i++)
+        {
+            /* Links read here may be stale if another thread pops first, the tag fails the CAS */
+            idx[i] = next - 1;
+            next = SSF_ATOMIC_LOAD_U32(_SSFMPoolNext(pool, idx[i]));
+            SSF_ASSERT(next <= pool->blocks);
+        }
+        if (i == 0) return 0;
+    } while (SSF_ATOMIC_CAS_U64(&(pool->top), top,
+                                ((top + SSF_MPOOL_TOP_TAG) & ~0xffffffffull) | next) == false);
+    SSF_ATOMIC_ADD_U32(&(pool->len), 0 - i);
+    return i;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Pushes the n oldest blocks of a magazine onto the free list as one chain.                     */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolSpill(SSFMPool_t *pool, SSFMPoolMagazine_t *mag, uint32_t n)
+{
+    uint32_t i;
+
+    SSF_REQUIRE((n > 0) && (n <= mag->len));
+
+    for (i = 1; i < n; i++)
+    {
+        SSF_ATOMIC_STORE_U32(_SSFMPoolNext(pool, mag->idx[i - 1]), mag->idx[i] + 1);
+    }
+    _SSFMPoolPush(pool, mag->idx[0], mag->idx[n - 1], n);
+    mag->len -= n;
+    memmove(mag->idx, &(mag->idx[n]), mag->len * sizeof(uint32_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the calling thread's magazine for pool, NULL if none and isBind false or none free.   */
+/* --------------------------------------------------------------------------------------------- */
+static SSFMPoolMagazine_t *_SSFMPoolMagazine(const SSFMPool_t *pool, bool isBind)
+{
+    SSFMPoolMagazine_t *unused = NULL;
+    uint32_t i;
+
+    for (i = 0; i < SSF_MPOOL_CONFIG_MAGAZINES; i++)
+    {
+        if (_ssfmpMagazines[i].pool == pool) return &(_ssfmpMagazines[i]);
+        if ((unused == NULL) && (_ssfmpMagazines[i].len == 0)) unused = &(_ssfmpMagazines[i]);
+    }
+    if ((isBind == false) || (unused == NULL)) return NULL;
+
+    /* An empty magazine holds no blocks so may be taken over by another pool */
+    unused->pool = pool;
+    return unused;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns a block from the calling thread's magazine, refilled from the free list if empty.     */
+/* --------------------------------------------------------------------------------------------- */
+static uint8_t *_SSFMPoolConcurrentAlloc(SSFMPool_t *pool)
+{
+    SSFMPoolMagazine_t *mag;
+    uint32_t idx;
+
+    mag = _SSFMPoolMagazine(pool, true);
+    if (mag == NULL)
+    {
+        if (_SSFMPoolPop(pool, &idx, 1) == 0) return NULL;
+    }
+    else
+    {
+        if (mag->len == 0) mag->len = _SSFMPoolPop(pool, mag->idx,
+                                                   SSF_MPOOL_CONFIG_MAGAZINE_SIZE / 2);
+        if (mag->len == 0) return NULL;
+        mag->len--;
+        idx = mag->idx[mag->len];
+    }
+    return pool->first + (idx * pool->stride);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns block idx to the calling thread's magazine, spilling half to the free list if full.   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolConcurrentFree(SSFMPool_t *pool, uint32_t idx)
+{
+    SSFMPoolMagazine_t *mag;
+
+    mag = _SSFMPoolMagazine(pool, true);
+    if (mag == NULL)
+    {
+        _SSFMPoolPush(pool, idx, idx, 1);
+        return;
+    }
+    if (mag->len == SSF_MPOOL_CONFIG_MAGAZINE_SIZE)
+    {
+        _SSFMPoolSpill(pool, mag, SSF_MPOOL_CONFIG_MAGAZINE_SIZE / 2);
+    }
+    mag->idx[mag->len] = idx;
+    mag->len++;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Moves up to n blocks to mpools from the magazine, refilled a chain at a time; returns count.  */
+/* --------------------------------------------------------------------------------------------- */
+static uint32_t _SSFMPoolConcurrentAllocN(SSFMPool_t *pool, void **mpools, uint32_t n)
+{
+    SSFMPoolMagazine_t local;
+    SSFMPoolMagazine_t *mag;
+    uint32_t i;
+
+    /* Without a magazine pop into a local one, refills never take more than needed */
+    mag = _SSFMPoolMagazine(pool, true);
+    if (mag == NULL)
+    {
+        local.len = 0;
+        mag = &local;
+    }
+    for (i = 0; i < n; i++)
+    {
+        if (mag->len == 0)
+        {
+            mag->len = _SSFMPoolPop(pool, mag->idx, ((n - i) < SSF_MPOOL_CONFIG_MAGAZINE_SIZE) ?
+                                                    (n - i) : SSF_MPOOL_CONFIG_MAGAZINE_SIZE);
+            if (mag->len == 0) break;
+        }
+        mag->len--;
+        mpools[i] = pool->first + (mag->idx[mag->len] * pool->stride);
+    }
+    return i;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Tops up the magazine from mpools, pushes the rest onto the free list as one chain.            */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolConcurrentFreeN(SSFMPool_t *pool, void **mpools, uint32_t n)
+{
+    SSFMPoolMagazine_t *mag;
+    uint32_t i = 0;
+    uint32_t idx;
+    uint32_t first;
+    uint32_t last;
+    uint32_t count;
+
+    mag = _SSFMPoolMagazine(pool, true);
+    if (mag != NULL)
+    {
+        for (; (i < n) && (mag->len < SSF_MPOOL_CONFIG_MAGAZINE_SIZE); i++)
+        {
+            mag->idx[mag->len] = (uint32_t)((uint8_t *)mpools[i] - pool->first) / pool->stride;
+            mag->len++;
+        }
+    }
+    if (i == n) return;
+
+    first = (uint32_t)((uint8_t *)mpools[i] - pool->first) / pool->stride;
+    last = first;
+    count = n - i;
+    for (i++; i < n; i++)
+    {
+        idx = (uint32_t)((uint8_t *)mpools[i] - pool->first) / pool->stride;
+        SSF_ATOMIC_STORE_U32(_SSFMPoolNext(pool, last), idx + 1);
+        last = idx;
+    }
+    _SSFMPoolPush(pool, first, last, count);
+}
+#endif /* SSF_MPOOL_CONCURRENT */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Checks the canary of a block being allocated and records its owner.                           */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolTag(const SSFMPool_t *pool, uint8_t *mem, uint8_t owner)
+{
+    uint8_t *p;
+
+    p = mem + pool->blockSize;
+    SSF_ASSERT(memcmp(p, SSF_MPOOL_CANARY, sizeof(uint32_t) - 1) == 0);
+    p += sizeof(uint32_t) - 1;
+    *p = owner;
+#if SSF_MPOOL_CONCURRENT == 1
+    if (pool->isConcurrent)
+    {
+        SSF_ASSERT(SSF_ATOMIC_XCHG_U32(_SSFMPoolState(mem), SSF_MPOOL_STATE_ALLOCATED) ==
+                   SSF_MPOOL_STATE_FREE);
+    }
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Checks that mpool is a block of pool with an intact canary.                                   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolCheck(const SSFMPool_t *pool, const void *mpool)
+{
+    SSF_REQUIRE(mpool != NULL);
+    SSF_REQUIRE(((const uint8_t *)mpool >= pool->first) &&
+                ((const uint8_t *)mpool < (pool->first + (pool->blocks * pool->stride))));
 #if SSF_MPOOL_DEBUG == 1
-typedef struct SSFMPoolDebug
+    SSF_REQUIRE(((uint32_t)((const uint8_t *)mpool - pool->first) % pool->stride) == 0);
+#endif
+
+    SSF_ASSERT(memcmp(((const uint8_t *)mpool) + pool->blockSize, SSF_MPOOL_CANARY,
+                      sizeof(uint32_t) - 1) == 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns true if mpool is an allocated block of pool with an intact canary, else false.        */
+/* --------------------------------------------------------------------------------------------- */
+static bool _SSFMPoolIsAllocated(const SSFMPool_t *pool, const void *mpool)
 {
-    SSFLLItem_t item;
-    SSFLLItem_t *block;
-} SSFMPoolDebug_t;
+    if ((mpool == NULL) || ((const uint8_t *)mpool < pool->first) ||
+        ((const uint8_t *)mpool >= (pool->first + (pool->blocks * pool->stride)))) return false;
+#if SSF_MPOOL_DEBUG == 1
+    if ((((uint32_t)((const uint8_t *)mpool - pool->first)) % pool->stride) != 0) return false;
 #endif
+    if (memcmp(((const uint8_t *)mpool) + pool->blockSize, SSF_MPOOL_CANARY,
+               sizeof(uint32_t) - 1) != 0) return false;
+#if SSF_MPOOL_CONCURRENT == 1
+    if (pool->isConcurrent)
+    {
+        return SSF_ATOMIC_LOAD_U32(_SSFMPoolState((const uint8_t *)mpool)) ==
+               SSF_MPOOL_STATE_ALLOCATED;
+    }
+#endif
+    return ((const SSFLLItem_t *)mpool - 1)->ll == NULL;
+}
 
 /* --------------------------------------------------------------------------------------------- */
-/* Initializes a memory pool.                                                                    */
+/* Initializes a memory pool of align aligned blocks carved from slab, or one allocation if NULL. */
 /* --------------------------------------------------------------------------------------------- */
-void SSFMPoolInit(SSFMPool_t *pool, uint32_t blocks, uint32_t blockSize)
+static void _SSFMPoolInit(SSFMPool_t *pool, uint32_t blocks, uint32_t blockSize, uint32_t align,
+                          void *slab, uint32_t slabSize, bool isConcurrent)
 {
-    uint32_t memSize = blockSize + sizeof(SSFLLItem_t) + sizeof(uint32_t);
+    uint32_t stride;
     uint32_t i;
-#if SSF_MPOOL_DEBUG == 1
-    SSFMPoolDebug_t *w;
-#endif /* SSF_MPOOL_DEBUG */
+    uint8_t *mem;
 
     SSF_REQUIRE(pool != NULL);
     SSF_REQUIRE(blocks > 0);
     SSF_REQUIRE(blockSize > 0);
+    SSF_REQUIRE(align >= sizeof(void *));
+    SSF_REQUIRE((align & (align - 1)) == 0);
     SSF_ASSERT(pool->magic != SSF_MPOOL_INIT_MAGIC);
 
-    SSFLLInit(&(pool->avail), blocks);
-#if SSF_MPOOL_DEBUG == 1
-    SSFLLInit(&(pool->world), blocks);
-#endif /* SSF_MPOOL_DEBUG */
+    /* Reject sizes whose slab does not fit in 32 bits */
+    stride = SSF_MPOOL_BLOCK_STRIDE(blockSize, align);
+    SSF_REQUIRE(stride > blockSize);
+    SSF_REQUIRE(blocks <= ((0xfffffffful - align) / stride));
+    SSF_REQUIRE((slab == NULL) || (slabSize >= SSF_MPOOL_SLAB_SIZE(blocks, blockSize, align)));
 
-    for (i = 0; i < blocks; i++)
+    memset(pool, 0, sizeof(SSFMPool_t));
+    if (slab == NULL)
     {
-        SSFLLItem_t *mem;
-        SSF_ASSERT((mem = (SSFLLItem_t*)SSF_MALLOC(memSize)) != NULL);
-        memset(mem, 0, memSize);
-        memcpy(((uint8_t *)mem) + blockSize + sizeof(SSFLLItem_t), "\x12\x34\x56\xff", sizeof(uint32_t));
-        SSF_LL_FIFO_PUSH(&(pool->avail), mem);
-#if SSF_MPOOL_DEBUG == 1
-        SSF_ASSERT((w = (SSFMPoolDebug_t *)SSF_MALLOC(sizeof(SSFMPoolDebug_t))) != NULL);
-        memset(w, 0, sizeof(SSFMPoolDebug_t));
-        w->block = (SSFLLItem_t *)mem;
-        SSF_LL_FIFO_PUSH(&(pool->world), w);
-#endif /* SSF_MPOOL_DEBUG */
+        slabSize = SSF_MPOOL_SLAB_SIZE(blocks, blockSize, align);
+        SSF_ASSERT((slab = SSF_MALLOC(slabSize)) != NULL);
+        pool->isSlabOwned = true;
     }
+    memset(slab, 0, slabSize);
+    pool->slab = (uint8_t *)slab;
+    pool->slabSize = slabSize;
+
+    /* Blocks are aligned, their list item headers sit just before them */
+    pool->first = pool->slab + (((align - (((uintptr_t)pool->slab + sizeof(SSFLLItem_t)) &
+                                         (align - 1))) & (align - 1)) + sizeof(SSFLLItem_t));
+
+    pool->stride = stride;
     pool->blocks = blocks;
     pool->blockSize = blockSize;
+
+#if SSF_MPOOL_CONCURRENT == 1
+    if (isConcurrent)
+    {
+        /* Free list links are block indexes + 1 kept in the unused list item headers */
+        for (i = 0; i < blocks; i++)
+        {
+            mem = pool->first + (i * stride);
+            memcpy(mem + blockSize, SSF_MPOOL_CANARY, sizeof(uint32_t));
+            *_SSFMPoolNext(pool, i) = (i + 2 <= blocks) ? i + 2 : 0;
+        }
+        pool->top = 1;
+        pool->len = blocks;
+        pool->isConcurrent = true;
+        SSF_ATOMIC_FENCE();
+        pool->magic = SSF_MPOOL_INIT_MAGIC;
+        return;
+    }
+#else
+    SSF_REQUIRE(isConcurrent == false);
+#endif
+    SSFLLInit(&(pool->avail), blocks);
+    for (i = 0; i < blocks; i++)
+    {
+        mem = pool->first + (i * stride);
+        memcpy(mem + blockSize, SSF_MPOOL_CANARY, sizeof(uint32_t));
+        SSF_LL_FIFO_PUSH(&(pool->avail), (mem - sizeof(SSFLLItem_t)));
+    }
     pool->magic = SSF_MPOOL_INIT_MAGIC;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes a memory pool whose blocks are carved from one allocation.                        */
+/* --------------------------------------------------------------------------------------------- */
+void SSFMPoolInit(SSFMPool_t *pool, uint32_t blocks, uint32_t blockSize)
+{
+    _SSFMPoolInit(pool, blocks, blockSize, SSF_MPOOL_CONFIG_BLOCK_ALIGN, NULL, 0, false);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes a memory pool of align aligned blocks carved from slab, or one allocation if NULL. */
+/* --------------------------------------------------------------------------------------------- */
+void SSFMPoolInitSlab(SSFMPool_t *pool, uint32_t blocks, uint32_t blockSize, uint32_t align,
+                      void *slab, uint32_t slabSize)
+{
+    _SSFMPoolInit(pool, blocks, blockSize, align, slab, slabSize, false);
+}
+
+#if SSF_MPOOL_CONCURRENT == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes a pool like SSFMPoolInitSlab() that any thread may alloc from and free to.        */
+/* --------------------------------------------------------------------------------------------- */
+void SSFMPoolInitConcurrent(SSFMPool_t *pool, uint32_t blocks, uint32_t blockSize, uint32_t align,
+                            void *slab, uint32_t slabSize)
+{
+    _SSFMPoolInit(pool, blocks, blockSize, align, slab, slabSize, true);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns blocks cached by the calling thread to a concurrent pool's free list.                 */
+/* --------------------------------------------------------------------------------------------- */
+void SSFMPoolFlush(SSFMPool_t *pool)
+{
+    SSFMPoolMagazine_t *mag;
+
+    SSF_REQUIRE(pool != NULL);
+    SSF_REQUIRE(pool->magic == SSF_MPOOL_INIT_MAGIC);
+
+    if (pool->isConcurrent == false) return;
+    mag = _SSFMPoolMagazine(pool, false);
+    if (mag == NULL) return;
+    if (mag->len > 0) _SSFMPoolSpill(pool, mag, mag->len);
+    mag->pool = NULL;
+}
+#endif /* SSF_MPOOL_CONCURRENT */
+
 /* --------------------------------------------------------------------------------------------- */
 /* Deinitializes a memory pool.                                                                  */
 /* --------------------------------------------------------------------------------------------- */
 void SSFMPoolDeInit(SSFMPool_t *pool)
 {
-    uint32_t i;
-    uint32_t memSize;
+    SSFLLItem_t *mem;
 
     SSF_REQUIRE(pool != NULL);
     SSF_REQUIRE(pool->magic == SSF_MPOOL_INIT_MAGIC);
+#if SSF_MPOOL_CONCURRENT == 1
+    SSFMPoolFlush(pool);
+#endif
     SSF_REQUIRE(SSFMPoolIsFull(pool));
 
-    memSize = pool->blockSize + sizeof(SSFLLItem_t) + sizeof(uint32_t);
-    for (i = 0; i < pool->blocks; i++)
+#if SSF_MPOOL_CONCURRENT == 1
+    if (pool->isConcurrent == false)
+#endif
     {
-        SSFLLItem_t *mem = NULL;
-#if SSF_MPOOL_DEBUG == 1
-    SSFMPoolDebug_t *w = NULL;
-#endif /* SSF_MPOOL_DEBUG */
-
-        SSF_LL_FIFO_POP(&(pool->avail), &mem);
-        SSF_ASSERT(mem != NULL);
-        memset(mem, 0, memSize);
-        SSF_FREE(mem);
-#if SSF_MPOOL_DEBUG == 1
-        SSF_LL_FIFO_POP(&(pool->world), &w);
-        SSF_ASSERT(w != NULL);
-        memset(w, 0, sizeof(SSFMPoolDebug_t));
-        SSF_FREE(w);
-#endif /* SSF_MPOOL_DEBUG */
+        while (SSF_LL_FIFO_POP(&(pool->avail), &mem));
+        SSFLLDeInit(&(pool->avail));
     }
-
-#if SSF_MPOOL_DEBUG == 1
-    SSFLLDeInit(&(pool->world));
-#endif /* SSF_MPOOL_DEBUG */
-    SSFLLDeInit(&(pool->avail));
+    memset(pool->slab, 0, pool->slabSize);
+    if (pool->isSlabOwned) SSF_FREE(pool->slab);
     memset(pool, 0, sizeof(SSFMPool_t));
 }
 
 /* --------------------------------------------------------------------------------------------- */
-/* Allocates a block from the pool.                                                              */
+/* Allocates a block from the pool, returns NULL if the pool is empty.                           */
 /* --------------------------------------------------------------------------------------------- */
-void *SSFMPoolAlloc(SSFMPool_t *pool, uint32_t size, uint8_t owner)
+void *SSFMPoolTryAlloc(SSFMPool_t *pool, uint32_t size, uint8_t owner)
 {
-    SSFLLItem_t *mem;
-    uint8_t *p;
+    SSFLLItem_t *item;
+    uint8_t *mem;
 
     SSF_REQUIRE(pool != NULL);
-    SSF_REQUIRE(size <= pool->blockSize);
     SSF_REQUIRE(pool->magic == SSF_MPOOL_INIT_MAGIC);
+    SSF_REQUIRE(size <= pool->blockSize);
+
+#if SSF_MPOOL_CONCURRENT == 1
+    if (pool->isConcurrent)
+    {
+        if ((mem = _SSFMPoolConcurrentAlloc(pool)) == NULL) return NULL;
+    }
+    else
+#endif
+    {
+        if (SSF_LL_FIFO_POP(&(pool->avail), &item) == false) return NULL;
+        mem = ((uint8_t *)item) + sizeof(SSFLLItem_t);
+    }
 
-    SSF_ASSERT(SSF_LL_FIFO_POP(&(pool->avail), &mem) == true);
+    _SSFMPoolTag(pool, mem, owner);
+    return (void *)mem;
+}
 
-    p = ((uint8_t *)mem) + sizeof(SSFLLItem_t) + pool->blockSize;
-    SSF_ASSERT(memcmp(p, "\x12\x34\x56", sizeof(uint32_t) - 1) == 0);
-    p += sizeof(uint32_t) - 1;
-    *p = owner;
+/* --------------------------------------------------------------------------------------------- */
+/* Allocates a block from the pool.                                                              */
+/* --------------------------------------------------------------------------------------------- */
+void *SSFMPoolAlloc(SSFMPool_t *pool, uint32_t size, uint8_t owner)
+{
+    void *mem;
 
-    return (void *)(((uint8_t *)mem) + sizeof(SSFLLItem_t));
+    SSF_ASSERT((mem = SSFMPoolTryAlloc(pool, size, owner)) != NULL);
+    return mem;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -157,15 +533,106 @@ void *SSFMPoolAlloc(SSFMPool_t *pool, uint32_t size, uint8_t owner)
 void *SSFMPoolFree(SSFMPool_t *pool, void *mpool)
 {
     SSF_REQUIRE(pool != NULL);
-    SSF_REQUIRE(mpool != NULL);
     SSF_REQUIRE(pool->magic == SSF_MPOOL_INIT_MAGIC);
+    _SSFMPoolCheck(pool, mpool);
 
-    SSF_ASSERT(memcmp(((uint8_t *)mpool) + pool->blockSize, "\x12\x34\x56",
-                      sizeof(uint32_t) - 1) == 0);
+#if SSF_MPOOL_CONCURRENT == 1
+    if (pool->isConcurrent)
+    {
+        _SSFMPoolRelease((uint8_t *)mpool);
+        _SSFMPoolConcurrentFree(pool, (uint32_t)((uint8_t *)mpool - pool->first) / pool->stride);
+        return NULL;
+    }
+#endif
     SSF_LL_FIFO_PUSH(&(pool->avail), ((SSFLLItem_t *) mpool) - 1);
     return NULL;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/* Allocates up to n blocks to mpools in one operation, returns number allocated.                */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFMPoolAllocN(SSFMPool_t *pool, uint32_t size, uint8_t owner, void **mpools,
+                        uint32_t n)
+{
+    SSFLLItem_t *item;
+    SSFLLItem_t *next;
+    uint32_t i;
+
+    SSF_REQUIRE(pool != NULL);
+    SSF_REQUIRE(pool->magic == SSF_MPOOL_INIT_MAGIC);
+    SSF_REQUIRE(size <= pool->blockSize);
+    SSF_REQUIRE(mpools != NULL);
+
+#if SSF_MPOOL_CONCURRENT == 1
+    if (pool->isConcurrent)
+    {
+        n = _SSFMPoolConcurrentAllocN(pool, mpools, n);
+    }
+    else
+#endif
+    {
+        /* The n oldest blocks, in the order n SSF_LL_FIFO_POP() calls would return them */
+        n = SSFLLGetChain(&(pool->avail), &item, n, SSF_LL_LOC_TAIL);
+        for (i = 0; i < n; i++)
+        {
+            mpools[i] = item + 1;
+            next = item->next;
+            item->next = NULL;
+            item = next;
+        }
+    }
+
+    for (i = 0; i < n; i++) _SSFMPoolTag(pool, (uint8_t *)mpools[i], owner);
+    return n;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns n blocks to the pool in one operation, sets each mpools entry to NULL.                */
+/* --------------------------------------------------------------------------------------------- */
+void SSFMPoolFreeN(SSFMPool_t *pool, void **mpools, uint32_t n)
+{
+    uint32_t i;
+    uint32_t j;
+
+    SSF_REQUIRE(pool != NULL);
+    SSF_REQUIRE(pool->magic == SSF_MPOOL_INIT_MAGIC);
+    SSF_REQUIRE(mpools != NULL);
+
+    /* Check every block before moving any, marking each checked one so a repeat fails too */
+    for (i = 0; i < n; i++)
+    {
+        if (_SSFMPoolIsAllocated(pool, mpools[i]) == false) break;
+        ((uint8_t *)mpools[i])[pool->blockSize] ^= SSF_MPOOL_MARK;
+    }
+    for (j = 0; j < i; j++) ((uint8_t *)mpools[j])[pool->blockSize] ^= SSF_MPOOL_MARK;
+    if (i < n)
+    {
+        /* Assert for a bad pointer or canary, else mpools[i] is already free or repeated */
+        _SSFMPoolCheck(pool, mpools[i]);
+        SSF_ERROR();
+    }
+
+#if SSF_MPOOL_CONCURRENT == 1
+    if (pool->isConcurrent)
+    {
+        for (i = 0; i < n; i++) _SSFMPoolRelease((uint8_t *)mpools[i]);
+        _SSFMPoolConcurrentFreeN(pool, mpools, n);
+    }
+    else
+#endif
+    if (n > 0)
+    {
+        /* Chain the blocks in order, avail takes them as n SSF_LL_FIFO_PUSH() calls would */
+        for (i = 0; (i + 1) < n; i++)
+        {
+            ((SSFLLItem_t *)mpools[i] - 1)->next = (SSFLLItem_t *)mpools[i + 1] - 1;
+        }
+        SSFLLPutChain(&(pool->avail), (SSFLLItem_t *)mpools[0] - 1, n, SSF_LL_LOC_HEAD);
+    }
+
+    for (i = 0; i < n; i++) mpools[i] = NULL;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /* Returns pool block size.                                                                      */
 /* --------------------------------------------------------------------------------------------- */
@@ -196,6 +663,14 @@ uint32_t SSFMPoolLen(const SSFMPool_t *pool)
     SSF_REQUIRE(pool != NULL);
     SSF_REQUIRE(pool->magic == SSF_MPOOL_INIT_MAGIC);
 
+#if SSF_MPOOL_CONCURRENT == 1
+    if (pool->isConcurrent)
+    {
+        const SSFMPoolMagazine_t *mag = _SSFMPoolMagazine(pool, false);
+
+        return SSF_ATOMIC_LOAD_U32(&(pool->len)) + ((mag == NULL) ? 0 : mag->len);
+    }
+#endif
     return SSFLLLen(&(pool->avail));
 }
 
@@ -207,6 +682,9 @@ bool SSFMPoolIsEmpty(const SSFMPool_t *pool)
     SSF_REQUIRE(pool != NULL);
     SSF_REQUIRE(pool->magic == SSF_MPOOL_INIT_MAGIC);
 
+#if SSF_MPOOL_CONCURRENT == 1
+    if (pool->isConcurrent) return SSFMPoolLen(pool) == 0;
+#endif
     return SSFLLIsEmpty(&(pool->avail));
 }
 
@@ -218,5 +696,8 @@ bool SSFMPoolIsFull(const SSFMPool_t *pool)
     SSF_REQUIRE(pool != NULL);
     SSF_REQUIRE(pool->magic == SSF_MPOOL_INIT_MAGIC);
 
+#if SSF_MPOOL_CONCURRENT == 1
+    if (pool->isConcurrent) return SSFMPoolLen(pool) == pool->blocks;
+#endif
     return SSFLLIsFull(&(pool->avail));
 }
@@ -43,14 +43,43 @@ extern "C" {
 /* --------------------------------------------------------------------------------------------- */
 /* Defines and typedefs                                                                          */
 /* --------------------------------------------------------------------------------------------- */
+#if (SSF_MPOOL_CONFIG_BLOCK_ALIGN & (SSF_MPOOL_CONFIG_BLOCK_ALIGN - 1)) != 0
+#error SSF_MPOOL_CONFIG_BLOCK_ALIGN must be a power of 2
+#endif
+
+#if (SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1) && (SSF_MPOOL_CONFIG_ENABLE_CONCURRENT == 1)
+#define SSF_MPOOL_CONCURRENT (1u)
+#if (SSF_MPOOL_CONFIG_MAGAZINE_SIZE < 2) || (SSF_MPOOL_CONFIG_MAGAZINES < 1)
+#error SSF_MPOOL_CONFIG_MAGAZINE_SIZE must be >= 2 and SSF_MPOOL_CONFIG_MAGAZINES >= 1
+#endif
+#else
+#define SSF_MPOOL_CONCURRENT (0u)
+#endif
+
+/* Bytes from one block to the next; a list item header, the block, then a 4 byte canary */
+#define SSF_MPOOL_BLOCK_STRIDE(blockSize, align) \
+    ((((uint32_t)sizeof(SSFLLItem_t) + (uint32_t)(blockSize) + 4ul) + (uint32_t)(align) - 1ul) & \
+     ~((uint32_t)(align) - 1ul))
+
+/* Minimum slabSize for SSFMPoolInitSlab(), includes slack to align the first block */
+#define SSF_MPOOL_SLAB_SIZE(blocks, blockSize, align) \
+    (((uint32_t)(blocks) * SSF_MPOOL_BLOCK_STRIDE(blockSize, align)) + (uint32_t)(align))
+
 typedef struct SSFMPool
 {
     SSFLL_t avail;
-#if SSF_MPOOL_DEBUG == 1
-    SSFLL_t world;
-#endif
+    uint8_t *slab;        /* Memory all blocks are carved from */
+    uint8_t *first;       /* First block, after its list item header */
+    uint32_t slabSize;
+    uint32_t stride;
     uint32_t blocks;
     uint32_t blockSize;
+    bool isSlabOwned;     /* true if slab was allocated by the pool */
+#if SSF_MPOOL_CONCURRENT == 1
+    bool isConcurrent;    /* true if initialized by SSFMPoolInitConcurrent() */
+    uint64_t top;         /* Free list top block index + 1 in low 32 bits, ABA tag in high 32 */
+    uint32_t len;         /* Blocks on the free list, not counting thread magazines */
+#endif
     uint32_t magic;
 } SSFMPool_t;
 
@@ -58,9 +87,20 @@ typedef struct SSFMPool
 /* External interface                                                                            */
 /* --------------------------------------------------------------------------------------------- */
 void SSFMPoolInit(SSFMPool_t *pool, uint32_t blocks, uint32_t blockSize);
+void SSFMPoolInitSlab(SSFMPool_t *pool, uint32_t blocks, uint32_t blockSize, uint32_t align,
+                      void *slab, uint32_t slabSize);
+#if SSF_MPOOL_CONCURRENT == 1
+void SSFMPoolInitConcurrent(SSFMPool_t *pool, uint32_t blocks, uint32_t blockSize, uint32_t align,
+                            void *slab, uint32_t slabSize);
+void SSFMPoolFlush(SSFMPool_t *pool);
+#endif
 void SSFMPoolDeInit(SSFMPool_t *pool);
 void *SSFMPoolAlloc(SSFMPool_t *pool, uint32_t size, uint8_t owner);
+void *SSFMPoolTryAlloc(SSFMPool_t *pool, uint32_t size, uint8_t owner);
 void *SSFMPoolFree(SSFMPool_t *pool, void *mpool);
+uint32_t SSFMPoolAllocN(SSFMPool_t *pool, uint32_t size, uint8_t owner, void **mpools,
+                        uint32_t n);
+void SSFMPoolFreeN(SSFMPool_t *pool, void **mpools, uint32_t n);
 uint32_t SSFMPoolBlockSize(const SSFMPool_t *pool);
 uint32_t SSFMPoolSize(const SSFMPool_t *pool);
 uint32_t SSFMPoolLen(const SSFMPool_t *pool);
@@ -32,18 +32,695 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "ssfmpool.h"
 #include "ssfport.h"
 #include "ssfassert.h"
+#if (SSF_MPOOL_CONCURRENT == 1) && !defined(_WIN32)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #if SSF_CONFIG_MPOOL_UNIT_TEST == 1
 
     #define SMP_TEST_BLOCK_SIZE (42UL)
     #define SMP_TEST_BLOCKS (10UL)
 
+    #define SMP_TEST_ALIGN (64UL)
+
 SSFMPool_t smpTestPool;
 void *smpTestPtrs[SMP_TEST_BLOCKS];
 void *testPtr;
+uint8_t smpTestSlab[SSF_MPOOL_SLAB_SIZE(SMP_TEST_BLOCKS, SMP_TEST_BLOCK_SIZE, SMP_TEST_ALIGN) + 1];
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    #define SMP_BENCH_BLOCKS (16384UL)
+    #define SMP_BENCH_BLOCK_SIZE (48UL)
+    #define SMP_BENCH_ROUNDS (200UL)
+static SSFLL_t _smpScatter;
+static void *_smpBenchPtrs[SMP_BENCH_BLOCKS];
+static void *_smpBenchNoise[SMP_BENCH_BLOCKS];
+static uint32_t _smpBenchOrder[SMP_BENCH_BLOCKS];
+
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes the per block malloc pool SSFMPool used to be, with other allocations between.   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolUTScatterInit(uint32_t blocks, uint32_t blockSize, bool isNoisy)
+{
+    uint32_t memSize = blockSize + sizeof(SSFLLItem_t) + sizeof(uint32_t);
+    SSFLLItem_t *mem;
+    uint32_t i;
+
+    SSFLLInit(&_smpScatter, blocks);
+    for (i = 0; i < blocks; i++)
+    {
+        SSF_ASSERT((mem = (SSFLLItem_t *)SSF_MALLOC(memSize)) != NULL);
+        memset(mem, 0, memSize);
+        memcpy(((uint8_t *)mem) + blockSize + sizeof(SSFLLItem_t), "\x12\x34\x56\xff",
+               sizeof(uint32_t));
+        SSF_LL_FIFO_PUSH(&_smpScatter, mem);
+        if (isNoisy)
+        {
+            _smpBenchNoise[i] = SSF_MALLOC(((uint32_t)(i * 2654435761ul) >> 23) + 16u);
+            SSF_ASSERT(_smpBenchNoise[i] != NULL);
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Deinitializes the per block malloc pool.                                                      */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolUTScatterDeInit(uint32_t blocks, bool isNoisy)
+{
+    SSFLLItem_t *mem;
+    uint32_t i;
+
+    for (i = 0; i < blocks; i++)
+    {
+        SSF_ASSERT(SSF_LL_FIFO_POP(&_smpScatter, &mem));
+        SSF_FREE(mem);
+        if (isNoisy) SSF_FREE(_smpBenchNoise[i]);
+    }
+    SSFLLDeInit(&_smpScatter);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Allocates a block from the per block malloc pool.                                             */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFMPoolUTScatterAlloc(uint32_t blockSize, uint8_t owner)
+{
+    SSFLLItem_t *mem;
+    uint8_t *p;
+
+    SSF_ASSERT(SSF_LL_FIFO_POP(&_smpScatter, &mem) == true);
+    p = ((uint8_t *)mem) + sizeof(SSFLLItem_t) + blockSize;
+    SSF_ASSERT(memcmp(p, "\x12\x34\x56", sizeof(uint32_t) - 1) == 0);
+    p[sizeof(uint32_t) - 1] = owner;
+    return (void *)(((uint8_t *)mem) + sizeof(SSFLLItem_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Frees a block to the per block malloc pool.                                                   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolUTScatterFree(void *mpool, uint32_t blockSize)
+{
+    SSF_ASSERT(memcmp(((uint8_t *)mpool) + blockSize, "\x12\x34\x56", sizeof(uint32_t) - 1) == 0);
+    SSF_LL_FIFO_PUSH(&_smpScatter, ((SSFLLItem_t *)mpool) - 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns ns/op of rounds that allocate and fill every block then free them in shuffled order. */
+/* --------------------------------------------------------------------------------------------- */
+static uint64_t _SSFMPoolUTBenchCycle(SSFMPool_t *pool)
+{
+    uint64_t start;
+    uint32_t round;
+    uint32_t i;
+
+    start = SSFPortGetHRTick64();
+    for (round = 0; round < SMP_BENCH_ROUNDS; round++)
+    {
+        for (i = 0; i < SMP_BENCH_BLOCKS; i++)
+        {
+            if (pool != NULL)
+            {
+                _smpBenchPtrs[i] = SSFMPoolAlloc(pool, SMP_BENCH_BLOCK_SIZE, (uint8_t)i);
+            }
+            else _smpBenchPtrs[i] = _SSFMPoolUTScatterAlloc(SMP_BENCH_BLOCK_SIZE, (uint8_t)i);
+            memset(_smpBenchPtrs[i], (int)round, SMP_BENCH_BLOCK_SIZE);
+        }
+        for (i = 0; i < SMP_BENCH_BLOCKS; i++)
+        {
+            if (pool != NULL) SSFMPoolFree(pool, _smpBenchPtrs[_smpBenchOrder[i]]);
+            else _SSFMPoolUTScatterFree(_smpBenchPtrs[_smpBenchOrder[i]], SMP_BENCH_BLOCK_SIZE);
+        }
+    }
+    return ((SSFPortGetHRTick64() - start) * (1000000000ull / SSF_HR_TICKS_PER_SEC)) /
+           (SMP_BENCH_ROUNDS * SMP_BENCH_BLOCKS);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Prints init time and alloc/fill/free cost of slab backed pools and per block malloc pools.   */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolUTBench(void)
+{
+    uint64_t start;
+    uint64_t initNs;
+    uint64_t opNs;
+    uint32_t seed = 1;
+    uint32_t i;
+    uint32_t j;
+    uint32_t t;
+
+    for (i = 0; i < SMP_BENCH_BLOCKS; i++) _smpBenchOrder[i] = i;
+    for (i = SMP_BENCH_BLOCKS - 1u; i > 0; i--)
+    {
+        seed = (seed * 1103515245ul) + 12345ul;
+        j = (seed >> 8) % (i + 1u);
+        t = _smpBenchOrder[i];
+        _smpBenchOrder[i] = _smpBenchOrder[j];
+        _smpBenchOrder[j] = t;
+    }
+
+    for (i = 0; i < 2u; i++)
+    {
+        start = SSFPortGetHRTick64();
+        SSFMPoolInitSlab(&smpTestPool, SMP_BENCH_BLOCKS, SMP_BENCH_BLOCK_SIZE,
+                         (i == 0) ? SSF_MPOOL_CONFIG_BLOCK_ALIGN : SMP_TEST_ALIGN, NULL, 0);
+        initNs = (SSFPortGetHRTick64() - start) * (1000000000ull / SSF_HR_TICKS_PER_SEC);
+        opNs = _SSFMPoolUTBenchCycle(&smpTestPool);
+        SSFMPoolDeInit(&smpTestPool);
+        printf("\r\n  Slab pool, %lu blocks of %lu aligned to %lu: init %lluus, %llu ns/op\r\n",
+               SMP_BENCH_BLOCKS, SMP_BENCH_BLOCK_SIZE,
+               (i == 0) ? (unsigned long)SSF_MPOOL_CONFIG_BLOCK_ALIGN : SMP_TEST_ALIGN,
+               (unsigned long long)(initNs / 1000u), (unsigned long long)opNs);
+    }
+
+    for (i = 0; i < 2u; i++)
+    {
+        start = SSFPortGetHRTick64();
+        _SSFMPoolUTScatterInit(SMP_BENCH_BLOCKS, SMP_BENCH_BLOCK_SIZE, i == 1u);
+        initNs = (SSFPortGetHRTick64() - start) * (1000000000ull / SSF_HR_TICKS_PER_SEC);
+        opNs = _SSFMPoolUTBenchCycle(NULL);
+        _SSFMPoolUTScatterDeInit(SMP_BENCH_BLOCKS, i == 1u);
+        printf("\r\n  Per block malloc pool, %lu blocks of %lu%s: init %lluus, %llu ns/op\r\n",
+               SMP_BENCH_BLOCKS, SMP_BENCH_BLOCK_SIZE,
+               (i == 1u) ? " between other allocations" : "",
+               (unsigned long long)(initNs / 1000u), (unsigned long long)opNs);
+    }
+}
+#endif /* SSF_CONFIG_UNIT_TEST_BENCHMARK */
+
+#if SSF_MPOOL_CONCURRENT == 1
+    #define SMP_TEST_POOLS (SSF_MPOOL_CONFIG_MAGAZINES + 1u)
+    #define SMP_TEST_MAG_BLOCKS (SSF_MPOOL_CONFIG_MAGAZINE_SIZE * 4u)
+
+static SSFMPool_t _smpPools[SMP_TEST_POOLS];
+static void *_smpPoolPtrs[SMP_TEST_POOLS];
+static void *_smpMagPtrs[SMP_TEST_MAG_BLOCKS];
+
+/* --------------------------------------------------------------------------------------------- */
+/* Unit tests a concurrent pool from one thread, including blocks cached in its magazines.      */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolUTConcurrent(void)
+{
+    uint32_t i;
+    uint32_t j;
+
+    SSF_ASSERT_TEST(SSFMPoolInitConcurrent(NULL, SMP_TEST_BLOCKS, SMP_TEST_BLOCK_SIZE,
+                                           SMP_TEST_ALIGN, NULL, 0));
+    SSF_ASSERT_TEST(SSFMPoolInitConcurrent(&smpTestPool, 0, SMP_TEST_BLOCK_SIZE, SMP_TEST_ALIGN,
+                                           NULL, 0));
+    SSF_ASSERT_TEST(SSFMPoolInitConcurrent(&smpTestPool, SMP_TEST_BLOCKS, SMP_TEST_BLOCK_SIZE,
+                                           SMP_TEST_ALIGN, smpTestSlab, 1u));
+    SSF_ASSERT_TEST(SSFMPoolFlush(NULL));
+    SSF_ASSERT_TEST(SSFMPoolFlush(&smpTestPool));
+    SSF_ASSERT_TEST(SSFMPoolTryAlloc(&smpTestPool, SMP_TEST_BLOCK_SIZE, 0));
+
+    /* Alloc and free every block, blocks cached by this thread still count as available */
+    SSFMPoolInitConcurrent(&smpTestPool, SMP_TEST_BLOCKS, SMP_TEST_BLOCK_SIZE, SMP_TEST_ALIGN,
+                           &smpTestSlab[1], sizeof(smpTestSlab) - 1u);
+    SSF_ASSERT_TEST(SSFMPoolInitConcurrent(&smpTestPool, SMP_TEST_BLOCKS, SMP_TEST_BLOCK_SIZE,
+                                           SMP_TEST_ALIGN, smpTestSlab, sizeof(smpTestSlab)));
+    SSF_ASSERT(SSFMPoolSize(&smpTestPool) == SMP_TEST_BLOCKS);
+    SSF_ASSERT(SSFMPoolBlockSize(&smpTestPool) == SMP_TEST_BLOCK_SIZE);
+    SSF_ASSERT(SSFMPoolLen(&smpTestPool) == SMP_TEST_BLOCKS);
+    SSF_ASSERT(SSFMPoolIsFull(&smpTestPool));
+    SSF_ASSERT_TEST(SSFMPoolTryAlloc(NULL, SMP_TEST_BLOCK_SIZE, 0));
+    SSF_ASSERT_TEST(SSFMPoolTryAlloc(&smpTestPool, SMP_TEST_BLOCK_SIZE + 1, 0));
+    for (i = 0; i < SMP_TEST_BLOCKS; i++)
+    {
+        smpTestPtrs[i] = SSFMPoolTryAlloc(&smpTestPool, SMP_TEST_BLOCK_SIZE, (uint8_t)i);
+        SSF_ASSERT(smpTestPtrs[i] != NULL);
+        SSF_ASSERT((((uintptr_t)smpTestPtrs[i]) & (SMP_TEST_ALIGN - 1)) == 0);
+        SSF_ASSERT((uint8_t *)smpTestPtrs[i] > &smpTestSlab[1]);
+        SSF_ASSERT(((uint8_t *)smpTestPtrs[i] + SMP_TEST_BLOCK_SIZE + sizeof(uint32_t)) <=
+                   &smpTestSlab[sizeof(smpTestSlab)]);
+        for (j = 0; j < i; j++) SSF_ASSERT(smpTestPtrs[j] != smpTestPtrs[i]);
+        memset(smpTestPtrs[i], (int)i, SMP_TEST_BLOCK_SIZE);
+        SSF_ASSERT(SSFMPoolLen(&smpTestPool) == SMP_TEST_BLOCKS - (i + 1));
+        SSF_ASSERT(SSFMPoolIsFull(&smpTestPool) == false);
+    }
+    SSF_ASSERT(SSFMPoolIsEmpty(&smpTestPool));
+    SSF_ASSERT(SSFMPoolTryAlloc(&smpTestPool, SMP_TEST_BLOCK_SIZE, 0) == NULL);
+    SSF_ASSERT_TEST(SSFMPoolAlloc(&smpTestPool, SMP_TEST_BLOCK_SIZE, 0));
+    SSF_ASSERT_TEST(SSFMPoolFree(&smpTestPool, &smpTestSlab[1]));
+    for (i = 0; i < SMP_TEST_BLOCKS; i++)
+    {
+        SSF_ASSERT(((uint8_t *)smpTestPtrs[i])[SMP_TEST_BLOCK_SIZE - 1] == (uint8_t)i);
+        smpTestPtrs[i] = SSFMPoolFree(&smpTestPool, smpTestPtrs[i]);
+        SSF_ASSERT(smpTestPtrs[i] == NULL);
+        SSF_ASSERT(SSFMPoolLen(&smpTestPool) == (i + 1));
+    }
+    SSF_ASSERT(SSFMPoolIsFull(&smpTestPool));
+    SSFMPoolFlush(&smpTestPool);
+    SSF_ASSERT(SSFMPoolLen(&smpTestPool) == SMP_TEST_BLOCKS);
+
+    /* Canary overrun detected, DeInit with a block allocated asserts */
+    testPtr = SSFMPoolAlloc(&smpTestPool, SMP_TEST_BLOCK_SIZE, 0);
+    ((uint8_t *)testPtr)[SMP_TEST_BLOCK_SIZE] ^= 0xff;
+    SSF_ASSERT_TEST(SSFMPoolFree(&smpTestPool, testPtr));
+    ((uint8_t *)testPtr)[SMP_TEST_BLOCK_SIZE] ^= 0xff;
+    SSF_ASSERT_TEST(SSFMPoolDeInit(&smpTestPool));
+    i = SSFMPoolLen(&smpTestPool);
+    SSFMPoolFree(&smpTestPool, testPtr);
+    SSF_ASSERT_TEST(SSFMPoolFree(&smpTestPool, testPtr));
+    SSF_ASSERT(SSFMPoolLen(&smpTestPool) == (i + 1));
+    testPtr = NULL;
+    SSFMPoolDeInit(&smpTestPool);
+    SSF_ASSERT_TEST(SSFMPoolDeInit(&smpTestPool));
+    for (i = 1; i < sizeof(smpTestSlab); i++) SSF_ASSERT(smpTestSlab[i] == 0);
+
+    /* Full magazines spill half to the free list and empty ones refill from it */
+    SSFMPoolInitConcurrent(&smpTestPool, SMP_TEST_MAG_BLOCKS, SMP_TEST_BLOCK_SIZE,
+                           SSF_MPOOL_CONFIG_BLOCK_ALIGN, NULL, 0);
+    for (j = 0; j < 3u; j++)
+    {
+        for (i = 0; i < SMP_TEST_MAG_BLOCKS; i++)
+        {
+            _smpMagPtrs[i] = SSFMPoolAlloc(&smpTestPool, SMP_TEST_BLOCK_SIZE, (uint8_t)i);
+            memset(_smpMagPtrs[i], (int)i, SMP_TEST_BLOCK_SIZE);
+        }
+        SSF_ASSERT(SSFMPoolIsEmpty(&smpTestPool));
+        for (i = 0; i < SMP_TEST_MAG_BLOCKS; i++)
+        {
+            SSF_ASSERT(((uint8_t *)_smpMagPtrs[(i * 7u) % SMP_TEST_MAG_BLOCKS])[0] ==
+                       (uint8_t)((i * 7u) % SMP_TEST_MAG_BLOCKS));
+            SSFMPoolFree(&smpTestPool, _smpMagPtrs[(i * 7u) % SMP_TEST_MAG_BLOCKS]);
+            SSF_ASSERT(SSFMPoolLen(&smpTestPool) == (i + 1));
+        }
+        SSF_ASSERT(SSFMPoolIsFull(&smpTestPool));
+    }
+    SSFMPoolDeInit(&smpTestPool);
+
+    /* Pools beyond the per thread magazines go straight to the free list */
+    for (i = 0; i < SMP_TEST_POOLS; i++)
+    {
+        SSFMPoolInitConcurrent(&_smpPools[i], 4u, SMP_TEST_BLOCK_SIZE,
+                               SSF_MPOOL_CONFIG_BLOCK_ALIGN, NULL, 0);
+        _smpPoolPtrs[i] = SSFMPoolAlloc(&_smpPools[i], SMP_TEST_BLOCK_SIZE, (uint8_t)i);
+        SSF_ASSERT(SSFMPoolLen(&_smpPools[i]) == 3u);
+    }
+    for (i = 0; i < SMP_TEST_POOLS; i++)
+    {
+        SSFMPoolFree(&_smpPools[i], _smpPoolPtrs[i]);
+        SSF_ASSERT(SSFMPoolIsFull(&_smpPools[i]));
+    }
+    for (i = 0; i < SMP_TEST_POOLS; i++) SSFMPoolDeInit(&_smpPools[i]);
+
+    /* A plain pool's TryAlloc returns NULL when empty and Flush does nothing */
+    SSFMPoolInit(&smpTestPool, 1u, SMP_TEST_BLOCK_SIZE);
+    testPtr = SSFMPoolTryAlloc(&smpTestPool, SMP_TEST_BLOCK_SIZE, 0);
+    SSF_ASSERT(testPtr != NULL);
+    SSF_ASSERT(SSFMPoolTryAlloc(&smpTestPool, SMP_TEST_BLOCK_SIZE, 0) == NULL);
+    SSFMPoolFlush(&smpTestPool);
+    SSF_ASSERT(SSFMPoolIsEmpty(&smpTestPool));
+    testPtr = SSFMPoolFree(&smpTestPool, testPtr);
+    SSFMPoolDeInit(&smpTestPool);
+}
+
+#if !defined(_WIN32)
+    #define SMP_TEST_THREADS (4u)
+    #define SMP_TEST_THREAD_HOLD (8u)
+    #define SMP_TEST_THREAD_ROUNDS (20000u)
+    #define SMP_TEST_THREAD_BLOCKS \
+        (SMP_TEST_THREADS * (SMP_TEST_THREAD_HOLD + SSF_MPOOL_CONFIG_MAGAZINE_SIZE + 1u))
+
+static void *_smpXchg[SMP_TEST_THREADS];
+
+/* --------------------------------------------------------------------------------------------- */
+/* Asserts that a block is still filled with the one value its last owner wrote.                 */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolUTCheckBlock(const uint8_t *block)
+{
+    uint32_t i;
+
+    for (i = 1; i < SMP_TEST_BLOCK_SIZE; i++) SSF_ASSERT(block[i] == block[0]);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Allocs, fills and frees blocks, handing some to other threads to free through _smpXchg.      */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFMPoolUTThread(void *arg)
+{
+    void *held[SMP_TEST_THREAD_HOLD];
+    uint8_t *other;
+    uint32_t id = (uint32_t)(uintptr_t)arg;
+    uint32_t seed = id + 1u;
+    uint32_t round;
+    uint32_t n;
+    uint32_t i;
+
+    for (round = 0; round < SMP_TEST_THREAD_ROUNDS; round++)
+    {
+        /* Odd rounds move their blocks as one chain */
+        seed = (seed * 1103515245ul) + 12345ul;
+        n = ((seed >> 16) % SMP_TEST_THREAD_HOLD) + 1u;
+        if ((round & 1u) != 0)
+        {
+            SSF_ASSERT(SSFMPoolAllocN(&smpTestPool, SMP_TEST_BLOCK_SIZE, (uint8_t)id, held, n) ==
+                       n);
+        }
+        for (i = 0; i < n; i++)
+        {
+            if ((round & 1u) == 0)
+            {
+                held[i] = SSFMPoolTryAlloc(&smpTestPool, SMP_TEST_BLOCK_SIZE, (uint8_t)id);
+            }
+            SSF_ASSERT(held[i] != NULL);
+            memset(held[i], (int)(uint8_t)(round + id), SMP_TEST_BLOCK_SIZE);
+        }
+        if ((round & 3u) == 0) sched_yield();
+
+        /* Swap the first block for one another thread left, to free blocks alloced elsewhere */
+        other = (uint8_t *)SSF_ATOMIC_XCHG_PTR(&(_smpXchg[(id + round) % SMP_TEST_THREADS]),
+                                               held[0]);
+        for (i = 1; i < n; i++)
+        {
+            SSF_ASSERT(((uint8_t *)held[i])[0] == (uint8_t)(round + id));
+            _SSFMPoolUTCheckBlock((uint8_t *)held[i]);
+            if ((round & 1u) == 0) SSFMPoolFree(&smpTestPool, held[i]);
+        }
+        if ((round & 1u) != 0) SSFMPoolFreeN(&smpTestPool, &held[1], n - 1u);
+        if (other != NULL)
+        {
+            _SSFMPoolUTCheckBlock(other);
+            SSFMPoolFree(&smpTestPool, other);
+        }
+    }
+    SSFMPoolFlush(&smpTestPool);
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Unit tests a concurrent pool shared by threads that free each other's blocks.                 */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolUTConcurrentThreads(void)
+{
+    pthread_t threads[SMP_TEST_THREADS];
+    uint32_t i;
+
+    SSFMPoolInitConcurrent(&smpTestPool, SMP_TEST_THREAD_BLOCKS, SMP_TEST_BLOCK_SIZE,
+                           SMP_TEST_ALIGN, NULL, 0);
+    for (i = 0; i < SMP_TEST_THREADS; i++) _smpXchg[i] = NULL;
+    for (i = 0; i < SMP_TEST_THREADS; i++)
+    {
+        SSF_ASSERT(pthread_create(&threads[i], NULL, _SSFMPoolUTThread, (void *)(uintptr_t)i) ==
+                   0);
+    }
+    for (i = 0; i < SMP_TEST_THREADS; i++) SSF_ASSERT(pthread_join(threads[i], NULL) == 0);
+    for (i = 0; i < SMP_TEST_THREADS; i++)
+    {
+        if (_smpXchg[i] != NULL) _smpXchg[i] = SSFMPoolFree(&smpTestPool, _smpXchg[i]);
+    }
+    SSF_ASSERT(SSFMPoolIsFull(&smpTestPool));
+    SSFMPoolDeInit(&smpTestPool);
+}
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    #define SMP_BENCH_THREADS_MAX (4u)
+    #define SMP_BENCH_PAIRS (1000000ul)
+    #define SMP_BENCH_BURST (4u)
+
+static SSF_MUTEX_DECLARATION(_smpBenchMutex);
+static bool _smpBenchIsLocked;
+
+/* --------------------------------------------------------------------------------------------- */
+/* Allocs and frees bursts of blocks, holding a mutex around each call if _smpBenchIsLocked.     */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFMPoolUTBenchThread(void *arg)
+{
+    void *ptrs[SMP_BENCH_BURST];
+    uint32_t pairs = (uint32_t)(uintptr_t)arg;
+    uint32_t i;
+    uint32_t j;
+
+    for (i = 0; i < pairs; i += SMP_BENCH_BURST)
+    {
+        for (j = 0; j < SMP_BENCH_BURST; j++)
+        {
+            if (_smpBenchIsLocked) SSF_MUTEX_ACQUIRE(_smpBenchMutex);
+            ptrs[j] = SSFMPoolAlloc(&smpTestPool, SMP_BENCH_BLOCK_SIZE, (uint8_t)j);
+            if (_smpBenchIsLocked) SSF_MUTEX_RELEASE(_smpBenchMutex);
+            *(uint32_t *)ptrs[j] = i;
+        }
+        for (j = 0; j < SMP_BENCH_BURST; j++)
+        {
+            if (_smpBenchIsLocked) SSF_MUTEX_ACQUIRE(_smpBenchMutex);
+            SSFMPoolFree(&smpTestPool, ptrs[j]);
+            if (_smpBenchIsLocked) SSF_MUTEX_RELEASE(_smpBenchMutex);
+        }
+    }
+    SSFMPoolFlush(&smpTestPool);
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Prints alloc/free pair cost of a mutex protected pool and a concurrent pool over threads.    */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolUTConcurrentBench(void)
+{
+    pthread_t threads[SMP_BENCH_THREADS_MAX];
+    uint64_t start;
+    uint64_t ns;
+    uint32_t n;
+    uint32_t i;
+    uint32_t mode;
+
+    SSF_MUTEX_INIT(_smpBenchMutex);
+    for (mode = 0; mode < 2u; mode++)
+    {
+        for (n = 1; n <= SMP_BENCH_THREADS_MAX; n <<= 1)
+        {
+            _smpBenchIsLocked = (mode == 0);
+            if (_smpBenchIsLocked)
+            {
+                SSFMPoolInitSlab(&smpTestPool, SMP_BENCH_BLOCKS, SMP_BENCH_BLOCK_SIZE,
+                                 SMP_TEST_ALIGN, NULL, 0);
+            }
+            else
+            {
+                SSFMPoolInitConcurrent(&smpTestPool, SMP_BENCH_BLOCKS, SMP_BENCH_BLOCK_SIZE,
+                                       SMP_TEST_ALIGN, NULL, 0);
+            }
+            start = SSFPortGetHRTick64();
+            for (i = 0; i < n; i++)
+            {
+                SSF_ASSERT(pthread_create(&threads[i], NULL, _SSFMPoolUTBenchThread,
+                                          (void *)(uintptr_t)(SMP_BENCH_PAIRS / n)) == 0);
+            }
+            for (i = 0; i < n; i++) SSF_ASSERT(pthread_join(threads[i], NULL) == 0);
+            ns = (SSFPortGetHRTick64() - start) * (1000000000ull / SSF_HR_TICKS_PER_SEC);
+            SSF_ASSERT(SSFMPoolIsFull(&smpTestPool));
+            SSFMPoolDeInit(&smpTestPool);
+            printf("\r\n  %s pool, %lu threads: %llu ns per alloc/free pair\r\n",
+                   _smpBenchIsLocked ? "Mutex protected" : "Concurrent", (unsigned long)n,
+                   (unsigned long long)(ns / SMP_BENCH_PAIRS));
+        }
+    }
+    SSF_MUTEX_DEINIT(_smpBenchMutex);
+}
+#endif /* SSF_CONFIG_UNIT_TEST_BENCHMARK */
+#endif /* !_WIN32 */
+#endif /* SSF_MPOOL_CONCURRENT */
+
+    #define SMP_TEST_BATCH_BLOCKS ((SSF_MPOOL_CONFIG_MAGAZINE_SIZE * 3u) + 1u)
+
+static void *_smpBatchPtrs[SMP_TEST_BATCH_BLOCKS];
+
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes smpTestPool as a concurrent pool if isConcurrent, else as a slab pool.            */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolUTBatchInit(uint32_t blocks, uint32_t blockSize, bool isConcurrent)
+{
+#if SSF_MPOOL_CONCURRENT == 1
+    if (isConcurrent)
+    {
+        SSFMPoolInitConcurrent(&smpTestPool, blocks, blockSize, SSF_MPOOL_CONFIG_BLOCK_ALIGN,
+                               NULL, 0);
+        return;
+    }
+#else
+    SSF_ASSERT(isConcurrent == false);
+#endif
+    SSFMPoolInitSlab(&smpTestPool, blocks, blockSize, SSF_MPOOL_CONFIG_BLOCK_ALIGN, NULL, 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Unit tests SSFMPoolAllocN() and SSFMPoolFreeN() on a slab or concurrent pool.                 */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolUTBatch(bool isConcurrent)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t n;
+
+    SSF_ASSERT_TEST(SSFMPoolAllocN(&smpTestPool, SMP_TEST_BLOCK_SIZE, 0, smpTestPtrs, 1u));
+    SSF_ASSERT_TEST(SSFMPoolFreeN(&smpTestPool, smpTestPtrs, 1u));
+
+    _SSFMPoolUTBatchInit(SMP_TEST_BLOCKS, SMP_TEST_BLOCK_SIZE, isConcurrent);
+    SSF_ASSERT_TEST(SSFMPoolAllocN(NULL, SMP_TEST_BLOCK_SIZE, 0, smpTestPtrs, 1u));
+    SSF_ASSERT_TEST(SSFMPoolAllocN(&smpTestPool, SMP_TEST_BLOCK_SIZE + 1, 0, smpTestPtrs, 1u));
+    SSF_ASSERT_TEST(SSFMPoolAllocN(&smpTestPool, SMP_TEST_BLOCK_SIZE, 0, NULL, 1u));
+    SSF_ASSERT_TEST(SSFMPoolFreeN(NULL, smpTestPtrs, 1u));
+    SSF_ASSERT_TEST(SSFMPoolFreeN(&smpTestPool, NULL, 1u));
+    SSF_ASSERT(SSFMPoolAllocN(&smpTestPool, SMP_TEST_BLOCK_SIZE, 0, smpTestPtrs, 0) == 0);
+    SSFMPoolFreeN(&smpTestPool, smpTestPtrs, 0);
+    SSF_ASSERT(SSFMPoolIsFull(&smpTestPool));
+
+    /* A short chain, then the rest of the pool, then nothing */
+    SSF_ASSERT(SSFMPoolAllocN(&smpTestPool, SMP_TEST_BLOCK_SIZE, 0x11, smpTestPtrs, 4u) == 4u);
+    SSF_ASSERT(SSFMPoolLen(&smpTestPool) == (SMP_TEST_BLOCKS - 4u));
+    SSF_ASSERT(SSFMPoolAllocN(&smpTestPool, 1u, 0x22, &smpTestPtrs[4], SMP_TEST_BLOCKS) ==
+               (SMP_TEST_BLOCKS - 4u));
+    SSF_ASSERT(SSFMPoolIsEmpty(&smpTestPool));
+    SSF_ASSERT(SSFMPoolAllocN(&smpTestPool, 1u, 0, &testPtr, 1u) == 0);
+    for (i = 0; i < SMP_TEST_BLOCKS; i++)
+    {
+        SSF_ASSERT(smpTestPtrs[i] != NULL);
+        SSF_ASSERT((((uintptr_t)smpTestPtrs[i]) & (SSF_MPOOL_CONFIG_BLOCK_ALIGN - 1)) == 0);
+        for (j = 0; j < i; j++) SSF_ASSERT(smpTestPtrs[j] != smpTestPtrs[i]);
+        SSF_ASSERT(((uint8_t *)smpTestPtrs[i])[SMP_TEST_BLOCK_SIZE + sizeof(uint32_t) - 1u] ==
+                   ((i < 4u) ? 0x11 : 0x22));
+        memset(smpTestPtrs[i], (int)i, SMP_TEST_BLOCK_SIZE);
+    }
+
+    /* A slab pool hands out blocks in the same order SSFMPoolAlloc() would */
+    if (isConcurrent == false)
+    {
+        for (i = 1; i < SMP_TEST_BLOCKS; i++)
+        {
+            SSF_ASSERT(((uint8_t *)smpTestPtrs[i] - (uint8_t *)smpTestPtrs[i - 1]) ==
+                       SSF_MPOOL_BLOCK_STRIDE(SMP_TEST_BLOCK_SIZE, SSF_MPOOL_CONFIG_BLOCK_ALIGN));
+        }
+    }
+
+    /* A bad or repeated block anywhere in the chain asserts before any block is freed */
+    testPtr = smpTestPtrs[2];
+    smpTestPtrs[2] = NULL;
+    SSF_ASSERT_TEST(SSFMPoolFreeN(&smpTestPool, smpTestPtrs, 4u));
+    smpTestPtrs[2] = &smpTestSlab[1];
+    SSF_ASSERT_TEST(SSFMPoolFreeN(&smpTestPool, smpTestPtrs, 4u));
+    smpTestPtrs[2] = testPtr;
+    ((uint8_t *)smpTestPtrs[3])[SMP_TEST_BLOCK_SIZE] ^= 0xff;
+    SSF_ASSERT_TEST(SSFMPoolFreeN(&smpTestPool, smpTestPtrs, 4u));
+    ((uint8_t *)smpTestPtrs[3])[SMP_TEST_BLOCK_SIZE] ^= 0xff;
+    smpTestPtrs[2] = smpTestPtrs[0];
+    SSF_ASSERT_TEST(SSFMPoolFreeN(&smpTestPool, smpTestPtrs, 4u));
+    smpTestPtrs[2] = testPtr;
+    SSF_ASSERT(SSFMPoolIsEmpty(&smpTestPool));
+
+    /* Free a chain, mix with single block calls, then free the rest as one chain */
+    testPtr = smpTestPtrs[3];
+    SSFMPoolFreeN(&smpTestPool, smpTestPtrs, 4u);
+    for (i = 0; i < 4u; i++) SSF_ASSERT(smpTestPtrs[i] == NULL);
+    SSF_ASSERT(SSFMPoolLen(&smpTestPool) == 4u);
+    /* A block freed twice asserts */
+    smpTestPtrs[3] = testPtr;
+    SSF_ASSERT_TEST(SSFMPoolFreeN(&smpTestPool, &smpTestPtrs[3], 2u));
+    SSF_ASSERT_TEST(SSFMPoolFree(&smpTestPool, testPtr));
+    smpTestPtrs[3] = NULL;
+    SSF_ASSERT(SSFMPoolLen(&smpTestPool) == 4u);
+    smpTestPtrs[0] = SSFMPoolAlloc(&smpTestPool, SMP_TEST_BLOCK_SIZE, 0x33);
+    smpTestPtrs[4] = SSFMPoolFree(&smpTestPool, smpTestPtrs[4]);
+    SSF_ASSERT(SSFMPoolLen(&smpTestPool) == 4u);
+    for (i = 5; i < SMP_TEST_BLOCKS; i++)
+    {
+        SSF_ASSERT(((uint8_t *)smpTestPtrs[i])[SMP_TEST_BLOCK_SIZE - 1u] == (uint8_t)i);
+    }
+    SSFMPoolFreeN(&smpTestPool, &smpTestPtrs[5], SMP_TEST_BLOCKS - 5u);
+    SSFMPoolFreeN(&smpTestPool, smpTestPtrs, 1u);
+    SSF_ASSERT(SSFMPoolIsFull(&smpTestPool));
+    SSFMPoolDeInit(&smpTestPool);
+
+    /* Chains longer than a magazine, freed in a different order than allocated */
+    _SSFMPoolUTBatchInit(SMP_TEST_BATCH_BLOCKS, SMP_TEST_BLOCK_SIZE, isConcurrent);
+    for (j = 0; j < 3u; j++)
+    {
+        n = SSFMPoolAllocN(&smpTestPool, SMP_TEST_BLOCK_SIZE, (uint8_t)j, _smpBatchPtrs,
+                           SMP_TEST_BATCH_BLOCKS);
+        SSF_ASSERT(n == SMP_TEST_BATCH_BLOCKS);
+        SSF_ASSERT(SSFMPoolIsEmpty(&smpTestPool));
+        for (i = 0; i < n; i++) memset(_smpBatchPtrs[i], (int)i, SMP_TEST_BLOCK_SIZE);
+        for (i = 0; i < (n / 2u); i++)
+        {
+            testPtr = _smpBatchPtrs[i];
+            _smpBatchPtrs[i] = _smpBatchPtrs[n - 1u - i];
+            _smpBatchPtrs[n - 1u - i] = testPtr;
+        }
+        SSFMPoolFreeN(&smpTestPool, &_smpBatchPtrs[j], n - j);
+        SSF_ASSERT(SSFMPoolLen(&smpTestPool) == (n - j));
+        SSFMPoolFreeN(&smpTestPool, _smpBatchPtrs, j);
+        SSF_ASSERT(SSFMPoolIsFull(&smpTestPool));
+    }
+    for (i = 0; i < SMP_TEST_BATCH_BLOCKS; i++) SSF_ASSERT(_smpBatchPtrs[i] == NULL);
+    SSFMPoolDeInit(&smpTestPool);
+    testPtr = NULL;
+}
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    #define SMP_BENCH_BATCH_PAIRS (4000000ul)
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns ns per block of allocing and freeing bursts of n blocks, as chains if isChain.        */
+/* --------------------------------------------------------------------------------------------- */
+static uint64_t _SSFMPoolUTBatchBenchCycle(uint32_t n, bool isChain)
+{
+    uint64_t start;
+    uint32_t i;
+    uint32_t j;
+
+    start = SSFPortGetHRTick64();
+    for (i = 0; i < SMP_BENCH_BATCH_PAIRS; i += n)
+    {
+        if (isChain)
+        {
+            SSFMPoolAllocN(&smpTestPool, SMP_BENCH_BLOCK_SIZE, 0x44, _smpBenchPtrs, n);
+            for (j = 0; j < n; j++) *(uint32_t *)_smpBenchPtrs[j] = i;
+            SSFMPoolFreeN(&smpTestPool, _smpBenchPtrs, n);
+        }
+        else
+        {
+            for (j = 0; j < n; j++)
+            {
+                _smpBenchPtrs[j] = SSFMPoolAlloc(&smpTestPool, SMP_BENCH_BLOCK_SIZE, 0x44);
+                *(uint32_t *)_smpBenchPtrs[j] = i;
+            }
+            for (j = 0; j < n; j++) SSFMPoolFree(&smpTestPool, _smpBenchPtrs[j]);
+        }
+    }
+    return ((SSFPortGetHRTick64() - start) * (1000000000ull / SSF_HR_TICKS_PER_SEC)) /
+           SMP_BENCH_BATCH_PAIRS;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Prints alloc/free pair cost of bursts moved one block at a time and as one chain.            */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFMPoolUTBatchBench(void)
+{
+    static const uint32_t bursts[] = { 1u, 8u, 32u, 256u };
+    uint64_t singleNs;
+    uint64_t chainNs;
+    uint32_t kind;
+    uint32_t i;
+
+    for (kind = 0; kind < ((SSF_MPOOL_CONCURRENT == 1) ? 2u : 1u); kind++)
+    {
+        for (i = 0; i < (sizeof(bursts) / sizeof(bursts[0])); i++)
+        {
+            _SSFMPoolUTBatchInit(SMP_BENCH_BLOCKS, SMP_BENCH_BLOCK_SIZE, kind == 1u);
+            singleNs = _SSFMPoolUTBatchBenchCycle(bursts[i], false);
+            chainNs = _SSFMPoolUTBatchBenchCycle(bursts[i], true);
+            SSF_ASSERT(SSFMPoolIsFull(&smpTestPool));
+            SSFMPoolDeInit(&smpTestPool);
+            printf("\r\n  %s pool, bursts of %lu: %llu ns per pair single, %llu ns chained\r\n",
+                   (kind == 1u) ? "Concurrent" : "Slab", (unsigned long)bursts[i],
+                   (unsigned long long)singleNs, (unsigned long long)chainNs);
+        }
+    }
+}
+#endif /* SSF_CONFIG_UNIT_TEST_BENCHMARK */
 
 /* --------------------------------------------------------------------------------------------- */
 /* Performs unit test on ssfll's external interface.                                             */
@@ -194,6 +871,92 @@ void SSFMPoolUnitTest(void)
     /* Clean up: free the block and deinit properly */
     testPtr = SSFMPoolFree(&smpTestPool, testPtr);
     SSFMPoolDeInit(&smpTestPool);
+
+    /* Blocks are carved from one slab back to back */
+    SSFMPoolInit(&smpTestPool, SMP_TEST_BLOCKS, SMP_TEST_BLOCK_SIZE);
+    for (i = 0; i < SMP_TEST_BLOCKS; i++)
+    {
+        smpTestPtrs[i] = SSFMPoolAlloc(&smpTestPool, SMP_TEST_BLOCK_SIZE, (uint8_t)i);
+        SSF_ASSERT((((uintptr_t)smpTestPtrs[i]) & (SSF_MPOOL_CONFIG_BLOCK_ALIGN - 1)) == 0);
+        if (i > 0)
+        {
+            SSF_ASSERT(((uint8_t *)smpTestPtrs[i] - (uint8_t *)smpTestPtrs[i - 1]) ==
+                       SSF_MPOOL_BLOCK_STRIDE(SMP_TEST_BLOCK_SIZE, SSF_MPOOL_CONFIG_BLOCK_ALIGN));
+        }
+    }
+    SSF_ASSERT_TEST(SSFMPoolFree(&smpTestPool, (uint8_t *)smpTestPtrs[0] - 1));
+    SSF_ASSERT_TEST(SSFMPoolFree(&smpTestPool,
+                                 (uint8_t *)smpTestPtrs[SMP_TEST_BLOCKS - 1] +
+                                 SSF_MPOOL_BLOCK_STRIDE(SMP_TEST_BLOCK_SIZE,
+                                                        SSF_MPOOL_CONFIG_BLOCK_ALIGN)));
+#if SSF_MPOOL_DEBUG == 1
+    SSF_ASSERT_TEST(SSFMPoolFree(&smpTestPool, (uint8_t *)smpTestPtrs[1] + 1));
+#endif
+    for (i = 0; i < SMP_TEST_BLOCKS; i++)
+    {
+        smpTestPtrs[i] = SSFMPoolFree(&smpTestPool, smpTestPtrs[i]);
+    }
+    SSFMPoolDeInit(&smpTestPool);
+
+    /* Caller provided slab with cache line aligned blocks */
+    SSF_ASSERT_TEST(SSFMPoolInitSlab(NULL, SMP_TEST_BLOCKS, SMP_TEST_BLOCK_SIZE, SMP_TEST_ALIGN,
+                                     smpTestSlab, sizeof(smpTestSlab)));
+    SSF_ASSERT_TEST(SSFMPoolInitSlab(&smpTestPool, 0, SMP_TEST_BLOCK_SIZE, SMP_TEST_ALIGN,
+                                     smpTestSlab, sizeof(smpTestSlab)));
+    SSF_ASSERT_TEST(SSFMPoolInitSlab(&smpTestPool, SMP_TEST_BLOCKS, 0, SMP_TEST_ALIGN,
+                                     smpTestSlab, sizeof(smpTestSlab)));
+    SSF_ASSERT_TEST(SSFMPoolInitSlab(&smpTestPool, SMP_TEST_BLOCKS, SMP_TEST_BLOCK_SIZE, 2u,
+                                     smpTestSlab, sizeof(smpTestSlab)));
+    SSF_ASSERT_TEST(SSFMPoolInitSlab(&smpTestPool, SMP_TEST_BLOCKS, SMP_TEST_BLOCK_SIZE, 96u,
+                                     smpTestSlab, sizeof(smpTestSlab)));
+    SSF_ASSERT_TEST(SSFMPoolInitSlab(&smpTestPool, SMP_TEST_BLOCKS, SMP_TEST_BLOCK_SIZE,
+                                     SMP_TEST_ALIGN, smpTestSlab, sizeof(smpTestSlab) - 2u));
+    SSF_ASSERT_TEST(SSFMPoolInitSlab(&smpTestPool, 0x10000000ul, SMP_TEST_BLOCK_SIZE,
+                                     SMP_TEST_ALIGN, NULL, 0));
+    SSF_ASSERT_TEST(SSFMPoolInitSlab(&smpTestPool, 1, 0xfffffff0ul, SMP_TEST_ALIGN, NULL, 0));
+    memset(smpTestSlab, 0xee, sizeof(smpTestSlab));
+    SSFMPoolInitSlab(&smpTestPool, SMP_TEST_BLOCKS, SMP_TEST_BLOCK_SIZE, SMP_TEST_ALIGN,
+                     &smpTestSlab[1], sizeof(smpTestSlab) - 1u);
+    SSF_ASSERT_TEST(SSFMPoolInitSlab(&smpTestPool, SMP_TEST_BLOCKS, SMP_TEST_BLOCK_SIZE,
+                                     SMP_TEST_ALIGN, &smpTestSlab[1], sizeof(smpTestSlab) - 1u));
+    SSF_ASSERT(SSFMPoolSize(&smpTestPool) == SMP_TEST_BLOCKS);
+    SSF_ASSERT(SSFMPoolBlockSize(&smpTestPool) == SMP_TEST_BLOCK_SIZE);
+    for (i = 0; i < SMP_TEST_BLOCKS; i++)
+    {
+        smpTestPtrs[i] = SSFMPoolAlloc(&smpTestPool, SMP_TEST_BLOCK_SIZE, (uint8_t)i);
+        SSF_ASSERT((((uintptr_t)smpTestPtrs[i]) & (SMP_TEST_ALIGN - 1)) == 0);
+        SSF_ASSERT((uint8_t *)smpTestPtrs[i] >= &smpTestSlab[1 + sizeof(SSFLLItem_t)]);
+        SSF_ASSERT(((uint8_t *)smpTestPtrs[i] + SMP_TEST_BLOCK_SIZE + sizeof(uint32_t)) <=
+                   &smpTestSlab[sizeof(smpTestSlab)]);
+        SSF_ASSERT(((uint8_t *)smpTestPtrs[i])[0] == 0);
+        memset(smpTestPtrs[i], (int)i, SMP_TEST_BLOCK_SIZE);
+    }
+    SSF_ASSERT(SSFMPoolIsEmpty(&smpTestPool));
+    for (i = 0; i < SMP_TEST_BLOCKS; i++)
+    {
+        SSF_ASSERT(((uint8_t *)smpTestPtrs[i])[SMP_TEST_BLOCK_SIZE - 1] == (uint8_t)i);
+        smpTestPtrs[i] = SSFMPoolFree(&smpTestPool, smpTestPtrs[i]);
+    }
+    SSFMPoolDeInit(&smpTestPool);
+    for (i = 1; i < sizeof(smpTestSlab); i++) SSF_ASSERT(smpTestSlab[i] == 0);
+    SSF_ASSERT(smpTestSlab[0] == 0xee);
+
+    _SSFMPoolUTBatch(false);
+#if SSF_MPOOL_CONCURRENT == 1
+    _SSFMPoolUTBatch(true);
+    _SSFMPoolUTConcurrent();
+#if !defined(_WIN32)
+    _SSFMPoolUTConcurrentThreads();
+#endif
+#endif
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    _SSFMPoolUTBench();
+    _SSFMPoolUTBatchBench();
+#if (SSF_MPOOL_CONCURRENT == 1) && !defined(_WIN32)
+    _SSFMPoolUTConcurrentBench();
+#endif
+#endif
 }
 #endif /* SSF_CONFIG_MPOOL_UNIT_TEST */
 
@@ -0,0 +1,385 @@
+/* --------------------------------------------------------------------------------------------- */
+/* Small System Framework                                                                        */
+/*                                                                                               */
+/* ssfsalloc.c                                                                                   */
+/* Provides size class allocator interface built from fixed block size memory pools.             */
+/*                                                                                               */
+/* BSD-3-Clause License                                                                          */
+/* Copyright 2026 Supurloop Software LLC                                                         */
+/*                                                                                               */
+/* Redistribution and use in source and binary forms, with or without modification, are          */
+/* permitted provided that the following conditions are met:                                     */
+/*                                                                                               */
+/* 1. Redistributions of source code must retain the above copyright notice, this list of        */
+/* conditions and the following disclaimer.                                                      */
+/* 2. Redistributions in binary form must reproduce the above copyright notice, this list of     */
+/* conditions and the following disclaimer in the documentation and/or other materials provided  */
+/* with the distribution.                                                                        */
+/* 3. Neither the name of the copyright holder nor the names of its contributors may be used to  */
+/* endorse or promote products derived from this software without specific prior written         */
+/* permission.                                                                                   */
+/*                                                                                               */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   */
+/* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    */
+/* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL      */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE */
+/* GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    */
+/* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     */
+/* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  */
+/* OF THE POSSIBILITY OF SUCH DAMAGE.                                                            */
+/* --------------------------------------------------------------------------------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ssfsalloc.h"
+#include "ssfassert.h"
+
+/* --------------------------------------------------------------------------------------------- */
+/* Defines                                                                                       */
+/* --------------------------------------------------------------------------------------------- */
+#define SSF_SALLOC_INIT_MAGIC (0x53414c43ul)
+#define SSF_SALLOC_HEAP_MARK ('s')
+
+/* The heap is never thread safe, plain pools are not either */
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+#define SSF_SALLOC_LOCK(sa) SSF_MUTEX_ACQUIRE((sa)->mutex)
+#define SSF_SALLOC_UNLOCK(sa) SSF_MUTEX_RELEASE((sa)->mutex)
+#define SSF_SALLOC_ADD(p, v) SSF_ATOMIC_ADD_U32(p, v)
+#define SSF_SALLOC_LOAD(p) SSF_ATOMIC_LOAD_U32(p)
+#else
+#define SSF_SALLOC_LOCK(sa)
+#define SSF_SALLOC_UNLOCK(sa)
+#define SSF_SALLOC_ADD(p, v) (*(p) += (v), *(p) - (v))
+#define SSF_SALLOC_LOAD(p) (*(p))
+#endif
+#if SSF_MPOOL_CONCURRENT == 1
+#define SSF_SALLOC_POOL_LOCK(sa)
+#define SSF_SALLOC_POOL_UNLOCK(sa)
+#else
+#define SSF_SALLOC_POOL_LOCK(sa) SSF_SALLOC_LOCK(sa)
+#define SSF_SALLOC_POOL_UNLOCK(sa) SSF_SALLOC_UNLOCK(sa)
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/* Module variables                                                                              */
+/* --------------------------------------------------------------------------------------------- */
+static SSFSAlloc_t *_ssfsaDefault;
+static uint32_t _ssfsaEarlyUsed;
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns the smallest class that fits size, SSF_SALLOC_FALLBACK if none does.                  */
+/* --------------------------------------------------------------------------------------------- */
+static uint8_t _SSFSAllocClass(uint32_t size)
+{
+    uint8_t cls = 0;
+
+    if (size > SSF_SALLOC_MAX_CLASS_SIZE) return SSF_SALLOC_FALLBACK;
+    while (SSF_SALLOC_CLASS_SIZE(cls) < size) cls++;
+    return cls;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Counts an allocation served by stats and updates its high water mark.                         */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSAllocCountAlloc(SSFSAllocStats_t *stats)
+{
+    uint32_t used;
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    uint32_t max;
+#endif
+
+    SSF_SALLOC_ADD(&(stats->allocs), 1);
+    used = SSF_SALLOC_ADD(&(stats->used), 1) + 1;
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    do
+    {
+        max = SSF_ATOMIC_LOAD_U32(&(stats->maxUsed));
+    } while ((used > max) && (SSF_ATOMIC_CAS_U32(&(stats->maxUsed), max, used) == false));
+#else
+    if (used > stats->maxUsed) stats->maxUsed = used;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns bytes of arena needed for classBlocks[] blocks of each class.                         */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFSAllocArenaSize(const uint32_t *classBlocks)
+{
+    uint64_t size = 0;
+    uint8_t cls;
+
+    SSF_REQUIRE(classBlocks != NULL);
+
+    for (cls = 0; cls < SSF_SALLOC_CONFIG_NUM_CLASSES; cls++)
+    {
+        if (classBlocks[cls] == 0) continue;
+        size += ((uint64_t)classBlocks[cls] *
+                 SSF_MPOOL_BLOCK_STRIDE(SSF_SALLOC_CLASS_SIZE(cls), SSF_MPOOL_CONFIG_BLOCK_ALIGN)) +
+                SSF_MPOOL_CONFIG_BLOCK_ALIGN;
+        SSF_REQUIRE(size <= 0xfffffffful);
+    }
+    return (uint32_t)size;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Initializes an allocator with classBlocks[] blocks per class carved from arena, or from one    */
+/* fallback allocation if NULL, with oversized requests served by heap or if NULL the fallback.  */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSAllocInit(SSFSAlloc_t *sa, const uint32_t *classBlocks, void *arena, uint32_t arenaSize,
+                   SSFHeapHandle_t heap)
+{
+    uint32_t size;
+    uint8_t *mem;
+    uint8_t cls;
+
+    SSF_REQUIRE(sa != NULL);
+    SSF_REQUIRE(classBlocks != NULL);
+    SSF_ASSERT(sa->magic != SSF_SALLOC_INIT_MAGIC);
+
+    size = SSFSAllocArenaSize(classBlocks);
+    SSF_REQUIRE(size > 0);
+    SSF_REQUIRE((arena == NULL) || (arenaSize >= size));
+
+    memset(sa, 0, sizeof(SSFSAlloc_t));
+    if (arena == NULL)
+    {
+        arenaSize = size;
+        if (heap != NULL)
+        {
+            SSF_ASSERT(SSFHeapMalloc(heap, &arena, arenaSize, SSF_SALLOC_HEAP_MARK));
+        }
+        else { SSF_ASSERT((arena = SSF_SALLOC_CONFIG_FALLBACK_MALLOC(arenaSize)) != NULL); }
+        sa->isArenaOwned = true;
+    }
+    sa->arena = (uint8_t *)arena;
+    sa->arenaSize = arenaSize;
+    sa->heap = heap;
+
+    /* Classes are carved in order so a pointer's class follows from the arena part it is in */
+    mem = sa->arena;
+    for (cls = 0; cls < SSF_SALLOC_CONFIG_NUM_CLASSES; cls++)
+    {
+        sa->stats[cls].blockSize = SSF_SALLOC_CLASS_SIZE(cls);
+        sa->stats[cls].blocks = classBlocks[cls];
+        if (classBlocks[cls] > 0)
+        {
+            size = SSF_SALLOC_CLASS_ARENA_SIZE(cls, classBlocks[cls]);
+#if SSF_MPOOL_CONCURRENT == 1
+            SSFMPoolInitConcurrent(&(sa->pools[cls]), classBlocks[cls], SSF_SALLOC_CLASS_SIZE(cls),
+                                   SSF_MPOOL_CONFIG_BLOCK_ALIGN, mem, size);
+#else
+            SSFMPoolInitSlab(&(sa->pools[cls]), classBlocks[cls], SSF_SALLOC_CLASS_SIZE(cls),
+                             SSF_MPOOL_CONFIG_BLOCK_ALIGN, mem, size);
+#endif
+            mem += size;
+        }
+        sa->ends[cls] = mem;
+    }
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_MUTEX_INIT(sa->mutex);
+#endif
+    sa->magic = SSF_SALLOC_INIT_MAGIC;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Deinitializes an allocator, all its allocations must have been freed.                         */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSAllocDeInit(SSFSAlloc_t *sa)
+{
+    uint8_t cls;
+
+    SSF_REQUIRE(sa != NULL);
+    SSF_REQUIRE(sa->magic == SSF_SALLOC_INIT_MAGIC);
+    for (cls = 0; cls <= SSF_SALLOC_FALLBACK; cls++)
+    {
+        SSF_REQUIRE(SSF_SALLOC_LOAD(&(sa->stats[cls].used)) == 0);
+    }
+
+    if (_ssfsaDefault == sa) _ssfsaDefault = NULL;
+    for (cls = 0; cls < SSF_SALLOC_CONFIG_NUM_CLASSES; cls++)
+    {
+        if (sa->stats[cls].blocks > 0) SSFMPoolDeInit(&(sa->pools[cls]));
+    }
+    if (sa->isArenaOwned)
+    {
+        if (sa->heap != NULL) SSFHeapFree(sa->heap, &(sa->arena), NULL);
+        else SSF_SALLOC_CONFIG_FALLBACK_FREE(sa->arena);
+    }
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_MUTEX_DEINIT(sa->mutex);
+#endif
+    memset(sa, 0, sizeof(SSFSAlloc_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns a block of at least size bytes from the smallest class with one free, from the        */
+/* fallback if size is bigger than every class or all that fit are empty, or NULL.               */
+/* --------------------------------------------------------------------------------------------- */
+void *SSFSAllocAlloc(SSFSAlloc_t *sa, uint32_t size)
+{
+    void *mem = NULL;
+    uint8_t want;
+    uint8_t cls;
+
+    SSF_REQUIRE(sa != NULL);
+    SSF_REQUIRE(sa->magic == SSF_SALLOC_INIT_MAGIC);
+
+    /* At most SSF_SALLOC_CONFIG_NUM_CLASSES steps, the owner tag records the class asked for */
+    want = _SSFSAllocClass(size);
+    for (cls = want; cls < SSF_SALLOC_CONFIG_NUM_CLASSES; cls++)
+    {
+        if (sa->stats[cls].blocks == 0) continue;
+        SSF_SALLOC_POOL_LOCK(sa);
+        mem = SSFMPoolTryAlloc(&(sa->pools[cls]), size, want);
+        SSF_SALLOC_POOL_UNLOCK(sa);
+        if (mem != NULL) break;
+    }
+    if ((cls != want) && (want != SSF_SALLOC_FALLBACK))
+    {
+        SSF_SALLOC_ADD(&(sa->stats[want].misses), 1);
+    }
+
+    if (mem == NULL)
+    {
+        if (sa->heap != NULL)
+        {
+            SSF_SALLOC_LOCK(sa);
+            if (SSFHeapMalloc(sa->heap, &mem, size, SSF_SALLOC_HEAP_MARK) == false) mem = NULL;
+            SSF_SALLOC_UNLOCK(sa);
+        }
+        else mem = SSF_SALLOC_CONFIG_FALLBACK_MALLOC(size);
+        if (mem == NULL)
+        {
+            SSF_SALLOC_ADD(&(sa->stats[SSF_SALLOC_FALLBACK].misses), 1);
+            return NULL;
+        }
+    }
+    _SSFSAllocCountAlloc(&(sa->stats[cls]));
+    return mem;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns ptr to its class or the fallback, always returns NULL.                                */
+/* --------------------------------------------------------------------------------------------- */
+void *SSFSAllocDealloc(SSFSAlloc_t *sa, void *ptr)
+{
+    uint8_t *mem = (uint8_t *)ptr;
+    uint8_t cls;
+
+    SSF_REQUIRE(sa != NULL);
+    SSF_REQUIRE(ptr != NULL);
+    SSF_REQUIRE(sa->magic == SSF_SALLOC_INIT_MAGIC);
+
+    if ((mem >= sa->arena) && (mem < sa->ends[SSF_SALLOC_CONFIG_NUM_CLASSES - 1]))
+    {
+        cls = 0;
+        while (mem >= sa->ends[cls]) cls++;
+        SSF_SALLOC_POOL_LOCK(sa);
+        SSFMPoolFree(&(sa->pools[cls]), ptr);
+        SSF_SALLOC_POOL_UNLOCK(sa);
+    }
+    else
+    {
+        cls = SSF_SALLOC_FALLBACK;
+        if (sa->heap != NULL)
+        {
+            SSF_SALLOC_LOCK(sa);
+            SSFHeapFree(sa->heap, &ptr, NULL);
+            SSF_SALLOC_UNLOCK(sa);
+        }
+        else SSF_SALLOC_CONFIG_FALLBACK_FREE(ptr);
+    }
+    SSF_ASSERT(SSF_SALLOC_ADD(&(sa->stats[cls].used), (uint32_t)-1) > 0);
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns a snapshot of the stats of class cls, or of the fallback if SSF_SALLOC_FALLBACK.       */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSAllocStats(const SSFSAlloc_t *sa, uint8_t cls, SSFSAllocStats_t *statsOut)
+{
+    SSF_REQUIRE(sa != NULL);
+    SSF_REQUIRE(sa->magic == SSF_SALLOC_INIT_MAGIC);
+    SSF_REQUIRE(cls <= SSF_SALLOC_FALLBACK);
+    SSF_REQUIRE(statsOut != NULL);
+
+    statsOut->blockSize = sa->stats[cls].blockSize;
+    statsOut->blocks = sa->stats[cls].blocks;
+    statsOut->used = SSF_SALLOC_LOAD(&(sa->stats[cls].used));
+    statsOut->maxUsed = SSF_SALLOC_LOAD(&(sa->stats[cls].maxUsed));
+    statsOut->allocs = SSF_SALLOC_LOAD(&(sa->stats[cls].allocs));
+    statsOut->misses = SSF_SALLOC_LOAD(&(sa->stats[cls].misses));
+}
+
+#if SSF_MPOOL_CONCURRENT == 1
+/* --------------------------------------------------------------------------------------------- */
+/* Returns blocks cached by the calling thread to the allocator's class pools.                   */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSAllocFlush(SSFSAlloc_t *sa)
+{
+    uint8_t cls;
+
+    SSF_REQUIRE(sa != NULL);
+    SSF_REQUIRE(sa->magic == SSF_SALLOC_INIT_MAGIC);
+
+    for (cls = 0; cls < SSF_SALLOC_CONFIG_NUM_CLASSES; cls++)
+    {
+        if (sa->stats[cls].blocks > 0) SSFMPoolFlush(&(sa->pools[cls]));
+    }
+}
+#endif /* SSF_MPOOL_CONCURRENT */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Sets the allocator SSFSAllocMalloc() and SSFSAllocFree() use, NULL for the fallback only.     */
+/* Asserts while blocks SSFSAllocMalloc() took with no default set, or that the default being    */
+/* replaced or cleared gave out, are still allocated.                                            */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSAllocSetDefault(SSFSAlloc_t *sa)
+{
+    uint8_t cls;
+
+    SSF_REQUIRE((sa == NULL) || (sa->magic == SSF_SALLOC_INIT_MAGIC));
+    SSF_REQUIRE(SSF_SALLOC_LOAD(&_ssfsaEarlyUsed) == 0);
+
+    if ((_ssfsaDefault != NULL) && (_ssfsaDefault != sa))
+    {
+        for (cls = 0; cls <= SSF_SALLOC_FALLBACK; cls++)
+        {
+            SSF_REQUIRE(SSF_SALLOC_LOAD(&(_ssfsaDefault->stats[cls].used)) == 0);
+        }
+    }
+    _ssfsaDefault = sa;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns size bytes from the default allocator, or the fallback if none, else NULL.            */
+/* --------------------------------------------------------------------------------------------- */
+void *SSFSAllocMalloc(size_t size)
+{
+    void *mem;
+
+    if (_ssfsaDefault == NULL)
+    {
+        mem = SSF_SALLOC_CONFIG_FALLBACK_MALLOC(size);
+        if (mem != NULL) SSF_SALLOC_ADD(&_ssfsaEarlyUsed, 1);
+        return mem;
+    }
+    if (size > 0xfffffffful) return NULL;
+    return SSFSAllocAlloc(_ssfsaDefault, (uint32_t)size);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Frees ptr from SSFSAllocMalloc(), does nothing if ptr is NULL.                                */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSAllocFree(void *ptr)
+{
+    if (ptr == NULL) return;
+    if (_ssfsaDefault == NULL)
+    {
+        SSF_ASSERT(SSF_SALLOC_ADD(&_ssfsaEarlyUsed, (uint32_t)-1) > 0);
+        SSF_SALLOC_CONFIG_FALLBACK_FREE(ptr);
+    }
+    else SSFSAllocDealloc(_ssfsaDefault, ptr);
+}
@@ -0,0 +1,125 @@
+/* --------------------------------------------------------------------------------------------- */
+/* Small System Framework                                                                        */
+/*                                                                                               */
+/* ssfsalloc.h                                                                                   */
+/* Provides size class allocator interface built from fixed block size memory pools.             */
+/*                                                                                               */
+/* BSD-3-Clause License                                                                          */
+/* Copyright 2026 Supurloop Software LLC                                                         */
+/*                                                                                               */
+/* Redistribution and use in source and binary forms, with or without modification, are          */
+/* permitted provided that the following conditions are met:                                     */
+/*                                                                                               */
+/* 1. Redistributions of source code must retain the above copyright notice, this list of        */
+/* conditions and the following disclaimer.                                                      */
+/* 2. Redistributions in binary form must reproduce the above copyright notice, this list of     */
+/* conditions and the following disclaimer in the documentation and/or other materials provided  */
+/* with the distribution.                                                                        */
+/* 3. Neither the name of the copyright holder nor the names of its contributors may be used to  */
+/* endorse or promote products derived from this software without specific prior written         */
+/* permission.                                                                                   */
+/*                                                                                               */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   */
+/* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    */
+/* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL      */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE */
+/* GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    */
+/* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     */
+/* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  */
+/* OF THE POSSIBILITY OF SUCH DAMAGE.                                                            */
+/* --------------------------------------------------------------------------------------------- */
+#ifndef SSF_SALLOC_INCLUDE_H
+#define SSF_SALLOC_INCLUDE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ssfport.h"
+#include "ssfmpool.h"
+#include "ssfheap.h"
+
+/* --------------------------------------------------------------------------------------------- */
+/* Defines and typedefs                                                                          */
+/* --------------------------------------------------------------------------------------------- */
+#if (SSF_SALLOC_CONFIG_MIN_CLASS_SIZE & (SSF_SALLOC_CONFIG_MIN_CLASS_SIZE - 1)) != 0
+#error SSF_SALLOC_CONFIG_MIN_CLASS_SIZE must be a power of 2
+#endif
+#if (SSF_SALLOC_CONFIG_NUM_CLASSES < 1) || \
+    ((SSF_SALLOC_CONFIG_MIN_CLASS_SIZE << (SSF_SALLOC_CONFIG_NUM_CLASSES - 1)) > 0x100000ul)
+#error SSF_SALLOC_CONFIG_NUM_CLASSES must be >= 1 with classes no bigger than 1 MB
+#endif
+
+/* Block size in bytes of class cls */
+#define SSF_SALLOC_CLASS_SIZE(cls) ((uint32_t)SSF_SALLOC_CONFIG_MIN_CLASS_SIZE << (cls))
+
+/* Largest request served by a class, bigger ones go to the fallback */
+#define SSF_SALLOC_MAX_CLASS_SIZE SSF_SALLOC_CLASS_SIZE(SSF_SALLOC_CONFIG_NUM_CLASSES - 1)
+
+/* Arena bytes needed by class cls to hold blocks blocks, sum over classes for SSFSAllocInit() */
+#define SSF_SALLOC_CLASS_ARENA_SIZE(cls, blocks) \
+    (((blocks) == 0) ? 0ul : SSF_MPOOL_SLAB_SIZE(blocks, SSF_SALLOC_CLASS_SIZE(cls), \
+                                                 SSF_MPOOL_CONFIG_BLOCK_ALIGN))
+
+/* Stats index of the SSFHeap or SSF_SALLOC_CONFIG_FALLBACK_MALLOC fallback */
+#define SSF_SALLOC_FALLBACK (SSF_SALLOC_CONFIG_NUM_CLASSES)
+
+typedef struct
+{
+    uint32_t blockSize;  /* Class block size in bytes, 0 for the fallback */
+    uint32_t blocks;     /* Blocks in the class, 0 for the fallback */
+    uint32_t used;       /* Allocations outstanding right now */
+    uint32_t maxUsed;    /* High water mark of used */
+    uint32_t allocs;     /* Allocations served */
+    uint32_t misses;     /* Requests of this class served elsewhere, or fallback failures */
+} SSFSAllocStats_t;
+
+typedef struct SSFSAlloc
+{
+    SSFMPool_t pools[SSF_SALLOC_CONFIG_NUM_CLASSES];
+    SSFSAllocStats_t stats[SSF_SALLOC_CONFIG_NUM_CLASSES + 1]; /* Per class, then fallback */
+    uint8_t *ends[SSF_SALLOC_CONFIG_NUM_CLASSES]; /* End of each class's part of the arena */
+    uint8_t *arena;       /* Memory all class blocks are carved from */
+    uint32_t arenaSize;
+    SSFHeapHandle_t heap; /* Fallback heap, NULL for SSF_SALLOC_CONFIG_FALLBACK_MALLOC */
+    bool isArenaOwned;    /* true if arena was allocated from the fallback */
+#if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
+    SSF_MUTEX_DECLARATION(mutex); /* Guards the heap, and the pools if not concurrent */
+#endif
+    uint32_t magic;
+} SSFSAlloc_t;
+
+/* --------------------------------------------------------------------------------------------- */
+/* External interface                                                                            */
+/* --------------------------------------------------------------------------------------------- */
+uint32_t SSFSAllocArenaSize(const uint32_t *classBlocks);
+void SSFSAllocInit(SSFSAlloc_t *sa, const uint32_t *classBlocks, void *arena, uint32_t arenaSize,
+                   SSFHeapHandle_t heap);
+void SSFSAllocDeInit(SSFSAlloc_t *sa);
+void *SSFSAllocAlloc(SSFSAlloc_t *sa, uint32_t size);
+void *SSFSAllocDealloc(SSFSAlloc_t *sa, void *ptr);
+void SSFSAllocStats(const SSFSAlloc_t *sa, uint8_t cls, SSFSAllocStats_t *statsOut);
+#if SSF_MPOOL_CONCURRENT == 1
+void SSFSAllocFlush(SSFSAlloc_t *sa);
+#endif
+
+/* Drop in replacements for SSF_MALLOC and SSF_FREE that use the default allocator */
+void SSFSAllocSetDefault(SSFSAlloc_t *sa);
+void *SSFSAllocMalloc(size_t size);
+void SSFSAllocFree(void *ptr);
+
+/* --------------------------------------------------------------------------------------------- */
+/* Unit test                                                                                     */
+/* --------------------------------------------------------------------------------------------- */
+#if SSF_CONFIG_SALLOC_UNIT_TEST == 1
+void SSFSAllocUnitTest(void);
+#endif /* SSF_CONFIG_SALLOC_UNIT_TEST */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSF_SALLOC_INCLUDE_H */
@@ -0,0 +1,389 @@
+/* --------------------------------------------------------------------------------------------- */
+/* Small System Framework                                                                        */
+/*                                                                                               */
+/* ssfsalloc_ut.c                                                                                */
+/* Provides unit tests for ssfsalloc's size class allocator interface.                           */
+/*                                                                                               */
+/* BSD-3-Clause License                                                                          */
+/* Copyright 2026 Supurloop Software LLC                                                         */
+/*                                                                                               */
+/* Redistribution and use in source and binary forms, with or without modification, are          */
+/* permitted provided that the following conditions are met:                                     */
+/*                                                                                               */
+/* 1. Redistributions of source code must retain the above copyright notice, this list of        */
+/* conditions and the following disclaimer.                                                      */
+/* 2. Redistributions in binary form must reproduce the above copyright notice, this list of     */
+/* conditions and the following disclaimer in the documentation and/or other materials provided  */
+/* with the distribution.                                                                        */
+/* 3. Neither the name of the copyright holder nor the names of its contributors may be used to  */
+/* endorse or promote products derived from this software without specific prior written         */
+/* permission.                                                                                   */
+/*                                                                                               */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   */
+/* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    */
+/* COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL      */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE */
+/* GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    */
+/* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     */
+/* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  */
+/* OF THE POSSIBILITY OF SUCH DAMAGE.                                                            */
+/* --------------------------------------------------------------------------------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ssfsalloc.h"
+#include "ssfport.h"
+#include "ssfassert.h"
+#if (SSF_MPOOL_CONCURRENT == 1) && !defined(_WIN32)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if SSF_CONFIG_SALLOC_UNIT_TEST == 1
+
+    #define SSA_TEST_BLOCKS (4u)
+    #define SSA_TEST_ARENA_SIZE (SSF_SALLOC_CONFIG_NUM_CLASSES * \
+                                 SSF_SALLOC_CLASS_ARENA_SIZE(SSF_SALLOC_CONFIG_NUM_CLASSES - 1, \
+                                                             SSA_TEST_BLOCKS))
+    #define SSA_TEST_HEAP_SIZE (SSA_TEST_ARENA_SIZE + (SSF_SALLOC_MAX_CLASS_SIZE * 4u) + 256u)
+    #define SSA_TEST_HEAP_MARK ('h')
+
+static SSFSAlloc_t _ssaTest;
+static uint32_t _ssaBlocks[SSF_SALLOC_CONFIG_NUM_CLASSES];
+static uint32_t _ssaNoBlocks[SSF_SALLOC_CONFIG_NUM_CLASSES];
+static uint64_t _ssaArena[(SSA_TEST_ARENA_SIZE / sizeof(uint64_t)) + 1];
+static uint64_t _ssaHeapMem[(SSA_TEST_HEAP_SIZE / sizeof(uint64_t)) + 1];
+static void *_ssaPtrs[SSA_TEST_BLOCKS + 1];
+
+/* --------------------------------------------------------------------------------------------- */
+/* Asserts the stats of class cls.                                                               */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSAllocUTStats(uint8_t cls, uint32_t used, uint32_t maxUsed, uint32_t allocs,
+                              uint32_t misses)
+{
+    SSFSAllocStats_t stats;
+
+    SSFSAllocStats(&_ssaTest, cls, &stats);
+    SSF_ASSERT(stats.used == used);
+    SSF_ASSERT(stats.maxUsed == maxUsed);
+    SSF_ASSERT(stats.allocs == allocs);
+    SSF_ASSERT(stats.misses == misses);
+}
+
+#if (SSF_MPOOL_CONCURRENT == 1) && !defined(_WIN32)
+    #define SSA_TEST_THREADS (4u)
+    #define SSA_TEST_THREAD_HOLD (8u)
+    #define SSA_TEST_THREAD_ROUNDS (10000u)
+
+/* --------------------------------------------------------------------------------------------- */
+/* Allocs, fills, checks and frees random sizes, some too big for any class.                     */
+/* --------------------------------------------------------------------------------------------- */
+static void *_SSFSAllocUTThread(void *arg)
+{
+    uint8_t *held[SSA_TEST_THREAD_HOLD];
+    uint32_t sizes[SSA_TEST_THREAD_HOLD];
+    uint32_t seed = (uint32_t)(uintptr_t)arg + 1u;
+    uint32_t round;
+    uint32_t i;
+    uint32_t j;
+
+    for (round = 0; round < SSA_TEST_THREAD_ROUNDS; round++)
+    {
+        for (i = 0; i < SSA_TEST_THREAD_HOLD; i++)
+        {
+            seed = (seed * 1103515245ul) + 12345ul;
+            sizes[i] = ((seed >> 8) % (SSF_SALLOC_MAX_CLASS_SIZE + 64u)) + 1u;
+            held[i] = (uint8_t *)SSFSAllocAlloc(&_ssaTest, sizes[i]);
+            SSF_ASSERT(held[i] != NULL);
+            memset(held[i], (int)(uint8_t)(round + i), sizes[i]);
+        }
+        if ((round & 7u) == 0) sched_yield();
+        for (i = 0; i < SSA_TEST_THREAD_HOLD; i++)
+        {
+            for (j = 0; j < sizes[i]; j++) SSF_ASSERT(held[i][j] == (uint8_t)(round + i));
+            SSFSAllocDealloc(&_ssaTest, held[i]);
+        }
+    }
+    SSFSAllocFlush(&_ssaTest);
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Unit tests an allocator shared by threads.                                                    */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSAllocUTThreads(void)
+{
+    pthread_t threads[SSA_TEST_THREADS];
+    SSFSAllocStats_t stats;
+    uint32_t allocs = 0;
+    uint8_t cls;
+    uint32_t i;
+
+    for (cls = 0; cls < SSF_SALLOC_CONFIG_NUM_CLASSES; cls++) _ssaBlocks[cls] = 64u;
+    SSFSAllocInit(&_ssaTest, _ssaBlocks, NULL, 0, NULL);
+    for (i = 0; i < SSA_TEST_THREADS; i++)
+    {
+        SSF_ASSERT(pthread_create(&threads[i], NULL, _SSFSAllocUTThread, (void *)(uintptr_t)i) ==
+                   0);
+    }
+    for (i = 0; i < SSA_TEST_THREADS; i++) SSF_ASSERT(pthread_join(threads[i], NULL) == 0);
+    for (cls = 0; cls <= SSF_SALLOC_FALLBACK; cls++)
+    {
+        SSFSAllocStats(&_ssaTest, cls, &stats);
+        SSF_ASSERT(stats.used == 0);
+        SSF_ASSERT(stats.maxUsed <= (SSA_TEST_THREADS * SSA_TEST_THREAD_HOLD));
+        allocs += stats.allocs;
+    }
+    SSF_ASSERT(allocs == (SSA_TEST_THREADS * SSA_TEST_THREAD_HOLD * SSA_TEST_THREAD_ROUNDS));
+    SSFSAllocDeInit(&_ssaTest);
+}
+#endif /* (SSF_MPOOL_CONCURRENT == 1) && !defined(_WIN32) */
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    #define SSA_BENCH_LIVE (256u)
+    #define SSA_BENCH_ROUNDS (2000u)
+    #define SSA_BENCH_MAX_SIZE (512u)
+
+static void *_ssaBenchPtrs[SSA_BENCH_LIVE];
+static uint32_t _ssaBenchSizes[SSA_BENCH_LIVE];
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns ns per alloc/free pair of mixed small sizes from sa, or SSF_MALLOC if NULL.           */
+/* --------------------------------------------------------------------------------------------- */
+static uint64_t _SSFSAllocUTBenchCycle(SSFSAlloc_t *sa)
+{
+    uint64_t start;
+    uint32_t round;
+    uint32_t i;
+
+    start = SSFPortGetHRTick64();
+    for (round = 0; round < SSA_BENCH_ROUNDS; round++)
+    {
+        for (i = 0; i < SSA_BENCH_LIVE; i++)
+        {
+            if (sa != NULL) _ssaBenchPtrs[i] = SSFSAllocAlloc(sa, _ssaBenchSizes[i]);
+            else _ssaBenchPtrs[i] = SSF_MALLOC(_ssaBenchSizes[i]);
+            SSF_ASSERT(_ssaBenchPtrs[i] != NULL);
+            *(uint32_t *)_ssaBenchPtrs[i] = round;
+        }
+        for (i = 0; i < SSA_BENCH_LIVE; i++)
+        {
+            /* Free in a different order than allocated */
+            if (sa != NULL) SSFSAllocDealloc(sa, _ssaBenchPtrs[(i * 97u) % SSA_BENCH_LIVE]);
+            else SSF_FREE(_ssaBenchPtrs[(i * 97u) % SSA_BENCH_LIVE]);
+        }
+    }
+    return ((SSFPortGetHRTick64() - start) * (1000000000ull / SSF_HR_TICKS_PER_SEC)) /
+           (SSA_BENCH_ROUNDS * SSA_BENCH_LIVE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Prints alloc/free pair cost of the size class allocator and SSF_MALLOC for mixed sizes.       */
+/* --------------------------------------------------------------------------------------------- */
+static void _SSFSAllocUTBench(void)
+{
+    uint64_t saNs;
+    uint64_t mallocNs;
+    uint32_t seed = 1;
+    uint8_t cls;
+    uint32_t i;
+
+    for (i = 0; i < SSA_BENCH_LIVE; i++)
+    {
+        seed = (seed * 1103515245ul) + 12345ul;
+        _ssaBenchSizes[i] = ((seed >> 8) % SSA_BENCH_MAX_SIZE) + sizeof(uint32_t);
+    }
+    for (cls = 0; cls < SSF_SALLOC_CONFIG_NUM_CLASSES; cls++)
+    {
+        _ssaBlocks[cls] = (SSF_SALLOC_CLASS_SIZE(cls) <= (SSA_BENCH_MAX_SIZE * 2u)) ?
+                          SSA_BENCH_LIVE : 0;
+    }
+    SSFSAllocInit(&_ssaTest, _ssaBlocks, NULL, 0, NULL);
+    saNs = _SSFSAllocUTBenchCycle(&_ssaTest);
+    SSFSAllocDeInit(&_ssaTest);
+    mallocNs = _SSFSAllocUTBenchCycle(NULL);
+    printf("\r\n  %u live blocks of 4 to %u bytes: size classes %llu ns, SSF_MALLOC %llu ns"
+           " per alloc/free pair\r\n", SSA_BENCH_LIVE, SSA_BENCH_MAX_SIZE + 3u,
+           (unsigned long long)saNs, (unsigned long long)mallocNs);
+}
+#endif /* SSF_CONFIG_UNIT_TEST_BENCHMARK */
+
+/* --------------------------------------------------------------------------------------------- */
+/* Performs unit test on ssfsalloc's external interface.                                         */
+/* --------------------------------------------------------------------------------------------- */
+void SSFSAllocUnitTest(void)
+{
+    SSFHeapHandle_t heap = NULL;
+    SSFHeapStatus_t heapStatus;
+    SSFSAllocStats_t stats;
+    void *volatile ptr;
+    volatile uint32_t size = 0;
+    volatile uint8_t cls;
+    uint32_t i;
+
+    for (cls = 0; cls < SSF_SALLOC_CONFIG_NUM_CLASSES; cls++)
+    {
+        _ssaBlocks[cls] = SSA_TEST_BLOCKS;
+        size += SSF_SALLOC_CLASS_ARENA_SIZE(cls, SSA_TEST_BLOCKS);
+    }
+    SSF_ASSERT(SSF_SALLOC_CLASS_SIZE(0) == SSF_SALLOC_CONFIG_MIN_CLASS_SIZE);
+    SSF_ASSERT(SSF_SALLOC_CLASS_ARENA_SIZE(0, 0) == 0);
+    SSF_ASSERT_TEST(SSFSAllocArenaSize(NULL));
+    SSF_ASSERT(SSFSAllocArenaSize(_ssaBlocks) == size);
+    SSF_ASSERT(SSFSAllocArenaSize(_ssaNoBlocks) == 0);
+
+    SSF_ASSERT_TEST(SSFSAllocInit(NULL, _ssaBlocks, NULL, 0, NULL));
+    SSF_ASSERT_TEST(SSFSAllocInit(&_ssaTest, NULL, NULL, 0, NULL));
+    SSF_ASSERT_TEST(SSFSAllocInit(&_ssaTest, _ssaNoBlocks, NULL, 0, NULL));
+    SSF_ASSERT_TEST(SSFSAllocInit(&_ssaTest, _ssaBlocks, _ssaArena, size - 1u, NULL));
+    SSF_ASSERT_TEST(SSFSAllocDeInit(NULL));
+    SSF_ASSERT_TEST(SSFSAllocDeInit(&_ssaTest));
+    SSF_ASSERT_TEST(SSFSAllocAlloc(NULL, 1u));
+    SSF_ASSERT_TEST(SSFSAllocAlloc(&_ssaTest, 1u));
+    SSF_ASSERT_TEST(SSFSAllocDealloc(&_ssaTest, _ssaArena));
+    SSF_ASSERT_TEST(SSFSAllocStats(&_ssaTest, 0, &stats));
+    SSF_ASSERT_TEST(SSFSAllocSetDefault(&_ssaTest));
+
+    /* Each size goes to the smallest class it fits, too big ones to the fallback */
+    SSFSAllocInit(&_ssaTest, _ssaBlocks, NULL, 0, NULL);
+    SSF_ASSERT_TEST(SSFSAllocInit(&_ssaTest, _ssaBlocks, NULL, 0, NULL));
+    SSF_ASSERT_TEST(SSFSAllocAlloc(NULL, 1u));
+    SSF_ASSERT_TEST(SSFSAllocDealloc(NULL, _ssaArena));
+    SSF_ASSERT_TEST(SSFSAllocDealloc(&_ssaTest, NULL));
+    SSF_ASSERT_TEST(SSFSAllocStats(NULL, 0, &stats));
+    SSF_ASSERT_TEST(SSFSAllocStats(&_ssaTest, SSF_SALLOC_FALLBACK + 1u, &stats));
+    SSF_ASSERT_TEST(SSFSAllocStats(&_ssaTest, 0, NULL));
+    for (cls = 0; cls < SSF_SALLOC_CONFIG_NUM_CLASSES; cls++)
+    {
+        SSFSAllocStats(&_ssaTest, cls, &stats);
+        SSF_ASSERT(stats.blockSize == SSF_SALLOC_CLASS_SIZE(cls));
+        SSF_ASSERT(stats.blocks == SSA_TEST_BLOCKS);
+        _SSFSAllocUTStats(cls, 0, 0, 0, 0);
+
+        _ssaPtrs[0] = SSFSAllocAlloc(&_ssaTest, SSF_SALLOC_CLASS_SIZE(cls));
+        SSF_ASSERT((((uintptr_t)_ssaPtrs[0]) & (SSF_MPOOL_CONFIG_BLOCK_ALIGN - 1)) == 0);
+        memset(_ssaPtrs[0], (int)cls, SSF_SALLOC_CLASS_SIZE(cls));
+        size = (cls == 0) ? 0 : SSF_SALLOC_CLASS_SIZE(cls - 1) + 1u;
+        _ssaPtrs[1] = SSFSAllocAlloc(&_ssaTest, size);
+        _SSFSAllocUTStats(cls, 2u, 2u, 2u, 0);
+        _ssaPtrs[0] = SSFSAllocDealloc(&_ssaTest, _ssaPtrs[0]);
+        SSF_ASSERT(_ssaPtrs[0] == NULL);
+        SSFSAllocDealloc(&_ssaTest, _ssaPtrs[1]);
+        _SSFSAllocUTStats(cls, 0, 2u, 2u, 0);
+    }
+    _SSFSAllocUTStats(SSF_SALLOC_FALLBACK, 0, 0, 0, 0);
+    SSFSAllocStats(&_ssaTest, SSF_SALLOC_FALLBACK, &stats);
+    SSF_ASSERT((stats.blockSize == 0) && (stats.blocks == 0));
+    ptr = SSFSAllocAlloc(&_ssaTest, SSF_SALLOC_MAX_CLASS_SIZE + 1u);
+    SSF_ASSERT(ptr != NULL);
+    memset(ptr, 0x55, SSF_SALLOC_MAX_CLASS_SIZE + 1u);
+    _SSFSAllocUTStats(SSF_SALLOC_FALLBACK, 1u, 1u, 1u, 0);
+    SSF_ASSERT_TEST(SSFSAllocDeInit(&_ssaTest));
+    ptr = SSFSAllocDealloc(&_ssaTest, ptr);
+    _SSFSAllocUTStats(SSF_SALLOC_FALLBACK, 0, 1u, 1u, 0);
+
+    /* A full class spills to the next bigger one, the last to the fallback */
+    for (cls = 0; cls < SSF_SALLOC_CONFIG_NUM_CLASSES; cls++)
+    {
+        for (i = 0; i <= SSA_TEST_BLOCKS; i++)
+        {
+            _ssaPtrs[i] = SSFSAllocAlloc(&_ssaTest, SSF_SALLOC_CLASS_SIZE(cls));
+            SSF_ASSERT(_ssaPtrs[i] != NULL);
+            memset(_ssaPtrs[i], (int)i, SSF_SALLOC_CLASS_SIZE(cls));
+        }
+        _SSFSAllocUTStats(cls, SSA_TEST_BLOCKS, SSA_TEST_BLOCKS,
+                          2u + SSA_TEST_BLOCKS + ((cls > 0) ? 1u : 0), 1u);
+        SSFSAllocStats(&_ssaTest, cls + 1u, &stats);
+        SSF_ASSERT(stats.used == 1u);
+        SSF_ASSERT_TEST(SSFSAllocDeInit(&_ssaTest));
+        for (i = 0; i <= SSA_TEST_BLOCKS; i++)
+        {
+            SSF_ASSERT(((uint8_t *)_ssaPtrs[i])[SSF_SALLOC_CLASS_SIZE(cls) - 1u] == (uint8_t)i);
+            SSFSAllocDealloc(&_ssaTest, _ssaPtrs[i]);
+        }
+        SSFSAllocStats(&_ssaTest, cls + 1u, &stats);
+        SSF_ASSERT(stats.used == 0);
+    }
+    _SSFSAllocUTStats(SSF_SALLOC_FALLBACK, 0, 1u, 2u, 0);
+    SSFSAllocDeInit(&_ssaTest);
+    SSF_ASSERT_TEST(SSFSAllocDeInit(&_ssaTest));
+
+#if SSF_SALLOC_CONFIG_NUM_CLASSES > 1
+    /* Classes without blocks are skipped, blocks come from a caller arena */
+    memcpy(_ssaNoBlocks, _ssaBlocks, sizeof(_ssaNoBlocks));
+    _ssaNoBlocks[0] = 0;
+    SSFSAllocInit(&_ssaTest, _ssaNoBlocks, _ssaArena, sizeof(_ssaArena), NULL);
+    ptr = SSFSAllocAlloc(&_ssaTest, 1u);
+    SSF_ASSERT(((uint8_t *)ptr > (uint8_t *)_ssaArena) &&
+               ((uint8_t *)ptr < ((uint8_t *)_ssaArena) + sizeof(_ssaArena)));
+    _SSFSAllocUTStats(0, 0, 0, 0, 1u);
+    _SSFSAllocUTStats(1u, 1u, 1u, 1u, 0);
+    ptr = SSFSAllocDealloc(&_ssaTest, ptr);
+    SSFSAllocDeInit(&_ssaTest);
+    memset(_ssaNoBlocks, 0, sizeof(_ssaNoBlocks));
+#endif
+
+    /* Arena and oversized requests from an SSFHeap, NULL when it is out of memory */
+    SSFHeapInit(&heap, (uint8_t *)_ssaHeapMem, sizeof(_ssaHeapMem), SSA_TEST_HEAP_MARK, false);
+    SSFSAllocInit(&_ssaTest, _ssaBlocks, NULL, 0, heap);
+    SSFHeapStatus(heap, &heapStatus);
+    SSF_ASSERT(heapStatus.numAllocRequests == 1u);
+    ptr = SSFSAllocAlloc(&_ssaTest, SSF_SALLOC_MAX_CLASS_SIZE * 2u);
+    SSF_ASSERT(ptr != NULL);
+    SSF_ASSERT(SSFSAllocAlloc(&_ssaTest, sizeof(_ssaHeapMem)) == NULL);
+    _SSFSAllocUTStats(SSF_SALLOC_FALLBACK, 1u, 1u, 1u, 1u);
+    SSFHeapStatus(heap, &heapStatus);
+    SSF_ASSERT(heapStatus.numAllocRequests == 2u);
+    SSFSAllocDealloc(&_ssaTest, ptr);
+    SSFSAllocDeInit(&_ssaTest);
+    SSFHeapStatus(heap, &heapStatus);
+    SSF_ASSERT(heapStatus.numFreeRequests == 2u);
+    SSFHeapDeInit(&heap, false);
+
+    /* Drop in SSF_MALLOC/SSF_FREE replacements use the default allocator, else the fallback */
+    ptr = SSFSAllocMalloc(1u);
+    SSF_ASSERT(ptr != NULL);
+    SSFSAllocInit(&_ssaTest, _ssaBlocks, NULL, 0, NULL);
+    SSF_ASSERT_TEST(SSFSAllocSetDefault(&_ssaTest));
+    SSFSAllocFree(ptr);
+    SSFSAllocFree(NULL);
+    SSFSAllocSetDefault(&_ssaTest);
+    ptr = SSFSAllocMalloc(1u);
+    _SSFSAllocUTStats(0, 1u, 1u, 1u, 0);
+    SSFSAllocFree(ptr);
+    SSFSAllocFree(NULL);
+    _SSFSAllocUTStats(0, 0, 1u, 1u, 0);
+    SSFSAllocDeInit(&_ssaTest);
+    ptr = SSFSAllocMalloc(1u);
+    SSF_ASSERT(ptr != NULL);
+    SSFSAllocFree(ptr);
+    SSFSAllocInit(&_ssaTest, _ssaBlocks, NULL, 0, NULL);
+    SSFSAllocSetDefault(&_ssaTest);
+    SSFSAllocSetDefault(NULL);
+
+    /* A default can not be replaced or cleared while it has class or fallback blocks out */
+    SSFSAllocSetDefault(&_ssaTest);
+    ptr = SSFSAllocMalloc(1u);
+    SSF_ASSERT(ptr != NULL);
+    SSF_ASSERT_TEST(SSFSAllocSetDefault(NULL));
+    SSFSAllocSetDefault(&_ssaTest);
+    SSFSAllocFree(ptr);
+    ptr = SSFSAllocMalloc(SSF_SALLOC_MAX_CLASS_SIZE * 2u);
+    SSF_ASSERT(ptr != NULL);
+    SSF_ASSERT_TEST(SSFSAllocSetDefault(NULL));
+    SSFSAllocFree(ptr);
+    SSFSAllocSetDefault(NULL);
+    SSFSAllocDeInit(&_ssaTest);
+
+#if (SSF_MPOOL_CONCURRENT == 1) && !defined(_WIN32)
+    _SSFSAllocUTThreads();
+#endif
+
+#if SSF_CONFIG_UNIT_TEST_BENCHMARK == 1
+    _SSFSAllocUTBench();
+#endif
+}
+#endif /* SSF_CONFIG_SALLOC_UNIT_TEST */
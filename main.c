@@ -36,8 +36,10 @@
 #include "ssfll.h"
 #include "ssfsm.h"
 #include "ssfmpool.h"
+#include "ssfsalloc.h"
 #include "ssfport.h"
 #include "ssfjson.h"
+#include "ssflz.h"
 #include "ssfbase64.h"
 #include "ssfhex.h"
 #include "ssffcsum.h"
@@ -108,6 +110,9 @@ SSFUnitTest_t unitTests[] =
 #if SSF_CONFIG_JSON_UNIT_TEST == 1
     { "ssfjson", "JSON Codec", SSFJsonUnitTest },
 #endif /* SSF_CONFIG_JSON_UNIT_TEST */
+#if SSF_CONFIG_LZ_UNIT_TEST == 1
+    { "ssflz", "LZ Compression Codec", SSFLZUnitTest },
+#endif /* SSF_CONFIG_LZ_UNIT_TEST */
 #if SSF_CONFIG_STR_UNIT_TEST == 1
     { "ssfstr", "Safe C Strings", SSFStrUnitTest },
 #endif /* SSF_CONFIG_STR_UNIT_TEST */
@@ -171,6 +176,9 @@ SSFUnitTest_t unitTests[] =
 #if SSF_CONFIG_MPOOL_UNIT_TEST == 1
     { "ssfmpool", "Memory Pool", SSFMPoolUnitTest },
 #endif /* SSF_CONFIG_MPOOL_UNIT_TEST */
+#if SSF_CONFIG_SALLOC_UNIT_TEST == 1
+    { "ssfsalloc", "Size Class Allocator", SSFSAllocUnitTest },
+#endif /* SSF_CONFIG_SALLOC_UNIT_TEST */
 
     /* _time */
 #if SSF_CONFIG_DTIME_UNIT_TEST == 1
@@ -43,7 +43,7 @@ extern "C" {
 /* Configure ssfbfifo's byte fifo interface                                                      */
 /* --------------------------------------------------------------------------------------------- */
 
-/* Define the maximum fifo size. */
+/* Define the maximum fifo size, up to 2^31 - 1 bytes. */
 #define SSF_BFIFO_CONFIG_MAX_BFIFO_SIZE (255UL)
 
 #define SSF_BFIFO_CONFIG_RUNTIME_BFIFO_SIZE_ANY         (0u)
@@ -61,12 +61,53 @@ extern "C" {
 /* Enable or disable the multi-byte fifo interface. */
 #define SSF_BFIFO_MULTI_BYTE_ENABLE                     (1u)
 
+/* Enable or disable the lock-free single producer/single consumer SSFBFifoSPSC interface. */
+#define SSF_BFIFO_CONFIG_ENABLE_SPSC                    (1u)
+
+/* Define the cache line size used to keep the SPSC producer and consumer indices apart. */
+#define SSF_BFIFO_SPSC_CACHE_LINE_SIZE                  (64u)
+
+/* 1 to enable the SSFBFifoMirror interface whose queued and free bytes are always contiguous, */
+/* using memfd pages mapped twice back to back on Linux, else a compacted plain buffer, else 0. */
+#define SSF_BFIFO_CONFIG_ENABLE_MIRROR                  (1u)
+
+/* 1 to enable the SSFBFifoBcast interface where one lock-free producer writes each byte once */
+/* and any number of readers each keep their own cursor, else 0. */
+#define SSF_BFIFO_CONFIG_ENABLE_BCAST                   (1u)
+
 /* --------------------------------------------------------------------------------------------- */
 /* Configure ssfmpool's memory pool interface                                                    */
 /* --------------------------------------------------------------------------------------------- */
-/* Enable pool debug struct that tracks all blocks and who allocated them                        */
+/* Enable pool debug checks that freed pointers are the start of a block                         */
 #define SSF_MPOOL_DEBUG (0u)
 
+/* Alignment in bytes of blocks from SSFMPoolInit(), a power of 2 >= pointer size, 64 for lines */
+#define SSF_MPOOL_CONFIG_BLOCK_ALIGN (8u)
+
+/* 1 to enable SSFMPoolInitConcurrent() pools that many threads may alloc and free without locks */
+/* when SSF_CONFIG_ENABLE_THREAD_SUPPORT is 1, else 0. */
+#define SSF_MPOOL_CONFIG_ENABLE_CONCURRENT (1u)
+
+/* Max free blocks each thread caches per concurrent pool, half move to or from the pool at once */
+#define SSF_MPOOL_CONFIG_MAGAZINE_SIZE (16u)
+
+/* Max concurrent pools each thread caches blocks for, further pools use the shared list directly */
+#define SSF_MPOOL_CONFIG_MAGAZINES (12u)
+
+/* --------------------------------------------------------------------------------------------- */
+/* Configure ssfsalloc's size class allocator                                                    */
+/* --------------------------------------------------------------------------------------------- */
+/* Smallest class block size in bytes, a power of 2; each further class doubles it */
+#define SSF_SALLOC_CONFIG_MIN_CLASS_SIZE (16u)
+
+/* Number of size classes, 9 gives 16, 32, 64, ... 4096 byte classes */
+#define SSF_SALLOC_CONFIG_NUM_CLASSES (9u)
+
+/* Allocator for the arena and oversized requests when no SSFHeap is given; must stay the */
+/* platform allocator when SSF_MALLOC and SSF_FREE are set to SSFSAllocMalloc/SSFSAllocFree. */
+#define SSF_SALLOC_CONFIG_FALLBACK_MALLOC malloc
+#define SSF_SALLOC_CONFIG_FALLBACK_FREE free
+
 /* --------------------------------------------------------------------------------------------- */
 /* Configure ssfjson's parser limits                                                             */
 /* --------------------------------------------------------------------------------------------- */
@@ -171,6 +212,76 @@ extern pthread_mutex_t gssfsmWakeMutex;
     SSF_ASSERT(pthread_mutex_unlock(&gssfsmWakeMutex) == 0); \
 }
 #endif /* WIN32 */
+
+/* Executors created with SSFSMExecInit() each need a wake primitive of their own, the */
+/* SSF_SM_THREAD_WAKE macros above are used by the default executor. */
+#ifdef _WIN32
+typedef HANDLE SSFSMExecWake_t;
+#define SSF_SM_EXEC_WAKE_INIT(w) { \
+    (w) = CreateSemaphore(NULL, 0, 1, NULL); \
+    SSF_ASSERT((w) != NULL); \
+}
+#define SSF_SM_EXEC_WAKE_DEINIT(w) { \
+    CloseHandle(w); \
+    (w) = NULL; \
+}
+#define SSF_SM_EXEC_WAKE_POST(w) { ReleaseSemaphore((w), 1, NULL); }
+#define SSF_SM_EXEC_WAKE_WAIT(w, timeout) { \
+    DWORD waitResult; \
+    waitResult = WaitForSingleObject((w), (DWORD)(timeout)); \
+    SSF_ASSERT((waitResult == WAIT_OBJECT_0) || (waitResult == WAIT_TIMEOUT)); \
+}
+#else /* WIN32 */
+typedef struct
+{
+    bool isSignalled;
+    pthread_cond_t cond;
+    pthread_mutex_t mutex;
+} SSFSMExecWake_t;
+
+#if SSF_SM_THREAD_PTHREAD_CLOCK_MONOTONIC == 1
+#define SSF_SM_EXEC_WAKE_INIT(w) { \
+    pthread_condattr_t attr; \
+    (w).isSignalled = false; \
+    SSF_ASSERT(pthread_condattr_init(&attr) == 0); \
+    SSF_ASSERT(pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) == 0); \
+    SSF_ASSERT(pthread_cond_init(&((w).cond), &attr) == 0); \
+    SSF_ASSERT(pthread_mutex_init(&((w).mutex), NULL) == 0); \
+}
+#else
+#define SSF_SM_EXEC_WAKE_INIT(w) { \
+    (w).isSignalled = false; \
+    SSF_ASSERT(pthread_cond_init(&((w).cond), NULL) == 0); \
+    SSF_ASSERT(pthread_mutex_init(&((w).mutex), NULL) == 0); \
+}
+#endif
+#define SSF_SM_EXEC_WAKE_DEINIT(w) { \
+    SSF_ASSERT(pthread_mutex_destroy(&((w).mutex)) == 0); \
+    SSF_ASSERT(pthread_cond_destroy(&((w).cond)) == 0); \
+}
+#define SSF_SM_EXEC_WAKE_POST(w) { \
+    SSF_ASSERT(pthread_mutex_lock(&((w).mutex)) == 0); \
+    (w).isSignalled = true; \
+    SSF_ASSERT(pthread_cond_signal(&((w).cond)) == 0); \
+    SSF_ASSERT(pthread_mutex_unlock(&((w).mutex)) == 0); \
+}
+#define SSF_SM_EXEC_WAKE_WAIT(w, timeout) { \
+    SSF_ASSERT(pthread_mutex_lock(&((w).mutex)) == 0); \
+    if ((w).isSignalled == false) { \
+        uint64_t ns; \
+        struct timespec ts; \
+        SSF_ASSERT(clock_gettime(SSF_SM_THREAD_PTHREAD_CLOCK, &ts) == 0); \
+        ns = ((uint64_t) ts.tv_nsec) + (((timeout * 1000ul) / SSF_TICKS_PER_SEC) * 1000000ul); \
+        while (ns >= 1000000000l) { \
+            ns -= 1000000000l; \
+            ts.tv_sec++; } \
+        ts.tv_nsec = (long int) ns; \
+        if (pthread_cond_timedwait(&((w).cond), &((w).mutex), &ts) != 0) { \
+            SSF_ASSERT(((errno & 0xff) == ETIMEDOUT) || (errno == 0)); } } \
+    (w).isSignalled = false; \
+    SSF_ASSERT(pthread_mutex_unlock(&((w).mutex)) == 0); \
+}
+#endif /* WIN32 */
 #endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
 
 /* Maximum number of simultaneously queued events for all state machines. */
@@ -179,6 +290,67 @@ extern pthread_mutex_t gssfsmWakeMutex;
 /* Maximum number of simultaneously running timers for all state machines. */
 #define SSF_SM_MAX_ACTIVE_TIMERS (3u)
 
+/* 1 to post events through a lock-free multi-producer/single-consumer queue backed by a */
+/* lock-free event pool, so SSFSMPutEventData() never blocks while SSFSMTask() runs handlers; */
+/* 0 to serialize posting and processing on the sync mutex. */
+/* Only applies when SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1, so costs nothing on bare metal. */
+#define SSF_SM_CONFIG_ENABLE_LOCK_FREE_EVENTS (1u)
+
+/* Event data up to this many bytes is stored inside every event, no allocation required. */
+#define SSF_SM_EVENT_INLINE_DATA_SIZE (16u)
+
+/* Number of data pools for event data larger than SSF_SM_EVENT_INLINE_DATA_SIZE, 0 for none. */
+/* Event data that does not fit a free data pool block is copied to the heap. */
+#define SSF_SM_EVENT_DATA_POOL_NUM (2u)
+
+/* Block size of each data pool, in increasing order. */
+#define SSF_SM_EVENT_DATA_POOL_SIZES { 64u, 256u }
+
+/* Number of blocks in each data pool per executor. */
+#define SSF_SM_EVENT_DATA_POOL_COUNTS { 4u, 2u }
+
+/* Number of event priority levels, 0 is the highest priority, each costs one list per executor. */
+#define SSF_SM_EVENT_PRIORITY_NUM (3u)
+
+/* Priority of events posted by SSFSMPutEventData() and of expired timer events. */
+#define SSF_SM_EVENT_PRIORITY_DEFAULT (1u)
+
+/* 1 to profile each executor's state dwell times, event queueing delay and handler time, and */
+/* timer lateness, else 0 for no profiling overhead. Adds two histograms per event id to each */
+/* executor, so it is off unless profiling is wanted. */
+#define SSF_SM_CONFIG_ENABLE_PROFILE (0u)
+
+/* Maximum number of distinct states profiled per state machine. */
+#define SSF_SM_PROFILE_MAX_STATES (8u)
+
+/* Number of log2 histogram bins, bin 0 counts 0, bin i counts [2^(i-1), 2^i) HR ticks. */
+#define SSF_SM_PROFILE_HIST_BINS (32u)
+
+/* 1 to add SSFSMProfileCLIHandler(), an ssfcli command printing the profile, else 0 to keep */
+/* ssfsm free of the _ui modules. Requires SSF_SM_CONFIG_ENABLE_PROFILE. */
+#define SSF_SM_CONFIG_ENABLE_PROFILE_CLI (0u)
+
+/* 1 to read time through a pluggable tick source that may be a virtual clock for simulation, */
+/* else 0 to always use SSFPortGetTick64(). Costs one function pointer. */
+#define SSF_SM_CONFIG_ENABLE_TICK_SOURCE (1u)
+
+/* 1 to enable SSFSMReplaceEventData() which replaces the data of a queued event with the same */
+/* state machine and event ids instead of queuing another, else 0. Adds SSF_SM_MAX * */
+/* SSF_SM_EVENT_MAX pointers to each executor. */
+#define SSF_SM_CONFIG_ENABLE_COALESCE (0u)
+
+/* 1 to enable SSFSMEpollTask() which runs an executor from an epoll loop on Linux, posting */
+/* events for ready file descriptors, else 0. Compiled out on other platforms. */
+#define SSF_SM_CONFIG_ENABLE_EPOLL (1u)
+
+/* Maximum number of ready file descriptors dispatched per SSFSMEpollTask() call. */
+#define SSF_SM_EPOLL_MAX_EVENTS (16u)
+
+/* Number of (current, next) state transitions whose super states are cached per executor, */
+/* must be a power of 2, else 0 to always query the super states on every transition. Each */
+/* entry costs four pointers per executor, worth it only for deep state hierarchies. */
+#define SSF_SM_TRAN_CACHE_SIZE (0u)
+
 /* Defines the state machine identifers. */
 typedef enum
 {
@@ -286,6 +458,12 @@ typedef enum
 /* 0 allows 2^30 unique TAGs and VALUE fields < 2^30 bytes in length */
 #define SSF_TLV_ENABLE_FIXED_MODE (0u)
 
+/* --------------------------------------------------------------------------------------------- */
+/* Configure ssflz interface                                                                     */
+/* --------------------------------------------------------------------------------------------- */
+/* Bits of the encoder's match table, SSFLZEncodeContext_t holds 2^bits 16-bit entries */
+#define SSF_LZ_HASH_BITS (10u)
+
 /* --------------------------------------------------------------------------------------------- */
 /* Configure ssfcfg interface                                                                    */
 /* --------------------------------------------------------------------------------------------- */
@@ -293,8 +471,30 @@ typedef enum
 #define SSF_CFG_MAX_STORAGE_SIZE (4096u) /* Max size of erasable NV storage sector */
 #define SSF_CFG_WRITE_CHECK_CHUNK_SIZE (32u) /* Max size of tmp stack buffer for write checking */
 
+/* 1 to append records to a log spread over a ring of sectors, 0 to erase one sector per dataId */
+#define SSF_CFG_ENABLE_LOG_STORAGE (0u)
+#define SSF_CFG_LOG_NUM_SECTORS (3u) /* Sectors in the log ring, >= 2 */
+#define SSF_CFG_LOG_MAX_IDS (16u) /* dataId must be < this, sizes the RAM index of the log */
+#define SSF_CFG_TX_MAX_SIZE (512u) /* RAM staging buffer size for SSFCfgTx*() transactions */
+
+/* 1 to cache validated records in RAM so repeated reads and unchanged writes skip storage */
+#define SSF_CFG_ENABLE_READ_CACHE (1u)
+#define SSF_CFG_READ_CACHE_MAX_DATA_LEN (64u) /* Only records up to this length are cached */
+
+/* 1 to LZ compress records so larger and more records fit, requires ssflz; changes the on-flash */
+/* format, builds without it can not read the compressed records it writes                       */
+#define SSF_CFG_ENABLE_COMPRESSION (0u)
+#define SSF_CFG_COMPRESS_MIN_DATA_LEN (128u) /* Shorter records are always stored as is */
+
+/* 1 to queue writes with SSFCfgWriteAsync() for SSFCfgTask() to complete in the background */
+#define SSF_CFG_ENABLE_WRITE_QUEUE (1u)
+#define SSF_CFG_QUEUE_MAX_DATA_LEN (128u) /* Only records up to this length can be queued */
+
 /* 1 to use RAM as storage, 0 to specify another storage interface */
 #define SSF_CFG_ENABLE_STORAGE_RAM (1u)
+/* 1 to allow RAM storage to be a memory-mapped file on Linux, 0 for RAM only */
+#define SSF_CFG_ENABLE_STORAGE_FILE (1u)
+#define SSF_CFG_FILE_BATCH_WRITES (16u) /* Writes between syncs in SSF_CFG_FILE_BATCHED mode */
 #if SSF_CFG_ENABLE_STORAGE_RAM == 0
 #define SSF_CFG_ERASE_STORAGE(dataId)
 #define SSF_CFG_WRITE_STORAGE(data, dataSize, dataId, dataOffset)
@@ -302,22 +502,47 @@ typedef enum
 #else
 #define SSF_MAX_CFG_RAM_SECTORS (3u)
 #define SSF_CFG_ERASE_STORAGE(dataId) { \
-    memset(&_ssfCfgStorageRAM[dataId], 0xff, SSF_CFG_MAX_STORAGE_SIZE); \
+    _SSFCfgStorageRAMErase(dataId); \
 }
 #define SSF_CFG_WRITE_STORAGE(data, dataLen, dataId, dataOffset) { \
-    memcpy(&_ssfCfgStorageRAM[dataId][dataOffset], data, dataLen); \
+    _SSFCfgStorageRAMWrite(data, dataLen, dataId, dataOffset); \
 }
 #define SSF_CFG_READ_STORAGE(data, dataSize, dataId, dataOffset) { \
-    memcpy(data, &_ssfCfgStorageRAM[dataId][dataOffset], dataSize); \
+    _SSFCfgStorageRAMRead(data, dataSize, dataId, dataOffset); \
 }
 #endif
 
 #if SSF_CONFIG_ENABLE_THREAD_SUPPORT == 1
-#define SSF_CFG_THREAD_SYNC_DECLARATION SSF_MUTEX_DECLARATION(_ssfcfgSyncMutex)
-#define SSF_CFG_THREAD_SYNC_INIT() SSF_MUTEX_INIT(_ssfcfgSyncMutex)
-#define SSF_CFG_THREAD_SYNC_DEINIT() SSF_MUTEX_DEINIT(_ssfcfgSyncMutex)
-#define SSF_CFG_THREAD_SYNC_ACQUIRE() SSF_MUTEX_ACQUIRE(_ssfcfgSyncMutex)
-#define SSF_CFG_THREAD_SYNC_RELEASE() SSF_MUTEX_RELEASE(_ssfcfgSyncMutex)
+#define SSF_CFG_THREAD_SYNC_DECLARATION SSF_RWLOCK_DECLARATION(_ssfcfgSyncLock)
+#define SSF_CFG_THREAD_SYNC_INIT() SSF_RWLOCK_INIT(_ssfcfgSyncLock)
+#define SSF_CFG_THREAD_SYNC_DEINIT() SSF_RWLOCK_DEINIT(_ssfcfgSyncLock)
+#define SSF_CFG_THREAD_SYNC_ACQUIRE() SSF_RWLOCK_ACQUIRE(_ssfcfgSyncLock)
+#define SSF_CFG_THREAD_SYNC_RELEASE() SSF_RWLOCK_RELEASE(_ssfcfgSyncLock)
+#define SSF_CFG_THREAD_SYNC_ACQUIRE_SHARED() SSF_RWLOCK_ACQUIRE_SHARED(_ssfcfgSyncLock)
+#define SSF_CFG_THREAD_SYNC_RELEASE_SHARED() SSF_RWLOCK_RELEASE_SHARED(_ssfcfgSyncLock)
+/* Sector storage locks each dataId's sector on its own, the lock above is then held shared by   */
+/* record reads and writes and exclusively only by calls that change all of storage              */
+#define SSF_CFG_SECTOR_SYNC_DECLARATION \
+    SSF_RWLOCK_DECLARATION(_ssfcfgSectorLocks[SSF_CFG_MAX_DATA_IDS])
+#define SSF_CFG_SECTOR_SYNC_INIT(dataId) SSF_RWLOCK_INIT(_ssfcfgSectorLocks[dataId])
+#define SSF_CFG_SECTOR_SYNC_DEINIT(dataId) SSF_RWLOCK_DEINIT(_ssfcfgSectorLocks[dataId])
+#define SSF_CFG_SECTOR_SYNC_ACQUIRE(dataId) SSF_RWLOCK_ACQUIRE(_ssfcfgSectorLocks[dataId])
+#define SSF_CFG_SECTOR_SYNC_RELEASE(dataId) SSF_RWLOCK_RELEASE(_ssfcfgSectorLocks[dataId])
+#define SSF_CFG_SECTOR_SYNC_ACQUIRE_SHARED(dataId) \
+    SSF_RWLOCK_ACQUIRE_SHARED(_ssfcfgSectorLocks[dataId])
+#define SSF_CFG_SECTOR_SYNC_RELEASE_SHARED(dataId) \
+    SSF_RWLOCK_RELEASE_SHARED(_ssfcfgSectorLocks[dataId])
+/* Serializes sector writes on the compression buffer and file sync state they share */
+#define SSF_CFG_WRITE_SYNC_DECLARATION SSF_MUTEX_DECLARATION(_ssfcfgWriteMutex)
+#define SSF_CFG_WRITE_SYNC_INIT() SSF_MUTEX_INIT(_ssfcfgWriteMutex)
+#define SSF_CFG_WRITE_SYNC_DEINIT() SSF_MUTEX_DEINIT(_ssfcfgWriteMutex)
+#define SSF_CFG_WRITE_SYNC_ACQUIRE() SSF_MUTEX_ACQUIRE(_ssfcfgWriteMutex)
+#define SSF_CFG_WRITE_SYNC_RELEASE() SSF_MUTEX_RELEASE(_ssfcfgWriteMutex)
+#define SSF_CFG_QUEUE_SYNC_DECLARATION SSF_MUTEX_DECLARATION(_ssfcfgQueueMutex)
+#define SSF_CFG_QUEUE_SYNC_INIT() SSF_MUTEX_INIT(_ssfcfgQueueMutex)
+#define SSF_CFG_QUEUE_SYNC_DEINIT() SSF_MUTEX_DEINIT(_ssfcfgQueueMutex)
+#define SSF_CFG_QUEUE_SYNC_ACQUIRE() SSF_MUTEX_ACQUIRE(_ssfcfgQueueMutex)
+#define SSF_CFG_QUEUE_SYNC_RELEASE() SSF_MUTEX_RELEASE(_ssfcfgQueueMutex)
 #endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
 
 /* --------------------------------------------------------------------------------------------- */
@@ -70,3 +70,22 @@ SSFPortTick_t SSFPortGetTick64(void)
 }
 #endif /* _WIN32 */
 
+/* --------------------------------------------------------------------------------------------- */
+/* Returns monotonic time in SSF_HR_TICKS_PER_SEC units, for measurement not scheduling.         */
+/* --------------------------------------------------------------------------------------------- */
+uint64_t SSFPortGetHRTick64(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER count;
+    LARGE_INTEGER freq;
+
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+    return (uint64_t)((((double)count.QuadPart) * SSF_HR_TICKS_PER_SEC) / freq.QuadPart);
+#else /* _WIN32 */
+    struct timespec ticks;
+    clock_gettime(CLOCK_MONOTONIC, &ticks);
+    return (((uint64_t)ticks.tv_sec) * 1000000000ull) + ((uint64_t)ticks.tv_nsec);
+#endif /* _WIN32 */
+}
+
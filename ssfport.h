@@ -54,6 +54,7 @@ extern "C" {
 #define SSF_CONFIG_HEX_UNIT_TEST     (1u)
 #define SSF_CONFIG_INI_UNIT_TEST     (1u)
 #define SSF_CONFIG_JSON_UNIT_TEST    (1u)
+#define SSF_CONFIG_LZ_UNIT_TEST      (1u)
 #define SSF_CONFIG_STR_UNIT_TEST     (1u)
 #define SSF_CONFIG_TLV_UNIT_TEST     (1u)
 #define SSF_CONFIG_UBJSON_UNIT_TEST  (1u)
@@ -86,6 +87,7 @@ extern "C" {
 #define SSF_CONFIG_HEAP_UNIT_TEST    (1u)
 #define SSF_CONFIG_LL_UNIT_TEST      (1u)
 #define SSF_CONFIG_MPOOL_UNIT_TEST   (1u)
+#define SSF_CONFIG_SALLOC_UNIT_TEST  (1u)
 
 /* _time */
 #define SSF_CONFIG_DTIME_UNIT_TEST   (1u)
@@ -105,6 +107,7 @@ extern "C" {
     SSF_CONFIG_HEX_UNIT_TEST == 1 || \
     SSF_CONFIG_INI_UNIT_TEST == 1 || \
     SSF_CONFIG_JSON_UNIT_TEST == 1 || \
+    SSF_CONFIG_LZ_UNIT_TEST == 1 || \
     SSF_CONFIG_STR_UNIT_TEST == 1 || \
     SSF_CONFIG_TLV_UNIT_TEST == 1 || \
     SSF_CONFIG_UBJSON_UNIT_TEST == 1 || \
@@ -130,6 +133,7 @@ extern "C" {
     SSF_CONFIG_HEAP_UNIT_TEST == 1 || \
     SSF_CONFIG_LL_UNIT_TEST == 1 || \
     SSF_CONFIG_MPOOL_UNIT_TEST == 1 || \
+    SSF_CONFIG_SALLOC_UNIT_TEST == 1 || \
     /* _time */ \
     SSF_CONFIG_DTIME_UNIT_TEST == 1 || \
     SSF_CONFIG_ISO8601_UNIT_TEST == 1 || \
@@ -143,6 +147,9 @@ extern "C" {
 #define SSF_CONFIG_UNIT_TEST (0u)
 #endif
 
+/* 1 to also run the timing benchmarks built into some unit tests and print results, else 0. */
+#define SSF_CONFIG_UNIT_TEST_BENCHMARK (0u)
+
 /* --------------------------------------------------------------------------------------------- */
 /* Platform specific tick configuration                                                          */
 /* --------------------------------------------------------------------------------------------- */
@@ -153,12 +160,21 @@ typedef uint64_t SSFPortTick_t;
 /* Define the number of system ticks per second */
 #define SSF_TICKS_PER_SEC (1000ull)
 
+/* Define the number of high resolution ticks per second, see SSFPortGetHRTick64() */
+#define SSF_HR_TICKS_PER_SEC (1000000000ull)
+
 /* --------------------------------------------------------------------------------------------- */
 /* Platform specific heap configuration                                                          */
 /* --------------------------------------------------------------------------------------------- */
 #define SSF_MALLOC malloc
 #define SSF_FREE free
 
+/* To serve framework allocations from ssfsalloc size classes after SSFSAllocSetDefault(): */
+/* void *SSFSAllocMalloc(size_t size); */
+/* void SSFSAllocFree(void *ptr); */
+/* #define SSF_MALLOC SSFSAllocMalloc */
+/* #define SSF_FREE SSFSAllocFree */
+
 /* --------------------------------------------------------------------------------------------- */
 /* Platform specific byte swapping macros                                                        */
 /* --------------------------------------------------------------------------------------------- */
@@ -231,6 +247,14 @@ typedef HANDLE SSFMutex_t;
     SSF_ASSERT(WaitForSingleObject(mutex, INFINITE) == WAIT_OBJECT_0); \
 }
 #define SSF_MUTEX_RELEASE(mutex) { SSF_ASSERT(ReleaseMutex(mutex)); }
+#define SSF_RWLOCK_DECLARATION(lock) SRWLOCK lock
+#define SSF_RWLOCK_INIT(lock) InitializeSRWLock(&lock)
+#define SSF_RWLOCK_DEINIT(lock)
+#define SSF_RWLOCK_ACQUIRE_SHARED(lock) AcquireSRWLockShared(&lock)
+#define SSF_RWLOCK_RELEASE_SHARED(lock) ReleaseSRWLockShared(&lock)
+#define SSF_RWLOCK_ACQUIRE(lock) AcquireSRWLockExclusive(&lock)
+#define SSF_RWLOCK_RELEASE(lock) ReleaseSRWLockExclusive(&lock)
+#define SSF_THREAD_LOCAL __declspec(thread)
 #else /* _WIN32 */
 #include <pthread.h>
 #include <errno.h>
@@ -249,9 +273,66 @@ typedef pthread_mutex_t SSFMutex_t;
 }
 #define SSF_MUTEX_ACQUIRE(mutex) { SSF_ASSERT(pthread_mutex_lock(&mutex) == 0); }
 #define SSF_MUTEX_RELEASE(mutex) { SSF_ASSERT(pthread_mutex_unlock(&mutex) == 0); }
+#define SSF_RWLOCK_DECLARATION(lock) pthread_rwlock_t lock
+#define SSF_RWLOCK_INIT(lock) { SSF_ASSERT(pthread_rwlock_init(&lock, NULL) == 0); }
+#define SSF_RWLOCK_DEINIT(lock) { SSF_ASSERT(pthread_rwlock_destroy(&lock) == 0); }
+#define SSF_RWLOCK_ACQUIRE_SHARED(lock) { SSF_ASSERT(pthread_rwlock_rdlock(&lock) == 0); }
+#define SSF_RWLOCK_RELEASE_SHARED(lock) { SSF_ASSERT(pthread_rwlock_unlock(&lock) == 0); }
+#define SSF_RWLOCK_ACQUIRE(lock) { SSF_ASSERT(pthread_rwlock_wrlock(&lock) == 0); }
+#define SSF_RWLOCK_RELEASE(lock) { SSF_ASSERT(pthread_rwlock_unlock(&lock) == 0); }
+#define SSF_THREAD_LOCAL __thread
 #endif /* _WIN32 */
+#else /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
+#define SSF_THREAD_LOCAL
 #endif /* SSF_CONFIG_ENABLE_THREAD_SUPPORT */
 
+/* --------------------------------------------------------------------------------------------- */
+/* Platform specific atomic operations                                                           */
+/* --------------------------------------------------------------------------------------------- */
+/* Used by the lock-free interfaces. Objects must be naturally aligned. Loads have acquire, */
+/* stores have release, and read-modify-write operations have full barrier semantics. */
+#ifdef _WIN32
+#define SSF_ATOMIC_LOAD_U32(p) ((uint32_t)InterlockedOr((volatile LONG *)(p), 0))
+#define SSF_ATOMIC_STORE_U32(p, v) InterlockedExchange((volatile LONG *)(p), (LONG)(v))
+#define SSF_ATOMIC_ADD_U32(p, v) ((uint32_t)InterlockedExchangeAdd((volatile LONG *)(p), \
+                                                                     (LONG)(v)))
+#define SSF_ATOMIC_XCHG_U32(p, v) ((uint32_t)InterlockedExchange((volatile LONG *)(p), (LONG)(v)))
+#define SSF_ATOMIC_CAS_U32(p, expected, desired) \
+    (InterlockedCompareExchange((volatile LONG *)(p), (LONG)(desired), (LONG)(expected)) == \
+     (LONG)(expected))
+#define SSF_ATOMIC_LOAD_U64(p) ((uint64_t)InterlockedOr64((volatile LONG64 *)(p), 0))
+#define SSF_ATOMIC_STORE_U64(p, v) InterlockedExchange64((volatile LONG64 *)(p), (LONG64)(v))
+#define SSF_ATOMIC_ADD_U64(p, v) ((uint64_t)InterlockedExchangeAdd64((volatile LONG64 *)(p), \
+                                                                       (LONG64)(v)))
+#define SSF_ATOMIC_CAS_U64(p, expected, desired) \
+    (InterlockedCompareExchange64((volatile LONG64 *)(p), (LONG64)(desired), \
+                                  (LONG64)(expected)) == (LONG64)(expected))
+#define SSF_ATOMIC_LOAD_PTR(p) InterlockedCompareExchangePointer((PVOID volatile *)(p), NULL, NULL)
+#define SSF_ATOMIC_STORE_PTR(p, v) InterlockedExchangePointer((PVOID volatile *)(p), (PVOID)(v))
+#define SSF_ATOMIC_XCHG_PTR(p, v) InterlockedExchangePointer((PVOID volatile *)(p), (PVOID)(v))
+#define SSF_ATOMIC_FENCE() MemoryBarrier()
+#else /* _WIN32 */
+#define SSF_ATOMIC_LOAD_U32(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SSF_ATOMIC_STORE_U32(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define SSF_ATOMIC_ADD_U32(p, v) __atomic_fetch_add((p), (v), __ATOMIC_ACQ_REL)
+#define SSF_ATOMIC_XCHG_U32(p, v) __atomic_exchange_n((p), (v), __ATOMIC_ACQ_REL)
+#define SSF_ATOMIC_CAS_U32(p, expected, desired) __extension__ ({ \
+    uint32_t _ssfExp = (expected); \
+    __atomic_compare_exchange_n((p), &_ssfExp, (desired), 0, __ATOMIC_ACQ_REL, \
+                                __ATOMIC_ACQUIRE); })
+#define SSF_ATOMIC_LOAD_U64(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SSF_ATOMIC_STORE_U64(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define SSF_ATOMIC_ADD_U64(p, v) __atomic_fetch_add((p), (v), __ATOMIC_ACQ_REL)
+#define SSF_ATOMIC_CAS_U64(p, expected, desired) __extension__ ({ \
+    uint64_t _ssfExp = (expected); \
+    __atomic_compare_exchange_n((p), &_ssfExp, (desired), 0, __ATOMIC_ACQ_REL, \
+                                __ATOMIC_ACQUIRE); })
+#define SSF_ATOMIC_LOAD_PTR(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SSF_ATOMIC_STORE_PTR(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define SSF_ATOMIC_XCHG_PTR(p, v) __atomic_exchange_n((p), (v), __ATOMIC_ACQ_REL)
+#define SSF_ATOMIC_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif /* _WIN32 */
+
 /* --------------------------------------------------------------------------------------------- */
 /* External interface                                                                            */
 /* --------------------------------------------------------------------------------------------- */
@@ -265,6 +346,7 @@ void SSFPortAssert(const char *file, unsigned int line);
 #else /* _WIN32 */
 SSFPortTick_t SSFPortGetTick64(void);
 #endif /* _WIN32 */
+uint64_t SSFPortGetHRTick64(void);
 
 #include "ssf.h"
 #include "ssfoptions.h"